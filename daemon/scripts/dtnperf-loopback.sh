@@ -0,0 +1,75 @@
+#!/bin/bash
+#
+# Regression benchmark with two local daemons connected over the
+# loopback interface. The client sends bundles with dtnperf through
+# node A to the dtnperf server on node B and the results of both
+# sides are appended to a CSV file.
+#
+# usage: dtnperf-loopback.sh [tcp|udp] [output.csv] [dtnperf options]
+#
+
+PROTO=${1:-tcp}
+OUTPUT=${2:-dtnperf-${PROTO}.csv}
+
+if [ $# -gt 2 ]; then
+	shift 2
+	PERF_OPTS="$@"
+else
+	PERF_OPTS="-t 10 -s 1024"
+fi
+
+DTND=${DTND:-dtnd}
+DTNPERF=${DTNPERF:-dtnperf}
+
+WORKDIR=`mktemp -d /tmp/dtnperf.XXXXXX`
+
+# generate a configuration for each node
+# $1 = name, $2 = own port, $3 = peer name, $4 = peer port
+genconfig() {
+	cat > ${WORKDIR}/${1}.conf << EOC
+local_uri = dtn://${1}.perf
+api_socket = ${WORKDIR}/${1}.sock
+discovery_announce = 0
+net_interfaces = lo0
+net_lo0_type = ${PROTO}
+net_lo0_interface = lo
+net_lo0_port = ${2}
+net_lo0_discovery = no
+static1_address = 127.0.0.1
+static1_port = ${4}
+static1_uri = dtn://${3}.perf
+static1_proto = ${PROTO}
+static1_immediately = yes
+EOC
+}
+
+genconfig a 4656 b 4657
+genconfig b 4657 a 4656
+
+${DTND} -c ${WORKDIR}/a.conf > ${WORKDIR}/a.log 2>&1 &
+PID_A=$!
+${DTND} -c ${WORKDIR}/b.conf > ${WORKDIR}/b.log 2>&1 &
+PID_B=$!
+
+# wait until both daemons are up
+sleep 3
+
+${DTNPERF} --server -U ${WORKDIR}/b.sock --format csv --output ${OUTPUT} perf &
+PID_SERVER=$!
+
+sleep 1
+
+${DTNPERF} -U ${WORKDIR}/a.sock ${PERF_OPTS} --format csv --output ${OUTPUT} dtn://b.perf/perf
+
+# give the server time to receive the remaining bundles
+sleep 5
+
+kill -INT ${PID_SERVER}
+wait ${PID_SERVER}
+
+kill ${PID_A} ${PID_B}
+wait ${PID_A} ${PID_B}
+
+rm -rf ${WORKDIR}
+
+echo "results written to ${OUTPUT}"
@@ -10,6 +10,10 @@
 #include <ibrcommon/net/vinterface.h>
 #include <ibrcommon/Logger.h>
 
+#ifdef WITH_BUNDLE_SECURITY
+#include <ibrdtn/security/ChunkedPayloadCipher.h>
+#endif
+
 #include <getopt.h>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
@@ -80,14 +84,14 @@ namespace dtn
 		 : _quiet(false), _options(0), _timestamps(false) {};
 
 		Configuration::Network::Network()
-		 : _routing("default"), _forwarding(true), _tcp_nodelay(true), _tcp_chunksize(4096), _default_net("lo"), _use_default_net(false), _auto_connect(0) {};
+		 : _routing("default"), _forwarding(true), _tcp_nodelay(true), _tcp_chunksize(4096), _tcp_send_cache(0), _tcp_send_cache_linger(5), _routing_bundles(4096), _default_net("lo"), _use_default_net(false), _auto_connect(0) {};
 
 		Configuration::Security::Security()
 		 : _enabled(false), _tlsEnabled(false), _tlsRequired(false)
 		{};
 
 		Configuration::Daemon::Daemon()
-		 : _daemonize(false), _kill(false), _threads(0)
+		 : _daemonize(false), _kill(false), _threads(0), _receive_lanes(0), _receive_queue(50), _trace_sampling(0), _trace_buffer(65536)
 		{};
 
 		Configuration::TimeSync::TimeSync()
@@ -292,6 +296,21 @@ namespace dtn
 			load(_filename);
 		}
 
+		const std::list<dtn::routing::StaticRoutingExtension::StaticRoute> Configuration::readStaticRoutes() const
+		{
+			std::list<dtn::routing::StaticRoutingExtension::StaticRoute> routes;
+
+			try {
+				const ibrcommon::ConfigFile conf(_filename);
+				Configuration::Network::loadStaticRoutes(conf, routes);
+			} catch (const ibrcommon::ConfigFile::file_not_found&) {
+				// keep the routes loaded on startup
+				return _network.getStaticRoutes();
+			}
+
+			return routes;
+		}
+
 		void Configuration::load(string filename)
 		{
 			try {
@@ -315,6 +334,7 @@ namespace dtn
 			_logger.load(_conf);
 			_network.load(_conf);
 			_security.load(_conf);
+			_daemon.load(_conf);
 			_timesync.load(_conf);
 		}
 
@@ -339,8 +359,12 @@ namespace dtn
 		{
 		}
 
-		void Configuration::Daemon::load(const ibrcommon::ConfigFile&)
+		void Configuration::Daemon::load(const ibrcommon::ConfigFile &conf)
 		{
+			_receive_lanes = conf.read<size_t>("receive_lanes", 0);
+			_receive_queue = conf.read<size_t>("receive_queue", 50);
+			_trace_sampling = conf.read<size_t>("trace_sampling", 0);
+			_trace_buffer = conf.read<size_t>("trace_buffer", 65536);
 		}
 
 		void Configuration::TimeSync::load(const ibrcommon::ConfigFile &conf)
@@ -466,24 +490,33 @@ namespace dtn
 			return _conf.read<std::string>("storage", "default");
 		}
 
-		void Configuration::Network::load(const ibrcommon::ConfigFile &conf)
+		size_t Configuration::getStorageReaders() const
 		{
-			/**
-			 * Load static routes
-			 */
-			_static_routes.clear();
+			return _conf.read<size_t>("storage_readers", 0);
+		}
 
+		void Configuration::Network::loadStaticRoutes(const ibrcommon::ConfigFile &conf, std::list<dtn::routing::StaticRoutingExtension::StaticRoute> &routes)
+		{
 			string key = "route1";
 			unsigned int keynumber = 1;
 
 			while (conf.keyExists( key ))
 			{
 				vector<string> route = dtn::utils::Utils::tokenize(" ", conf.read<string>(key, "dtn:none dtn:none"));
-				_static_routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute( route.front(), route.back() ) );
+				routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute( route.front(), route.back() ) );
 
 				keynumber++;
 				stringstream ss; ss << "route" << keynumber; ss >> key;
 			}
+		}
+
+		void Configuration::Network::load(const ibrcommon::ConfigFile &conf)
+		{
+			/**
+			 * Load static routes
+			 */
+			_static_routes.clear();
+			loadStaticRoutes(conf, _static_routes);
 
 			/**
 			 * load static nodes
@@ -557,6 +590,12 @@ namespace dtn
 			 */
 			_forwarding = (conf.read<std::string>("routing_forwarding", "yes") == "yes");
 
+			/**
+			 * expected number of known bundles, sizes the summary vectors
+			 */
+			_routing_bundles = conf.read<size_t>("routing_bundles", 4096);
+			if (_routing_bundles == 0) _routing_bundles = 4096;
+
 			/**
 			 * get network interfaces
 			 */
@@ -647,6 +686,8 @@ namespace dtn
 			_tcp_nodelay = (conf.read<std::string>("tcp_nodelay", "yes") == "yes");
 			_tcp_chunksize = conf.read<unsigned int>("tcp_chunksize", 4096);
 			_tcp_idle_timeout = conf.read<unsigned int>("tcp_idle_timeout", 0);
+			_tcp_send_cache = conf.read<size_t>("tcp_send_cache", 0);
+			_tcp_send_cache_linger = conf.read<size_t>("tcp_send_cache_linger", 5);
 
 			/**
 			 * dynamic rebind
@@ -762,6 +803,11 @@ namespace dtn
 			return _forwarding;
 		}
 
+		size_t Configuration::Network::getRoutingBundles() const
+		{
+			return _routing_bundles;
+		}
+
 		bool Configuration::Network::getTCPOptionNoDelay() const
 		{
 			return _tcp_nodelay;
@@ -777,6 +823,16 @@ namespace dtn
 			return _tcp_idle_timeout;
 		}
 
+		size_t Configuration::Network::getTCPSendCacheLimit() const
+		{
+			return _tcp_send_cache;
+		}
+
+		size_t Configuration::Network::getTCPSendCacheLinger() const
+		{
+			return _tcp_send_cache_linger;
+		}
+
 		bool Configuration::Network::doDynamicRebind() const
 		{
 			return _dynamic_rebind;
@@ -823,7 +879,18 @@ namespace dtn
 
 		size_t Configuration::getLimit(std::string suffix)
 		{
-			std::string unparsed = _conf.read<std::string>("limit_" + suffix, "0");
+			return getLimit(suffix, 0);
+		}
+
+		size_t Configuration::getLimit(std::string suffix, const size_t def)
+		{
+			std::string unparsed;
+
+			try {
+				unparsed = _conf.read<std::string>("limit_" + suffix);
+			} catch (const ibrcommon::ConfigFile::key_not_found&) {
+				return def;
+			}
 
 			std::stringstream ss(unparsed);
 
@@ -913,6 +980,21 @@ namespace dtn
 #endif
 
 #ifdef WITH_BUNDLE_SECURITY
+			// chunked encryption of large payloads
+			_chunk_size = conf.read<size_t>("security_chunk_size", 0);
+
+			if ((_chunk_size > 0) && (_chunk_size < dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE))
+			{
+				IBRCOMMON_LOGGER(warning) << "security_chunk_size is too small, using " << dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE << " bytes" << IBRCOMMON_LOGGER_ENDL;
+				_chunk_size = dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE;
+			}
+			else if (_chunk_size > dtn::security::ChunkedPayloadCipher::MAX_CHUNK_SIZE)
+			{
+				IBRCOMMON_LOGGER(warning) << "security_chunk_size is too large, using " << dtn::security::ChunkedPayloadCipher::MAX_CHUNK_SIZE << " bytes" << IBRCOMMON_LOGGER_ENDL;
+				_chunk_size = dtn::security::ChunkedPayloadCipher::MAX_CHUNK_SIZE;
+			}
+			_chunk_threads = conf.read<size_t>("security_chunk_threads", 0);
+
 			// enable security if the security path is set
 			try {
 				_path = conf.read<std::string>("security_path");
@@ -1001,6 +1083,16 @@ namespace dtn
 		{
 			return _bab_default_key;
 		}
+
+		size_t Configuration::Security::getChunkSize() const
+		{
+			return _chunk_size;
+		}
+
+		size_t Configuration::Security::getChunkThreads() const
+		{
+			return _chunk_threads;
+		}
 #endif
 #if defined WITH_BUNDLE_SECURITY || defined WITH_TLS
 		const ibrcommon::File& Configuration::Security::getCA() const
@@ -1066,6 +1158,26 @@ namespace dtn
 			return _threads;
 		}
 
+		size_t Configuration::Daemon::getReceiveLanes() const
+		{
+			return _receive_lanes;
+		}
+
+		size_t Configuration::Daemon::getReceiveQueueLimit() const
+		{
+			return _receive_queue;
+		}
+
+		size_t Configuration::Daemon::getTraceSampling() const
+		{
+			return _trace_sampling;
+		}
+
+		size_t Configuration::Daemon::getTraceBufferSize() const
+		{
+			return _trace_buffer;
+		}
+
 		const ibrcommon::File& Configuration::Daemon::getPidFile() const
 		{
 			if (_pidfile == ibrcommon::File()) throw ParameterNotSetException();
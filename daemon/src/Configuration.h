@@ -74,6 +74,13 @@ namespace dtn
 			void load();
 			void load(string filename);
 
+			/**
+			 * Read the static routes from the configuration file again. The
+			 * loaded configuration is not modified.
+			 * @return All static routes defined in the configuration file.
+			 */
+			const std::list<dtn::routing::StaticRoutingExtension::StaticRoute> readStaticRoutes() const;
+
 			void params(int argc, char *argv[]);
 
 			/**
@@ -149,6 +156,12 @@ namespace dtn
 			 */
 			std::string getStorage() const;
 
+			/**
+			 * Get the number of read-only connections of the sqlite storage.
+			 * @return Zero, if all queries should use the main connection.
+			 */
+			size_t getStorageReaders() const;
+
 			enum RoutingExtension
 			{
 				DEFAULT_ROUTING = 0,
@@ -163,6 +176,13 @@ namespace dtn
 			 */
 			size_t getLimit(std::string);
 
+			/**
+			 * Returns a limit like getLimit(std::string), but the given default
+			 * if the limit is not set. Thus an explicit zero is returned as it is.
+			 * @return A limit in bytes.
+			 */
+			size_t getLimit(std::string suffix, const size_t def);
+
 			class Extension
 			{
 			protected:
@@ -316,6 +336,8 @@ namespace dtn
 				virtual ~Network();
 				void load(const ibrcommon::ConfigFile &conf);
 
+				static void loadStaticRoutes(const ibrcommon::ConfigFile &conf, std::list<dtn::routing::StaticRoutingExtension::StaticRoute> &routes);
+
 				std::list<dtn::routing::StaticRoutingExtension::StaticRoute> _static_routes;
 				std::list<Node> _nodes;
 				std::list<NetConfig> _interfaces;
@@ -324,6 +346,9 @@ namespace dtn
 				bool _tcp_nodelay;
 				size_t _tcp_chunksize;
 				size_t _tcp_idle_timeout;
+				size_t _tcp_send_cache;
+				size_t _tcp_send_cache_linger;
+				size_t _routing_bundles;
 				ibrcommon::vinterface _default_net;
 				bool _use_default_net;
 				bool _dynamic_rebind;
@@ -356,6 +381,11 @@ namespace dtn
 				 */
 				bool doForwarding() const;
 
+				/**
+				 * @return The expected number of bundles known at the same time.
+				 */
+				size_t getRoutingBundles() const;
+
 				/**
 				 * @return True, is tcp options NODELAY should be set.
 				 */
@@ -371,6 +401,16 @@ namespace dtn
 				 */
 				size_t getTCPIdleTimeout() const;
 
+				/**
+				 * @return The maximum bytes of serialized bundles shared between TCP connections. Zero disables the cache.
+				 */
+				size_t getTCPSendCacheLimit() const;
+
+				/**
+				 * @return Seconds to keep a serialized bundle after its last transmission.
+				 */
+				size_t getTCPSendCacheLinger() const;
+
 				/**
 				 * @return True, if the dynamic rebind feature is requested.
 				 */
@@ -428,10 +468,23 @@ namespace dtn
 
 				const ibrcommon::File& getBABDefaultKey() const;
 
+				/**
+				 * Payloads larger than this size are encrypted in chunks of this size.
+				 * @return The chunk size in bytes, 0 if chunked encryption is disabled.
+				 */
+				size_t getChunkSize() const;
+
+				/**
+				 * @return The number of threads for chunked encryption, 0 for one per CPU.
+				 */
+				size_t getChunkThreads() const;
+
 			private:
 				ibrcommon::File _path;
 				Level _level;
 				ibrcommon::File _bab_default_key;
+				size_t _chunk_size;
+				size_t _chunk_threads;
 #endif
 #if defined WITH_BUNDLE_SECURITY || defined WITH_TLS
 			public:
@@ -470,6 +523,10 @@ namespace dtn
 				ibrcommon::File _pidfile;
 				bool _kill;
 				size_t _threads;
+				size_t _receive_lanes;
+				size_t _receive_queue;
+				size_t _trace_sampling;
+				size_t _trace_buffer;
 
 			protected:
 				Daemon();
@@ -481,6 +538,26 @@ namespace dtn
 				const ibrcommon::File& getPidFile() const;
 				bool kill_daemon() const;
 				size_t getThreads() const;
+
+				/**
+				 * @return The number of parallel lanes in the receive pipeline. Zero disables the pipeline.
+				 */
+				size_t getReceiveLanes() const;
+
+				/**
+				 * @return The maximum number of bundles queued in each lane of the receive pipeline.
+				 */
+				size_t getReceiveQueueLimit() const;
+
+				/**
+				 * @return Trace one of each n bundles through the daemon. Zero disables tracing.
+				 */
+				size_t getTraceSampling() const;
+
+				/**
+				 * @return The number of stage records kept for tracing.
+				 */
+				size_t getTraceBufferSize() const;
 			};
 
 			class TimeSync : public Configuration::Extension
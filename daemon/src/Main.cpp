@@ -11,9 +11,12 @@
 
 #include "core/BundleCore.h"
 #include "core/EventSwitch.h"
+#include "core/ReceivePipeline.h"
+#include "core/Tracer.h"
 #include "core/BundleStorage.h"
 #include "core/MemoryBundleStorage.h"
 #include "core/SimpleBundleStorage.h"
+#include "core/CachedBundleStorage.h"
 
 #include "core/Node.h"
 #include "core/EventSwitch.h"
@@ -30,6 +33,7 @@
 
 #include "net/UDPConvergenceLayer.h"
 #include "net/TCPConvergenceLayer.h"
+#include "net/SerializedBundleCache.h"
 #include "net/FileConvergenceLayer.h"
 #include "net/DatagramConvergenceLayer.h"
 #include "net/UDPDatagramService.h"
@@ -63,6 +67,7 @@
 #ifdef WITH_BUNDLE_SECURITY
 #include "security/SecurityManager.h"
 #include "security/SecurityKeyManager.h"
+#include <ibrdtn/security/PayloadConfidentialBlock.h>
 #endif
 
 #ifdef WITH_TLS
@@ -264,7 +269,11 @@ void createBundleStorage(BundleCore &core, Configuration &conf, std::list< dtn::
 
 			IBRCOMMON_LOGGER(info) << "using sqlite bundle storage in " << path.getPath() << IBRCOMMON_LOGGER_ENDL;
 
-			dtn::core::SQLiteBundleStorage *sbs = new dtn::core::SQLiteBundleStorage(path, conf.getLimit("storage") );
+			dtn::core::SQLiteBundleStorage *sbs = new dtn::core::SQLiteBundleStorage(path, conf.getLimit("storage"), conf.getStorageReaders() );
+
+			// blocks up to these sizes are stored in the database instead of files
+			sbs->setBlockLimits(conf.getLimit("storage_inline", dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT),
+					conf.getLimit("storage_blob", dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT));
 
 			// use sqlite storage as BLOB provider, auto delete off
 			ibrcommon::BLOB::changeProvider(sbs, false);
@@ -319,6 +328,17 @@ void createBundleStorage(BundleCore &core, Configuration &conf, std::list< dtn::
 		exit(-1);
 	}
 
+	// keep recently used bundles in memory in front of the storage
+	const size_t cache_limit = conf.getLimit("storage_cache");
+	if (cache_limit > 0)
+	{
+		IBRCOMMON_LOGGER(info) << "caching up to " << cache_limit << " bytes of bundles in memory" << IBRCOMMON_LOGGER_ENDL;
+
+		dtn::core::CachedBundleStorage *cache = new dtn::core::CachedBundleStorage(*storage, cache_limit);
+		components.push_back(cache);
+		storage = cache;
+	}
+
 	// set the storage in the core
 	core.setStorage(storage);
 }
@@ -550,6 +570,10 @@ int __daemon_run(Configuration &conf)
 	{
 		// initialize the key manager for the security extensions
 		dtn::security::SecurityKeyManager::getInstance().initialize( sec.getPath(), sec.getCA(), sec.getKey() );
+
+		// encrypt large payloads in chunks using several threads
+		dtn::security::PayloadConfidentialBlock::chunk_size = sec.getChunkSize();
+		dtn::security::PayloadConfidentialBlock::chunk_threads = sec.getChunkThreads();
 	}
 #endif
 
@@ -622,7 +646,7 @@ int __daemon_run(Configuration &conf)
 	}
 
 	// create the base router
-	dtn::routing::BaseRouter *router = new dtn::routing::BaseRouter(core.getStorage());
+	dtn::routing::BaseRouter *router = new dtn::routing::BaseRouter(core.getStorage(), conf.getNetwork().getRoutingBundles());
 
 	// make the router globally available
 	core.setRouter(router);
@@ -754,6 +778,10 @@ int __daemon_run(Configuration &conf)
 			{
 				components.push_back( new StatisticLogger( dtn::daemon::StatisticLogger::LOGGER_UDP, conf.getStatistic().interval(), conf.getStatistic().address(), conf.getStatistic().port() ) );
 			}
+			else if (conf.getStatistic().type() == "prometheus")
+			{
+				components.push_back( new StatisticLogger( dtn::daemon::StatisticLogger::LOGGER_FILE_PROMETHEUS, conf.getStatistic().interval(), conf.getStatistic().logfile() ) );
+			}
 		} catch (const Configuration::ParameterNotSetException&) {
 			IBRCOMMON_LOGGER(error) << "StatisticLogger: Parameter statistic_file is not set! Fallback to stdout logging." << IBRCOMMON_LOGGER_ENDL;
 			components.push_back( new StatisticLogger( dtn::daemon::StatisticLogger::LOGGER_STDOUT, conf.getStatistic().interval() ) );
@@ -766,6 +794,19 @@ int __daemon_run(Configuration &conf)
 	// initialize the event switch
 	esw.initialize();
 
+	// initialize the receive pipeline
+	dtn::core::ReceivePipeline &pipeline = dtn::core::ReceivePipeline::getInstance();
+	pipeline.setup(conf.getDaemon().getReceiveLanes(), conf.getDaemon().getReceiveQueueLimit());
+	pipeline.initialize();
+
+	// set up the tracing of bundles through the daemon
+	dtn::core::Tracer::getInstance().setup(conf.getDaemon().getTraceSampling(), conf.getDaemon().getTraceBufferSize());
+
+	// set up the cache of serialized bundles shared by all TCP connections
+	dtn::net::SerializedBundleCache &sendcache = dtn::net::SerializedBundleCache::getInstance();
+	sendcache.setup(conf.getNetwork().getTCPSendCacheLimit(), conf.getNetwork().getTCPSendCacheLinger());
+	sendcache.initialize();
+
 	/**
 	 * initialize all components!
 	 */
@@ -835,6 +876,12 @@ int __daemon_run(Configuration &conf)
 	// send shutdown signal to unbound threads
 	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
 
+	// stop the receive pipeline and release blocked receivers
+	pipeline.terminate();
+
+	// stop dropping deleted bundles out of the send cache
+	sendcache.terminate();
+
 	/**
 	 * terminate all components!
 	 */
@@ -8,11 +8,13 @@
 #include "StatisticLogger.h"
 #include "core/NodeEvent.h"
 #include "core/BundleEvent.h"
+#include "core/Metrics.h"
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
 #include <sstream>
 #include <typeinfo>
 #include <ctime>
+#include <cstdio>
 
 namespace dtn
 {
@@ -95,6 +97,10 @@ namespace dtn
 				writeStatLog();
 				break;
 
+			case LOGGER_FILE_PROMETHEUS:
+				writePrometheusLog();
+				break;
+
 			case LOGGER_UDP:
 				writeUDPLog(*_sock);
 				break;
@@ -250,6 +256,22 @@ namespace dtn
 			_fileout.close();
 		}
 
+		void StatisticLogger::writePrometheusLog()
+		{
+			// write into a temporary file and replace the old one, thus a
+			// collector never reads a partially written file
+			const std::string tmpfile = _file.getPath() + ".tmp";
+
+			_fileout.open(tmpfile.c_str(), ios_base::trunc);
+			dtn::core::Metrics::getInstance().write(_fileout);
+			_fileout.close();
+
+			if (::rename(tmpfile.c_str(), _file.getPath().c_str()) != 0)
+			{
+				IBRCOMMON_LOGGER(warning) << "can not write metrics to " << _file.getPath() << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
 		void StatisticLogger::writeUDPLog(ibrcommon::UnicastSocket &socket)
 		{
 			std::stringstream ss;
@@ -11,6 +11,8 @@
  *  - Sent Bundles
  *  - Bundles in Storage
  *
+ * The prometheus type exports the metrics of dtn::core::Metrics instead.
+ *
  * This data is logged into a file. The format for this file
  * can specified with the "format"-variable.
  *
@@ -45,7 +47,8 @@ namespace dtn
 				LOGGER_UDP = 2,			// Statistically datagrams are sent to a specified address and port. Each interval or if the values are changing.
 				LOGGER_FILE_PLAIN = 10,	// All output is machine readable only and appended into a file.
 				LOGGER_FILE_CSV = 11,	// All output is machine readable only and appended into a csv file.
-				LOGGER_FILE_STAT = 12	// All output is machine readable only and directed into a stat file. This file contains only one dataset.
+				LOGGER_FILE_STAT = 12,	// All output is machine readable only and directed into a stat file. This file contains only one dataset.
+				LOGGER_FILE_PROMETHEUS = 13	// All metrics are written in the Prometheus text format into a file. This file contains only one dataset.
 			};
 
 			StatisticLogger(LoggerType type, unsigned int interval, std::string address = "127.0.0.1", unsigned int port = 1234);
@@ -69,6 +72,7 @@ namespace dtn
 			void writePlainLog(std::ostream &stream);
 			void writeCsvLog(std::ostream &stream);
 			void writeStatLog();
+			void writePrometheusLog();
 
 			void writeUDPLog(ibrcommon::UnicastSocket &socket);
 
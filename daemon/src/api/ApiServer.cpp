@@ -159,6 +159,22 @@ namespace dtn
 #endif
 
 #ifdef WITH_BUNDLE_SECURITY
+			// if both bits are set, encrypt and sign the bundle within one pass over the payload
+			if (bundle.get(dtn::data::PrimaryBlock::DTNSEC_REQUEST_ENCRYPT) && bundle.get(dtn::data::PrimaryBlock::DTNSEC_REQUEST_SIGN))
+			{
+				try {
+					dtn::security::SecurityManager::getInstance().encryptAndSign(bundle);
+
+					bundle.set(dtn::data::PrimaryBlock::DTNSEC_REQUEST_ENCRYPT, false);
+					bundle.set(dtn::data::PrimaryBlock::DTNSEC_REQUEST_SIGN, false);
+				} catch (const dtn::security::SecurityManager::KeyMissingException&) {
+					// one of the keys is missing, try the steps separately
+				} catch (const dtn::security::SecurityManager::EncryptException&) {
+					IBRCOMMON_LOGGER(warning) << "Encryption of bundle failed." << IBRCOMMON_LOGGER_ENDL;
+					bundle.set(dtn::data::PrimaryBlock::DTNSEC_REQUEST_ENCRYPT, false);
+				}
+			}
+
 			// if the encrypt bit is set, then try to encrypt the bundle
 			if (bundle.get(dtn::data::PrimaryBlock::DTNSEC_REQUEST_ENCRYPT))
 			{
@@ -17,7 +17,7 @@ namespace dtn
 	{
 		BundleStreamBuf::BundleStreamBuf(BundleStreamBufCallback &callback, size_t chunk_size, bool wait_seq_zero)
 		 : _callback(callback), _in_buf(new char[BUFF_SIZE]), _out_buf(new char[BUFF_SIZE]),
-		   _chunk_size(chunk_size), _chunk_payload(ibrcommon::BLOB::create()), _chunk_offset(0), _in_seq(0),
+		   _chunk_size(chunk_size), _chunk_payload(ibrcommon::BLOB::create()), _chunk_offset(0), _chunks_size(0), _chunks_limit(0), _in_seq(0),
 		   _out_seq(0), _streaming(wait_seq_zero), _first_chunk(true), _last_chunk_received(false), _timeout_receive(0)
 		{
 			// Initialize get pointer.  This should be zero so that underflow is called upon first read.
@@ -115,6 +115,29 @@ namespace dtn
 			_timeout_receive = timeout;
 		}
 
+		void BundleStreamBuf::setBufferLimit(size_t limit)
+		{
+			_chunks_limit = limit;
+		}
+
+		void BundleStreamBuf::queue(const Chunk &c)
+		{
+			if (c._seq < _in_seq) return;
+
+			IBRCOMMON_LOGGER_DEBUG(40) << "BundleStreamBuf::underflow(): bundle accepted, seq. no. " << c._seq << IBRCOMMON_LOGGER_ENDL;
+
+			if (_chunks.insert(c).second)
+			{
+				_chunks_size += c._size;
+			}
+		}
+
+		void BundleStreamBuf::dequeue(const Chunk &c)
+		{
+			_chunks_size -= c._size;
+			_chunks.erase(c);
+		}
+
 		void BundleStreamBuf::append(ibrcommon::BLOB::Reference &ref, const char* data, size_t length)
 		{
 			ibrcommon::BLOB::iostream stream = ref.iostream();
@@ -138,14 +161,8 @@ namespace dtn
 
 				IBRCOMMON_LOGGER_DEBUG(40) << "BundleStreamBuf::underflow(): bundle received" << IBRCOMMON_LOGGER_ENDL;
 
-				// create a chunk object
-				Chunk c(b);
-
-				if (c._seq >= _in_seq)
-				{
-					IBRCOMMON_LOGGER_DEBUG(40) << "BundleStreamBuf::underflow(): bundle accepted, seq. no. " << c._seq << IBRCOMMON_LOGGER_ENDL;
-					_chunks.insert(c);
-				}
+				// put the chunk into the reorder buffer
+				queue(Chunk(b));
 			}
 
 			ibrcommon::TimeMeasurement tm;
@@ -159,20 +176,18 @@ namespace dtn
 					dtn::data::MetaBundle b = _callback.get(_timeout_receive);
 					IBRCOMMON_LOGGER_DEBUG(40) << "BundleStreamBuf::underflow(): bundle received" << IBRCOMMON_LOGGER_ENDL;
 
-					// create a chunk object
-					Chunk c(b);
-
-					if (c._seq >= _in_seq)
-					{
-						IBRCOMMON_LOGGER_DEBUG(40) << "BundleStreamBuf::underflow(): bundle accepted, seq. no. " << c._seq << IBRCOMMON_LOGGER_ENDL;
-						_chunks.insert(c);
-					}
+					// put the chunk into the reorder buffer
+					queue(Chunk(b));
 				} catch (std::exception&) {
 					// timed out
 				}
 
 				tm.stop();
-				if (((_timeout_receive > 0) && (tm.getSeconds() > _timeout_receive)) || !_streaming)
+
+				// the reorder buffer is exhausted, do not wait for the missing chunks
+				bool overrun = ((_chunks_limit > 0) && (_chunks_size > _chunks_limit));
+
+				if (((_timeout_receive > 0) && (tm.getSeconds() > _timeout_receive)) || !_streaming || overrun)
 				{
 					// skip the missing bundles and proceed with the last received one
 					_in_seq = (*_chunks.begin())._seq;
@@ -236,7 +251,7 @@ namespace dtn
 				_callback.delivered(c._meta);
 
 				// delete the last chunk
-				_chunks.erase(c);
+				dequeue(c);
 
 				// reset the chunk offset
 				_chunk_offset = 0;
@@ -264,7 +279,7 @@ namespace dtn
 		}
 
 		BundleStreamBuf::Chunk::Chunk(const dtn::data::MetaBundle &m)
-		 : _meta(m), _seq(0), _first(false), _last(false)
+		 : _meta(m), _seq(0), _size(0), _first(false), _last(false)
 		{
 			dtn::core::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
 			dtn::data::Bundle bundle = storage.get(_meta);
@@ -275,6 +290,11 @@ namespace dtn
 				_first = block.get(dtn::data::StreamBlock::STREAM_BEGIN);
 				_last = block.get(dtn::data::StreamBlock::STREAM_END);
 			} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { }
+
+			try {
+				const dtn::data::PayloadBlock &payload = bundle.getBlock<dtn::data::PayloadBlock>();
+				_size = payload.getLength();
+			} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { }
 		}
 
 		BundleStreamBuf::Chunk::~Chunk()
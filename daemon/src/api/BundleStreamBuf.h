@@ -37,6 +37,13 @@ namespace dtn
 			void setChunkSize(size_t size);
 			void setTimeout(size_t timeout);
 
+			/**
+			 * Limit the number of payload bytes held in the reorder buffer. If the
+			 * limit is exceeded while a chunk is missing, the missing chunks are skipped.
+			 * @param limit The limit in bytes, zero disables the limit.
+			 */
+			void setBufferLimit(size_t limit);
+
 		protected:
 			virtual int sync();
 			virtual int overflow(int = std::char_traits<char>::eof());
@@ -56,12 +63,23 @@ namespace dtn
 
 				dtn::data::MetaBundle _meta;
 				size_t _seq;
+				size_t _size;
 				bool _first;
 				bool _last;
 			};
 
 			void flushPayload(bool final = false);
 
+			/**
+			 * Put a received chunk into the reorder buffer.
+			 */
+			void queue(const Chunk &c);
+
+			/**
+			 * Remove a consumed chunk from the reorder buffer.
+			 */
+			void dequeue(const Chunk &c);
+
 			static void append(ibrcommon::BLOB::Reference &ref, const char* data, size_t length);
 
 			BundleStreamBufCallback &_callback;
@@ -78,6 +96,10 @@ namespace dtn
 			std::set<Chunk> _chunks;
 			size_t _chunk_offset;
 
+			// number of payload bytes held in the reorder buffer
+			size_t _chunks_size;
+			size_t _chunks_limit;
+
 			dtn::data::Bundle _current_bundle;
 
 			size_t _in_seq;
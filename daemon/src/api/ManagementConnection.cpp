@@ -10,11 +10,14 @@
 #include "ManagementConnection.h"
 #include "core/BundleCore.h"
 #include "core/GlobalEvent.h"
+#include "core/Metrics.h"
+#include "core/Tracer.h"
 
 #include <ibrdtn/utils/Utils.h>
 
 #include <ibrcommon/Logger.h>
 #include <ibrcommon/net/LinkManager.h>
+#include <sstream>
 
 namespace dtn
 {
@@ -251,6 +254,52 @@ namespace dtn
 						_stream << ClientHandler::API_STATUS_OK << " WAKEUP" << std::endl;
 					}
 				}
+				else if (cmd[0] == "metrics")
+				{
+					_stream << ClientHandler::API_STATUS_OK << " METRICS" << std::endl;
+
+					// the exposition format contains no empty lines
+					dtn::core::Metrics::getInstance().write(_stream);
+
+					// last line empty
+					_stream << std::endl;
+				}
+				else if (cmd[0] == "trace")
+				{
+					dtn::core::Tracer &tracer = dtn::core::Tracer::getInstance();
+
+					if (cmd.size() == 1)
+					{
+						_stream << ClientHandler::API_STATUS_OK << " TRACE" << std::endl;
+
+						// the trace contains no empty lines
+						tracer.write(_stream);
+
+						// last line empty
+						_stream << std::endl;
+					}
+					else if (cmd[1] == "sample")
+					{
+						if (cmd.size() < 3) throw ibrcommon::Exception("not enough parameters");
+
+						size_t sampling = 0;
+						std::stringstream ss(cmd[2]);
+						ss >> sampling;
+						if (ss.fail()) throw ibrcommon::Exception("invalid sampling interval");
+
+						tracer.setSampling(sampling);
+						_stream << ClientHandler::API_STATUS_OK << " TRACE SAMPLING " << sampling << std::endl;
+					}
+					else if (cmd[1] == "clear")
+					{
+						tracer.clear();
+						_stream << ClientHandler::API_STATUS_OK << " TRACE CLEARED" << std::endl;
+					}
+					else
+					{
+						_stream << ClientHandler::API_STATUS_BAD_REQUEST << " UNKNOWN COMMAND" << std::endl;
+					}
+				}
 				else if (cmd[0] == "bundle")
 				{
 					if (cmd[1] == "list")
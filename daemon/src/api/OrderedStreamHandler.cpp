@@ -203,6 +203,14 @@ namespace dtn
 							_streambuf.setTimeout(timeout);
 							_stream << ClientHandler::API_STATUS_OK << " TIMEOUT CHANGED" << std::endl;
 						}
+						else if (cmd[1] == "buffer")
+						{
+							size_t limit = 0;
+							std::stringstream ss(cmd[2]);
+							ss >> limit;
+							_streambuf.setBufferLimit(limit);
+							_stream << ClientHandler::API_STATUS_OK << " BUFFER CHANGED" << std::endl;
+						}
 						else
 						{
 							_stream << ClientHandler::API_STATUS_BAD_REQUEST << " UNKNOWN COMMAND" << std::endl;
@@ -2,7 +2,9 @@
 #include "core/BundleCore.h"
 #include "core/GlobalEvent.h"
 #include "core/BundleEvent.h"
+#include "core/Tracer.h"
 #include "net/TransferAbortedEvent.h"
+#include "net/SerializedBundleCache.h"
 #include "routing/RequeueBundleEvent.h"
 #include "routing/QueueBundleEvent.h"
 
@@ -123,6 +125,8 @@ namespace dtn
 
 		void BundleCore::transferTo(const dtn::data::EID &destination, const dtn::data::BundleID &bundle)
 		{
+			dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_TRANSFER);
+
 			try {
 				_connectionmanager.queue(destination, bundle);
 			} catch (const dtn::net::NeighborNotAvailableException &ex) {
@@ -177,6 +181,9 @@ namespace dtn
 						dtn::data::BundleID id(custody._source, custody._bundle_timestamp.getValue(), custody._bundle_sequence.getValue(), (custody._fragment_length.getValue() > 0), custody._fragment_offset.getValue());
 						getStorage().releaseCustody(bundle._source, id);
 
+						// the stored bundle has been changed
+						dtn::net::SerializedBundleCache::getInstance().remove(id);
+
 						IBRCOMMON_LOGGER_DEBUG(5) << "custody released for " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
 
 						delivered = true;
@@ -320,6 +327,8 @@ namespace dtn
 					}
 				} catch (const std::bad_cast&) { }
 			}
+
+			dtn::core::Tracer::getInstance().record(b, dtn::core::Tracer::STAGE_VALIDATED);
 		}
 
 		const std::string BundleCore::getName() const
@@ -340,7 +349,7 @@ namespace dtn
 #ifdef WITH_BUNDLE_SECURITY
 					case dtn::security::PayloadConfidentialBlock::BLOCK_TYPE:
 					{
-						// try to decrypt the bundle
+						// try to decrypt the bundle, a signature addressed to this node is verified within the same pass
 						try {
 							dtn::security::SecurityManager::getInstance().decrypt(b);
 						} catch (const dtn::security::SecurityManager::KeyMissingException&) {
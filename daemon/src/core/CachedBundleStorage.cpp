@@ -0,0 +1,248 @@
+/*
+ * CachedBundleStorage.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "core/CachedBundleStorage.h"
+#include "core/BundleExpiredEvent.h"
+
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <sstream>
+
+namespace dtn
+{
+	namespace core
+	{
+		CachedBundleStorage::Entry::Entry(const dtn::data::BundleID &i)
+		 : id(i)
+		{
+		}
+
+		CachedBundleStorage::Entry::~Entry()
+		{
+		}
+
+		CachedBundleStorage::CachedBundleStorage(BundleStorage &storage, size_t limit)
+		 : _storage(storage), _limit(limit), _size(0), _generation(0),
+		   _hits(Metrics::getInstance().getCounter("dtnd_storage_cache_total", "Bundles requested from the bundle cache.", "result=\"hit\"")),
+		   _misses(Metrics::getInstance().getCounter("dtnd_storage_cache_total", "Bundles requested from the bundle cache.", "result=\"miss\"")),
+		   _evictions(Metrics::getInstance().getCounter("dtnd_storage_cache_evictions_total", "Bundles dropped out of the bundle cache to make room."))
+		{
+		}
+
+		CachedBundleStorage::~CachedBundleStorage()
+		{
+		}
+
+		void CachedBundleStorage::componentUp()
+		{
+			bindEvent(BundleExpiredEvent::className);
+		}
+
+		void CachedBundleStorage::componentDown()
+		{
+			unbindEvent(BundleExpiredEvent::className);
+		}
+
+		void CachedBundleStorage::raiseEvent(const Event *evt)
+		{
+			try {
+				const BundleExpiredEvent &expired = dynamic_cast<const BundleExpiredEvent&>(*evt);
+
+				ibrcommon::MutexLock l(_lock);
+				invalidate(expired._bundle);
+			} catch (const std::bad_cast&) { }
+		}
+
+		const std::string CachedBundleStorage::getName() const
+		{
+			return "CachedBundleStorage";
+		}
+
+		void CachedBundleStorage::store(const dtn::data::Bundle &bundle)
+		{
+			_storage.store(bundle);
+
+			// the storage may modify the bundle (e.g. accept custody), thus
+			// the bundle is cached once it is read back
+			ibrcommon::MutexLock l(_lock);
+			invalidate(bundle);
+		}
+
+		dtn::data::Bundle CachedBundleStorage::get(const dtn::data::BundleID &id)
+		{
+			size_t generation = 0;
+			std::string data;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				std::map<dtn::data::BundleID, std::list<Entry>::iterator>::iterator iter = _index.find(id);
+
+				if (iter != _index.end())
+				{
+					std::list<Entry>::iterator entry = (*iter).second;
+
+					// mark the bundle as recently used
+					_lru.splice(_lru.begin(), _lru, entry);
+					data = entry->data;
+				}
+
+				generation = _generation;
+			}
+
+			if (!data.empty())
+			{
+				// each caller gets blocks and a payload of its own
+				dtn::data::Bundle bundle;
+				std::istringstream stream(data);
+				dtn::data::DefaultDeserializer(stream) >> bundle;
+
+				if (!dtn::utils::Clock::isExpired(bundle))
+				{
+					_hits.add();
+					return bundle;
+				}
+
+				// the storage decides what to do with expired bundles
+				ibrcommon::MutexLock l(_lock);
+				invalidate(id);
+				generation = _generation;
+			}
+
+			_misses.add();
+
+			const dtn::data::Bundle bundle = _storage.get(id);
+			put(bundle, generation);
+
+			return bundle;
+		}
+
+		const std::list<dtn::data::MetaBundle> CachedBundleStorage::get(BundleFilterCallback &cb)
+		{
+			return _storage.get(cb);
+		}
+
+		const std::set<dtn::data::EID> CachedBundleStorage::getDistinctDestinations()
+		{
+			return _storage.getDistinctDestinations();
+		}
+
+		void CachedBundleStorage::remove(const dtn::data::BundleID &id)
+		{
+			try {
+				_storage.remove(id);
+			} catch (...) {
+				ibrcommon::MutexLock l(_lock);
+				invalidate(id);
+				throw;
+			}
+
+			ibrcommon::MutexLock l(_lock);
+			invalidate(id);
+		}
+
+		dtn::data::MetaBundle CachedBundleStorage::remove(const ibrcommon::BloomFilter &filter)
+		{
+			const dtn::data::MetaBundle meta = _storage.remove(filter);
+
+			ibrcommon::MutexLock l(_lock);
+			invalidate(meta);
+
+			return meta;
+		}
+
+		void CachedBundleStorage::clear()
+		{
+			_storage.clear();
+
+			ibrcommon::MutexLock l(_lock);
+			_lru.clear();
+			_index.clear();
+			_size = 0;
+			_generation++;
+		}
+
+		bool CachedBundleStorage::empty()
+		{
+			return _storage.empty();
+		}
+
+		unsigned int CachedBundleStorage::count()
+		{
+			return _storage.count();
+		}
+
+		void CachedBundleStorage::releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id)
+		{
+			_storage.releaseCustody(custodian, id);
+
+			// the storage may have changed the bundle
+			ibrcommon::MutexLock l(_lock);
+			invalidate(id);
+		}
+
+		size_t CachedBundleStorage::getSize() const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _size;
+		}
+
+		size_t CachedBundleStorage::getEntries() const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _index.size();
+		}
+
+		void CachedBundleStorage::put(const dtn::data::Bundle &bundle, const size_t generation)
+		{
+			std::stringstream stream;
+			dtn::data::DefaultSerializer(stream) << bundle;
+
+			// do not flush the whole cache for a single bundle
+			if (stream.tellp() > (std::streampos)_limit) return;
+
+			const dtn::data::BundleID id(bundle);
+
+			ibrcommon::MutexLock l(_lock);
+
+			// the bundle has been removed while it was loaded
+			if (generation != _generation) return;
+
+			// the bundle is already cached by a concurrent call
+			if (_index.find(id) != _index.end()) return;
+
+			const size_t length = stream.tellp();
+
+			// drop the least recently used bundles
+			while (!_lru.empty() && ((_size + length) > _limit))
+			{
+				const Entry &last = _lru.back();
+				_index.erase(last.id);
+				_size -= last.data.size();
+				_lru.pop_back();
+				_evictions.add();
+			}
+
+			_lru.push_front(Entry(id));
+			_lru.front().data = stream.str();
+			_index[id] = _lru.begin();
+			_size += length;
+		}
+
+		void CachedBundleStorage::invalidate(const dtn::data::BundleID &id)
+		{
+			// a bundle loaded concurrently must not be cached
+			_generation++;
+
+			std::map<dtn::data::BundleID, std::list<Entry>::iterator>::iterator iter = _index.find(id);
+			if (iter == _index.end()) return;
+
+			_size -= (*iter).second->data.size();
+			_lru.erase((*iter).second);
+			_index.erase(iter);
+		}
+	}
+}
@@ -0,0 +1,179 @@
+/*
+ * CachedBundleStorage.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef CACHEDBUNDLESTORAGE_H_
+#define CACHEDBUNDLESTORAGE_H_
+
+#include "Component.h"
+#include "core/BundleStorage.h"
+#include "core/EventReceiver.h"
+#include "core/Metrics.h"
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <list>
+#include <map>
+#include <string>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Keeps recently requested bundles in memory in front of another
+		 * storage. Bundles are often read several times shortly after they
+		 * are stored, e.g. to forward them to several neighbors or to deliver
+		 * them to a local registration. These reads are served without loading
+		 * the bundle out of the underlying storage again. A bundle is cached on
+		 * the first read and not on store, since the storage may modify a bundle
+		 * while it is stored (e.g. set itself as custodian).
+		 *
+		 * Copies of a bundle share their blocks and payload, thus the bundles
+		 * are cached in their serialized form and each read returns a bundle
+		 * of its own. A reader may decrypt or extend the returned bundle
+		 * without changing the cached one.
+		 *
+		 * The cache is limited by the serialized size of the bundles and drops
+		 * the least recently used bundles first. A bundle is dropped, if it is
+		 * removed through this storage or if it expires. All other methods are
+		 * forwarded to the underlying storage.
+		 */
+		class CachedBundleStorage : public BundleStorage, public EventReceiver, public dtn::daemon::IntegratedComponent
+		{
+		public:
+			/**
+			 * @param storage The underlying storage, it has to outlive this object.
+			 * @param limit Maximum bytes of all cached bundles.
+			 */
+			CachedBundleStorage(BundleStorage &storage, size_t limit);
+			virtual ~CachedBundleStorage();
+
+			/**
+			 * Stores a bundle in the underlying storage. A cached bundle
+			 * with the same ID is dropped.
+			 * @param bundle The bundle to store.
+			 */
+			virtual void store(const dtn::data::Bundle &bundle);
+
+			/**
+			 * Returns a bundle out of the cache or loads it from the
+			 * underlying storage.
+			 * @param id The ID of the bundle to return.
+			 * @return A bundle object.
+			 */
+			virtual dtn::data::Bundle get(const dtn::data::BundleID &id);
+
+			/**
+			 * @see BundleStorage::get(BundleFilterCallback &cb)
+			 */
+			virtual const std::list<dtn::data::MetaBundle> get(BundleFilterCallback &cb);
+
+			/**
+			 * @see BundleStorage::getDistinctDestinations()
+			 */
+			virtual const std::set<dtn::data::EID> getDistinctDestinations();
+
+			/**
+			 * @see BundleStorage::remove(const dtn::data::BundleID &id)
+			 */
+			virtual void remove(const dtn::data::BundleID &id);
+
+			/**
+			 * @see BundleStorage::remove(const ibrcommon::BloomFilter &filter)
+			 */
+			virtual dtn::data::MetaBundle remove(const ibrcommon::BloomFilter &filter);
+
+			/**
+			 * @sa BundleStorage::clear()
+			 */
+			virtual void clear();
+
+			/**
+			 * @sa BundleStorage::empty()
+			 */
+			virtual bool empty();
+
+			/**
+			 * @sa BundleStorage::count()
+			 */
+			virtual unsigned int count();
+
+			/**
+			 * @sa BundleStorage::releaseCustody();
+			 */
+			virtual void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
+
+			/**
+			 * Returns the bytes of all cached bundles.
+			 */
+			size_t getSize() const;
+
+			/**
+			 * Returns the number of cached bundles.
+			 */
+			size_t getEntries() const;
+
+			/**
+			 * This method is used to receive events.
+			 * @param evt
+			 */
+			void raiseEvent(const Event *evt);
+
+			/**
+			 * @see Component::getName()
+			 */
+			virtual const std::string getName() const;
+
+		protected:
+			virtual void componentUp();
+			virtual void componentDown();
+
+		private:
+			class Entry
+			{
+			public:
+				Entry(const dtn::data::BundleID &id);
+				~Entry();
+
+				dtn::data::BundleID id;
+
+				// the serialized bundle
+				std::string data;
+			};
+
+			/**
+			 * Put a bundle into the cache, unless a bundle has been removed
+			 * since the given generation.
+			 */
+			void put(const dtn::data::Bundle &bundle, const size_t generation);
+
+			/**
+			 * Drop a bundle out of the cache. The lock has to be held.
+			 */
+			void invalidate(const dtn::data::BundleID &id);
+
+			BundleStorage &_storage;
+			const size_t _limit;
+
+			mutable ibrcommon::Mutex _lock;
+
+			// the most recently used bundle first
+			std::list<Entry> _lru;
+			std::map<dtn::data::BundleID, std::list<Entry>::iterator> _index;
+			size_t _size;
+
+			// incremented on each removal, thus a bundle loaded before it is not cached
+			size_t _generation;
+
+			Metrics::Counter &_hits;
+			Metrics::Counter &_misses;
+			Metrics::Counter &_evictions;
+		};
+	}
+}
+
+#endif /* CACHEDBUNDLESTORAGE_H_ */
@@ -9,6 +9,7 @@
 
 #include <ibrcommon/thread/MutexLock.h>
 #include "core/GlobalEvent.h"
+#include "core/Metrics.h"
 #include <ibrcommon/Logger.h>
 #include <stdexcept>
 #include <iostream>
@@ -84,6 +85,9 @@ namespace dtn
 				_active_cond.signal(true);
 			}
 
+			Metrics &metrics = Metrics::getInstance();
+			metrics.event_wait.record(Metrics::now() - t->queued);
+
 			try {
 				// execute the event
 				t->receiver->raiseEvent(t->event);
@@ -284,12 +288,12 @@ namespace dtn
 		}
 
 		EventSwitch::Task::Task()
-		 : receiver(NULL), event(NULL)
+		 : receiver(NULL), event(NULL), queued(Metrics::now())
 		{
 		}
 
 		EventSwitch::Task::Task(EventReceiver *er, dtn::core::Event *evt)
-		 : receiver(er), event(evt)
+		 : receiver(er), event(evt), queued(Metrics::now())
 		{
 		}
 
@@ -68,6 +68,9 @@ namespace dtn
 
 				EventReceiver *receiver;
 				dtn::core::Event *event;
+
+				// time the task has been queued
+				u_int64_t queued;
 			};
 
 			class Worker : public ibrcommon::JoinableThread
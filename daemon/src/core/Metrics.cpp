@@ -0,0 +1,331 @@
+/*
+ * Metrics.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "core/Metrics.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Exceptions.h>
+#include <string.h>
+#include <time.h>
+#include <iomanip>
+
+namespace dtn
+{
+	namespace core
+	{
+		// shard of the current thread, assigned on the first update
+		static __thread size_t __shard = Metrics::SHARDS;
+		static size_t __next_shard = 0;
+
+		static size_t getShard()
+		{
+			if (__shard == Metrics::SHARDS)
+			{
+				__shard = __sync_fetch_and_add(&__next_shard, 1) % Metrics::SHARDS;
+			}
+			return __shard;
+		}
+
+		/**
+		 * Print a duration in microseconds as seconds.
+		 */
+		static void writeSeconds(std::ostream &stream, const u_int64_t value)
+		{
+			stream << (value / 1000000) << "." << std::setw(6) << std::setfill('0') << (value % 1000000) << std::setfill(' ');
+		}
+
+		Metrics::Counter::Counter()
+		{
+			::memset(_shards, 0, sizeof(_shards));
+		}
+
+		Metrics::Counter::~Counter()
+		{
+		}
+
+		void Metrics::Counter::add(u_int64_t value)
+		{
+			__sync_fetch_and_add(&_shards[getShard()].value, value);
+		}
+
+		u_int64_t Metrics::Counter::get() const
+		{
+			u_int64_t ret = 0;
+			for (size_t i = 0; i < SHARDS; i++) ret += _shards[i].value;
+			return ret;
+		}
+
+		Metrics::Histogram::Histogram()
+		{
+			::memset(_shards, 0, sizeof(_shards));
+		}
+
+		Metrics::Histogram::~Histogram()
+		{
+		}
+
+		void Metrics::Histogram::record(u_int64_t value)
+		{
+			Shard &s = _shards[getShard()];
+			__sync_fetch_and_add(&s.buckets[getBucket(value)], 1);
+			__sync_fetch_and_add(&s.sum, value);
+			__sync_fetch_and_add(&s.count, 1);
+		}
+
+		u_int64_t Metrics::Histogram::getCount() const
+		{
+			u_int64_t ret = 0;
+			for (size_t i = 0; i < SHARDS; i++) ret += _shards[i].count;
+			return ret;
+		}
+
+		u_int64_t Metrics::Histogram::getSum() const
+		{
+			u_int64_t ret = 0;
+			for (size_t i = 0; i < SHARDS; i++) ret += _shards[i].sum;
+			return ret;
+		}
+
+		u_int64_t Metrics::Histogram::getBucketCount(size_t bucket) const
+		{
+			u_int64_t ret = 0;
+			for (size_t i = 0; i < SHARDS; i++) ret += _shards[i].buckets[bucket];
+			return ret;
+		}
+
+		u_int64_t Metrics::Histogram::getPercentile(double percentile) const
+		{
+			u_int64_t counts[BUCKETS];
+			u_int64_t total = 0;
+
+			// take a snapshot, the shards may change while summing up
+			for (size_t b = 0; b < BUCKETS; b++)
+			{
+				counts[b] = getBucketCount(b);
+				total += counts[b];
+			}
+
+			if (total == 0) return 0;
+
+			// rank of the requested value, starting at one
+			u_int64_t rank = (u_int64_t)((percentile / 100.0) * total + 0.5);
+			if (rank == 0) rank = 1;
+			if (rank > total) rank = total;
+
+			u_int64_t seen = 0;
+			for (size_t b = 0; b < BUCKETS; b++)
+			{
+				seen += counts[b];
+				if (seen >= rank) return getUpperBound(b);
+			}
+
+			return getUpperBound(BUCKETS - 1);
+		}
+
+		size_t Metrics::Histogram::getBucket(u_int64_t value)
+		{
+			// small values get a bucket of their own
+			if (value < SUB_BUCKETS) return value;
+
+			// position of the highest bit
+			size_t exponent = 63 - __builtin_clzll(value);
+			if (exponent >= MAX_EXPONENT) return BUCKETS - 1;
+
+			// the three bits below the highest one select the sub-bucket
+			return ((exponent - 2) * SUB_BUCKETS) + ((value >> (exponent - 3)) & (SUB_BUCKETS - 1));
+		}
+
+		u_int64_t Metrics::Histogram::getUpperBound(size_t bucket)
+		{
+			if (bucket < SUB_BUCKETS) return bucket;
+
+			const size_t exponent = (bucket / SUB_BUCKETS) + 2;
+			const u_int64_t sub = bucket % SUB_BUCKETS;
+			const u_int64_t lower = (SUB_BUCKETS + sub) << (exponent - 3);
+
+			return lower + (1ULL << (exponent - 3)) - 1;
+		}
+
+		Metrics::Measurement::Measurement(Histogram &histogram)
+		 : _histogram(histogram), _start(Metrics::now())
+		{
+		}
+
+		Metrics::Measurement::~Measurement()
+		{
+			_histogram.record(Metrics::now() - _start);
+		}
+
+		Metrics::Family::Family()
+		 : type(METRIC_COUNTER)
+		{
+		}
+
+		Metrics::Family::~Family()
+		{
+		}
+
+		Metrics::Metrics()
+		 : ingest_latency(getHistogram("dtnd_bundle_ingest_to_store_seconds", "Time between the reception of a bundle and its storage.")),
+		   forward_latency(getHistogram("dtnd_bundle_store_to_forward_seconds", "Time between the storage of a bundle and its first successful transfer.")),
+		   segment_rtt(getHistogram("dtnd_tcpcl_segment_rtt_seconds", "Round-trip time of acknowledged TCP convergence layer segments.")),
+		   event_wait(getHistogram("dtnd_event_queue_wait_seconds", "Time an event waits in the queue of the event switch."))
+		{
+		}
+
+		Metrics::~Metrics()
+		{
+			for (std::map<std::string, Family>::iterator iter = _families.begin(); iter != _families.end(); iter++)
+			{
+				Family &f = iter->second;
+
+				for (std::map<std::string, Counter*>::iterator c = f.counters.begin(); c != f.counters.end(); c++)
+				{
+					delete c->second;
+				}
+
+				for (std::map<std::string, Histogram*>::iterator h = f.histograms.begin(); h != f.histograms.end(); h++)
+				{
+					delete h->second;
+				}
+			}
+		}
+
+		Metrics& Metrics::getInstance()
+		{
+			static Metrics instance;
+			return instance;
+		}
+
+		u_int64_t Metrics::now()
+		{
+			struct timespec ts;
+			::clock_gettime(CLOCK_MONOTONIC, &ts);
+			return ((u_int64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+		}
+
+		Metrics::Family& Metrics::getFamily(const std::string &name, const std::string &help, const MetricType type)
+		{
+			std::map<std::string, Family>::iterator iter = _families.find(name);
+
+			if (iter == _families.end())
+			{
+				Family &f = _families[name];
+				f.type = type;
+				f.help = help;
+				return f;
+			}
+
+			if (iter->second.type != type)
+			{
+				throw ibrcommon::Exception("metric " + name + " is registered with another type");
+			}
+
+			return iter->second;
+		}
+
+		Metrics::Counter& Metrics::getCounter(const std::string &name, const std::string &help, const std::string &labels)
+		{
+			ibrcommon::MutexLock l(_lock);
+			Family &f = getFamily(name, help, METRIC_COUNTER);
+
+			Counter *&c = f.counters[labels];
+			if (c == NULL) c = new Counter();
+			return *c;
+		}
+
+		Metrics::Histogram& Metrics::getHistogram(const std::string &name, const std::string &help, const std::string &labels)
+		{
+			ibrcommon::MutexLock l(_lock);
+			Family &f = getFamily(name, help, METRIC_HISTOGRAM);
+
+			Histogram *&h = f.histograms[labels];
+			if (h == NULL) h = new Histogram();
+			return *h;
+		}
+
+		void Metrics::write(std::ostream &stream)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			for (std::map<std::string, Family>::const_iterator iter = _families.begin(); iter != _families.end(); iter++)
+			{
+				const std::string &name = iter->first;
+				const Family &f = iter->second;
+
+				stream << "# HELP " << name << " " << f.help << "\n";
+
+				if (f.type == METRIC_COUNTER)
+				{
+					stream << "# TYPE " << name << " counter\n";
+
+					for (std::map<std::string, Counter*>::const_iterator c = f.counters.begin(); c != f.counters.end(); c++)
+					{
+						stream << name;
+						if (c->first.length() > 0) stream << "{" << c->first << "}";
+						stream << " " << c->second->get() << "\n";
+					}
+				}
+				else
+				{
+					stream << "# TYPE " << name << " histogram\n";
+
+					for (std::map<std::string, Histogram*>::const_iterator h = f.histograms.begin(); h != f.histograms.end(); h++)
+					{
+						write(stream, name, h->first, *h->second);
+					}
+				}
+			}
+
+			stream << std::flush;
+		}
+
+		void Metrics::write(std::ostream &stream, const std::string &name, const std::string &labels, const Histogram &histogram)
+		{
+			const std::string prefix = (labels.length() > 0) ? (labels + ",") : "";
+
+			// the export uses one bucket per power of two, which is
+			// fine enough for dashboards and keeps the output small
+			u_int64_t cumulative = 0;
+			u_int64_t total = 0;
+			size_t last = 0;
+
+			u_int64_t counts[Histogram::BUCKETS];
+			for (size_t b = 0; b < Histogram::BUCKETS; b++)
+			{
+				counts[b] = histogram.getBucketCount(b);
+				total += counts[b];
+				if (counts[b] > 0) last = b;
+			}
+
+			for (size_t b = 0; b < Histogram::BUCKETS; b++)
+			{
+				cumulative += counts[b];
+
+				// write only the last sub-bucket of each power of two
+				if ((b % Histogram::SUB_BUCKETS) != (Histogram::SUB_BUCKETS - 1)) continue;
+
+				stream << name << "_bucket{" << prefix << "le=\"";
+				writeSeconds(stream, Histogram::getUpperBound(b));
+				stream << "\"} " << cumulative << "\n";
+
+				// omit the empty buckets above the largest value
+				if (b >= last) break;
+			}
+
+			stream << name << "_bucket{" << prefix << "le=\"+Inf\"} " << total << "\n";
+
+			stream << name << "_sum";
+			if (labels.length() > 0) stream << "{" << labels << "}";
+			stream << " ";
+			writeSeconds(stream, histogram.getSum());
+			stream << "\n";
+
+			stream << name << "_count";
+			if (labels.length() > 0) stream << "{" << labels << "}";
+			stream << " " << total << "\n";
+		}
+	}
+}
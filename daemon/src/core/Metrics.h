@@ -0,0 +1,212 @@
+/*
+ * Metrics.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <ibrcommon/thread/Mutex.h>
+#include <sys/types.h>
+#include <iostream>
+#include <string>
+#include <map>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Registry of the counters and latency histograms of the daemon.
+		 *
+		 * Recording a value never takes a lock. Each metric is split into shards
+		 * and every thread updates the shard assigned to it, so concurrent threads
+		 * do not contend for the same cache line. The shards are summed up when
+		 * the metrics are exported in the Prometheus text format.
+		 *
+		 * Metrics are registered once and the returned references stay valid
+		 * for the lifetime of the process. Hot paths should keep the reference
+		 * instead of looking up the metric on each call.
+		 */
+		class Metrics
+		{
+		public:
+			/**
+			 * Number of shards of each metric.
+			 */
+			static const size_t SHARDS = 8;
+
+			/**
+			 * A monotonic increasing counter.
+			 */
+			class Counter
+			{
+			public:
+				Counter();
+				~Counter();
+
+				void add(u_int64_t value = 1);
+				u_int64_t get() const;
+
+			private:
+				struct Shard
+				{
+					volatile u_int64_t value;
+
+					// keep the shards on separate cache lines
+					char padding[64 - sizeof(u_int64_t)];
+				};
+
+				Shard _shards[SHARDS];
+			};
+
+			/**
+			 * A histogram of durations in microseconds. The buckets are spaced
+			 * logarithmically with eight linear sub-buckets per power of two, thus
+			 * the relative error of a recorded value is at most 12.5 percent.
+			 */
+			class Histogram
+			{
+			public:
+				/**
+				 * Values above 2^MAX_EXPONENT microseconds (about 12 days)
+				 * are accounted in the last bucket.
+				 */
+				static const size_t MAX_EXPONENT = 40;
+				static const size_t SUB_BUCKETS = 8;
+				static const size_t BUCKETS = (MAX_EXPONENT - 2) * SUB_BUCKETS;
+
+				Histogram();
+				~Histogram();
+
+				/**
+				 * Record a duration.
+				 * @param value Duration in microseconds.
+				 */
+				void record(u_int64_t value);
+
+				u_int64_t getCount() const;
+				u_int64_t getSum() const;
+
+				/**
+				 * Returns the number of values recorded in a bucket.
+				 */
+				u_int64_t getBucketCount(size_t bucket) const;
+
+				/**
+				 * Returns the upper bound of the bucket containing the given
+				 * percentile of all recorded values.
+				 * @param percentile Value between 0 and 100.
+				 */
+				u_int64_t getPercentile(double percentile) const;
+
+				/**
+				 * Returns the bucket of a value.
+				 */
+				static size_t getBucket(u_int64_t value);
+
+				/**
+				 * Returns the largest value accounted in a bucket.
+				 */
+				static u_int64_t getUpperBound(size_t bucket);
+
+			private:
+				struct Shard
+				{
+					volatile u_int64_t count;
+					volatile u_int64_t sum;
+					volatile u_int64_t buckets[BUCKETS];
+				};
+
+				Shard _shards[SHARDS];
+			};
+
+			/**
+			 * Records the time between its construction and destruction
+			 * into a histogram.
+			 */
+			class Measurement
+			{
+			public:
+				Measurement(Histogram &histogram);
+				~Measurement();
+
+			private:
+				Histogram &_histogram;
+				const u_int64_t _start;
+			};
+
+			static Metrics& getInstance();
+
+			/**
+			 * Returns the time of a monotonic clock in microseconds.
+			 */
+			static u_int64_t now();
+
+			/**
+			 * Returns the counter with the given name and labels. The counter
+			 * is created on the first call.
+			 * @param name Name of the metric, e.g. "dtnd_cl_bytes_total".
+			 * @param help Description of the metric.
+			 * @param labels Labels in the export format, e.g. cl="tcp".
+			 */
+			Counter& getCounter(const std::string &name, const std::string &help, const std::string &labels = "");
+
+			/**
+			 * Returns the histogram with the given name and labels. The histogram
+			 * is created on the first call.
+			 */
+			Histogram& getHistogram(const std::string &name, const std::string &help, const std::string &labels = "");
+
+			/**
+			 * Write all metrics in the Prometheus text exposition format.
+			 */
+			void write(std::ostream &stream);
+
+		private:
+			Metrics();
+			virtual ~Metrics();
+
+			enum MetricType
+			{
+				METRIC_COUNTER = 0,
+				METRIC_HISTOGRAM = 1
+			};
+
+			class Family
+			{
+			public:
+				Family();
+				~Family();
+
+				MetricType type;
+				std::string help;
+				std::map<std::string, Counter*> counters;
+				std::map<std::string, Histogram*> histograms;
+			};
+
+			Family& getFamily(const std::string &name, const std::string &help, const MetricType type);
+
+			static void write(std::ostream &stream, const std::string &name, const std::string &labels, const Histogram &histogram);
+
+			ibrcommon::Mutex _lock;
+			std::map<std::string, Family> _families;
+
+		public:
+			// time between the reception of a bundle and its storage
+			Histogram &ingest_latency;
+
+			// time between the storage of a bundle and its first successful forwarding
+			Histogram &forward_latency;
+
+			// round-trip time of acknowledged TCP convergence layer segments
+			Histogram &segment_rtt;
+
+			// time events wait in the queue of the event switch
+			Histogram &event_wait;
+		};
+	}
+}
+
+#endif /* METRICS_H_ */
@@ -312,6 +312,25 @@ namespace dtn
 			return (_attr_list.empty() && _uri_list.empty());
 		}
 
+		size_t Node::getExpireTime() const
+		{
+			size_t ret = 0;
+
+			for (std::set<Attribute>::const_iterator iter = _attr_list.begin(); iter != _attr_list.end(); iter++)
+			{
+				const Attribute &attr = (*iter);
+				if ((attr.expire > 0) && ((ret == 0) || (attr.expire < ret))) ret = attr.expire;
+			}
+
+			for (std::set<URI>::const_iterator iter = _uri_list.begin(); iter != _uri_list.end(); iter++)
+			{
+				const URI &u = (*iter);
+				if ((u.expire > 0) && ((ret == 0) || (u.expire < ret))) ret = u.expire;
+			}
+
+			return ret;
+		}
+
 		const Node& Node::operator+=(const Node &other)
 		{
 			for (std::set<Attribute>::const_iterator iter = other._attr_list.begin(); iter != other._attr_list.end(); iter++)
@@ -160,6 +160,12 @@ namespace dtn
 			 */
 			bool expire();
 
+			/**
+			 * Returns the earliest expiration time of all URIs and attributes
+			 * or zero, if none of them expires.
+			 */
+			size_t getExpireTime() const;
+
 			/**
 			 * Compare this node to another one. Two nodes are equal if the
 			 * uri and address of both nodes are equal.
@@ -0,0 +1,330 @@
+/*
+ * ReceivePipeline.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "config.h"
+#include "core/ReceivePipeline.h"
+#include "core/BundleCore.h"
+#include "core/BundleEvent.h"
+#include "core/Metrics.h"
+#include "net/BundleReceivedEvent.h"
+
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#ifdef WITH_BUNDLE_SECURITY
+#include "security/SecurityManager.h"
+#endif
+
+namespace dtn
+{
+	namespace core
+	{
+		ReceivePipeline& ReceivePipeline::getInstance()
+		{
+			static ReceivePipeline instance;
+			return instance;
+		}
+
+		ReceivePipeline::ReceivePipeline()
+		 : _lane_count(0), _lane_limit(0), _active(false), _pushing(0)
+		{
+			static const char *names[STAGE_COUNT] = { "validate", "security", "store" };
+
+			for (size_t stage = 0; stage < STAGE_COUNT; stage++)
+			{
+				_dropped[stage] = &Metrics::getInstance().getCounter("dtnd_receive_pipeline_dropped_total",
+						"Bundles dropped by a stage of the receive pipeline.", std::string("stage=\"") + names[stage] + "\"");
+			}
+		}
+
+		ReceivePipeline::~ReceivePipeline()
+		{
+			for (std::vector<Lane*>::iterator iter = _lanes.begin(); iter != _lanes.end(); iter++)
+			{
+				delete (*iter);
+			}
+		}
+
+		void ReceivePipeline::setup(size_t lanes, size_t limit)
+		{
+			_lane_count = lanes;
+			_lane_limit = (limit > 0) ? limit : 1;
+		}
+
+		bool ReceivePipeline::isActive() const
+		{
+			return _active;
+		}
+
+		const std::string ReceivePipeline::getName() const
+		{
+			return "ReceivePipeline";
+		}
+
+		void ReceivePipeline::componentUp()
+		{
+			if (_lane_count == 0) return;
+
+			// create all lanes of all stages
+			for (size_t stage = 0; stage < STAGE_COUNT; stage++)
+			{
+				for (size_t i = 0; i < _lane_count; i++)
+				{
+					_lanes.push_back( new Lane(*this, STAGE(stage), i, _lane_limit) );
+				}
+			}
+
+			for (std::vector<Lane*>::iterator iter = _lanes.begin(); iter != _lanes.end(); iter++)
+			{
+				try {
+					(*iter)->start();
+				} catch (const ibrcommon::ThreadException &ex) {
+					IBRCOMMON_LOGGER(error) << "failed to start lane of the ReceivePipeline\n" << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
+			// publish the lanes before the first bundle is accepted
+			__sync_synchronize();
+			_active = true;
+
+			IBRCOMMON_LOGGER(info) << "Receive pipeline enabled with " << _lane_count << " lanes per stage" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void ReceivePipeline::componentDown()
+		{
+			// do not accept any further bundle
+			_active = false;
+			__sync_synchronize();
+
+			// wake up blocked producers and stop all workers
+			for (std::vector<Lane*>::iterator iter = _lanes.begin(); iter != _lanes.end(); iter++)
+			{
+				(*iter)->shutdown();
+			}
+
+			// wait until no producer uses the lanes anymore
+			while (__sync_fetch_and_add(&_pushing, 0) > 0)
+			{
+				ibrcommon::Thread::yield();
+			}
+
+			for (std::vector<Lane*>::iterator iter = _lanes.begin(); iter != _lanes.end(); iter++)
+			{
+				(*iter)->join();
+				delete (*iter);
+			}
+			_lanes.clear();
+		}
+
+		bool ReceivePipeline::push(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool fromlocal)
+		{
+			// announce the producer before the state is checked
+			__sync_add_and_fetch(&_pushing, 1);
+
+			bool ret = false;
+
+			if (_active)
+			{
+				Job *job = new Job(peer, bundle, fromlocal);
+
+				if (getLane(STAGE_VALIDATE, getLaneIndex(bundle)).push(job))
+				{
+					ret = true;
+				}
+				else
+				{
+					// the pipeline is going down, the caller processes the bundle
+					delete job;
+				}
+			}
+
+			__sync_sub_and_fetch(&_pushing, 1);
+			return ret;
+		}
+
+		void ReceivePipeline::dropped(const STAGE stage) const
+		{
+			_dropped[stage]->add();
+		}
+
+		void ReceivePipeline::forward(const STAGE stage, const size_t index, Job *job)
+		{
+			if (!getLane(STAGE(stage + 1), index).push(job))
+			{
+				IBRCOMMON_LOGGER(notice) << "Receive pipeline is going down, bundle dropped: " << job->bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+				dropped(stage);
+				delete job;
+			}
+		}
+
+		size_t ReceivePipeline::getLaneIndex(const dtn::data::Bundle &bundle) const
+		{
+			// the source EID selects the lane, thus the order of bundles
+			// of the same source is kept through all stages
+			const std::string source = bundle._source.getString();
+
+			size_t hash = 5381;
+			for (std::string::const_iterator iter = source.begin(); iter != source.end(); iter++)
+			{
+				hash = ((hash << 5) + hash) + (unsigned char)(*iter);
+			}
+
+			return hash % _lane_count;
+		}
+
+		ReceivePipeline::Lane& ReceivePipeline::getLane(const STAGE stage, const size_t index)
+		{
+			return *_lanes[(stage * _lane_count) + index];
+		}
+
+		bool ReceivePipeline::process(const STAGE stage, Job &job) const
+		{
+			switch (stage)
+			{
+				case STAGE_VALIDATE:
+				{
+					// drop bundles to the NULL-destination
+					if (job.bundle._destination == dtn::data::EID("dtn:null")) return false;
+
+					// the bundle may have expired while it was waiting in the queue
+					if (dtn::utils::Clock::isExpired(job.bundle))
+					{
+						IBRCOMMON_LOGGER(notice) << "bundle expired in the receive pipeline: " << job.bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+						dtn::core::BundleEvent::raise(job.bundle, dtn::core::BUNDLE_DELETED, dtn::data::StatusReportBlock::LIFETIME_EXPIRED);
+						return false;
+					}
+					return true;
+				}
+
+				case STAGE_SECURITY:
+				{
+#ifdef WITH_BUNDLE_SECURITY
+					// local bundles are not verified, known bundles are not stored again
+					if (job.fromlocal) return true;
+					if (dtn::core::BundleCore::getInstance().getRouter().isKnown(job.bundle)) return true;
+
+					try {
+						// lets see if signatures and hashes are correct and remove them if possible
+						dtn::security::SecurityManager::getInstance().verify(job.bundle);
+						job.verified = true;
+					} catch (const dtn::security::SecurityManager::VerificationFailedException &ex) {
+						IBRCOMMON_LOGGER(notice) << "Security checks failed, bundle will be dropped: " << job.bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+						return false;
+					}
+#endif
+					return true;
+				}
+
+				case STAGE_STORE:
+				{
+					// pass the bundle to the router, this blocks until the bundle is stored
+					dtn::net::BundleReceivedEvent::dispatch(job.peer, job.bundle, job.fromlocal, job.received, job.verified);
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		ReceivePipeline::Job::Job(const dtn::data::EID &p, const dtn::data::Bundle &b, const bool local)
+		 : peer(p), bundle(b), fromlocal(local), received(Metrics::now()), verified(false)
+		{
+		}
+
+		ReceivePipeline::Job::~Job()
+		{
+		}
+
+		ReceivePipeline::Lane::Lane(ReceivePipeline &pipeline, const STAGE stage, const size_t index, const size_t limit)
+		 : _pipeline(pipeline), _stage(stage), _index(index), _limit(limit), _running(true)
+		{
+		}
+
+		ReceivePipeline::Lane::~Lane()
+		{
+			join();
+
+			// delete all jobs left
+			while (!_jobs.empty())
+			{
+				delete _jobs.front();
+				_jobs.pop();
+			}
+		}
+
+		bool ReceivePipeline::Lane::push(Job *job)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			// block while the queue is full
+			while (_running && (_jobs.size() >= _limit))
+			{
+				_cond.wait();
+			}
+
+			if (!_running) return false;
+
+			_jobs.push(job);
+			_cond.signal(true);
+			return true;
+		}
+
+		void ReceivePipeline::Lane::shutdown()
+		{
+			ibrcommon::MutexLock l(_cond);
+			_running = false;
+			_cond.signal(true);
+		}
+
+		bool ReceivePipeline::Lane::__cancellation()
+		{
+			shutdown();
+			return true;
+		}
+
+		void ReceivePipeline::Lane::run()
+		{
+			while (true)
+			{
+				Job *job = NULL;
+
+				{
+					ibrcommon::MutexLock l(_cond);
+
+					while (_running && _jobs.empty())
+					{
+						_cond.wait();
+					}
+
+					if (!_running) return;
+
+					job = _jobs.front();
+					_jobs.pop();
+
+					// wake-up blocked producers
+					_cond.signal(true);
+				}
+
+				try {
+					if (_pipeline.process(_stage, *job))
+					{
+						_pipeline.forward(_stage, _index, job);
+						continue;
+					}
+
+					// the last stage hands over the bundle
+					if (_stage != STAGE_STORE) _pipeline.dropped(_stage);
+				} catch (const std::exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG(10) << "receive pipeline failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+					_pipeline.dropped(_stage);
+				}
+
+				delete job;
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+/*
+ * ReceivePipeline.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef RECEIVEPIPELINE_H_
+#define RECEIVEPIPELINE_H_
+
+#include "Component.h"
+#include "core/Metrics.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Conditional.h>
+
+#include <queue>
+#include <vector>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * The receive pipeline takes over received bundles from the convergence layers
+		 * and the API and processes them in several stages. Each stage owns a fixed number
+		 * of lanes with a bounded queue and a worker thread. A bundle is assigned to a lane
+		 * by its source EID, thus all bundles of one source pass the pipeline in the order
+		 * of reception while bundles of different sources are processed in parallel.
+		 * If the queue of a lane is full, the caller is blocked until there is space left.
+		 * This propagates backpressure to the convergence layer.
+		 *
+		 * Payloads are not decrypted in the pipeline. Bundles are stored and forwarded
+		 * as they were received and decrypted on delivery.
+		 */
+		class ReceivePipeline : public dtn::daemon::IntegratedComponent
+		{
+		public:
+			enum STAGE
+			{
+				STAGE_VALIDATE = 0,
+				STAGE_SECURITY = 1,
+				STAGE_STORE = 2
+			};
+
+			static const size_t STAGE_COUNT = 3;
+
+			static ReceivePipeline& getInstance();
+
+			/**
+			 * Define the number of lanes per stage and the maximum number of
+			 * bundles queued in each lane. This has to be done before the
+			 * component is initialized. With zero lanes the pipeline is disabled.
+			 * @param lanes Number of parallel lanes per stage.
+			 * @param limit Maximum number of queued bundles per lane.
+			 */
+			void setup(size_t lanes, size_t limit);
+
+			/**
+			 * @return True, if the pipeline accepts bundles.
+			 */
+			bool isActive() const;
+
+			/**
+			 * Put a received bundle into the pipeline. This call blocks while
+			 * the queue of the corresponding lane is full.
+			 *
+			 * A return value of true only means that the pipeline has taken over
+			 * the bundle. A later stage may still drop it, e.g. if it expires or
+			 * fails the security checks. Such bundles are reported like before:
+			 * expired bundles with a BundleEvent, failed checks in the log. All
+			 * drops are counted in dtnd_receive_pipeline_dropped_total.
+			 * @param peer The EID of the node the bundle was received from.
+			 * @param bundle The received bundle.
+			 * @param fromlocal True, if the bundle was received from a local application.
+			 * @return False, if the pipeline is not active or going down and the
+			 * bundle has not been queued. The caller has to process the bundle.
+			 */
+			bool push(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool fromlocal);
+
+			/**
+			 * @see Component::getName()
+			 */
+			virtual const std::string getName() const;
+
+		protected:
+			virtual void componentUp();
+			virtual void componentDown();
+
+		private:
+			ReceivePipeline();
+			virtual ~ReceivePipeline();
+
+			class Job
+			{
+			public:
+				Job(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool fromlocal);
+				~Job();
+
+				const dtn::data::EID peer;
+				dtn::data::Bundle bundle;
+				const bool fromlocal;
+
+				// time of the reception
+				const u_int64_t received;
+
+				// set if the security checks have been done
+				bool verified;
+			};
+
+			class Lane : public ibrcommon::JoinableThread
+			{
+			public:
+				Lane(ReceivePipeline &pipeline, const STAGE stage, const size_t index, const size_t limit);
+				virtual ~Lane();
+
+				/**
+				 * Queue a job in this lane. Blocks while the queue is full.
+				 * @return False, if the lane has been shut down and the job was not queued.
+				 */
+				bool push(Job *job);
+
+				void shutdown();
+
+			protected:
+				void run();
+				bool __cancellation();
+
+			private:
+				ReceivePipeline &_pipeline;
+				const STAGE _stage;
+				const size_t _index;
+				const size_t _limit;
+
+				ibrcommon::Conditional _cond;
+				std::queue<Job*> _jobs;
+				bool _running;
+			};
+
+			/**
+			 * Process one stage of a job.
+			 * @return False, if the bundle leaves the pipeline at this stage.
+			 */
+			bool process(const STAGE stage, Job &job) const;
+
+			/**
+			 * Hand over a job to the next stage using the same lane index.
+			 */
+			void forward(const STAGE stage, const size_t index, Job *job);
+
+			/**
+			 * Returns the lane index for a given bundle.
+			 */
+			size_t getLaneIndex(const dtn::data::Bundle &bundle) const;
+
+			Lane& getLane(const STAGE stage, const size_t index);
+
+			/**
+			 * Account a bundle dropped at the given stage.
+			 */
+			void dropped(const STAGE stage) const;
+
+			size_t _lane_count;
+			size_t _lane_limit;
+
+			// read by the convergence layers without a lock
+			volatile bool _active;
+
+			// number of push() calls in progress, the lanes are not deleted before it drops to zero
+			volatile size_t _pushing;
+
+			Metrics::Counter *_dropped[STAGE_COUNT];
+
+			// all lanes ordered by stage, followed by the lane index
+			std::vector<Lane*> _lanes;
+		};
+	}
+}
+
+#endif /* RECEIVEPIPELINE_H_ */
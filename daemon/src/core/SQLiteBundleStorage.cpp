@@ -47,7 +47,7 @@ namespace dtn
 			"SELECT * FROM " + _tables[SQL_TABLE_BUNDLE] + " WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset != NULL ORDER BY fragmentoffset ASC;",
 
 			"SELECT source, timestamp, sequencenumber, fragmentoffset, procflags FROM "+ _tables[SQL_TABLE_BUNDLE] +" WHERE expiretime <= ?;",
-			"SELECT filename FROM "+ _tables[SQL_TABLE_BUNDLE] +" as a, "+ _tables[SQL_TABLE_BLOCK] +" as b WHERE a.source_id = b.source_id AND a.timestamp = b.timestamp AND a.sequencenumber = b.sequencenumber AND ((a.fragmentoffset = b.fragmentoffset) OR ((a.fragmentoffset IS NULL) AND (b.fragmentoffset IS NULL))) AND a.expiretime <= ?;",
+			"SELECT filename FROM "+ _tables[SQL_TABLE_BUNDLE] +" as a, "+ _tables[SQL_TABLE_BLOCK] +" as b WHERE a.source_id = b.source_id AND a.timestamp = b.timestamp AND a.sequencenumber = b.sequencenumber AND ((a.fragmentoffset = b.fragmentoffset) OR ((a.fragmentoffset IS NULL) AND (b.fragmentoffset IS NULL))) AND a.expiretime <= ? AND b.filename != '';",
 			"DELETE FROM "+ _tables[SQL_TABLE_BUNDLE] +" WHERE expiretime <= ?;",
 			"SELECT expiretime FROM "+ _tables[SQL_TABLE_BUNDLE] +" ORDER BY expiretime ASC LIMIT 1;",
 
@@ -63,12 +63,13 @@ namespace dtn
 
 			"UPDATE "+ _tables[SQL_TABLE_BUNDLE] +" SET procflags = ? WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset = ?;",
 
-			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset IS NULL ORDER BY ordernumber ASC;",
-			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset = ? ORDER BY ordernumber ASC;",
+			"SELECT filename, blocktype, key, CASE WHEN length(data) <= ?5 THEN data ELSE NULL END FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ?1 AND timestamp = ?2 AND sequencenumber = ?3 AND fragmentoffset IS NULL ORDER BY ordernumber ASC;",
+			"SELECT filename, blocktype, key, CASE WHEN length(data) <= ?5 THEN data ELSE NULL END FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ?1 AND timestamp = ?2 AND sequencenumber = ?3 AND fragmentoffset = ?4 ORDER BY ordernumber ASC;",
 			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset IS NULL AND ordernumber = ?;",
 			"SELECT filename, blocktype FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset = ? AND ordernumber = ?;",
 			"DELETE FROM "+ _tables[SQL_TABLE_BLOCK] +";",
-			"INSERT INTO "+ _tables[SQL_TABLE_BLOCK] +" (source_id, timestamp, sequencenumber, fragmentoffset, blocktype, filename, ordernumber) VALUES (?,?,?,?,?,?,?);",
+			"INSERT INTO "+ _tables[SQL_TABLE_BLOCK] +" (source_id, timestamp, sequencenumber, fragmentoffset, blocktype, filename, ordernumber, data) VALUES (?,?,?,?,?,?,?,?);",
+			"SELECT key FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE source_id = ? AND timestamp = ? AND sequencenumber = ? AND fragmentoffset IS ? AND ordernumber = ?;",
 
 #ifdef SQLITE_STORAGE_EXTENDED
 			"SELECT Routing FROM "+ _tables[SQL_TABLE_ROUTING] +" WHERE Key = ?;",
@@ -91,7 +92,7 @@ namespace dtn
 
 		const std::string SQLiteBundleStorage::_db_structure[10] =
 		{
-			"CREATE TABLE IF NOT EXISTS `" + _tables[SQL_TABLE_BLOCK] + "` ( `key` INTEGER PRIMARY KEY ASC, `source_id` TEXT NOT NULL, `timestamp` INTEGER NOT NULL, `sequencenumber` INTEGER NOT NULL, `fragmentoffset` INTEGER DEFAULT NULL, `blocktype` INTEGER NOT NULL, `filename` TEXT NOT NULL, `ordernumber` INTEGER NOT NULL);",
+			"CREATE TABLE IF NOT EXISTS `" + _tables[SQL_TABLE_BLOCK] + "` ( `key` INTEGER PRIMARY KEY ASC, `source_id` TEXT NOT NULL, `timestamp` INTEGER NOT NULL, `sequencenumber` INTEGER NOT NULL, `fragmentoffset` INTEGER DEFAULT NULL, `blocktype` INTEGER NOT NULL, `filename` TEXT NOT NULL, `ordernumber` INTEGER NOT NULL, `data` BLOB DEFAULT NULL);",
 			"CREATE TABLE IF NOT EXISTS `" + _tables[SQL_TABLE_BUNDLE] + "` ( `key` INTEGER PRIMARY KEY ASC, `source_id` TEXT NOT NULL, `source` TEXT NOT NULL, `destination` TEXT NOT NULL, `reportto` TEXT NOT NULL, `custodian` TEXT NOT NULL, `procflags` INTEGER NOT NULL, `timestamp` INTEGER NOT NULL, `sequencenumber` INTEGER NOT NULL, `lifetime` INTEGER NOT NULL, `fragmentoffset` INTEGER DEFAULT NULL, `appdatalength` INTEGER DEFAULT NULL, `expiretime` INTEGER NOT NULL, `priority` INTEGER NOT NULL, `hopcount` INTEGER DEFAULT NULL);",
 			"create table if not exists "+ _tables[SQL_TABLE_ROUTING] +" (INTEGER PRIMARY KEY ASC, Key int, Routing text);",
 			"create table if not exists "+ _tables[SQL_TABLE_BUNDLE_ROUTING_INFO] +" (INTEGER PRIMARY KEY ASC, BundleID text, Key int, Routing text);",
@@ -195,13 +196,218 @@ namespace dtn
 			return _file.size();
 		}
 
+		SQLiteBundleStorage::BlobStreamBuf::BlobStreamBuf(sqlite3_blob *blob)
+		 : _blob(blob), _size(sqlite3_blob_bytes(blob)), _offset(0)
+		{
+			setp(_buffer, _buffer + BUFFER_SIZE);
+			setg(_buffer, _buffer, _buffer);
+		}
+
+		SQLiteBundleStorage::BlobStreamBuf::~BlobStreamBuf()
+		{
+			sync();
+			sqlite3_blob_close(_blob);
+		}
+
+		int SQLiteBundleStorage::BlobStreamBuf::sync()
+		{
+			const int len = pptr() - pbase();
+			if (len == 0) return 0;
+
+			if ((_offset + len > _size) || (sqlite3_blob_write(_blob, pbase(), len, _offset) != SQLITE_OK))
+			{
+				return -1;
+			}
+
+			_offset += len;
+			setp(_buffer, _buffer + BUFFER_SIZE);
+			return 0;
+		}
+
+		int SQLiteBundleStorage::BlobStreamBuf::overflow(int c)
+		{
+			if (sync() != 0) return traits_type::eof();
+
+			if (!traits_type::eq_int_type(c, traits_type::eof()))
+			{
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+
+			return traits_type::not_eof(c);
+		}
+
+		int SQLiteBundleStorage::BlobStreamBuf::underflow()
+		{
+			if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+			int len = _size - _offset;
+			if (len > (int)BUFFER_SIZE) len = BUFFER_SIZE;
+			if (len <= 0) return traits_type::eof();
+
+			if (sqlite3_blob_read(_blob, _buffer, len, _offset) != SQLITE_OK)
+			{
+				return traits_type::eof();
+			}
+
+			_offset += len;
+			setg(_buffer, _buffer, _buffer + len);
+			return traits_type::to_int_type(*gptr());
+		}
+
+		std::streampos SQLiteBundleStorage::BlobStreamBuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+		{
+			// only the read position can be changed
+			if (!(which & std::ios_base::in)) return std::streampos(-1);
+
+			// the current position is the begin of the unread buffer
+			std::streamoff pos = _offset - (egptr() - gptr());
+
+			if (way == std::ios_base::beg) pos = off;
+			else if (way == std::ios_base::cur) pos += off;
+			else pos = _size + off;
+
+			if ((pos < 0) || (pos > _size)) return std::streampos(-1);
+
+			_offset = pos;
+			setg(_buffer, _buffer, _buffer);
+			return std::streampos(pos);
+		}
+
+		std::streampos SQLiteBundleStorage::BlobStreamBuf::seekpos(std::streampos pos, std::ios_base::openmode which)
+		{
+			return seekoff(std::streamoff(pos), std::ios_base::beg, which);
+		}
+
 		ibrcommon::BLOB::Reference SQLiteBundleStorage::create()
 		{
 			return ibrcommon::BLOB::Reference(new SQLiteBLOB(_blobPath));
 		}
 
-		SQLiteBundleStorage::SQLiteBundleStorage(const ibrcommon::File &path, const size_t &size)
-		 : dbPath(path), dbFile(path.get("sqlite.db")), dbSize(size), _next_expiration(0)
+		SQLiteBundleStorage::ReadConnection::ReadConnection(const ibrcommon::File &path, const size_t inline_limit)
+		 : _database(NULL)
+		{
+			// the connection is never shared between threads, thus no mutex is needed
+			if (sqlite3_open_v2(path.getPath().c_str(), &_database, SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_READONLY, NULL))
+			{
+				IBRCOMMON_LOGGER(error) << "Can't open read-only database: " << sqlite3_errmsg(_database) << IBRCOMMON_LOGGER_ENDL;
+				sqlite3_close(_database);
+				throw ibrcommon::Exception("Unable to open sqlite database");
+			}
+
+			// wait for locks held by the writer during a checkpoint
+			sqlite3_busy_timeout(_database, 1000);
+
+			// prepare all statements, modifying statements are never executed on this connection
+			for (int i = 0; i < SQL_QUERIES_END; i++)
+			{
+				if (sqlite3_prepare_v2(_database, _sql_queries[i].c_str(), _sql_queries[i].length(), &_statements[i], 0) != SQLITE_OK)
+				{
+					_statements[i] = NULL;
+				}
+			}
+
+			// the inline limit is bound once, bindings are kept on reset
+			sqlite3_bind_int64(_statements[BLOCK_GET_ID], 5, inline_limit);
+			sqlite3_bind_int64(_statements[BLOCK_GET_ID_FRAGMENT], 5, inline_limit);
+		}
+
+		SQLiteBundleStorage::ReadConnection::~ReadConnection()
+		{
+			for (int i = 0; i < SQL_QUERIES_END; i++)
+			{
+				sqlite3_finalize(_statements[i]);
+			}
+
+			for (std::map<std::string, sqlite3_stmt*>::iterator iter = _queries.begin(); iter != _queries.end(); iter++)
+			{
+				sqlite3_finalize((*iter).second);
+			}
+
+			sqlite3_close(_database);
+		}
+
+		sqlite3_stmt* SQLiteBundleStorage::ReadConnection::prepare(const std::string &query)
+		{
+			std::map<std::string, sqlite3_stmt*>::const_iterator iter = _queries.find(query);
+			if (iter != _queries.end()) return (*iter).second;
+
+			sqlite3_stmt *st = NULL;
+			int err = sqlite3_prepare_v2(_database, query.c_str(), query.length(), &st, 0);
+			if (err != SQLITE_OK)
+			{
+				IBRCOMMON_LOGGER(error) << "SQLiteBundlestorage: failure in prepareStatement: " << err << " with Query: " << query << IBRCOMMON_LOGGER_ENDL;
+				throw SQLiteQueryException("failed to prepare query");
+			}
+
+			_queries[query] = st;
+			return st;
+		}
+
+		SQLiteBundleStorage::Reader::Reader(SQLiteBundleStorage &storage)
+		 : _storage(storage), _conn(storage.lease())
+		{
+		}
+
+		SQLiteBundleStorage::Reader::~Reader()
+		{
+			if (_conn != NULL) _storage.release(_conn);
+		}
+
+		bool SQLiteBundleStorage::Reader::pooled() const
+		{
+			return (_conn != NULL);
+		}
+
+		sqlite3* SQLiteBundleStorage::Reader::database() const
+		{
+			return (_conn != NULL) ? _conn->_database : _storage._database;
+		}
+
+		sqlite3_stmt* SQLiteBundleStorage::Reader::operator[](const size_t key) const
+		{
+			return (_conn != NULL) ? _conn->_statements[key] : _storage._statements[key];
+		}
+
+		ibrcommon::Mutex& SQLiteBundleStorage::Reader::lock(const size_t key) const
+		{
+			return (_conn != NULL) ? _conn->_locks[key] : _storage._locks[key];
+		}
+
+		sqlite3_stmt* SQLiteBundleStorage::Reader::prepare(const std::string &query) const
+		{
+			if (_conn == NULL) throw SQLiteQueryException("no pooled connection leased");
+			return _conn->prepare(query);
+		}
+
+		SQLiteBundleStorage::ReadConnection* SQLiteBundleStorage::lease()
+		{
+			if (_readers.empty()) return NULL;
+
+			ibrcommon::MutexLock l(_readers_cond);
+			while (_readers_idle.empty())
+			{
+				_readers_cond.wait();
+			}
+
+			ReadConnection *conn = _readers_idle.front();
+			_readers_idle.pop_front();
+			return conn;
+		}
+
+		void SQLiteBundleStorage::release(ReadConnection *conn)
+		{
+			ibrcommon::MutexLock l(_readers_cond);
+			_readers_idle.push_back(conn);
+			_readers_cond.signal(true);
+		}
+
+		SQLiteBundleStorage::SQLiteBundleStorage(const ibrcommon::File &path, const size_t &size, const size_t readers)
+		 : dbPath(path), dbFile(path.get("sqlite.db")), dbSize(size), _inline_limit(DEFAULT_INLINE_LIMIT), _blob_limit(DEFAULT_BLOB_LIMIT),
+		   _query_get(Metrics::getInstance().getHistogram("dtnd_storage_query_seconds", "Time spent in the queries of the bundle storage.", "storage=\"sqlite\",query=\"get\"")),
+		   _query_select(Metrics::getInstance().getHistogram("dtnd_storage_query_seconds", "Time spent in the queries of the bundle storage.", "storage=\"sqlite\",query=\"select\"")),
+		   _query_store(Metrics::getInstance().getHistogram("dtnd_storage_query_seconds", "Time spent in the queries of the bundle storage.", "storage=\"sqlite\",query=\"store\"")),
+		   _next_expiration(0), _reader_count(readers)
 		{
 			//Configure SQLite Library
 			SQLiteConfigure::configure();
@@ -228,6 +434,12 @@ namespace dtn
 				sqlite3_finalize(_statements[i]);
 			}
 
+			// close all read-only connections
+			for (std::vector<ReadConnection*>::iterator iter = _readers.begin(); iter != _readers.end(); iter++)
+			{
+				delete (*iter);
+			}
+
 			//close Databaseconnection
 			if (sqlite3_close(_database) != SQLITE_OK)
 			{
@@ -238,6 +450,12 @@ namespace dtn
 			SQLiteConfigure::shutdown();
 		}
 
+		void SQLiteBundleStorage::setBlockLimits(const size_t inline_limit, const size_t blob_limit)
+		{
+			_inline_limit = inline_limit;
+			_blob_limit = (blob_limit < inline_limit) ? inline_limit : blob_limit;
+		}
+
 		void SQLiteBundleStorage::openDatabase(const ibrcommon::File &path)
 		{
 			ibrcommon::MutexLock l(*this);
@@ -269,6 +487,9 @@ namespace dtn
 				sqlite3_finalize(st);
 			}
 
+			// add the data column to block tables of older databases, this fails if the column already exists
+			sqlite3_exec(_database, ("ALTER TABLE " + _tables[SQL_TABLE_BLOCK] + " ADD COLUMN `data` BLOB DEFAULT NULL;").c_str(), NULL, NULL, NULL);
+
 			// delete all old BLOB container
 			_blobPath.remove(true);
 
@@ -289,9 +510,49 @@ namespace dtn
 				}
 			}
 
+			// the inline limit is bound once, bindings are kept on reset
+			sqlite3_bind_int64(_statements[BLOCK_GET_ID], 5, _inline_limit);
+			sqlite3_bind_int64(_statements[BLOCK_GET_ID_FRAGMENT], 5, _inline_limit);
+
 			// disable synchronous mode
 			sqlite3_exec(_database, "PRAGMA synchronous = OFF;", NULL, NULL, NULL);
 
+			if (_reader_count > 0)
+			{
+				// switch to write-ahead logging, thus readers do not block the writer and vice versa
+				std::string mode;
+				sqlite3_stmt *st = prepare("PRAGMA journal_mode = WAL;");
+				if (sqlite3_step(st) == SQLITE_ROW)
+				{
+					mode = (const char*)sqlite3_column_text(st, 0);
+				}
+				sqlite3_finalize(st);
+
+				if (mode == "wal")
+				{
+					// wait for locks held by readers during a checkpoint
+					sqlite3_busy_timeout(_database, 1000);
+
+					ibrcommon::MutexLock l(_readers_cond);
+					for (size_t i = 0; i < _reader_count; i++)
+					{
+						try {
+							ReadConnection *conn = new ReadConnection(path, _inline_limit);
+							_readers.push_back(conn);
+							_readers_idle.push_back(conn);
+						} catch (const ibrcommon::Exception&) {
+							break;
+						}
+					}
+
+					IBRCOMMON_LOGGER(info) << "SQLiteBundleStorage: WAL journal enabled with " << _readers.size() << " read-only connections" << IBRCOMMON_LOGGER_ENDL;
+				}
+				else
+				{
+					IBRCOMMON_LOGGER(warning) << "SQLiteBundleStorage: unable to enable WAL journal, reader pool disabled" << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
 			// enable sqlite tracing if debug level is higher than 50
 			if (IBRCOMMON_LOGGER_LEVEL >= 50)
 			{
@@ -326,6 +587,18 @@ namespace dtn
 				}
 			} catch (const ibrcommon::QueueUnblockedException &ex) {
 				// we are aborted, abort all blocking tasks
+				try {
+					while (true)
+					{
+						Task *t = _tasks.getnpop();
+
+						try {
+							dynamic_cast<BlockingTask&>(*t).abort();
+						} catch (const std::bad_cast&) {
+							delete t;
+						};
+					}
+				} catch (const ibrcommon::QueueUnblockedException&) { };
 			}
 		}
 
@@ -462,7 +735,7 @@ namespace dtn
 		{
 			std::set<dtn::data::BundleID> corrupt_bundle_ids;
 
-			sqlite3_stmt *blockConistencyCheck = prepare("SELECT source_id, timestamp, sequencenumber, fragmentoffset, filename, ordernumber FROM "+ _tables[SQL_TABLE_BLOCK] +";");
+			sqlite3_stmt *blockConistencyCheck = prepare("SELECT source_id, timestamp, sequencenumber, fragmentoffset, filename, ordernumber FROM "+ _tables[SQL_TABLE_BLOCK] +" WHERE filename != '';");
 
 			while (sqlite3_step(blockConistencyCheck) == SQLITE_ROW)
 			{
@@ -533,14 +806,16 @@ namespace dtn
 			size_t stmt_key = BUNDLE_GET_ID;
 			if (id.fragment) stmt_key = FRAGMENT_GET_ID;
 
+			Reader r(*this);
+
 			// lock the prepared statement
-			AutoResetLock l(_locks[stmt_key], _statements[stmt_key]);
+			AutoResetLock l(r.lock(stmt_key), r[stmt_key]);
 
 			// bind bundle id to the statement
-			set_bundleid(_statements[stmt_key], id);
+			set_bundleid(r[stmt_key], id);
 
 			// execute the query and check for error
-			if (sqlite3_step(_statements[stmt_key]) != SQLITE_ROW)
+			if (sqlite3_step(r[stmt_key]) != SQLITE_ROW)
 			{
 				stringstream error;
 				error << "SQLiteBundleStorage: No Bundle found with BundleID: " << id.toString();
@@ -549,7 +824,7 @@ namespace dtn
 			}
 
 			// query bundle data
-			get(_statements[stmt_key], bundle);
+			get(r[stmt_key], bundle);
 
 			return bundle;
 		}
@@ -604,6 +879,7 @@ namespace dtn
 
 		const std::list<dtn::data::MetaBundle> SQLiteBundleStorage::get(BundleFilterCallback &cb)
 		{
+			Metrics::Measurement m(_query_select);
 			std::list<dtn::data::MetaBundle> ret;
 
 			const std::string base_query =
@@ -611,11 +887,16 @@ namespace dtn
 
 			sqlite3_stmt *st = NULL;
 			size_t bind_offset = 1;
+			bool generic = false;
+
+			Reader r(*this);
 
 			try {
 				SQLBundleQuery &query = dynamic_cast<SQLBundleQuery&>(cb);
 
-				if (query._statement == NULL)
+				// statements of the query object belong to the main connection,
+				// a pooled connection caches its own statement of the query
+				if (r.pooled() || (query._statement == NULL))
 				{
 					std::string sql = base_query + " WHERE " + query.getWhere() + " ORDER BY priority DESC";
 
@@ -627,29 +908,37 @@ namespace dtn
 					// add closing delimiter
 					sql += ";";
 
-					// prepare the hole statement
-					query._statement = prepare(sql);
+					if (r.pooled())
+					{
+						st = r.prepare(sql);
+					}
+					else
+					{
+						// prepare the hole statement
+						query._statement = prepare(sql);
+					}
 				}
 
-				st = query._statement;
+				if (!r.pooled()) st = query._statement;
 				bind_offset = query.bind(st, 1);
 			} catch (const std::bad_cast&) {
 				// this query is not optimized for sql, use the generic way (slow)
-				st = _statements[BUNDLE_GET_FILTER];
+				st = r[BUNDLE_GET_FILTER];
+				generic = true;
 			};
 
 			size_t offset = 0;
 			while (true)
 			{
 				// lock the database
-				AutoResetLock l(_locks[BUNDLE_GET_FILTER], st);
+				AutoResetLock l(r.lock(BUNDLE_GET_FILTER), st);
 
 				if (cb.limit() > 0)
 				{
 					sqlite3_bind_int64(st, bind_offset, offset);
 					sqlite3_bind_int64(st, bind_offset + 1, cb.limit());
 				}
-				else if (st == _statements[BUNDLE_GET_FILTER])
+				else if (generic)
 				{
 					sqlite3_bind_int64(st, bind_offset, offset);
 					sqlite3_bind_int64(st, bind_offset + 1, 10);
@@ -699,7 +988,7 @@ namespace dtn
 					// abort if enough bundles are found
 					if (ret.size() >= cb.limit()) break;
 				}
-				else if (st == _statements[BUNDLE_GET_FILTER])
+				else if (generic)
 				{
 					if (cb.limit() == 0)
 					{
@@ -717,6 +1006,7 @@ namespace dtn
 
 		dtn::data::Bundle SQLiteBundleStorage::get(const dtn::data::BundleID &id)
 		{
+			Metrics::Measurement m(_query_get);
 			dtn::data::Bundle bundle;
 			int err = 0;
 
@@ -728,25 +1018,27 @@ namespace dtn
 			size_t stmt_key = BUNDLE_GET_ID;
 			if (id.fragment) stmt_key = FRAGMENT_GET_ID;
 
+			Reader r(*this);
+
 			// do this while db is locked
-			AutoResetLock l(_locks[stmt_key], _statements[stmt_key]);
+			AutoResetLock l(r.lock(stmt_key), r[stmt_key]);
 
 			// set the bundle key values
-			set_bundleid(_statements[stmt_key], id);
+			set_bundleid(r[stmt_key], id);
 
 			// execute the query and check for error
-			if ((err = sqlite3_step(_statements[stmt_key])) != SQLITE_ROW)
+			if ((err = sqlite3_step(r[stmt_key])) != SQLITE_ROW)
 			{
 				IBRCOMMON_LOGGER_DEBUG(15) << "sql error: " << err << "; No bundle found with id: " << id.toString() << IBRCOMMON_LOGGER_ENDL;
 				throw dtn::core::BundleStorage::NoBundleFoundException();
 			}
 
 			// read bundle data
-			get(_statements[stmt_key], bundle);
+			get(r[stmt_key], bundle);
 
 			try {
 				// read all blocks
-				get_blocks(bundle, id);
+				get_blocks(r, bundle, id);
 			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER(error) << "could not get bundle blocks: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 				throw dtn::core::BundleStorage::NoBundleFoundException();
@@ -800,6 +1092,32 @@ namespace dtn
 #endif
 
 		void SQLiteBundleStorage::store(const dtn::data::Bundle &bundle)
+		{
+			Metrics::Measurement m(_query_store);
+			// without reader pool the bundle is stored in the context of the caller
+			if (_readers.empty())
+			{
+				store_bundle(bundle);
+				return;
+			}
+
+			// hand over the bundle to the writer thread and wait until it is stored
+			TaskStore task(bundle);
+			_tasks.push(&task);
+
+			try {
+				task.wait();
+			} catch (const ibrcommon::Exception&) {
+				throw SQLiteQueryException("SQLiteBundleStorage: store() failed");
+			}
+		}
+
+		void SQLiteBundleStorage::TaskStore::run(SQLiteBundleStorage &storage)
+		{
+			storage.store_bundle(_bundle);
+		}
+
+		void SQLiteBundleStorage::store_bundle(const dtn::data::Bundle &bundle)
 		{
 			IBRCOMMON_LOGGER_DEBUG(25) << "store bundle " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
 
@@ -913,8 +1231,13 @@ namespace dtn
 				// step through all blocks
 				while (sqlite3_step(storage._statements[stmt_key]) == SQLITE_ROW)
 				{
+					const std::string filename( (const char*)sqlite3_column_text(storage._statements[stmt_key], 0) );
+
+					// blocks stored in the database are deleted with the bundle
+					if (filename.length() == 0) continue;
+
 					// delete each referenced block file
-					ibrcommon::File blockfile( (const char*)sqlite3_column_text(storage._statements[stmt_key], 0) );
+					ibrcommon::File blockfile( filename );
 					blockfile.remove();
 				}
 			}
@@ -1149,9 +1472,10 @@ namespace dtn
 
 		bool SQLiteBundleStorage::empty()
 		{
-			AutoResetLock l(_locks[EMPTY_CHECK], _statements[EMPTY_CHECK]);
+			Reader r(*this);
+			AutoResetLock l(r.lock(EMPTY_CHECK), r[EMPTY_CHECK]);
 
-			if (SQLITE_DONE == sqlite3_step(_statements[EMPTY_CHECK]))
+			if (SQLITE_DONE == sqlite3_step(r[EMPTY_CHECK]))
 			{
 				return true;
 			}
@@ -1166,16 +1490,17 @@ namespace dtn
 			int rows = 0;
 			int err = 0;
 
-			AutoResetLock l(_locks[COUNT_ENTRIES], _statements[COUNT_ENTRIES]);
+			Reader r(*this);
+			AutoResetLock l(r.lock(COUNT_ENTRIES), r[COUNT_ENTRIES]);
 
-			if ((err = sqlite3_step(_statements[COUNT_ENTRIES])) == SQLITE_ROW)
+			if ((err = sqlite3_step(r[COUNT_ENTRIES])) == SQLITE_ROW)
 			{
-				rows = sqlite3_column_int(_statements[COUNT_ENTRIES], 0);
+				rows = sqlite3_column_int(r[COUNT_ENTRIES], 0);
 			}
 			else
 			{
 				stringstream error;
-				error << "SQLiteBundleStorage: count: failure " << err << " " << sqlite3_errmsg(_database);
+				error << "SQLiteBundleStorage: count: failure " << err << " " << sqlite3_errmsg(r.database());
 				IBRCOMMON_LOGGER(error) << error.str() << IBRCOMMON_LOGGER_ENDL;
 				throw SQLiteQueryException(error.str());
 			}
@@ -1607,60 +1932,104 @@ namespace dtn
 				const dtn::data::Block &block = (**it);
 				blocktyp = (int)block.getType();
 
-				ibrcommon::TemporaryFile tmpfile(_blockPath, "block");
+				std::stringstream data;
+				dtn::data::SeparateSerializer serializer(data);
+				const size_t length = serializer.getLength(block);
 
-				try {
-					try {
-						const dtn::data::PayloadBlock &payload = dynamic_cast<const dtn::data::PayloadBlock&>(block);
-						ibrcommon::BLOB::Reference ref = payload.getBLOB();
-						ibrcommon::BLOB::iostream stream = ref.iostream();
+				// small blocks are stored in the database, but the age of an
+				// AgeBlock is derived from the times of its file
+				const bool indb = (length <= _blob_limit) && (blocktyp != dtn::data::AgeBlock::BLOCK_TYPE);
 
-						const SQLiteBLOB &blob = dynamic_cast<const SQLiteBLOB&>(*ref);
+				// the filename of the block data, empty if the block is stored in the database
+				std::string filename;
 
-						// first remove the tmp file
-						tmpfile.remove();
+				if (!indb)
+				{
+					ibrcommon::TemporaryFile tmpfile(_blockPath, "block");
 
-						// make a hardlink to the origin blob file
-						if ( ::link(blob._file.getPath().c_str(), tmpfile.getPath().c_str()) != 0 )
-						{
-							tmpfile = ibrcommon::TemporaryFile(_blockPath, "block");
-							throw ibrcommon::Exception("hard-link failed");
+					try {
+						try {
+							const dtn::data::PayloadBlock &payload = dynamic_cast<const dtn::data::PayloadBlock&>(block);
+							ibrcommon::BLOB::Reference ref = payload.getBLOB();
+							ibrcommon::BLOB::iostream stream = ref.iostream();
+
+							const SQLiteBLOB &blob = dynamic_cast<const SQLiteBLOB&>(*ref);
+
+							// first remove the tmp file
+							tmpfile.remove();
+
+							// make a hardlink to the origin blob file
+							if ( ::link(blob._file.getPath().c_str(), tmpfile.getPath().c_str()) != 0 )
+							{
+								tmpfile = ibrcommon::TemporaryFile(_blockPath, "block");
+								throw ibrcommon::Exception("hard-link failed");
+							}
+						} catch (const std::bad_cast&) {
+							throw ibrcommon::Exception("not a Payload or SQLiteBLOB");
 						}
-					} catch (const std::bad_cast&) {
-						throw ibrcommon::Exception("not a Payload or SQLiteBLOB");
+
+						storedBytes += _blockPath.size();
+					} catch (const ibrcommon::Exception&) {
+						std::ofstream filestream(tmpfile.getPath().c_str(), std::ios_base::out | std::ios::binary);
+						dtn::data::SeparateSerializer serializer(filestream);
+						serializer << block;
+						storedBytes += serializer.getLength(block);
+						filestream.close();
 					}
 
-					storedBytes += _blockPath.size();
-				} catch (const ibrcommon::Exception&) {
-					std::ofstream filestream(tmpfile.getPath().c_str(), std::ios_base::out | std::ios::binary);
-					dtn::data::SeparateSerializer serializer(filestream);
-					serializer << block;
-					storedBytes += serializer.getLength(block);
-					filestream.close();
+					filename = tmpfile.getPath();
+				}
+				else
+				{
+					storedBytes += length;
 				}
 
-				// protect this query from concurrent access and enable the auto-reset feature
-				AutoResetLock l(_locks[BLOCK_STORE], _statements[BLOCK_STORE]);
+				{
+					// protect this query from concurrent access and enable the auto-reset feature
+					AutoResetLock l(_locks[BLOCK_STORE], _statements[BLOCK_STORE]);
 
-				// set bundle key data
-				set_bundleid(_statements[BLOCK_STORE], id);
+					// set bundle key data
+					set_bundleid(_statements[BLOCK_STORE], id);
 
-				// set the column four to null if this is not a fragment
-				if (!id.fragment) sqlite3_bind_null(_statements[BLOCK_STORE], 4);
+					// set the column four to null if this is not a fragment
+					if (!id.fragment) sqlite3_bind_null(_statements[BLOCK_STORE], 4);
 
-				// set the block type
-				sqlite3_bind_int(_statements[BLOCK_STORE], 5, blocktyp);
+					// set the block type
+					sqlite3_bind_int(_statements[BLOCK_STORE], 5, blocktyp);
 
-				// the filename of the block data
-				sqlite3_bind_text(_statements[BLOCK_STORE], 6, tmpfile.getPath().c_str(), tmpfile.getPath().size(), SQLITE_TRANSIENT);
+					// the filename of the block data
+					sqlite3_bind_text(_statements[BLOCK_STORE], 6, filename.c_str(), filename.size(), SQLITE_TRANSIENT);
 
-				// the ordering number
-				sqlite3_bind_int(_statements[BLOCK_STORE], 7, blocknumber);
+					// the ordering number
+					sqlite3_bind_int(_statements[BLOCK_STORE], 7, blocknumber);
 
-				// execute the query and store the block in the database
-				if (sqlite3_step(_statements[BLOCK_STORE]) != SQLITE_DONE)
+					if (!indb)
+					{
+						sqlite3_bind_null(_statements[BLOCK_STORE], 8);
+					}
+					else if (length <= _inline_limit)
+					{
+						// store the block data as part of the record
+						serializer << block;
+						const std::string buf = data.str();
+						sqlite3_bind_blob(_statements[BLOCK_STORE], 8, buf.data(), buf.size(), SQLITE_TRANSIENT);
+					}
+					else
+					{
+						// reserve the space for the block, the data is streamed into it
+						sqlite3_bind_zeroblob(_statements[BLOCK_STORE], 8, length);
+					}
+
+					// execute the query and store the block in the database
+					if (sqlite3_step(_statements[BLOCK_STORE]) != SQLITE_DONE)
+					{
+						throw SQLiteQueryException("can not store block of bundle");
+					}
+				}
+
+				if (indb && (length > _inline_limit))
 				{
-					throw SQLiteQueryException("can not store block of bundle");
+					stream_block(id, blocknumber, block);
 				}
 
 				//increment blocknumber
@@ -1670,7 +2039,45 @@ namespace dtn
 			return storedBytes;
 		}
 
-		void SQLiteBundleStorage::get_blocks(dtn::data::Bundle &bundle, const dtn::data::BundleID &id)
+		void SQLiteBundleStorage::stream_block(const dtn::data::BundleID &id, const int blocknumber, const dtn::data::Block &block)
+		{
+			sqlite3_int64 key = 0;
+
+			{
+				AutoResetLock l(_locks[BLOCK_GET_KEY], _statements[BLOCK_GET_KEY]);
+
+				set_bundleid(_statements[BLOCK_GET_KEY], id);
+				if (!id.fragment) sqlite3_bind_null(_statements[BLOCK_GET_KEY], 4);
+				sqlite3_bind_int(_statements[BLOCK_GET_KEY], 5, blocknumber);
+
+				if (sqlite3_step(_statements[BLOCK_GET_KEY]) != SQLITE_ROW)
+				{
+					throw SQLiteQueryException("can not find the record of the block");
+				}
+
+				key = sqlite3_column_int64(_statements[BLOCK_GET_KEY], 0);
+			}
+
+			sqlite3_blob *blob = NULL;
+			if (sqlite3_blob_open(_database, "main", _tables[SQL_TABLE_BLOCK].c_str(), "data", key, 1, &blob) != SQLITE_OK)
+			{
+				IBRCOMMON_LOGGER(error) << "stream_block() failure: " << sqlite3_errmsg(_database) << IBRCOMMON_LOGGER_ENDL;
+				throw SQLiteQueryException("can not open the block data");
+			}
+
+			BlobStreamBuf buf(blob);
+			std::ostream stream(&buf);
+
+			dtn::data::SeparateSerializer(stream) << block;
+			stream.flush();
+
+			if (!stream.good())
+			{
+				throw SQLiteQueryException("can not write the block data");
+			}
+		}
+
+		void SQLiteBundleStorage::get_blocks(const Reader &r, dtn::data::Bundle &bundle, const dtn::data::BundleID &id)
 		{
 			int err = 0;
 			string file;
@@ -1678,16 +2085,46 @@ namespace dtn
 			// select the right statement to use
 			const size_t stmt_key = id.fragment ? BLOCK_GET_ID_FRAGMENT : BLOCK_GET_ID;
 
-			AutoResetLock l(_locks[stmt_key], _statements[stmt_key]);
+			AutoResetLock l(r.lock(stmt_key), r[stmt_key]);
 
 			// set the bundle key values
-			set_bundleid(_statements[stmt_key], id);
+			set_bundleid(r[stmt_key], id);
 
 			// query the database and step through all blocks
-			while ((err = sqlite3_step(_statements[stmt_key])) == SQLITE_ROW)
+			while ((err = sqlite3_step(r[stmt_key])) == SQLITE_ROW)
 			{
-				const ibrcommon::File f( (const char*) sqlite3_column_text(_statements[stmt_key], 0) );
-				int blocktyp = sqlite3_column_int(_statements[stmt_key], 1);
+				const std::string filename( (const char*) sqlite3_column_text(r[stmt_key], 0) );
+
+				// the block is stored in the database
+				if (filename.length() == 0)
+				{
+					if (sqlite3_column_type(r[stmt_key], 3) != SQLITE_NULL)
+					{
+						// small blocks are returned by the query
+						const std::string data( (const char*) sqlite3_column_blob(r[stmt_key], 3), sqlite3_column_bytes(r[stmt_key], 3) );
+						std::istringstream is(data);
+						dtn::data::SeparateDeserializer(is, bundle).readBlock();
+					}
+					else
+					{
+						// larger blocks are streamed out of the database
+						sqlite3_blob *blob = NULL;
+						if (sqlite3_blob_open(r.database(), "main", _tables[SQL_TABLE_BLOCK].c_str(), "data", sqlite3_column_int64(r[stmt_key], 2), 0, &blob) != SQLITE_OK)
+						{
+							IBRCOMMON_LOGGER(error) << "get_blocks() failure: " << sqlite3_errmsg(r.database()) << IBRCOMMON_LOGGER_ENDL;
+							throw SQLiteQueryException("can not open the block data");
+						}
+
+						BlobStreamBuf buf(blob);
+						std::istream is(&buf);
+						dtn::data::SeparateDeserializer(is, bundle).readBlock();
+					}
+
+					continue;
+				}
+
+				const ibrcommon::File f( filename );
+				int blocktyp = sqlite3_column_int(r[stmt_key], 1);
 
 				// open the file
 				std::ifstream is(f.getPath().c_str(), std::ios::binary | std::ios::in);
@@ -1745,7 +2182,7 @@ namespace dtn
 			}
 			else
 			{
-				IBRCOMMON_LOGGER(error) << "get_blocks() failure: "<< err << " " << sqlite3_errmsg(_database) << IBRCOMMON_LOGGER_ENDL;
+				IBRCOMMON_LOGGER(error) << "get_blocks() failure: "<< err << " " << sqlite3_errmsg(r.database()) << IBRCOMMON_LOGGER_ENDL;
 				throw SQLiteQueryException("can not query for blocks");
 			}
 		}
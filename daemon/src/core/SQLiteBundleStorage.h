@@ -14,6 +14,7 @@
 #include "EventReceiver.h"
 #include "core/BundleStorage.h"
 #include "core/EventReceiver.h"
+#include "core/Metrics.h"
 #include <ibrdtn/data/MetaBundle.h>
 
 #include <ibrcommon/thread/Thread.h>
@@ -25,6 +26,9 @@
 #include <string>
 #include <list>
 #include <set>
+#include <map>
+#include <vector>
+#include <streambuf>
 
 //#define SQLITE_STORAGE_EXTENDED 1
 
@@ -77,6 +81,7 @@ namespace dtn
 				BLOCK_GET_FRAGMENT,
 				BLOCK_CLEAR,
 				BLOCK_STORE,
+				BLOCK_GET_KEY,
 
 #ifdef SQLITE_STORAGE_EXTENDED
 				ROUTING_GET,
@@ -157,14 +162,29 @@ namespace dtn
 			 * @param Pfad zum Ordner in denen die Datein gespeichert werden.
 			 * @param Dateiname der Datenbank
 			 * @param maximale Größe der Datenbank
+			 * @param readers Number of read-only connections. If greater than zero, the
+			 *   database is switched to WAL journaling, all writes are serialized through
+			 *   the write queue and queries run concurrently on the read-only connections.
 			 */
-			SQLiteBundleStorage(const ibrcommon::File &path, const size_t &size);
+			SQLiteBundleStorage(const ibrcommon::File &path, const size_t &size, const size_t readers = 0);
 
 			/**
 			 * destructor
 			 */
 			virtual ~SQLiteBundleStorage();
 
+			// default size limits of blocks stored in the database
+			static const size_t DEFAULT_INLINE_LIMIT = 1024;
+			static const size_t DEFAULT_BLOB_LIMIT = 65536;
+
+			/**
+			 * Define where blocks are stored. Blocks up to inline_limit bytes are
+			 * stored in the block table, blocks up to blob_limit bytes are streamed
+			 * into the block table and larger blocks are stored as files.
+			 * This has to be done before the database is opened.
+			 */
+			void setBlockLimits(const size_t inline_limit, const size_t blob_limit);
+
 			/**
 			 * open the database
 			 */
@@ -439,6 +459,113 @@ namespace dtn
 				size_t _timestamp;
 			};
 
+			class TaskStore : public BlockingTask
+			{
+			public:
+				TaskStore(const dtn::data::Bundle &bundle)
+				 : _bundle(bundle) { };
+
+				virtual ~TaskStore() {};
+				virtual void run(SQLiteBundleStorage &storage);
+
+			private:
+				const dtn::data::Bundle &_bundle;
+			};
+
+			/**
+			 * A read-only connection of the reader pool. It holds its own set
+			 * of prepared statements and is used by one thread at a time.
+			 */
+			class ReadConnection
+			{
+			public:
+				ReadConnection(const ibrcommon::File &path, const size_t inline_limit);
+				~ReadConnection();
+
+				/**
+				 * Returns a prepared statement for a custom query. The statement
+				 * is compiled once and cached for the lifetime of the connection.
+				 */
+				sqlite3_stmt* prepare(const std::string &query);
+
+				sqlite3 *_database;
+				sqlite3_stmt* _statements[SQL_QUERIES_END];
+				ibrcommon::Mutex _locks[SQL_QUERIES_END];
+
+			private:
+				std::map<std::string, sqlite3_stmt*> _queries;
+			};
+
+			/**
+			 * Provides the statements for a read operation. With an enabled reader pool
+			 * a connection is leased for the lifetime of this object, otherwise the
+			 * statements of the main connection are used.
+			 */
+			class Reader
+			{
+			public:
+				Reader(SQLiteBundleStorage &storage);
+				~Reader();
+
+				/**
+				 * @return True, if a connection of the reader pool is used.
+				 */
+				bool pooled() const;
+
+				sqlite3* database() const;
+				sqlite3_stmt* operator[](const size_t key) const;
+				ibrcommon::Mutex& lock(const size_t key) const;
+
+				/**
+				 * Returns the cached statement of a custom query. Only available
+				 * if a connection of the reader pool is used.
+				 */
+				sqlite3_stmt* prepare(const std::string &query) const;
+
+			private:
+				SQLiteBundleStorage &_storage;
+				ReadConnection *_conn;
+			};
+
+			/**
+			 * Lease a connection of the reader pool. Blocks until a connection is available.
+			 * @return NULL, if the reader pool is disabled.
+			 */
+			ReadConnection* lease();
+			void release(ReadConnection *conn);
+
+			/**
+			 * Stores a bundle using the main connection. This is called by the
+			 * writer thread if the reader pool is enabled.
+			 */
+			void store_bundle(const dtn::data::Bundle &bundle);
+
+			/**
+			 * Stream buffer for the incremental I/O of a BLOB column. The buffer
+			 * is used either for reading or for writing.
+			 */
+			class BlobStreamBuf : public std::streambuf
+			{
+			public:
+				BlobStreamBuf(sqlite3_blob *blob);
+				virtual ~BlobStreamBuf();
+
+			protected:
+				virtual int overflow(int c);
+				virtual int underflow();
+				virtual int sync();
+				virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which);
+				virtual std::streampos seekpos(std::streampos pos, std::ios_base::openmode which);
+
+			private:
+				static const size_t BUFFER_SIZE = 4096;
+
+				sqlite3_blob *_blob;
+				int _size;
+				int _offset;
+				char _buffer[BUFFER_SIZE];
+			};
+
 			/**
 			 * A SQLiteBLOB is container for large amount of data. Stored in the database
 			 * working directory.
@@ -512,10 +639,19 @@ namespace dtn
 
 			/**
 			 * Reads the Blocks from the belonging to the ID and adds them to the bundle. The caller of this function has to have the Lock for the database.
+			 * @param The connection to read from
 			 * @param Bundle where the Blocks should be added
 			 * @param The BundleID for which the Blocks should be read
 			 */
-			void get_blocks(dtn::data::Bundle &bundle, const dtn::data::BundleID &id);
+			void get_blocks(const Reader &reader, dtn::data::Bundle &bundle, const dtn::data::BundleID &id);
+
+			/**
+			 * Streams a block into the reserved data column of its record.
+			 * @param The BundleID the block belongs to
+			 * @param The ordering number of the block
+			 * @param The block to store
+			 */
+			void stream_block(const dtn::data::BundleID &id, const int blocknumber, const dtn::data::Block &block);
 
 			/**
 			 * Checks the files on the filesystem against the filenames in the database
@@ -559,6 +695,15 @@ namespace dtn
 
 			int dbSize;
 
+			// size limits of blocks stored in the database
+			size_t _inline_limit;
+			size_t _blob_limit;
+
+			// time spent in the queries of the storage
+			dtn::core::Metrics::Histogram &_query_get;
+			dtn::core::Metrics::Histogram &_query_select;
+			dtn::core::Metrics::Histogram &_query_store;
+
 			// holds the database handle
 			sqlite3 *_database;
 
@@ -574,6 +719,12 @@ namespace dtn
 			// array of locks for each statement
 			ibrcommon::Mutex _locks[SQL_QUERIES_END];
 
+			// pool of read-only connections
+			const size_t _reader_count;
+			std::vector<ReadConnection*> _readers;
+			std::list<ReadConnection*> _readers_idle;
+			ibrcommon::Conditional _readers_cond;
+
 			void add_deletion(const dtn::data::BundleID &id);
 			void remove_deletion(const dtn::data::BundleID &id);
 			bool contains_deletion(const dtn::data::BundleID &id);
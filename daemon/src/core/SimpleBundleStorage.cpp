@@ -286,7 +286,8 @@ namespace dtn
 				try {
 					dtn::data::EID custodian = BundleStorage::acceptCustody(bundle);
 
-					// container for the custody accepted bundle
+					// container for the custody accepted bundle, the copy shares
+					// the blocks with the received bundle
 					dtn::data::Bundle ca_bundle = bundle;
 
 					// set the new custodian
@@ -296,11 +297,11 @@ namespace dtn
 					meta = ca_bundle;
 
 					// add the bundle to the stored bundles
-					_pending_bundles[hash] = ca_bundle;
+					setPending(hash, ca_bundle);
 				} catch (const ibrcommon::Exception&) {
 					// no custody requested
 					// add the bundle to the stored bundles
-					_pending_bundles[hash] = bundle;
+					setPending(hash, bundle);
 				}
 
 				// increment the storage size
@@ -316,6 +317,15 @@ namespace dtn
 			_datastore.store(hash, bc);
 		}
 
+		void SimpleBundleStorage::setPending(const DataStorage::Hash &hash, const dtn::data::Bundle &bundle)
+		{
+			// insert a copy without constructing an empty bundle first
+			std::pair<std::map<DataStorage::Hash, dtn::data::Bundle>::iterator, bool> ret =
+					_pending_bundles.insert(std::make_pair(hash, bundle));
+
+			if (!ret.second) ret.first->second = bundle;
+		}
+
 		void SimpleBundleStorage::remove(const dtn::data::BundleID &id)
 		{
 			ibrcommon::MutexLock l(_bundleslock);
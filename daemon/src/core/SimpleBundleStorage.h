@@ -144,6 +144,12 @@ namespace dtn
 
 			dtn::data::Bundle __get(const dtn::data::MetaBundle&);
 
+			/**
+			 * Put a bundle into the list of bundles not written yet.
+			 * The lock of the bundle lists has to be held by the caller.
+			 */
+			void setPending(const DataStorage::Hash &hash, const dtn::data::Bundle &bundle);
+
 			// This object manage data stored on disk
 			DataStorage _datastore;
 
@@ -0,0 +1,267 @@
+/*
+ * Tracer.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "core/Tracer.h"
+#include "core/Metrics.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <map>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * A copy of a record taken while the ring buffer is written.
+		 */
+		struct TraceRecord
+		{
+			u_int64_t time;
+			Tracer::Stage stage;
+
+			bool operator<(const TraceRecord &other) const
+			{
+				if (time != other.time) return (time < other.time);
+				return (stage < other.stage);
+			}
+		};
+
+		/**
+		 * Escape a string for a JSON document.
+		 */
+		static std::string escape(const std::string &value)
+		{
+			std::string ret;
+			for (std::string::const_iterator iter = value.begin(); iter != value.end(); iter++)
+			{
+				const char c = (*iter);
+				if ((c == '"') || (c == '\\')) ret.push_back('\\');
+				if ((unsigned char)c < 0x20) continue;
+				ret.push_back(c);
+			}
+			return ret;
+		}
+
+		Tracer::Tracer()
+		 : _sampling(0), _capacity(0), _entries(NULL), _head(0)
+		{
+		}
+
+		Tracer::~Tracer()
+		{
+			delete[] _entries;
+		}
+
+		Tracer& Tracer::getInstance()
+		{
+			static Tracer instance;
+			return instance;
+		}
+
+		void Tracer::setup(size_t sampling, size_t capacity)
+		{
+			ibrcommon::MutexLock l(_lock);
+			_capacity = (capacity > 0) ? capacity : 1;
+			_sampling = 0;
+
+			delete[] _entries;
+			_entries = NULL;
+			_head = 0;
+
+			if (sampling > 0)
+			{
+				_entries = new Entry[_capacity];
+				::memset(_entries, 0, sizeof(Entry) * _capacity);
+				__sync_synchronize();
+				_sampling = sampling;
+			}
+		}
+
+		void Tracer::setSampling(size_t sampling)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			// the buffer is allocated on the first use and kept afterwards,
+			// because concurrent writers may still hold a pointer into it
+			if ((sampling > 0) && (_entries == NULL))
+			{
+				if (_capacity == 0) _capacity = 1;
+				Entry *entries = new Entry[_capacity];
+				::memset(entries, 0, sizeof(Entry) * _capacity);
+				_entries = entries;
+				__sync_synchronize();
+			}
+
+			_sampling = sampling;
+		}
+
+		size_t Tracer::getSampling() const
+		{
+			return _sampling;
+		}
+
+		bool Tracer::isSampled(const size_t timestamp, const size_t sequencenumber) const
+		{
+			const size_t sampling = _sampling;
+			if (sampling == 0) return false;
+			if (sampling == 1) return true;
+
+			// mix the fields, consecutive sequence numbers are spread over all values
+			u_int64_t h = ((u_int64_t)timestamp * 0x9E3779B97F4A7C15ULL) ^ (u_int64_t)sequencenumber;
+			h ^= (h >> 33);
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= (h >> 33);
+
+			return ((h % sampling) == 0);
+		}
+
+		void Tracer::record(const dtn::data::Bundle &b, const Stage stage, u_int64_t time)
+		{
+			if (!isSampled(b._timestamp, b._sequencenumber)) return;
+			record(dtn::data::BundleID(b), stage, time);
+		}
+
+		void Tracer::record(const dtn::data::BundleID &id, const Stage stage, u_int64_t time)
+		{
+			if (!isSampled(id.timestamp, id.sequencenumber)) return;
+			if (time == 0) time = Metrics::now();
+
+			const std::string name = id.toString();
+
+			const u_int64_t index = __sync_fetch_and_add(&_head, 1);
+			Entry &e = _entries[index % _capacity];
+
+			// mark the record as incomplete while it is written
+			e.sequence = 0;
+			__sync_synchronize();
+
+			e.time = time;
+			e.stage = stage;
+			::strncpy(e.bundle, name.c_str(), ID_LENGTH - 1);
+			e.bundle[ID_LENGTH - 1] = '\0';
+
+			__sync_synchronize();
+			e.sequence = index + 1;
+		}
+
+		void Tracer::clear()
+		{
+			ibrcommon::MutexLock l(_lock);
+			if (_entries == NULL) return;
+
+			for (size_t i = 0; i < _capacity; i++)
+			{
+				_entries[i].sequence = 0;
+			}
+		}
+
+		void Tracer::write(std::ostream &stream)
+		{
+			typedef std::map<std::string, std::vector<TraceRecord> > trace_map;
+			trace_map traces;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				for (size_t i = 0; (_entries != NULL) && (i < _capacity); i++)
+				{
+					const Entry &e = _entries[i];
+
+					const u_int64_t sequence = e.sequence;
+					if (sequence == 0) continue;
+					__sync_synchronize();
+
+					TraceRecord r;
+					r.time = e.time;
+					r.stage = e.stage;
+					char bundle[ID_LENGTH];
+					::memcpy(bundle, e.bundle, ID_LENGTH);
+					bundle[ID_LENGTH - 1] = '\0';
+
+					// skip records overwritten while they were copied
+					__sync_synchronize();
+					if (e.sequence != sequence) continue;
+
+					traces[bundle].push_back(r);
+				}
+			}
+
+			// one event per line, the output contains no empty lines
+			stream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+
+			size_t tid = 0;
+			bool first = true;
+
+			for (trace_map::iterator iter = traces.begin(); iter != traces.end(); iter++)
+			{
+				std::vector<TraceRecord> &records = iter->second;
+				std::sort(records.begin(), records.end());
+				tid++;
+
+				// name the track of the bundle
+				if (!first) stream << "," << std::endl;
+				first = false;
+				stream << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+						<< ", \"args\": {\"name\": \"" << escape(iter->first) << "\"}}";
+
+				for (std::vector<TraceRecord>::const_iterator r = records.begin(); r != records.end(); r++)
+				{
+					stream << "," << std::endl;
+
+					if (r == records.begin())
+					{
+						// the first stage is a point in time
+						stream << "{\"name\": \"" << getName((*r).stage) << "\", \"cat\": \"bundle\", \"ph\": \"i\", \"s\": \"t\", \"ts\": "
+								<< (*r).time << ", \"pid\": 1, \"tid\": " << tid << "}";
+					}
+					else
+					{
+						// the time spent until this stage is reached
+						const TraceRecord &prev = *(r - 1);
+						stream << "{\"name\": \"" << getName((*r).stage) << "\", \"cat\": \"bundle\", \"ph\": \"X\", \"ts\": "
+								<< prev.time << ", \"dur\": " << ((*r).time - prev.time) << ", \"pid\": 1, \"tid\": " << tid << "}";
+					}
+				}
+			}
+
+			if (!first) stream << std::endl;
+			stream << "]}" << std::endl;
+		}
+
+		const std::string Tracer::getName(const Stage stage)
+		{
+			switch (stage)
+			{
+			case STAGE_CL_RECEIVE_START:
+				return "cl_receive_start";
+			case STAGE_CL_RECEIVE_END:
+				return "cl_receive_end";
+			case STAGE_VALIDATED:
+				return "validated";
+			case STAGE_RECEIVED_EVENT:
+				return "received_event";
+			case STAGE_STORED:
+				return "stored";
+			case STAGE_QUEUED:
+				return "queued";
+			case STAGE_ROUTED:
+				return "routed";
+			case STAGE_TRANSFER:
+				return "transfer";
+			case STAGE_CL_SEND_START:
+				return "cl_send_start";
+			case STAGE_CL_SEND_END:
+				return "cl_send_end";
+			case STAGE_ACK:
+				return "ack";
+			}
+
+			return "unknown";
+		}
+	}
+}
@@ -0,0 +1,124 @@
+/*
+ * Tracer.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <sys/types.h>
+#include <iostream>
+#include <string>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Records the time a sampled bundle passes each stage of the daemon.
+		 *
+		 * The records are written into a ring buffer of fixed size without
+		 * taking a lock; old records are overwritten. A bundle is sampled by
+		 * its id, thus the decision is the same at every stage and no state
+		 * per bundle is kept. The buffer can be written as Chrome trace JSON
+		 * (chrome://tracing or Perfetto), with one track per bundle and one
+		 * slice for the time spent before each stage.
+		 *
+		 * Tracing is disabled with a sampling interval of zero. Then each
+		 * call costs a single comparison.
+		 */
+		class Tracer
+		{
+		public:
+			enum Stage
+			{
+				STAGE_CL_RECEIVE_START = 0,
+				STAGE_CL_RECEIVE_END = 1,
+				STAGE_VALIDATED = 2,
+				STAGE_RECEIVED_EVENT = 3,
+				STAGE_STORED = 4,
+				STAGE_QUEUED = 5,
+				STAGE_ROUTED = 6,
+				STAGE_TRANSFER = 7,
+				STAGE_CL_SEND_START = 8,
+				STAGE_CL_SEND_END = 9,
+				STAGE_ACK = 10
+			};
+
+			/**
+			 * Maximum length of the bundle id stored in each record.
+			 */
+			static const size_t ID_LENGTH = 96;
+
+			static Tracer& getInstance();
+
+			/**
+			 * Set up the ring buffer. This must be called before the
+			 * first record is written.
+			 * @param sampling Trace one of each n bundles, zero disables tracing.
+			 * @param capacity Number of records in the ring buffer.
+			 */
+			void setup(size_t sampling, size_t capacity);
+
+			/**
+			 * Change the sampling interval at runtime.
+			 * @param sampling Trace one of each n bundles, zero disables tracing.
+			 */
+			void setSampling(size_t sampling);
+
+			size_t getSampling() const;
+
+			/**
+			 * Returns true, if the bundle with the given timestamp and
+			 * sequence number is traced.
+			 */
+			bool isSampled(const size_t timestamp, const size_t sequencenumber) const;
+
+			/**
+			 * Record a stage of a bundle.
+			 * @param time Time of the stage, see Metrics::now(). Zero is the current time.
+			 */
+			void record(const dtn::data::BundleID &id, const Stage stage, u_int64_t time = 0);
+			void record(const dtn::data::Bundle &b, const Stage stage, u_int64_t time = 0);
+
+			/**
+			 * Remove all records.
+			 */
+			void clear();
+
+			/**
+			 * Write all records in the Chrome trace event format.
+			 */
+			void write(std::ostream &stream);
+
+			static const std::string getName(const Stage stage);
+
+		private:
+			Tracer();
+			virtual ~Tracer();
+
+			struct Entry
+			{
+				// index of the record plus one, zero while it is written
+				volatile u_int64_t sequence;
+				u_int64_t time;
+				Stage stage;
+				char bundle[ID_LENGTH];
+			};
+
+			// protects the allocation of the ring buffer
+			ibrcommon::Mutex _lock;
+
+			volatile size_t _sampling;
+			size_t _capacity;
+			Entry *_entries;
+			volatile u_int64_t _head;
+		};
+	}
+}
+
+#endif /* TRACER_H_ */
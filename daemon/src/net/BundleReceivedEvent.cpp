@@ -7,16 +7,19 @@
 
 #include "net/BundleReceivedEvent.h"
 #include "core/BundleCore.h"
+#include "core/ReceivePipeline.h"
+#include "core/Metrics.h"
+#include "core/Tracer.h"
 #include <ibrcommon/Logger.h>
 
 namespace dtn
 {
 	namespace net
 	{
-		BundleReceivedEvent::BundleReceivedEvent(const dtn::data::EID &p, const dtn::data::Bundle &b, const bool &local)
-		 : Event(-1), peer(p), bundle(b), fromlocal(local)
+		BundleReceivedEvent::BundleReceivedEvent(const dtn::data::EID &p, const dtn::data::Bundle &b, const bool &local, const u_int64_t r, const bool v)
+		 : Event(-1), peer(p), bundle(b), fromlocal(local), received(r), verified(v)
 		{
-
+			dtn::core::Tracer::getInstance().record(b, dtn::core::Tracer::STAGE_RECEIVED_EVENT);
 		}
 
 		BundleReceivedEvent::~BundleReceivedEvent()
@@ -26,8 +29,17 @@ namespace dtn
 
 		void BundleReceivedEvent::raise(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local, const bool &wait)
 		{
+			// hand over the bundle to the receive pipeline if enabled
+			if (dtn::core::ReceivePipeline::getInstance().push(peer, bundle, local)) return;
+
 			// raise the new event
-			dtn::core::Event::raiseEvent( new BundleReceivedEvent(peer, bundle, local), wait );
+			dtn::core::Event::raiseEvent( new BundleReceivedEvent(peer, bundle, local, dtn::core::Metrics::now(), false), wait );
+		}
+
+		void BundleReceivedEvent::dispatch(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local, const u_int64_t received, const bool verified)
+		{
+			// raise the new event and block until it is processed
+			dtn::core::Event::raiseEvent( new BundleReceivedEvent(peer, bundle, local, received, verified), true );
 		}
 
 		const string BundleReceivedEvent::getName() const
@@ -27,14 +27,31 @@ namespace dtn
 
 			static const string className;
 
+			/**
+			 * Raise a new BundleReceivedEvent. If the receive pipeline is active, the bundle
+			 * is queued in the pipeline and the event is raised once all stages are passed.
+			 */
 			static void raise(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local = false, const bool &wait = false);
 
+			/**
+			 * Raise a new BundleReceivedEvent bypassing the receive pipeline and
+			 * wait until the event has been processed.
+			 * @param verified True, if the security checks have been done already.
+			 */
+			static void dispatch(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local, const u_int64_t received, const bool verified);
+
 			const dtn::data::EID peer;
 			const dtn::data::Bundle bundle;
 			const bool fromlocal;
 
+			// time of the reception, see dtn::core::Metrics::now()
+			const u_int64_t received;
+
+			// the security checks have been done by the receive pipeline
+			const bool verified;
+
 		private:
-			BundleReceivedEvent(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local);
+			BundleReceivedEvent(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const bool &local, const u_int64_t received, const bool verified);
 		};
 	}
 }
@@ -34,15 +34,17 @@ namespace dtn
 {
 	namespace net
 	{
-		struct CompareNodeDestination:
-		public std::binary_function< dtn::core::Node, dtn::data::EID, bool > {
-			bool operator() ( const dtn::core::Node &node, const dtn::data::EID &destination ) const {
-				return node.getEID() == destination;
-			}
-		};
+		ConnectionManager::NodeEntry::NodeEntry(const dtn::core::Node &n)
+		 : node(n), scheduled(0), cl(NULL), cl_revision(0)
+		{
+		}
+
+		ConnectionManager::NodeEntry::~NodeEntry()
+		{
+		}
 
 		ConnectionManager::ConnectionManager()
-		 : _shutdown(false), _next_autoconnect(0)
+		 : _shutdown(false), _cl_revision(0), _next_autoconnect(0)
 		{
 		}
 
@@ -70,6 +72,7 @@ namespace dtn
 				ibrcommon::MutexLock l(_cl_lock);
 				// clear the list of convergence layers
 				_cl.clear();
+				_cl_revision++;
 			}
 
 			unbindEvent(NodeEvent::className);
@@ -120,22 +123,7 @@ namespace dtn
 					case ConnectionEvent::CONNECTION_UP:
 					{
 						ibrcommon::MutexLock l(_node_lock);
-
-						try {
-							dtn::core::Node &n = getNode(connection.peer);
-							n += connection.node;
-
-							IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes added: " << n << IBRCOMMON_LOGGER_ENDL;
-						} catch (const ibrcommon::Exception&) {
-							_nodes.push_back(connection.node);
-
-							IBRCOMMON_LOGGER_DEBUG(56) << "New node available: " << connection.node << IBRCOMMON_LOGGER_ENDL;
-
-							// announce the new node
-							dtn::core::NodeEvent::raise(connection.node, dtn::core::NODE_AVAILABLE);
-
-						}
-
+						add(connection.node);
 						break;
 					}
 
@@ -145,10 +133,11 @@ namespace dtn
 
 						try {
 							// remove the node from the connected list
-							dtn::core::Node &n = getNode(connection.peer);
-							n -= connection.node;
+							NodeEntry &entry = getNode(connection.peer);
+							entry.node -= connection.node;
+							update(entry);
 
-							IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes removed: " << n << IBRCOMMON_LOGGER_ENDL;
+							IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes removed: " << entry.node << IBRCOMMON_LOGGER_ENDL;
 						} catch (const ibrcommon::Exception&) { };
 						break;
 					}
@@ -165,33 +154,20 @@ namespace dtn
 		void ConnectionManager::addConnection(const dtn::core::Node &n)
 		{
 			ibrcommon::MutexLock l(_node_lock);
-			try {
-				dtn::core::Node &db = getNode(n.getEID());
-
-				// add all attributes to the node in the database
-				db += n;
-
-				IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes added: " << db << IBRCOMMON_LOGGER_ENDL;
-
-			} catch (const ibrcommon::Exception&) {
-				_nodes.push_back(n);
-
-				// announce the new node
-				dtn::core::NodeEvent::raise(n, dtn::core::NODE_AVAILABLE);
-				IBRCOMMON_LOGGER_DEBUG(56) << "New node available: " << n << IBRCOMMON_LOGGER_ENDL;
-			}
+			add(n);
 		}
 
 		void ConnectionManager::removeConnection(const dtn::core::Node &n)
 		{
 			ibrcommon::MutexLock l(_node_lock);
 			try {
-				dtn::core::Node &db = getNode(n.getEID());
+				NodeEntry &entry = getNode(n.getEID());
 
 				// erase all attributes to the node in the database
-				db -= n;
+				entry.node -= n;
+				update(entry);
 
-				IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes removed: " << db << IBRCOMMON_LOGGER_ENDL;
+				IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes removed: " << entry.node << IBRCOMMON_LOGGER_ENDL;
 			} catch (const ibrcommon::Exception&) { };
 		}
 
@@ -199,6 +175,9 @@ namespace dtn
 		{
 			ibrcommon::MutexLock l(_cl_lock);
 			_cl.insert( cl );
+
+			// invalidate the selections of all nodes
+			_cl_revision++;
 		}
 
 		void ConnectionManager::discovered(const dtn::core::Node &node)
@@ -207,20 +186,49 @@ namespace dtn
 			if (node.getEID() == dtn::core::BundleCore::local) return;
 
 			ibrcommon::MutexLock l(_node_lock);
+			add(node);
+		}
 
-			try {
-				dtn::core::Node &db = getNode(node.getEID());
+		void ConnectionManager::add(const dtn::core::Node &n)
+		{
+			node_map::iterator iter = _nodes.find(n.getEID());
+
+			if (iter != _nodes.end())
+			{
+				NodeEntry &entry = iter->second;
 
 				// add all attributes to the node in the database
-				db += node;
+				entry.node += n;
+				update(entry);
 
-				IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes added: " << db << IBRCOMMON_LOGGER_ENDL;
-			} catch (const ibrcommon::Exception&) {
-				_nodes.push_back(node);
+				IBRCOMMON_LOGGER_DEBUG(56) << "Node attributes added: " << entry.node << IBRCOMMON_LOGGER_ENDL;
+			}
+			else
+			{
+				NodeEntry &entry = _nodes.insert( node_map::value_type(n.getEID(), NodeEntry(n)) ).first->second;
+				update(entry);
 
 				// announce the new node
-				dtn::core::NodeEvent::raise(node, dtn::core::NODE_AVAILABLE);
-				IBRCOMMON_LOGGER_DEBUG(56) << "New node available: " << node << IBRCOMMON_LOGGER_ENDL;
+				dtn::core::NodeEvent::raise(n, dtn::core::NODE_AVAILABLE);
+				IBRCOMMON_LOGGER_DEBUG(56) << "New node available: " << n << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		void ConnectionManager::update(NodeEntry &entry)
+		{
+			// the URIs may have changed, select the convergence layer again
+			entry.cl = NULL;
+
+			// a node without expiring attributes is checked once, because it
+			// may be empty after attributes has been removed
+			size_t next = entry.node.getExpireTime();
+			if (next == 0) next = dtn::utils::Clock::getTime();
+
+			// an earlier check covers all later expirations
+			if ((entry.scheduled == 0) || (next < entry.scheduled))
+			{
+				entry.scheduled = next;
+				_expire_queue.push( expire_entry(next, entry.node.getEID()) );
 			}
 		}
 
@@ -228,23 +236,43 @@ namespace dtn
 		{
 			ibrcommon::MutexLock l(_node_lock);
 
-			// search for outdated nodes
-			std::list<dtn::core::Node>::iterator iter = _nodes.begin();
-			while ( iter != _nodes.end() )
+			const size_t now = dtn::utils::Clock::getTime();
+
+			// process all due checks, attributes expire after their timestamp has passed
+			while (!_expire_queue.empty() && (_expire_queue.top().first < now))
 			{
-				dtn::core::Node &n = (*iter);
+				const expire_entry e = _expire_queue.top();
+				_expire_queue.pop();
+
+				node_map::iterator iter = _nodes.find(e.second);
+				if (iter == _nodes.end()) continue;
+
+				NodeEntry &entry = iter->second;
 
-				if ( n.expire() )
+				// skip checks replaced by an earlier one
+				if (entry.scheduled != e.first) continue;
+				entry.scheduled = 0;
+
+				if ( entry.node.expire() )
 				{
 					// announce the unavailable event
-					dtn::core::NodeEvent::raise(n, dtn::core::NODE_UNAVAILABLE);
+					dtn::core::NodeEvent::raise(entry.node, dtn::core::NODE_UNAVAILABLE);
 
 					// remove the element
-					_nodes.erase( iter++ );
+					_nodes.erase( iter );
 				}
 				else
 				{
-					iter++;
+					// the URIs may have changed
+					entry.cl = NULL;
+
+					// schedule the check for the next expiring attribute
+					const size_t next = entry.node.getExpireTime();
+					if (next > 0)
+					{
+						entry.scheduled = next;
+						_expire_queue.push( expire_entry(next, entry.node.getEID()) );
+					}
 				}
 			}
 		}
@@ -259,10 +287,10 @@ namespace dtn
 			if (_next_autoconnect < dtn::utils::Clock::getTime())
 			{
 				// search for non-connected but available nodes
-				ibrcommon::MutexLock l(_cl_lock);
-				for (std::list<dtn::core::Node>::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
+				ibrcommon::MutexLock l(_node_lock);
+				for (node_map::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
 				{
-					const Node &n = (*iter);
+					const Node &n = iter->second.node;
 					std::list<Node::URI> ul = n.get(Node::NODE_CONNECTED, Node::CONN_TCPIP);
 
 					if (ul.empty() && n.isAvailable())
@@ -302,24 +330,30 @@ namespace dtn
 			throw ConnectionNotAvailableException();
 		}
 
-		void ConnectionManager::queue(const dtn::core::Node &node, const ConvergenceLayer::Job &job)
+		void ConnectionManager::queue(NodeEntry &entry, const ConvergenceLayer::Job &job)
 		{
 			ibrcommon::MutexLock l(_cl_lock);
 
-			// search for the right cl
-			for (std::set<ConvergenceLayer*>::iterator iter = _cl.begin(); iter != _cl.end(); iter++)
+			// search for the right cl, if the selection is not valid anymore
+			if ((entry.cl == NULL) || (entry.cl_revision != _cl_revision))
 			{
-				ConvergenceLayer *cl = (*iter);
-				if (node.has(cl->getDiscoveryProtocol()))
-				{
-					cl->queue(node, job);
+				entry.cl = NULL;
+				entry.cl_revision = _cl_revision;
 
-					// stop here, we queued the bundle already
-					return;
+				for (std::set<ConvergenceLayer*>::iterator iter = _cl.begin(); iter != _cl.end(); iter++)
+				{
+					ConvergenceLayer *cl = (*iter);
+					if (entry.node.has(cl->getDiscoveryProtocol()))
+					{
+						entry.cl = cl;
+						break;
+					}
 				}
+
+				if (entry.cl == NULL) throw ConnectionNotAvailableException();
 			}
 
-			throw ConnectionNotAvailableException();
+			entry.cl->queue(entry.node, job);
 		}
 
 		void ConnectionManager::queue(const ConvergenceLayer::Job &job)
@@ -329,9 +363,9 @@ namespace dtn
 			if (IBRCOMMON_LOGGER_LEVEL >= 50)
 			{
 				IBRCOMMON_LOGGER_DEBUG(50) << "## node list ##" << IBRCOMMON_LOGGER_ENDL;
-				for (std::list<dtn::core::Node>::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
+				for (node_map::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
 				{
-					const dtn::core::Node &n = (*iter);
+					const dtn::core::Node &n = iter->second.node;
 					IBRCOMMON_LOGGER_DEBUG(2) << n << IBRCOMMON_LOGGER_ENDL;
 				}
 			}
@@ -339,18 +373,16 @@ namespace dtn
 			IBRCOMMON_LOGGER_DEBUG(50) << "search for node " << job._destination.getString() << IBRCOMMON_LOGGER_ENDL;
 
 			// queue to a node
-			for (std::list<dtn::core::Node>::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
+			node_map::iterator iter = _nodes.find(job._destination);
+
+			if (iter == _nodes.end())
 			{
-				const Node &n = (*iter);
-				if (n == job._destination)
-				{
-					IBRCOMMON_LOGGER_DEBUG(2) << "next hop: " << n << IBRCOMMON_LOGGER_ENDL;
-					queue(n, job);
-					return;
-				}
+				throw NeighborNotAvailableException("No active connection to this neighbor available!");
 			}
 
-			throw NeighborNotAvailableException("No active connection to this neighbor available!");
+			NodeEntry &entry = iter->second;
+			IBRCOMMON_LOGGER_DEBUG(2) << "next hop: " << entry.node << IBRCOMMON_LOGGER_ENDL;
+			queue(entry, job);
 		}
 
 		void ConnectionManager::queue(const dtn::data::EID &eid, const dtn::data::BundleID &b)
@@ -364,10 +396,10 @@ namespace dtn
 
 			std::set<dtn::core::Node> ret;
 
-			for (std::list<dtn::core::Node>::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
+			for (node_map::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
 			{
-				const Node &n = (*iter);
-				if (n.isAvailable()) ret.insert( *iter );
+				const Node &n = iter->second.node;
+				if (n.isAvailable()) ret.insert( n );
 			}
 
 			return ret;
@@ -377,13 +409,10 @@ namespace dtn
 		bool ConnectionManager::isNeighbor(const dtn::core::Node &node) const
 		{
 			// search for the node in the node list
-			for (std::list<dtn::core::Node>::const_iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
-			{
-				const Node &n = (*iter);
-				if ((n == node) && (n.isAvailable())) return true;
-			}
+			node_map::const_iterator iter = _nodes.find(node.getEID());
+			if (iter == _nodes.end()) return false;
 
-			return false;
+			return iter->second.node.isAvailable();
 		}
 
 		const std::string ConnectionManager::getName() const
@@ -391,13 +420,10 @@ namespace dtn
 			return "ConnectionManager";
 		}
 
-		dtn::core::Node& ConnectionManager::getNode(const dtn::data::EID &eid)
+		ConnectionManager::NodeEntry& ConnectionManager::getNode(const dtn::data::EID &eid)
 		{
-			for (std::list<dtn::core::Node>::iterator iter = _nodes.begin(); iter != _nodes.end(); iter++)
-			{
-				dtn::core::Node &n = (*iter);
-				if (n == eid) return n;
-			}
+			node_map::iterator iter = _nodes.find(eid);
+			if (iter != _nodes.end()) return iter->second;
 
 			throw ibrcommon::Exception("neighbor not found");
 		}
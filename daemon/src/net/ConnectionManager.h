@@ -17,6 +17,9 @@
 #include <ibrcommon/Exceptions.h>
 
 #include <set>
+#include <map>
+#include <queue>
+#include <vector>
 
 namespace dtn
 {
@@ -97,10 +100,47 @@ namespace dtn
 			virtual void componentDown();
 
 		private:
+			/**
+			 * A known node together with its cached state.
+			 */
+			class NodeEntry
+			{
+			public:
+				NodeEntry(const dtn::core::Node &n);
+				~NodeEntry();
+
+				dtn::core::Node node;
+
+				// time of the scheduled expiration check, zero if none is scheduled
+				size_t scheduled;
+
+				// convergence layer selected for this node, NULL if not selected yet
+				ConvergenceLayer *cl;
+
+				// revision of the convergence layer set the selection is based on
+				size_t cl_revision;
+			};
+
+			typedef std::map<dtn::data::EID, NodeEntry> node_map;
+			typedef std::pair<size_t, dtn::data::EID> expire_entry;
+			typedef std::priority_queue<expire_entry, std::vector<expire_entry>, std::greater<expire_entry> > expire_queue;
+
+			/**
+			 * add the attributes of a node to the database and announce
+			 * the node if it is new
+			 */
+			void add(const dtn::core::Node &n);
+
+			/**
+			 * invalidate the cached state of a node after its attributes
+			 * has been changed and schedule the next expiration check
+			 */
+			void update(NodeEntry &entry);
+
 			/**
 			 *  queue a bundle for delivery
 			 */
-			void queue(const dtn::core::Node &node, const ConvergenceLayer::Job &job);
+			void queue(NodeEntry &entry, const ConvergenceLayer::Job &job);
 
 			/**
 			 * checks for timed out nodes
@@ -115,7 +155,7 @@ namespace dtn
 			/**
 			 * get node
 			 */
-			dtn::core::Node& getNode(const dtn::data::EID &eid);
+			NodeEntry& getNode(const dtn::data::EID &eid);
 
 			// if set to true, this module will shutdown
 			bool _shutdown;
@@ -126,11 +166,17 @@ namespace dtn
 			// contains all configured convergence layers
 			std::set<ConvergenceLayer*> _cl;
 
+			// incremented on each change of the convergence layers
+			size_t _cl_revision;
+
 			// mutex for the lists of nodes
 			ibrcommon::Mutex _node_lock;
 
-			// contains all nodes
-			std::list<dtn::core::Node> _nodes;
+			// contains all nodes indexed by their EID
+			node_map _nodes;
+
+			// scheduled expiration checks, the earliest first
+			expire_queue _expire_queue;
 
 			// next timestamp for autoconnect check
 			size_t _next_autoconnect;
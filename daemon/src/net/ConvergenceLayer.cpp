@@ -1,5 +1,8 @@
 #include "net/ConvergenceLayer.h"
 #include "net/BundleReceiver.h"
+#include "core/Metrics.h"
+#include <algorithm>
+#include <cctype>
 
 namespace dtn
 {
@@ -23,5 +26,35 @@ namespace dtn
 			_bundle = dtn::data::BundleID();
 			_destination = dtn::data::EID();
 		}
+
+		void ConvergenceLayer::account(const dtn::core::Node::Protocol p, const bool incoming, const size_t bytes)
+		{
+			static const int PROTOCOLS = dtn::core::Node::CONN_DGRAM_ETHERNET + 1;
+
+			// counters indexed by protocol and direction, registered on first use
+			static dtn::core::Metrics::Counter * volatile bundles[PROTOCOLS][2];
+			static dtn::core::Metrics::Counter * volatile volume[PROTOCOLS][2];
+
+			if ((p < 0) || (p >= PROTOCOLS)) return;
+
+			const int dir = incoming ? 0 : 1;
+
+			if (bundles[p][dir] == NULL)
+			{
+				std::string name = dtn::core::Node::toString(p);
+				std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+				const std::string labels = "cl=\"" + name + "\",direction=\"" + (incoming ? "in" : "out") + "\"";
+
+				// concurrent registrations return the same counters
+				dtn::core::Metrics &metrics = dtn::core::Metrics::getInstance();
+				volume[p][dir] = &metrics.getCounter("dtnd_cl_bytes_total", "Bytes of bundles transferred by a convergence layer.", labels);
+				__sync_synchronize();
+				bundles[p][dir] = &metrics.getCounter("dtnd_cl_bundles_total", "Bundles transferred by a convergence layer.", labels);
+			}
+
+			bundles[p][dir]->add();
+			volume[p][dir]->add(bytes);
+		}
 	}
 }
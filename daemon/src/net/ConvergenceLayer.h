@@ -45,6 +45,14 @@ namespace dtn
 			 * @param n
 			 */
 			virtual void open(const dtn::core::Node&) {};
+
+			/**
+			 * Account a transferred bundle in the metrics of a convergence layer.
+			 * @param p The protocol of the convergence layer.
+			 * @param incoming True, if the bundle has been received.
+			 * @param bytes The length of the bundle.
+			 */
+			static void account(const dtn::core::Node::Protocol p, const bool incoming, const size_t bytes);
 		};
 	}
 }
@@ -0,0 +1,233 @@
+/*
+ * DatagramBatch.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "config.h"
+#include "net/DatagramBatch.h"
+#include <errno.h>
+#include <string.h>
+
+namespace dtn
+{
+	namespace net
+	{
+		DatagramBatch::Buffer::Buffer(char *data, size_t length)
+		{
+			setg(data, data, data + length);
+			setp(data, data + length);
+		}
+
+		DatagramBatch::Buffer::~Buffer()
+		{
+		}
+
+		size_t DatagramBatch::Buffer::written() const
+		{
+			return pptr() - pbase();
+		}
+
+		DatagramBatch::DatagramBatch(size_t slots, size_t size)
+		 : _slots(slots), _size(size), _count(0), _data(slots * size), _lengths(slots), _truncated(slots), _addrs(slots), _addrlens(slots), _iov(slots),
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+		   _msgs(slots)
+#else
+		   _hdrs(slots)
+#endif
+		{
+		}
+
+		DatagramBatch::~DatagramBatch()
+		{
+		}
+
+		size_t DatagramBatch::capacity() const
+		{
+			return _slots;
+		}
+
+		size_t DatagramBatch::getMaxLength() const
+		{
+			return _size;
+		}
+
+		size_t DatagramBatch::size() const
+		{
+			return _count;
+		}
+
+		bool DatagramBatch::empty() const
+		{
+			return (_count == 0);
+		}
+
+		bool DatagramBatch::full() const
+		{
+			return (_count >= _slots);
+		}
+
+		void DatagramBatch::clear()
+		{
+			_count = 0;
+		}
+
+		struct msghdr& DatagramBatch::getHeader(size_t slot)
+		{
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+			return _msgs[slot].msg_hdr;
+#else
+			return _hdrs[slot];
+#endif
+		}
+
+		void DatagramBatch::prepare(size_t slot)
+		{
+			_iov[slot].iov_base = &_data[slot * _size];
+			_iov[slot].iov_len = _size;
+
+			struct msghdr &hdr = getHeader(slot);
+			::memset(&hdr, 0, sizeof(hdr));
+			hdr.msg_name = &_addrs[slot];
+			hdr.msg_namelen = sizeof(struct sockaddr_storage);
+			hdr.msg_iov = &_iov[slot];
+			hdr.msg_iovlen = 1;
+		}
+
+		size_t DatagramBatch::receive(int fd, bool wait)
+		{
+			_count = 0;
+
+			for (size_t i = 0; i < _slots; i++) prepare(i);
+
+#ifdef HAVE_RECVMMSG
+			// block for the first datagram only, take all others which are already queued
+			int ret = 0;
+			do {
+				ret = ::recvmmsg(fd, &_msgs[0], _slots, wait ? MSG_WAITFORONE : MSG_DONTWAIT, NULL);
+			} while ((ret < 0) && (errno == EINTR));
+
+			if (ret < 0)
+			{
+				if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) return 0;
+				throw ibrcommon::IOException(std::string("recvmmsg failed: ") + ::strerror(errno));
+			}
+
+			for (int i = 0; i < ret; i++)
+			{
+				_lengths[i] = _msgs[i].msg_len;
+				_truncated[i] = ((_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0);
+				_addrlens[i] = _msgs[i].msg_hdr.msg_namelen;
+			}
+
+			_count = ret;
+#else
+			while (_count < _slots)
+			{
+				const bool block = wait && (_count == 0);
+
+				ssize_t ret = ::recvmsg(fd, &getHeader(_count), block ? 0 : MSG_DONTWAIT);
+
+				if (ret < 0)
+				{
+					if (errno == EINTR) continue;
+					if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) break;
+					if (_count > 0) break;
+					throw ibrcommon::IOException(std::string("recvmsg failed: ") + ::strerror(errno));
+				}
+
+				_lengths[_count] = ret;
+				_truncated[_count] = ((getHeader(_count).msg_flags & MSG_TRUNC) != 0);
+				_addrlens[_count] = getHeader(_count).msg_namelen;
+				_count++;
+			}
+#endif
+
+			return _count;
+		}
+
+		const char* DatagramBatch::getData(size_t slot) const
+		{
+			return &_data[slot * _size];
+		}
+
+		size_t DatagramBatch::getLength(size_t slot) const
+		{
+			return _lengths[slot];
+		}
+
+		bool DatagramBatch::isTruncated(size_t slot) const
+		{
+			return _truncated[slot];
+		}
+
+		const struct sockaddr* DatagramBatch::getAddress(size_t slot) const
+		{
+			return (const struct sockaddr*)&_addrs[slot];
+		}
+
+		socklen_t DatagramBatch::getAddressLength(size_t slot) const
+		{
+			return _addrlens[slot];
+		}
+
+		char* DatagramBatch::next()
+		{
+			if (full()) throw ibrcommon::Exception("datagram batch is full");
+			return &_data[_count * _size];
+		}
+
+		void DatagramBatch::push(size_t length, const struct sockaddr *addr, socklen_t addrlen)
+		{
+			if (full()) throw ibrcommon::Exception("datagram batch is full");
+			if (length > _size) throw ibrcommon::Exception("datagram exceeds the buffer size");
+			if (addrlen > sizeof(struct sockaddr_storage)) throw ibrcommon::Exception("invalid address length");
+
+			prepare(_count);
+			::memcpy(&_addrs[_count], addr, addrlen);
+
+			_iov[_count].iov_len = length;
+			getHeader(_count).msg_namelen = addrlen;
+			_lengths[_count] = length;
+			_truncated[_count] = false;
+			_addrlens[_count] = addrlen;
+			_count++;
+		}
+
+		size_t DatagramBatch::send(int fd)
+		{
+			size_t sent = 0;
+
+#ifdef HAVE_SENDMMSG
+			while (sent < _count)
+			{
+				int ret = ::sendmmsg(fd, &_msgs[sent], _count - sent, 0);
+
+				if (ret < 0)
+				{
+					if (errno == EINTR) continue;
+					break;
+				}
+
+				sent += ret;
+			}
+#else
+			while (sent < _count)
+			{
+				ssize_t ret = ::sendmsg(fd, &getHeader(sent), 0);
+
+				if (ret < 0)
+				{
+					if (errno == EINTR) continue;
+					break;
+				}
+
+				sent++;
+			}
+#endif
+
+			_count = 0;
+			return sent;
+		}
+	}
+}
@@ -0,0 +1,148 @@
+/*
+ * DatagramBatch.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef DATAGRAMBATCH_H_
+#define DATAGRAMBATCH_H_
+
+#include "config.h"
+#include <ibrcommon/Exceptions.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <streambuf>
+#include <vector>
+
+namespace dtn
+{
+	namespace net
+	{
+		/**
+		 * A set of pre-allocated datagram buffers. All datagrams of a batch
+		 * are received or sent with one recvmmsg() or sendmmsg() call. If these
+		 * calls are not available, the datagrams are transferred one by one.
+		 *
+		 * The buffers are allocated once and reused for each batch, thus
+		 * sending and receiving does not allocate any memory.
+		 */
+		class DatagramBatch
+		{
+		public:
+			/**
+			 * A stream buffer on top of the buffer of one slot. It is used to
+			 * serialize bundles into and parse them out of a slot without copying.
+			 */
+			class Buffer : public std::streambuf
+			{
+			public:
+				Buffer(char *data, size_t length);
+				virtual ~Buffer();
+
+				/**
+				 * @return The number of bytes written into the buffer.
+				 */
+				size_t written() const;
+			};
+
+			/**
+			 * @param slots Number of datagrams in one batch.
+			 * @param size Maximum size of each datagram.
+			 */
+			DatagramBatch(size_t slots, size_t size);
+			virtual ~DatagramBatch();
+
+			/**
+			 * @return The number of slots.
+			 */
+			size_t capacity() const;
+
+			/**
+			 * @return The maximum size of a datagram.
+			 */
+			size_t getMaxLength() const;
+
+			/**
+			 * @return The number of datagrams in the batch.
+			 */
+			size_t size() const;
+
+			bool empty() const;
+			bool full() const;
+
+			/**
+			 * Remove all datagrams of the batch.
+			 */
+			void clear();
+
+			/**
+			 * Replace the content of the batch by the datagrams waiting on a socket.
+			 * @param fd The socket to read from.
+			 * @param wait If true, block until at least one datagram is available.
+			 * @return The number of received datagrams.
+			 * @throw ibrcommon::IOException if the receive call failed.
+			 */
+			size_t receive(int fd, bool wait = true);
+
+			const char* getData(size_t slot) const;
+			size_t getLength(size_t slot) const;
+
+			/**
+			 * @return True, if the received datagram was larger than the buffer
+			 * of the slot and its end has been cut off.
+			 */
+			bool isTruncated(size_t slot) const;
+
+			const struct sockaddr* getAddress(size_t slot) const;
+			socklen_t getAddressLength(size_t slot) const;
+
+			/**
+			 * Returns the buffer of the next free slot. The datagram is written
+			 * into this buffer and added to the batch with push().
+			 */
+			char* next();
+
+			/**
+			 * Add the datagram written into the next free slot to the batch.
+			 * @param length The length of the datagram.
+			 * @param addr The destination of the datagram.
+			 * @param addrlen The length of the destination address.
+			 */
+			void push(size_t length, const struct sockaddr *addr, socklen_t addrlen);
+
+			/**
+			 * Send all datagrams of the batch and clear it afterwards. If a send
+			 * call fails, the remaining datagrams are discarded.
+			 * @param fd The socket to write to.
+			 * @return The number of datagrams sent, counted from the first one.
+			 */
+			size_t send(int fd);
+
+		private:
+			void prepare(size_t slot);
+
+			struct msghdr& getHeader(size_t slot);
+
+			const size_t _slots;
+			const size_t _size;
+			size_t _count;
+
+			std::vector<char> _data;
+			std::vector<size_t> _lengths;
+			std::vector<bool> _truncated;
+			std::vector<struct sockaddr_storage> _addrs;
+			std::vector<socklen_t> _addrlens;
+			std::vector<struct iovec> _iov;
+
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+			// the message headers are part of the vector passed to the batch calls
+			std::vector<struct mmsghdr> _msgs;
+#else
+			std::vector<struct msghdr> _hdrs;
+#endif
+		};
+	}
+}
+
+#endif /* DATAGRAMBATCH_H_ */
@@ -0,0 +1,350 @@
+/*
+ * SerializedBundleCache.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "net/SerializedBundleCache.h"
+#include "core/BundleEvent.h"
+#include "core/BundleExpiredEvent.h"
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/AgeBlock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <sstream>
+
+namespace dtn
+{
+	namespace net
+	{
+		SerializedBundleCache::Entry::Entry(const dtn::data::BundleID &i)
+		 : id(i), length(0), refs(0), ready(false), linger(true), detached(false), released(0)
+		{
+		}
+
+		SerializedBundleCache::Entry::~Entry()
+		{
+		}
+
+		SerializedBundleCache::Reference::Reference(SerializedBundleCache &cache, const dtn::data::BundleID &id, Loader &loader)
+		 : _cache(cache), _entry(NULL)
+		{
+			bool created = false;
+			_entry = _cache.acquire(id, created);
+
+			if (_entry == NULL)
+			{
+				// the cache is disabled
+				loader.load(id, _bundle);
+				return;
+			}
+
+			// the bundle is already cached
+			if (!created) return;
+
+			try {
+				if (_cache.fill(*_entry, loader, _bundle))
+				{
+					// the serialized data is used from now on
+					_bundle = dtn::data::Bundle();
+					return;
+				}
+			} catch (...) {
+				_cache.release(_entry);
+				_entry = NULL;
+				throw;
+			}
+
+			// the bundle is too large, send the loaded bundle directly
+			_cache.release(_entry);
+			_entry = NULL;
+		}
+
+		SerializedBundleCache::Reference::~Reference()
+		{
+			if (_entry != NULL) _cache.release(_entry);
+		}
+
+		bool SerializedBundleCache::Reference::isCached() const
+		{
+			return (_entry != NULL);
+		}
+
+		const dtn::data::MetaBundle& SerializedBundleCache::Reference::getMeta() const
+		{
+			return _entry->meta;
+		}
+
+		const std::string& SerializedBundleCache::Reference::getData() const
+		{
+			return _entry->data;
+		}
+
+		const dtn::data::Bundle& SerializedBundleCache::Reference::getBundle() const
+		{
+			return _bundle;
+		}
+
+		SerializedBundleCache::SerializedBundleCache()
+		 : _limit(0), _linger(0), _size(0),
+		   _hits(dtn::core::Metrics::getInstance().getCounter("dtnd_send_cache_total", "Bundles requested from the cache of serialized bundles.", "result=\"hit\"")),
+		   _misses(dtn::core::Metrics::getInstance().getCounter("dtnd_send_cache_total", "Bundles requested from the cache of serialized bundles.", "result=\"miss\"")),
+		   _bypass(dtn::core::Metrics::getInstance().getCounter("dtnd_send_cache_total", "Bundles requested from the cache of serialized bundles.", "result=\"bypass\""))
+		{
+		}
+
+		SerializedBundleCache::~SerializedBundleCache()
+		{
+			for (std::map<dtn::data::BundleID, Entry*>::iterator iter = _index.begin(); iter != _index.end(); iter++)
+			{
+				delete (*iter).second;
+			}
+		}
+
+		SerializedBundleCache& SerializedBundleCache::getInstance()
+		{
+			static SerializedBundleCache instance;
+			return instance;
+		}
+
+		void SerializedBundleCache::setup(size_t limit, size_t linger)
+		{
+			ibrcommon::MutexLock l(_cond);
+			_limit = limit;
+			_linger = (u_int64_t)linger * 1000000;
+			evict(0);
+		}
+
+		size_t SerializedBundleCache::getSize() const
+		{
+			ibrcommon::MutexLock l(_cond);
+			return _size;
+		}
+
+		size_t SerializedBundleCache::getEntries() const
+		{
+			ibrcommon::MutexLock l(_cond);
+			return _index.size();
+		}
+
+		void SerializedBundleCache::remove(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			std::map<dtn::data::BundleID, Entry*>::iterator iter = _index.find(id);
+			if (iter == _index.end()) return;
+
+			Entry *entry = (*iter).second;
+
+			if (entry->refs == 0)
+			{
+				_idle.erase(entry->idle);
+				_index.erase(iter);
+				drop(entry);
+			}
+			else
+			{
+				// senders holding the entry finish their transmission
+				detach(entry);
+			}
+		}
+
+		void SerializedBundleCache::componentUp()
+		{
+			bindEvent(dtn::core::BundleEvent::className);
+			bindEvent(dtn::core::BundleExpiredEvent::className);
+		}
+
+		void SerializedBundleCache::componentDown()
+		{
+			unbindEvent(dtn::core::BundleEvent::className);
+			unbindEvent(dtn::core::BundleExpiredEvent::className);
+		}
+
+		void SerializedBundleCache::raiseEvent(const dtn::core::Event *evt)
+		{
+			try {
+				const dtn::core::BundleEvent &event = dynamic_cast<const dtn::core::BundleEvent&>(*evt);
+
+				switch (event.getAction())
+				{
+				case dtn::core::BUNDLE_DELETED:
+				case dtn::core::BUNDLE_DELIVERED:
+					remove(event.getBundle());
+					break;
+
+				default:
+					break;
+				}
+			} catch (const std::bad_cast&) { }
+
+			try {
+				const dtn::core::BundleExpiredEvent &expired = dynamic_cast<const dtn::core::BundleExpiredEvent&>(*evt);
+				remove(expired._bundle);
+			} catch (const std::bad_cast&) { }
+		}
+
+		const std::string SerializedBundleCache::getName() const
+		{
+			return "SerializedBundleCache";
+		}
+
+		SerializedBundleCache::Entry* SerializedBundleCache::acquire(const dtn::data::BundleID &id, bool &created)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			while (true)
+			{
+				if (_limit == 0)
+				{
+					_bypass.add();
+					return NULL;
+				}
+
+				evict(0);
+
+				std::map<dtn::data::BundleID, Entry*>::iterator iter = _index.find(id);
+
+				if (iter == _index.end())
+				{
+					// the caller loads the bundle, other senders wait for it
+					Entry *entry = new Entry(id);
+					entry->refs = 1;
+					_index[id] = entry;
+					created = true;
+					return entry;
+				}
+
+				Entry *entry = (*iter).second;
+
+				// pin the entry
+				if (entry->refs == 0) _idle.erase(entry->idle);
+				entry->refs++;
+
+				// wait until another sender has loaded the bundle
+				while (!entry->ready && !entry->detached)
+				{
+					_cond.wait();
+				}
+
+				if (entry->ready)
+				{
+					_hits.add();
+					return entry;
+				}
+
+				// the bundle could not be cached, try again
+				entry->refs--;
+				if (entry->refs == 0) drop(entry);
+			}
+		}
+
+		bool SerializedBundleCache::fill(Entry &entry, Loader &loader, dtn::data::Bundle &bundle)
+		{
+			try {
+				loader.load(entry.id, bundle);
+
+				std::stringstream ss;
+				dtn::data::DefaultSerializer serializer(ss);
+				const size_t length = serializer.getLength(bundle);
+
+				{
+					ibrcommon::MutexLock l(_cond);
+
+					// make room for the new bundle
+					evict(length);
+
+					if ((_size + length) > _limit)
+					{
+						_bypass.add();
+						detach(&entry);
+						return false;
+					}
+
+					// reserve the memory before the bundle is serialized
+					_size += length;
+					entry.length = length;
+				}
+
+				serializer << bundle;
+
+				entry.meta = dtn::data::MetaBundle(bundle);
+				entry.data = ss.str();
+
+				// the age is increased on each load, thus the data gets outdated
+				entry.linger = !bundle.has<dtn::data::AgeBlock>();
+
+				ibrcommon::MutexLock l(_cond);
+				entry.ready = true;
+				_misses.add();
+				_cond.signal(true);
+			} catch (...) {
+				ibrcommon::MutexLock l(_cond);
+				detach(&entry);
+				throw;
+			}
+
+			return true;
+		}
+
+		void SerializedBundleCache::release(Entry *entry)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			entry->refs--;
+			if (entry->refs > 0) return;
+
+			if (entry->detached)
+			{
+				drop(entry);
+				return;
+			}
+
+			if ((_limit == 0) || (_linger == 0) || !entry->linger)
+			{
+				_index.erase(entry->id);
+				drop(entry);
+				return;
+			}
+
+			// keep the bundle for senders asking a little later
+			entry->released = dtn::core::Metrics::now();
+			entry->idle = _idle.insert(_idle.end(), entry);
+
+			evict(0);
+		}
+
+		void SerializedBundleCache::detach(Entry *entry)
+		{
+			if (!entry->detached)
+			{
+				_index.erase(entry->id);
+				entry->detached = true;
+			}
+
+			_cond.signal(true);
+		}
+
+		void SerializedBundleCache::evict(const size_t additional)
+		{
+			const u_int64_t now = dtn::core::Metrics::now();
+
+			// the idle list is ordered by the time of release
+			while (!_idle.empty())
+			{
+				Entry *entry = _idle.front();
+
+				if (((_size + additional) <= _limit) && ((entry->released + _linger) > now)) break;
+
+				_idle.pop_front();
+				_index.erase(entry->id);
+				drop(entry);
+			}
+		}
+
+		void SerializedBundleCache::drop(Entry *entry)
+		{
+			_size -= entry->length;
+			delete entry;
+		}
+	}
+}
@@ -0,0 +1,240 @@
+/*
+ * SerializedBundleCache.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef SERIALIZEDBUNDLECACHE_H_
+#define SERIALIZEDBUNDLECACHE_H_
+
+#include "Component.h"
+#include "core/EventReceiver.h"
+#include "core/Metrics.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <sys/types.h>
+#include <string>
+#include <list>
+#include <map>
+
+namespace dtn
+{
+	namespace net
+	{
+		/**
+		 * Keeps bundles in their serialized form for a short time, so a bundle
+		 * which is sent to several neighbors at once (e.g. by flooding a group
+		 * bundle) is read out of the storage and signed only once.
+		 *
+		 * A bundle is loaded by the first sender asking for it. Senders asking
+		 * for the same bundle while it is loaded wait for the result instead
+		 * of loading it again. An entry is pinned as long as a sender holds a
+		 * reference to it. Entries without references are kept for the linger
+		 * time and dropped earlier, if the memory limit is reached. Bundles
+		 * which do not fit into the limit are passed through without caching.
+		 * Bundles with an age block are not kept after their last reference,
+		 * since their age is increased on each load.
+		 *
+		 * A bundle is dropped out of the cache once it is deleted, delivered,
+		 * expired or its custody is released. Senders already holding a
+		 * reference finish their transmission.
+		 *
+		 * The cache is disabled with a limit of zero.
+		 */
+		class SerializedBundleCache : public dtn::core::EventReceiver, public dtn::daemon::IntegratedComponent
+		{
+		public:
+			/**
+			 * Loads a bundle on a miss. The loaded bundle is serialized as it is,
+			 * thus it has to be prepared for sending (e.g. authenticated) by the
+			 * loader.
+			 */
+			class Loader
+			{
+			public:
+				virtual ~Loader() {};
+
+				/**
+				 * @throw dtn::core::BundleStorage::NoBundleFoundException if the bundle is gone
+				 */
+				virtual void load(const dtn::data::BundleID &id, dtn::data::Bundle &bundle) = 0;
+			};
+
+		private:
+			class Entry
+			{
+			public:
+				Entry(const dtn::data::BundleID &id);
+				~Entry();
+
+				const dtn::data::BundleID id;
+				dtn::data::MetaBundle meta;
+				std::string data;
+
+				// bytes reserved in the cache
+				size_t length;
+
+				// number of references held by senders
+				size_t refs;
+
+				// set once the data is complete
+				bool ready;
+
+				// keep the entry for the linger time after the last release
+				bool linger;
+
+				// removed from the index, deleted with the last reference
+				bool detached;
+
+				// time of the last release, see dtn::core::Metrics::now()
+				u_int64_t released;
+				std::list<Entry*>::iterator idle;
+			};
+
+		public:
+			/**
+			 * Holds a bundle for sending. If the bundle is cached, the serialized
+			 * data is shared with all other senders of the bundle, else the
+			 * reference holds the loaded bundle itself.
+			 */
+			class Reference
+			{
+			public:
+				/**
+				 * Get a bundle out of the cache or load it with the given loader.
+				 * @throw any exception of the loader
+				 */
+				Reference(SerializedBundleCache &cache, const dtn::data::BundleID &id, Loader &loader);
+				~Reference();
+
+				/**
+				 * Returns true, if the serialized data is available.
+				 */
+				bool isCached() const;
+
+				/**
+				 * Returns the meta data of a cached bundle.
+				 */
+				const dtn::data::MetaBundle& getMeta() const;
+
+				/**
+				 * Returns the serialized data of a cached bundle.
+				 */
+				const std::string& getData() const;
+
+				/**
+				 * Returns the bundle, if it is not cached.
+				 */
+				const dtn::data::Bundle& getBundle() const;
+
+			private:
+				Reference(const Reference&);
+				Reference& operator=(const Reference&);
+
+				SerializedBundleCache &_cache;
+				Entry *_entry;
+				dtn::data::Bundle _bundle;
+			};
+
+			static SerializedBundleCache& getInstance();
+
+			/**
+			 * Configure the cache. Entries already cached are kept until
+			 * they are released.
+			 * @param limit Maximum bytes of all cached bundles, zero disables the cache.
+			 * @param linger Seconds to keep a bundle after its last reference has been released.
+			 */
+			void setup(size_t limit, size_t linger);
+
+			/**
+			 * Returns the bytes of all cached bundles.
+			 */
+			size_t getSize() const;
+
+			/**
+			 * Returns the number of cached bundles.
+			 */
+			size_t getEntries() const;
+
+			/**
+			 * Drop a bundle out of the cache, e.g. because it has been
+			 * changed in the storage.
+			 */
+			void remove(const dtn::data::BundleID &id);
+
+			/**
+			 * This method is used to receive events.
+			 * @param evt
+			 */
+			void raiseEvent(const dtn::core::Event *evt);
+
+			/**
+			 * @see Component::getName()
+			 */
+			virtual const std::string getName() const;
+
+		protected:
+			virtual void componentUp();
+			virtual void componentDown();
+
+		private:
+			SerializedBundleCache();
+			virtual ~SerializedBundleCache();
+
+			/**
+			 * Pin a cached bundle or insert a new entry for it. Returns NULL,
+			 * if the caller has to load the bundle without the cache.
+			 * @param created Set to true, if the caller has to load the bundle into the new entry.
+			 */
+			Entry* acquire(const dtn::data::BundleID &id, bool &created);
+
+			/**
+			 * Load and serialize a bundle into a new entry. Returns false, if
+			 * the bundle does not fit into the cache. The loaded bundle is
+			 * left in bundle.
+			 */
+			bool fill(Entry &entry, Loader &loader, dtn::data::Bundle &bundle);
+
+			/**
+			 * Drop a reference to an entry.
+			 */
+			void release(Entry *entry);
+
+			/**
+			 * Remove an entry from the index and wake up all waiting senders.
+			 * The entry is deleted with its last reference. The lock has to be held.
+			 */
+			void detach(Entry *entry);
+
+			/**
+			 * Drop unreferenced entries, which are older than the linger time
+			 * or which exceed the limit together with the given additional bytes.
+			 * The lock has to be held.
+			 */
+			void evict(const size_t additional);
+
+			/**
+			 * Delete an entry and free its reserved bytes. The lock has to be held.
+			 */
+			void drop(Entry *entry);
+
+			mutable ibrcommon::Conditional _cond;
+			std::map<dtn::data::BundleID, Entry*> _index;
+
+			// unreferenced entries, the least recently released first
+			std::list<Entry*> _idle;
+
+			size_t _limit;
+			u_int64_t _linger;
+			size_t _size;
+
+			dtn::core::Metrics::Counter &_hits;
+			dtn::core::Metrics::Counter &_misses;
+			dtn::core::Metrics::Counter &_bypass;
+		};
+	}
+}
+
+#endif /* SERIALIZEDBUNDLECACHE_H_ */
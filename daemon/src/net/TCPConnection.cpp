@@ -10,6 +10,8 @@
 #include "core/BundleCore.h"
 #include "core/BundleEvent.h"
 #include "core/BundleStorage.h"
+#include "core/Metrics.h"
+#include "core/Tracer.h"
 
 #include "net/TCPConvergenceLayer.h"
 #include "net/BundleReceivedEvent.h"
@@ -239,6 +241,8 @@ namespace dtn
 			try {
 				const dtn::data::MetaBundle bundle = _sentqueue.getnpop();
 
+				dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_ACK);
+
 				// signal completion of the transfer
 				TransferCompletedEvent::raise(_node.getEID(), bundle);
 
@@ -258,6 +262,11 @@ namespace dtn
 			_lastack = ack;
 		}
 
+		void TCPConnection::eventSegmentAck(size_t rtt)
+		{
+			dtn::core::Metrics::getInstance().segment_rtt.record(rtt);
+		}
+
 		void TCPConnection::initialize()
 		{
 			// start the receiver for incoming bundles + handshake
@@ -434,6 +443,16 @@ namespace dtn
 			if (!stream.good()) throw ibrcommon::IOException("stream went bad");
 
 			dtn::data::DefaultDeserializer(stream, dtn::core::BundleCore::getInstance()) >> bundle;
+
+			// the id of the bundle is known after the deserialization, the reception
+			// started with the arrival of its first segment
+			dtn::core::Tracer &tracer = dtn::core::Tracer::getInstance();
+			tracer.record(bundle, dtn::core::Tracer::STAGE_CL_RECEIVE_START, conn._stream.getReceiveStart());
+			tracer.record(bundle, dtn::core::Tracer::STAGE_CL_RECEIVE_END);
+
+			// account the received bundle
+			ConvergenceLayer::account(dtn::core::Node::CONN_TCPIP, true, dtn::data::DefaultSerializer(stream).getLength(bundle));
+
 			return conn;
 		}
 
@@ -457,17 +476,82 @@ namespace dtn
 				// activate exceptions for this method
 				if (!stream.good()) throw ibrcommon::IOException("stream went bad");
 
+				dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_CL_SEND_START);
+
 				// transmit the bundle
 				serializer << bundle;
 
 				// flush the stream
 				stream << std::flush;
 
+				dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_CL_SEND_END);
+
 				// stop the time measurement
 				m.stop();
 
 				// get throughput
-				double kbytes_per_second = (serializer.getLength(bundle) / m.getSeconds()) / 1024;
+				const size_t length = serializer.getLength(bundle);
+				double kbytes_per_second = (length / m.getSeconds()) / 1024;
+
+				// account the transmitted bundle
+				ConvergenceLayer::account(dtn::core::Node::CONN_TCPIP, false, length);
+
+				// print out throughput
+				IBRCOMMON_LOGGER_DEBUG(5) << "transfer finished after " << m << " with "
+						<< std::setiosflags(std::ios::fixed) << std::setprecision(2) << kbytes_per_second << " kb/s" << IBRCOMMON_LOGGER_ENDL;
+
+			} catch (const ibrcommon::Exception &ex) {
+				// the connection not available
+				IBRCOMMON_LOGGER_DEBUG(10) << "connection error: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// forward exception
+				throw;
+			}
+
+			return conn;
+		}
+
+		TCPConnection& operator<<(TCPConnection &conn, const SerializedBundleCache::Reference &ref)
+		{
+			// bundles not in the cache are serialized directly
+			if (!ref.isCached()) return (conn << ref.getBundle());
+
+			// prepare a measurement
+			ibrcommon::TimeMeasurement m;
+
+			std::iostream &stream = conn._stream;
+
+			const dtn::data::MetaBundle &meta = ref.getMeta();
+			const std::string &data = ref.getData();
+
+			// put the bundle into the sentqueue
+			conn._sentqueue.push(meta);
+
+			// start the measurement
+			m.start();
+
+			try {
+				// activate exceptions for this method
+				if (!stream.good()) throw ibrcommon::IOException("stream went bad");
+
+				dtn::core::Tracer::getInstance().record(meta, dtn::core::Tracer::STAGE_CL_SEND_START);
+
+				// transmit the serialized bundle
+				stream.write(data.c_str(), data.length());
+
+				// flush the stream
+				stream << std::flush;
+
+				dtn::core::Tracer::getInstance().record(meta, dtn::core::Tracer::STAGE_CL_SEND_END);
+
+				// stop the time measurement
+				m.stop();
+
+				// get throughput
+				double kbytes_per_second = (data.length() / m.getSeconds()) / 1024;
+
+				// account the transmitted bundle
+				ConvergenceLayer::account(dtn::core::Node::CONN_TCPIP, false, data.length());
 
 				// print out throughput
 				IBRCOMMON_LOGGER_DEBUG(5) << "transfer finished after " << m << " with "
@@ -540,35 +624,42 @@ namespace dtn
 			return true;
 		}
 
+		void TCPConnection::Sender::load(const dtn::data::BundleID &id, dtn::data::Bundle &bundle)
+		{
+			// read the bundle out of the storage
+			bundle = dtn::core::BundleCore::getInstance().getStorage().get(id);
+
+#ifdef WITH_BUNDLE_SECURITY
+			const dtn::daemon::Configuration::Security::Level seclevel =
+					dtn::daemon::Configuration::getInstance().getSecurity().getLevel();
+
+			if (seclevel & dtn::daemon::Configuration::Security::SECURITY_LEVEL_AUTHENTICATED)
+			{
+				try {
+					dtn::security::SecurityManager::getInstance().auth(bundle);
+				} catch (const dtn::security::SecurityManager::KeyMissingException&) {
+					// sign requested, but no key is available
+					IBRCOMMON_LOGGER(warning) << "No key available for sign process." << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+#endif
+		}
+
 		void TCPConnection::Sender::run()
 		{
 			try {
-				dtn::core::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
+				SerializedBundleCache &cache = SerializedBundleCache::getInstance();
 
 				while (_connection.good())
 				{
 					_current_transfer = ibrcommon::Queue<dtn::data::BundleID>::getnpop(true);
 
 					try {
-						// read the bundle out of the storage
-						dtn::data::Bundle bundle = storage.get(_current_transfer);
-
-#ifdef WITH_BUNDLE_SECURITY
-						const dtn::daemon::Configuration::Security::Level seclevel =
-								dtn::daemon::Configuration::getInstance().getSecurity().getLevel();
+						// get the bundle, senders of the same bundle share one copy
+						SerializedBundleCache::Reference ref(cache, _current_transfer, *this);
 
-						if (seclevel & dtn::daemon::Configuration::Security::SECURITY_LEVEL_AUTHENTICATED)
-						{
-							try {
-								dtn::security::SecurityManager::getInstance().auth(bundle);
-							} catch (const dtn::security::SecurityManager::KeyMissingException&) {
-								// sign requested, but no key is available
-								IBRCOMMON_LOGGER(warning) << "No key available for sign process." << IBRCOMMON_LOGGER_ENDL;
-							}
-						}
-#endif
 						// send bundle
-						_connection << bundle;
+						_connection << ref;
 					} catch (const dtn::core::BundleStorage::NoBundleFoundException&) {
 						// send transfer aborted event
 						TransferAbortedEvent::raise(_connection._node.getEID(), _current_transfer, dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
@@ -16,6 +16,7 @@
 #include "net/ConvergenceLayer.h"
 #include "net/DiscoveryService.h"
 #include "net/DiscoveryServiceProvider.h"
+#include "net/SerializedBundleCache.h"
 
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
@@ -105,6 +106,7 @@ namespace dtn
 			virtual void eventBundleRefused();
 			virtual void eventBundleForwarded();
 			virtual void eventBundleAck(size_t ack);
+			virtual void eventSegmentAck(size_t rtt);
 
 			dtn::core::Node::Protocol getDiscoveryProtocol() const;
 
@@ -120,6 +122,7 @@ namespace dtn
 
 			friend TCPConnection& operator>>(TCPConnection &conn, dtn::data::Bundle &bundle);
 			friend TCPConnection& operator<<(TCPConnection &conn, const dtn::data::Bundle &bundle);
+			friend TCPConnection& operator<<(TCPConnection &conn, const SerializedBundleCache::Reference &ref);
 
 #ifdef WITH_TLS
 			/*!
@@ -164,12 +167,17 @@ namespace dtn
 				size_t &_keepalive_timeout;
 			};
 
-			class Sender : public ibrcommon::JoinableThread, public ibrcommon::Queue<dtn::data::BundleID>
+			class Sender : public ibrcommon::JoinableThread, public ibrcommon::Queue<dtn::data::BundleID>, public SerializedBundleCache::Loader
 			{
 			public:
 				Sender(TCPConnection &connection);
 				virtual ~Sender();
 
+				/**
+				 * read a bundle out of the storage and prepare it for sending
+				 */
+				void load(const dtn::data::BundleID &id, dtn::data::Bundle &bundle);
+
 			protected:
 				void run();
 				void finally();
@@ -4,13 +4,14 @@
 #include "net/TransferAbortedEvent.h"
 #include "core/BundleEvent.h"
 #include "core/BundleCore.h"
+#include "core/Metrics.h"
+#include "core/Tracer.h"
 #include "routing/RequeueBundleEvent.h"
 
 #include <ibrdtn/utils/Utils.h>
 #include <ibrdtn/data/Serializer.h>
 #include <ibrdtn/data/ScopeControlHopLimitBlock.h>
 
-#include <ibrcommon/net/UnicastSocket.h>
 #include <ibrcommon/net/vaddress.h>
 #include <ibrcommon/net/vinterface.h>
 #include <ibrcommon/data/BLOB.h>
@@ -30,8 +31,10 @@
 #include <string.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <netdb.h>
 
 #include <iostream>
+#include <algorithm>
 #include <list>
 
 
@@ -42,17 +45,17 @@ namespace dtn
 	namespace net
 	{
 		const int UDPConvergenceLayer::DEFAULT_PORT = 4556;
+		const size_t UDPConvergenceLayer::BATCH_SIZE = 32;
 
 		UDPConvergenceLayer::UDPConvergenceLayer(ibrcommon::vinterface net, int port, unsigned int mtu)
-			: _socket(NULL), _net(net), _port(port), m_maxmsgsize(mtu), _running(false)
+			: _net(net), _port(port), _fd_inet(-1), _fd_inet6(-1), m_maxmsgsize(mtu),
+			  _recv_batch(BATCH_SIZE, mtu), _recv_next(0), _recv_time(0), _sender(*this), _running(false)
 		{
-			_socket = new ibrcommon::UnicastSocket();
 		}
 
 		UDPConvergenceLayer::~UDPConvergenceLayer()
 		{
 			componentDown();
-			delete _socket;
 		}
 
 		dtn::core::Node::Protocol UDPConvergenceLayer::getDiscoveryProtocol() const
@@ -98,102 +101,136 @@ namespace dtn
 				return;
 			}
 
-			std::stringstream ss;
-			dtn::data::DefaultSerializer serializer(ss);
+			const dtn::core::Node::URI &uri = uri_list.front();
 
-			dtn::core::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
-
-			try {
-				// read the bundle out of the storage
-				const dtn::data::Bundle bundle = storage.get(job._bundle);
-
-				unsigned int size = serializer.getLength(bundle);
-
-				if (size > m_maxmsgsize)
-				{
-					// TODO: create a fragment of length "size"
-					throw ConnectionInterruptedException();
-				}
+			std::string address = "0.0.0.0";
+			unsigned int port = 0;
 
-				serializer << bundle;
-				string data = ss.str();
+			// read values
+			uri.decode(address, port);
 
-				const dtn::core::Node::URI &uri = uri_list.front();
+			try {
+				// resolve the address of the node once, the sender only copies it
+				ibrcommon::vaddress addr(address);
 
-				std::string address = "0.0.0.0";
-				unsigned int port = 0;
+				struct addrinfo hints, *ainfo;
+				::memset(&hints, 0, sizeof hints);
+				hints.ai_socktype = SOCK_DGRAM;
+				ainfo = addr.addrinfo(&hints, port);
 
-				// read values
-				uri.decode(address, port);
+				Transmission t(node.getEID(), job, ainfo->ai_addr, ainfo->ai_addrlen);
+				freeaddrinfo(ainfo);
 
-				// get the address of the node
-				ibrcommon::vaddress addr(address);
+				_sender.push(t);
+			} catch (const ibrcommon::Exception&) {
+				IBRCOMMON_LOGGER_DEBUG(5) << "can not resolve the address " << address << IBRCOMMON_LOGGER_ENDL;
+				dtn::net::TransferAbortedEvent::raise(node.getEID(), job._bundle, dtn::net::TransferAbortedEvent::REASON_UNDEFINED);
+			}
+		}
 
-				// set write lock
-				ibrcommon::MutexLock l(m_writelock);
+		UDPConvergenceLayer& UDPConvergenceLayer::operator>>(dtn::data::Bundle &bundle)
+		{
+			ibrcommon::MutexLock l(m_readlock);
 
-				// send converted line back to client.
-				int ret = _socket->send(addr, port, data.c_str(), data.length());
+			size_t slot = 0;
+			size_t len = 0;
 
-				if (ret == -1)
+			while (true)
+			{
+				// read the next batch if all datagrams are processed
+				while (_recv_next >= _recv_batch.size())
 				{
-					// CL is busy, requeue bundle
-					dtn::routing::RequeueBundleEvent::raise(job._destination, job._bundle);
+					_recv_next = 0;
+					_recv_batch.clear();
 
-					return;
+					std::list<int> fds;
+					_socket.select(fds, NULL);
+
+					for (std::list<int>::const_iterator iter = fds.begin(); iter != fds.end(); iter++)
+					{
+						if (_recv_batch.receive(*iter, false) > 0)
+						{
+							// all datagrams of the batch have arrived by now
+							_recv_time = dtn::core::Metrics::now();
+							break;
+						}
+					}
 				}
 
-				// raise bundle event
-				dtn::net::TransferCompletedEvent::raise(job._destination, bundle);
-				dtn::core::BundleEvent::raise(bundle, dtn::core::BUNDLE_FORWARDED);
-			} catch (const dtn::core::BundleStorage::NoBundleFoundException&) {
-				// send transfer aborted event
-				dtn::net::TransferAbortedEvent::raise(node.getEID(), job._bundle, dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
-			}
+				slot = _recv_next++;
+				len = _recv_batch.getLength(slot);
 
-		}
+				// the end of the bundle is missing
+				if (!_recv_batch.isTruncated(slot)) break;
 
-		UDPConvergenceLayer& UDPConvergenceLayer::operator>>(dtn::data::Bundle &bundle)
-		{
-			ibrcommon::MutexLock l(m_readlock);
+				IBRCOMMON_LOGGER(warning) << "UDPConvergenceLayer: datagram larger than the MTU of " << _recv_batch.getMaxLength() << " bytes dropped" << IBRCOMMON_LOGGER_ENDL;
+			}
 
-			char data[m_maxmsgsize];
+			// parse the bundle directly out of the receive buffer
+			DatagramBatch::Buffer buf(const_cast<char*>(_recv_batch.getData(slot)), len);
+			std::istream stream(&buf);
 
-			// data waiting
-			int len = _socket->receive(data, m_maxmsgsize);
+			// get the bundle
+			dtn::data::DefaultDeserializer(stream, dtn::core::BundleCore::getInstance()) >> bundle;
 
-			if (len > 0)
-			{
-				// read all data into a stream
-				stringstream ss;
-				ss.write(data, len);
+			// the id of the bundle is known after the deserialization, the reception
+			// started with the arrival of its datagram
+			dtn::core::Tracer &tracer = dtn::core::Tracer::getInstance();
+			tracer.record(bundle, dtn::core::Tracer::STAGE_CL_RECEIVE_START, _recv_time);
+			tracer.record(bundle, dtn::core::Tracer::STAGE_CL_RECEIVE_END);
 
-				// get the bundle
-				dtn::data::DefaultDeserializer(ss, dtn::core::BundleCore::getInstance()) >> bundle;
-			}
+			// account the received bundle
+			ConvergenceLayer::account(dtn::core::Node::CONN_UDPIP, true, len);
 
 			return (*this);
 		}
 
+		int UDPConvergenceLayer::getSocket(const struct sockaddr *addr) const
+		{
+			if ((addr->sa_family == AF_INET6) && (_fd_inet6 != -1)) return _fd_inet6;
+			if ((addr->sa_family == AF_INET) && (_fd_inet != -1)) return _fd_inet;
+			return (_fd_inet != -1) ? _fd_inet : _fd_inet6;
+		}
+
 		void UDPConvergenceLayer::componentUp()
 		{
 			try {
-				try {
-					ibrcommon::UnicastSocket &sock = dynamic_cast<ibrcommon::UnicastSocket&>(*_socket);
-					sock.bind(_port, _net);
-				} catch (const std::bad_cast&) {
+				std::list<int> fds;
+
+				if (_net.empty())
+				{
+					fds.push_back(_socket.bind(_port, SOCK_DGRAM));
+				}
+				else
+				{
+					_socket.bind(_net, _port, SOCK_DGRAM);
+					fds = _socket.get(_net);
+				}
 
+				// remember one socket of each address family for sending
+				for (std::list<int>::const_iterator iter = fds.begin(); iter != fds.end(); iter++)
+				{
+					struct sockaddr_storage addr;
+					socklen_t addrlen = sizeof(addr);
+					if (::getsockname(*iter, (struct sockaddr*)&addr, &addrlen) != 0) continue;
+
+					if ((addr.ss_family == AF_INET) && (_fd_inet == -1)) _fd_inet = *iter;
+					if ((addr.ss_family == AF_INET6) && (_fd_inet6 == -1)) _fd_inet6 = *iter;
 				}
-			} catch (const ibrcommon::udpsocket::SocketException &ex) {
+			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER(error) << "Failed to add UDP ConvergenceLayer on " << _net.toString() << ":" << _port << IBRCOMMON_LOGGER_ENDL;
 				IBRCOMMON_LOGGER(error) << "      Error: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
+
+			_sender.start();
 		}
 
 		void UDPConvergenceLayer::componentDown()
 		{
 			_running = false;
-			_socket->shutdown();
+			_sender.stop();
+			_sender.join();
+			_socket.shutdown();
 			stop();
 			join();
 		}
@@ -224,6 +261,9 @@ namespace dtn
 					IBRCOMMON_LOGGER(warning) << "Received a invalid bundle: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 				} catch (const ibrcommon::IOException &ex) {
 
+				} catch (const ibrcommon::vsocket_exception&) {
+					// the socket has been shut down
+					if (!_running) return;
 				}
 				yield();
 			}
@@ -239,5 +279,160 @@ namespace dtn
 		{
 			return "UDPConvergenceLayer";
 		}
+
+		UDPConvergenceLayer::Transmission::Transmission()
+		 : addrlen(0)
+		{
+			::memset(&addr, 0, sizeof(addr));
+		}
+
+		UDPConvergenceLayer::Transmission::Transmission(const dtn::data::EID &n, const ConvergenceLayer::Job &j, const struct sockaddr *a, socklen_t alen)
+		 : node(n), job(j), addrlen(alen)
+		{
+			::memset(&addr, 0, sizeof(addr));
+			::memcpy(&addr, a, std::min((size_t)alen, sizeof(addr)));
+		}
+
+		UDPConvergenceLayer::Transmission::~Transmission()
+		{
+		}
+
+		UDPConvergenceLayer::Sender::Pending::Pending(const Transmission &t, const dtn::data::MetaBundle &m, size_t l)
+		 : transmission(t), meta(m), length(l)
+		{
+		}
+
+		UDPConvergenceLayer::Sender::Pending::~Pending()
+		{
+		}
+
+		UDPConvergenceLayer::Sender::Sender(UDPConvergenceLayer &cl)
+		 : _cl(cl), _batch(BATCH_SIZE, cl.m_maxmsgsize), _fd(-1)
+		{
+			_pending.reserve(BATCH_SIZE);
+		}
+
+		UDPConvergenceLayer::Sender::~Sender()
+		{
+		}
+
+		bool UDPConvergenceLayer::Sender::__cancellation()
+		{
+			ibrcommon::Queue<Transmission>::abort();
+			return true;
+		}
+
+		void UDPConvergenceLayer::Sender::run()
+		{
+			try {
+				while (true)
+				{
+					// wait for the first bundle
+					add(ibrcommon::Queue<Transmission>::getnpop(true));
+
+					// take all other bundles which are already waiting
+					try {
+						while (!_batch.full())
+						{
+							add(ibrcommon::Queue<Transmission>::getnpop(false));
+						}
+					} catch (const ibrcommon::QueueUnblockedException &ex) {
+						if (ex.reason == ibrcommon::QueueUnblockedException::QUEUE_ABORT) throw;
+					}
+
+					flush();
+				}
+			} catch (const ibrcommon::QueueUnblockedException&) {
+				// queue aborted
+			}
+
+			// requeue all bundles which are not sent
+			for (std::vector<Pending>::const_iterator iter = _pending.begin(); iter != _pending.end(); iter++)
+			{
+				const ConvergenceLayer::Job &job = (*iter).transmission.job;
+				dtn::routing::RequeueBundleEvent::raise(job._destination, job._bundle);
+			}
+			_pending.clear();
+			_batch.clear();
+		}
+
+		void UDPConvergenceLayer::Sender::add(const Transmission &t)
+		{
+			const int fd = _cl.getSocket((const struct sockaddr*)&t.addr);
+
+			// a batch is sent with one socket
+			if ((fd != _fd) && !_batch.empty()) flush();
+			_fd = fd;
+
+			dtn::core::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
+
+			try {
+				// read the bundle out of the storage
+				const dtn::data::Bundle bundle = storage.get(t.job._bundle);
+
+				dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_CL_SEND_START);
+
+				// serialize the bundle directly into the send buffer
+				DatagramBatch::Buffer buf(_batch.next(), _batch.getMaxLength());
+				std::ostream stream(&buf);
+				dtn::data::DefaultSerializer serializer(stream);
+
+				if (serializer.getLength(bundle) <= _batch.getMaxLength())
+				{
+					serializer << bundle;
+				}
+				else
+				{
+					stream.setstate(std::ios::failbit);
+				}
+
+				// the stream fails if the bundle does not fit into the buffer
+				if (!stream.good())
+				{
+					// TODO: create a fragment of length "size"
+					IBRCOMMON_LOGGER_DEBUG(10) << "bundle " << t.job._bundle.toString() << " exceeds the mtu of the UDP convergence layer" << IBRCOMMON_LOGGER_ENDL;
+					dtn::net::TransferAbortedEvent::raise(t.node, t.job._bundle, dtn::net::TransferAbortedEvent::REASON_UNDEFINED);
+					return;
+				}
+
+				_batch.push(buf.written(), (const struct sockaddr*)&t.addr, t.addrlen);
+				_pending.push_back(Pending(t, dtn::data::MetaBundle(bundle), buf.written()));
+			} catch (const dtn::core::BundleStorage::NoBundleFoundException&) {
+				// send transfer aborted event
+				dtn::net::TransferAbortedEvent::raise(t.node, t.job._bundle, dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
+			}
+		}
+
+		void UDPConvergenceLayer::Sender::flush()
+		{
+			if (_batch.empty()) return;
+
+			const size_t sent = (_fd == -1) ? 0 : _batch.send(_fd);
+
+			for (size_t i = 0; i < _pending.size(); i++)
+			{
+				const Transmission &t = _pending[i].transmission;
+				const dtn::data::MetaBundle &meta = _pending[i].meta;
+
+				if (i >= sent)
+				{
+					// CL is busy, requeue bundle
+					dtn::routing::RequeueBundleEvent::raise(t.job._destination, t.job._bundle);
+					continue;
+				}
+
+				// the datagram carries no acknowledgement, the bundle is done once it is sent
+				dtn::core::Tracer::getInstance().record(meta, dtn::core::Tracer::STAGE_CL_SEND_END);
+
+				// account the transmitted bundle
+				ConvergenceLayer::account(dtn::core::Node::CONN_UDPIP, false, _pending[i].length);
+
+				// raise bundle event
+				dtn::net::TransferCompletedEvent::raise(t.job._destination, meta);
+				dtn::core::BundleEvent::raise(meta, dtn::core::BUNDLE_FORWARDED);
+			}
+
+			_pending.clear();
+		}
 	}
 }
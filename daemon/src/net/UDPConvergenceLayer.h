@@ -5,8 +5,14 @@
 #include "net/ConvergenceLayer.h"
 #include <ibrcommon/Exceptions.h>
 #include "net/DiscoveryServiceProvider.h"
+#include "net/DatagramBatch.h"
+#include <ibrdtn/data/MetaBundle.h>
 #include <ibrcommon/net/vinterface.h>
-#include <ibrcommon/net/udpsocket.h>
+#include <ibrcommon/net/vsocket.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/Thread.h>
+#include <vector>
 
 using namespace dtn::data;
 
@@ -18,6 +24,10 @@ namespace dtn
 		/**
 		 * This class implement a ConvergenceLayer for UDP/IP.
 		 * Each bundle is sent in exact one UDP datagram.
+		 *
+		 * Queued bundles are collected by a sender thread and transmitted
+		 * in batches with one system call. Incoming datagrams are read in
+		 * batches as well, see DatagramBatch.
 		 */
 		class UDPConvergenceLayer : public ConvergenceLayer, public dtn::daemon::IndependentComponent, public DiscoveryServiceProvider
 		{
@@ -59,21 +69,101 @@ namespace dtn
 			bool __cancellation();
 
 		private:
-			ibrcommon::udpsocket *_socket;
+			/**
+			 * A queued bundle with the resolved address of the peer.
+			 */
+			class Transmission
+			{
+			public:
+				Transmission();
+				Transmission(const dtn::data::EID &node, const ConvergenceLayer::Job &job, const struct sockaddr *addr, socklen_t addrlen);
+				~Transmission();
+
+				dtn::data::EID node;
+				ConvergenceLayer::Job job;
+				struct sockaddr_storage addr;
+				socklen_t addrlen;
+			};
+
+			/**
+			 * Takes all waiting bundles of the queue and sends them
+			 * with one system call.
+			 */
+			class Sender : public ibrcommon::JoinableThread, public ibrcommon::Queue<Transmission>
+			{
+			public:
+				Sender(UDPConvergenceLayer &cl);
+				virtual ~Sender();
+
+			protected:
+				void run();
+				bool __cancellation();
+
+			private:
+				/**
+				 * Serialize the bundle of a transmission into the batch.
+				 */
+				void add(const Transmission &t);
+
+				/**
+				 * Send all bundles of the batch and raise the events
+				 * for each of them.
+				 */
+				void flush();
+
+				/**
+				 * A bundle in the current batch.
+				 */
+				class Pending
+				{
+				public:
+					Pending(const Transmission &t, const dtn::data::MetaBundle &meta, size_t length);
+					~Pending();
+
+					Transmission transmission;
+					dtn::data::MetaBundle meta;
+					size_t length;
+				};
+
+				UDPConvergenceLayer &_cl;
+				DatagramBatch _batch;
+				std::vector<Pending> _pending;
+				int _fd;
+			};
+
+			/**
+			 * Returns the socket to use for a destination address.
+			 */
+			int getSocket(const struct sockaddr *addr) const;
+
+			ibrcommon::vsocket _socket;
 
 			ibrcommon::vinterface _net;
 			int _port;
-			int m_socket;
+
+			// bound sockets for IPv4 and IPv6, -1 if not available
+			int _fd_inet;
+			int _fd_inet6;
 
 			static const int DEFAULT_PORT;
 
+			// number of datagrams sent or received with one system call
+			static const size_t BATCH_SIZE;
+
 			unsigned int m_maxmsgsize;
 
-			ibrcommon::Mutex m_writelock;
 			ibrcommon::Mutex m_readlock;
 
-			bool _running;
+			// received datagrams and the next one to process
+			DatagramBatch _recv_batch;
+			size_t _recv_next;
 
+			// arrival of the current batch, see dtn::core::Metrics::now()
+			u_int64_t _recv_time;
+
+			Sender _sender;
+
+			bool _running;
 
 		};
 	}
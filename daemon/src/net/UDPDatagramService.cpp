@@ -8,15 +8,19 @@
 #include "net/UDPDatagramService.h"
 #include <ibrdtn/utils/Utils.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <algorithm>
 #include <vector>
 #include <string.h>
+#include <stdlib.h>
+#include <netdb.h>
 
 namespace dtn
 {
 	namespace net
 	{
 		UDPDatagramService::UDPDatagramService(const ibrcommon::vinterface &iface, int port, size_t mtu)
-		 : _iface(iface), _bind_port(port)
+		 : _iface(iface), _bind_port(port), _send_buffer(mtu), _recv_batch(RECV_BATCH_SIZE, mtu), _recv_next(0)
 		{
 			// set connection parameters
 			_params.max_msg_length = mtu - 2;	// minus 2 bytes because we encode seqno and flags into 2 bytes
@@ -59,8 +63,11 @@ namespace dtn
 		 */
 		void UDPDatagramService::send(const char &type, const char &flags, const unsigned int &seqno, const std::string &identifier, const char *buf, size_t length) throw (DatagramException)
 		{
+			if ((length + 2) > _send_buffer.size()) throw DatagramException("frame exceeds the mtu");
+
 			try {
-				char tmp[length + 2];
+				ibrcommon::MutexLock l(_send_lock);
+				char *tmp = &_send_buffer[0];
 
 				// add a 2-byte header - type of frame first
 				tmp[0] = type;
@@ -94,8 +101,11 @@ namespace dtn
 		 */
 		void UDPDatagramService::send(const char &type, const char &flags, const unsigned int &seqno, const char *buf, size_t length) throw (DatagramException)
 		{
+			if ((length + 2) > _send_buffer.size()) throw DatagramException("frame exceeds the mtu");
+
 			try {
-				char tmp[length];
+				ibrcommon::MutexLock l(_send_lock);
+				char *tmp = &_send_buffer[0];
 
 				// add a 2-byte header - type of frame first
 				tmp[0] = type;
@@ -127,10 +137,46 @@ namespace dtn
 		size_t UDPDatagramService::recvfrom(char *buf, size_t length, char &type, char &flags, unsigned int &seqno, std::string &address) throw (DatagramException)
 		{
 			try {
-				char tmp[length + 2];
-				std::string from;
-				unsigned int port;
-				size_t ret = receive(tmp, length + 2, from, port);
+				const char *tmp = NULL;
+				size_t ret = 0;
+				size_t slot = 0;
+
+				while (true)
+				{
+					// read the next batch if all frames are processed
+					while (_recv_next >= _recv_batch.size())
+					{
+						_recv_next = 0;
+						_recv_batch.clear();
+
+						std::list<int> fds;
+						_socket.select(fds, NULL);
+
+						for (std::list<int>::const_iterator iter = fds.begin(); iter != fds.end(); iter++)
+						{
+							if (_recv_batch.receive(*iter, false) > 0) break;
+						}
+					}
+
+					slot = _recv_next++;
+					tmp = _recv_batch.getData(slot);
+					ret = _recv_batch.getLength(slot);
+
+					// drop frames which do not fit into the buffers, a part of the data is missing
+					if (_recv_batch.isTruncated(slot) || ((ret >= 2) && ((ret - 2) > length)))
+					{
+						IBRCOMMON_LOGGER(warning) << "UDPDatagramService: frame larger than the MTU of " << _recv_batch.getMaxLength() << " bytes dropped" << IBRCOMMON_LOGGER_ENDL;
+						continue;
+					}
+
+					if (ret < 2)
+					{
+						IBRCOMMON_LOGGER_DEBUG(20) << "UDPDatagramService: frame too short dropped" << IBRCOMMON_LOGGER_ENDL;
+						continue;
+					}
+
+					break;
+				}
 
 				// first byte if the type
 				type = tmp[0];
@@ -139,14 +185,28 @@ namespace dtn
 				flags = 0x0f & (tmp[1] >> 4);
 				seqno = 0x0f & tmp[1];
 
+				// decode the address of the sender
+				char host[NI_MAXHOST];
+				char serv[NI_MAXSERV];
+				if (::getnameinfo(_recv_batch.getAddress(slot), _recv_batch.getAddressLength(slot), host, sizeof(host), serv, sizeof(serv), NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+				{
+					throw DatagramException("invalid sender address");
+				}
+
+				const std::string from(host);
+				const unsigned int port = ::atoi(serv);
+
 				address = UDPDatagramService::encode(from, port);
 
 				// copy payload to the destination buffer
-				::memcpy(buf, &tmp[2], ret - 2);
+				const size_t payload = ret - 2;
+				::memcpy(buf, &tmp[2], payload);
 
 				IBRCOMMON_LOGGER_DEBUG(20) << "UDPDatagramService::recvfrom() type: " << std::hex << (int)type << "; flags: " << std::hex << (int)flags << "; seqno: " << seqno << "; address: [" << from << "]:" << std::dec << port << IBRCOMMON_LOGGER_ENDL;
 
-				return ret - 2;
+				return payload;
+			} catch (const DatagramException&) {
+				throw;
 			} catch (const ibrcommon::Exception&) {
 				throw DatagramException("receive failed");
 			}
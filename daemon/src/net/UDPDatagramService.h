@@ -10,8 +10,11 @@
 
 #include "net/DatagramConvergenceLayer.h"
 #include "net/DatagramConnectionParameter.h"
+#include "net/DatagramBatch.h"
 #include <ibrcommon/net/udpsocket.h>
 #include <ibrcommon/net/vinterface.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <vector>
 
 namespace dtn
 {
@@ -50,7 +53,8 @@ namespace dtn
 			virtual void send(const char &type, const char &flags, const unsigned int &seqno, const char *buf, size_t length) throw (DatagramException);
 
 			/**
-			 * Receive an incoming datagram.
+			 * Receive an incoming datagram. All datagrams waiting on the socket
+			 * are read at once and returned by the following calls.
 			 * @param buf A buffer to catch the incoming data.
 			 * @param length The length of the buffer.
 			 * @param address A buffer for the address of the sender.
@@ -96,10 +100,19 @@ namespace dtn
 
 
 			const static int BROADCAST_PORT = 5551;
+			const static size_t RECV_BATCH_SIZE = 16;
 			const ibrcommon::vinterface _iface;
 			const int _bind_port;
 
 			DatagramConnectionParameter _params;
+
+			// buffer for outgoing frames
+			ibrcommon::Mutex _send_lock;
+			std::vector<char> _send_buffer;
+
+			// received frames and the next one to process
+			DatagramBatch _recv_batch;
+			size_t _recv_next;
 		};
 
 	} /* namespace net */
@@ -21,7 +21,10 @@
 #include "core/BundleEvent.h"
 #include "core/NodeEvent.h"
 #include "core/TimeEvent.h"
+#include "core/GlobalEvent.h"
 #include "routing/NodeHandshakeEvent.h"
+#include "core/Metrics.h"
+#include "core/Tracer.h"
 
 #include <ibrcommon/Logger.h>
 #include <ibrcommon/thread/MutexLock.h>
@@ -83,6 +86,8 @@ namespace dtn
 			// acquire the transfer of this bundle, could throw already in transit or no resource left exception
 			entry.acquireTransfer(id);
 
+			dtn::core::Tracer::getInstance().record(id, dtn::core::Tracer::STAGE_ROUTED);
+
 			// transfer the bundle to the next hop
 			dtn::core::BundleCore::getInstance().transferTo(entry.eid, id);
 		}
@@ -109,8 +114,19 @@ namespace dtn
 		/**
 		 * implementation of the BaseRouter class
 		 */
-		BaseRouter::BaseRouter(dtn::core::BundleStorage &storage)
-		 : _storage(storage)
+		/**
+		 * The vectors are sent to other nodes, which expect two hash functions.
+		 * A false positive of the known bundles is confirmed locally, while a false
+		 * positive of the purged bundles deletes a bundle on a neighbor.
+		 */
+		static const size_t VECTOR_HASHES = 2;
+		static const double KNOWN_FALSE_POSITIVES = 0.01;
+		static const double PURGED_FALSE_POSITIVES = 0.001;
+
+		BaseRouter::BaseRouter(dtn::core::BundleStorage &storage, size_t bundles)
+		 : _known_bundles(24, 3600, RotatingBloomFilter::getSize(bundles, KNOWN_FALSE_POSITIVES, VECTOR_HASHES), VECTOR_HASHES, 512),
+		   _purged_bundles(24, 3600, RotatingBloomFilter::getSize(bundles, PURGED_FALSE_POSITIVES, VECTOR_HASHES), VECTOR_HASHES),
+		   _storage(storage)
 		{
 			// register myself for all extensions
 			Extension::_router = this;
@@ -147,6 +163,7 @@ namespace dtn
 			bindEvent(dtn::core::TimeEvent::className);
 			bindEvent(dtn::core::BundleGeneratedEvent::className);
 			bindEvent(dtn::net::ConnectionEvent::className);
+			bindEvent(dtn::core::GlobalEvent::className);
 
 			for (std::list<BaseRouter::Extension*>::iterator iter = _extensions.begin(); iter != _extensions.end(); iter++)
 			{
@@ -177,6 +194,7 @@ namespace dtn
 			unbindEvent(dtn::core::TimeEvent::className);
 			unbindEvent(dtn::core::BundleGeneratedEvent::className);
 			unbindEvent(dtn::net::ConnectionEvent::className);
+			unbindEvent(dtn::core::GlobalEvent::className);
 
 			// delete all extensions
 			for (std::list<BaseRouter::Extension*>::iterator iter = _extensions.begin(); iter != _extensions.end(); iter++)
@@ -236,6 +254,9 @@ namespace dtn
 						}
 					} catch (const dtn::core::BundleStorage::NoBundleFoundException&) { };
 
+					// measure the time since the storage of the bundle
+					forwarded(event.getBundle());
+
 					// lock the list of neighbors
 					ibrcommon::MutexLock l(_neighbor_database);
 					NeighborDatabase::NeighborEntry &entry = _neighbor_database.get(event.getPeer());
@@ -279,8 +300,12 @@ namespace dtn
 					{
 						// store the bundle into a storage module
 						_storage.store(received.bundle);
+						stored(received.bundle);
 
-						// set the bundle as known
+						// account the time between the reception and the storage
+						dtn::core::Metrics::getInstance().ingest_latency.record(dtn::core::Metrics::now() - received.received);
+
+						// set the bundle as known, a local bundle known already is not added twice
 						setKnown(received.bundle);
 
 						// raise the queued event to notify all receivers about the new bundle
@@ -293,8 +318,12 @@ namespace dtn
 						// security methods modifies the bundle, thus we need a copy of it
 						dtn::data::Bundle bundle = received.bundle;
 
-						// lets see if signatures and hashes are correct and remove them if possible
-						dtn::security::SecurityManager::getInstance().verify(bundle);
+						// lets see if signatures and hashes are correct and remove them if possible,
+						// unless the receive pipeline has done this already
+						if (!received.verified)
+						{
+							dtn::security::SecurityManager::getInstance().verify(bundle);
+						}
 
 						// prevent loops
 						{
@@ -310,6 +339,11 @@ namespace dtn
 						// store the bundle into a storage module
 						_storage.store(received.bundle);
 #endif
+						stored(received.bundle);
+
+						// account the time between the reception and the storage
+						dtn::core::Metrics::getInstance().ingest_latency.record(dtn::core::Metrics::now() - received.received);
+
 						// set the bundle as known
 						setKnown(received.bundle);
 
@@ -349,6 +383,7 @@ namespace dtn
 				try {
 					// store the bundle into a storage module
 					_storage.store(generated.bundle);
+					stored(generated.bundle);
 
 					// raise the queued event to notify all receivers about the new bundle
  					QueueBundleEvent::raise(generated.bundle, dtn::core::BundleCore::local);
@@ -403,32 +438,87 @@ namespace dtn
 			return _storage;
 		}
 
+		void BaseRouter::stored(const dtn::data::BundleID &id)
+		{
+			dtn::core::Tracer::getInstance().record(id, dtn::core::Tracer::STAGE_STORED);
+
+			// limit the number of tracked bundles
+			static const size_t MAX_TRACKED = 4096;
+
+			// bundles not transferred within this time are not tracked anymore
+			static const u_int64_t MAX_AGE = 3600ULL * 1000000;
+
+			const u_int64_t now = dtn::core::Metrics::now();
+
+			ibrcommon::MutexLock l(_stored_times_lock);
+
+			// a bundle stored again is tracked from now on
+			std::map<dtn::data::BundleID, stored_list::iterator>::iterator iter = _stored_index.find(id);
+			if (iter != _stored_index.end())
+			{
+				_stored_times.erase(iter->second);
+				_stored_index.erase(iter);
+			}
+
+			// the list is ordered by time, thus only the oldest entries are checked
+			while (!_stored_times.empty() && (((now - _stored_times.front().second) > MAX_AGE) || (_stored_times.size() >= MAX_TRACKED)))
+			{
+				_stored_index.erase(_stored_times.front().first);
+				_stored_times.pop_front();
+			}
+
+			_stored_index[id] = _stored_times.insert(_stored_times.end(), std::make_pair(id, now));
+		}
+
+		void BaseRouter::forwarded(const dtn::data::BundleID &id)
+		{
+			u_int64_t time = 0;
+
+			{
+				ibrcommon::MutexLock l(_stored_times_lock);
+				std::map<dtn::data::BundleID, stored_list::iterator>::iterator iter = _stored_index.find(id);
+				if (iter == _stored_index.end()) return;
+
+				time = iter->second->second;
+				_stored_times.erase(iter->second);
+				_stored_index.erase(iter);
+			}
+
+			dtn::core::Metrics::getInstance().forward_latency.record(dtn::core::Metrics::now() - time);
+		}
+
 		void BaseRouter::setKnown(const dtn::data::MetaBundle &meta)
 		{
 			ibrcommon::MutexLock l(_known_bundles_lock);
-			return _known_bundles.add(meta);
+			_known_bundles.add(meta);
 		}
 
 		// set the bundle as known
 		bool BaseRouter::isKnown(const dtn::data::BundleID &id)
 		{
 			ibrcommon::MutexLock l(_known_bundles_lock);
-			return _known_bundles.contains(id);
+			return _known_bundles.has(id);
 		}
 
-		const SummaryVector BaseRouter::getSummaryVector()
+		const refcnt_ptr<SummaryVector> BaseRouter::getSummaryVector()
 		{
 			ibrcommon::MutexLock l(_known_bundles_lock);
 			return _known_bundles.getSummaryVector();
 		}
 
+		const refcnt_ptr<InvertibleBloomFilter> BaseRouter::getInvertibleSummaryVector()
+		{
+			ibrcommon::MutexLock l(_known_bundles_lock);
+			return _known_bundles.getInvertibleBloomFilter();
+		}
+
 		void BaseRouter::addPurgedBundle(const dtn::data::MetaBundle &meta)
 		{
 			ibrcommon::MutexLock l(_purged_bundles_lock);
 			return _purged_bundles.add(meta);
 		}
 
-		const SummaryVector BaseRouter::getPurgedBundles()
+		const refcnt_ptr<SummaryVector> BaseRouter::getPurgedBundles()
 		{
 			ibrcommon::MutexLock l(_purged_bundles_lock);
 			return _purged_bundles.getSummaryVector();
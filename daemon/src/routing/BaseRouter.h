@@ -11,6 +11,7 @@
 #include "Component.h"
 #include "routing/NeighborDatabase.h"
 #include "routing/BundleSummary.h"
+#include "routing/RotatingBloomFilter.h"
 #include "routing/NodeHandshake.h"
 #include "core/EventReceiver.h"
 #include "core/BundleStorage.h"
@@ -21,6 +22,8 @@
 
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Conditional.h>
+#include <map>
+#include <list>
 
 
 namespace dtn
@@ -152,7 +155,12 @@ namespace dtn
 			};
 
 		public:
-			BaseRouter(dtn::core::BundleStorage &storage);
+			/**
+			 * @param storage The storage of all bundles.
+			 * @param bundles Expected number of bundles known at the same time,
+			 * sizes the summary and purge vectors.
+			 */
+			BaseRouter(dtn::core::BundleStorage &storage, size_t bundles = 4096);
 			~BaseRouter();
 
 			/**
@@ -182,7 +190,10 @@ namespace dtn
 			dtn::core::BundleStorage &getStorage();
 
 			/**
-			 * This method returns true, if the given BundleID is known.
+			 * This method returns true, if the given BundleID is known. A bundle
+			 * is known until the filter it has been added to is dropped. Unlike
+			 * the summary vector, the check has no false positives, thus a new
+			 * bundle is never dropped as known.
 			 * @param id
 			 * @return
 			 */
@@ -195,16 +206,25 @@ namespace dtn
 			void setKnown(const dtn::data::MetaBundle &meta);
 
 			/**
-			 * Get a vector (bloomfilter) of all known bundles.
+			 * Get a vector (bloomfilter) of all known bundles. The returned
+			 * snapshot is shared and must not be modified.
 			 * @return
 			 */
-			const SummaryVector getSummaryVector();
+			const refcnt_ptr<SummaryVector> getSummaryVector();
 
 			/**
-			 * Get a vector (bloomfilter) of all purged bundles.
+			 * Get a lookup table of all known bundles for a set reconciliation.
+			 * The returned snapshot is shared and must not be modified.
 			 * @return
 			 */
-			const SummaryVector getPurgedBundles();
+			const refcnt_ptr<InvertibleBloomFilter> getInvertibleSummaryVector();
+
+			/**
+			 * Get a vector (bloomfilter) of all purged bundles. The returned
+			 * snapshot is shared and must not be modified.
+			 * @return
+			 */
+			const refcnt_ptr<SummaryVector> getPurgedBundles();
 
 			/**
 			 * Add a bundle to the purge vector of this daemon.
@@ -228,16 +248,33 @@ namespace dtn
 			virtual void componentDown();
 
 		private:
+			/**
+			 * Remember the time a bundle has been stored to measure
+			 * the time until its first transfer.
+			 */
+			void stored(const dtn::data::BundleID &id);
+
+			/**
+			 * Record the time since the storage of a transferred bundle.
+			 */
+			void forwarded(const dtn::data::BundleID &id);
+
 			ibrcommon::Mutex _known_bundles_lock;
-			dtn::routing::BundleSummary _known_bundles;
+			dtn::routing::RotatingBloomFilter _known_bundles;
 
 			ibrcommon::Mutex _purged_bundles_lock;
-			dtn::routing::BundleSummary _purged_bundles;
+			dtn::routing::RotatingBloomFilter _purged_bundles;
 
 			dtn::core::BundleStorage &_storage;
 			std::list<BaseRouter::Extension*> _extensions;
 
 			NeighborDatabase _neighbor_database;
+
+			// storage time of bundles not transferred yet, the oldest first
+			typedef std::list<std::pair<dtn::data::BundleID, u_int64_t> > stored_list;
+			ibrcommon::Mutex _stored_times_lock;
+			stored_list _stored_times;
+			std::map<dtn::data::BundleID, stored_list::iterator> _stored_index;
 		};
 	}
 }
@@ -0,0 +1,278 @@
+/*
+ * InvertibleBloomFilter.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "routing/InvertibleBloomFilter.h"
+#include <ibrdtn/data/SDNV.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <list>
+
+namespace dtn
+{
+	namespace routing
+	{
+		// upper limit for the size of received tables
+		static const size_t MAX_CELLS = 65536;
+
+		static size_t roundup(size_t cells)
+		{
+			size_t ret = InvertibleBloomFilter::HASHES;
+			while (ret < cells) ret <<= 1;
+			return ret;
+		}
+
+		InvertibleBloomFilter::Cell::Cell()
+		 : keysum(0), count(0), hashsum(0)
+		{
+		}
+
+		bool InvertibleBloomFilter::Cell::empty() const
+		{
+			return (count == 0) && (keysum == 0) && (hashsum == 0);
+		}
+
+		bool InvertibleBloomFilter::Cell::pure() const
+		{
+			return ((count == 1) || (count == -1)) && (hashsum == InvertibleBloomFilter::check(keysum));
+		}
+
+		InvertibleBloomFilter::InvertibleBloomFilter(size_t cells)
+		 : _cells(roundup(cells))
+		{
+		}
+
+		InvertibleBloomFilter::~InvertibleBloomFilter()
+		{
+		}
+
+		void InvertibleBloomFilter::insert(const dtn::data::BundleID &id)
+		{
+			update(_cells, key(id), 1);
+		}
+
+		void InvertibleBloomFilter::remove(const dtn::data::BundleID &id)
+		{
+			update(_cells, key(id), -1);
+		}
+
+		void InvertibleBloomFilter::clear()
+		{
+			_cells.assign(_cells.size(), Cell());
+		}
+
+		size_t InvertibleBloomFilter::size() const
+		{
+			return _cells.size();
+		}
+
+		InvertibleBloomFilter& InvertibleBloomFilter::operator+=(const InvertibleBloomFilter &other)
+		{
+			for (size_t i = 0; (i < _cells.size()) && (i < other._cells.size()); i++)
+			{
+				Cell &c = _cells[i];
+				const Cell &o = other._cells[i];
+				c.count += o.count;
+				c.keysum ^= o.keysum;
+				c.hashsum ^= o.hashsum;
+			}
+
+			return (*this);
+		}
+
+		InvertibleBloomFilter& InvertibleBloomFilter::operator-=(const InvertibleBloomFilter &other)
+		{
+			for (size_t i = 0; (i < _cells.size()) && (i < other._cells.size()); i++)
+			{
+				Cell &c = _cells[i];
+				const Cell &o = other._cells[i];
+				c.count -= o.count;
+				c.keysum ^= o.keysum;
+				c.hashsum ^= o.hashsum;
+			}
+
+			return (*this);
+		}
+
+		InvertibleBloomFilter InvertibleBloomFilter::fold(size_t cells) const
+		{
+			cells = roundup(cells);
+			if (cells >= _cells.size()) return (*this);
+
+			InvertibleBloomFilter ret(cells);
+
+			const size_t part = _cells.size() / HASHES;
+			const size_t retpart = cells / HASHES;
+
+			// the cell of a key within a partition is its hash modulo the partition size,
+			// thus all cells with the same remainder are merged
+			for (size_t p = 0; p < HASHES; p++)
+			{
+				for (size_t i = 0; i < part; i++)
+				{
+					Cell &c = ret._cells[(p * retpart) + (i & (retpart - 1))];
+					const Cell &o = _cells[(p * part) + i];
+					c.count += o.count;
+					c.keysum ^= o.keysum;
+					c.hashsum ^= o.hashsum;
+				}
+			}
+
+			return ret;
+		}
+
+		bool InvertibleBloomFilter::decode(std::set<u_int64_t> &positive, std::set<u_int64_t> &negative) const
+		{
+			std::vector<Cell> cells = _cells;
+			std::list<size_t> pure;
+
+			for (size_t i = 0; i < cells.size(); i++)
+			{
+				if (cells[i].pure()) pure.push_back(i);
+			}
+
+			while (!pure.empty())
+			{
+				const Cell &c = cells[pure.front()];
+				pure.pop_front();
+
+				// the cell may have changed since it was queued
+				if (!c.pure()) continue;
+
+				const u_int64_t k = c.keysum;
+				const int32_t count = c.count;
+
+				if (count > 0) positive.insert(k);
+				else negative.insert(k);
+
+				// a table can not hold more distinct keys than cells
+				if ((positive.size() + negative.size()) > cells.size()) return false;
+
+				// peel the key off all its cells
+				update(cells, k, -count);
+
+				for (size_t p = 0; p < HASHES; p++)
+				{
+					const size_t i = index(k, p);
+					if (cells[i].pure()) pure.push_back(i);
+				}
+			}
+
+			for (size_t i = 0; i < cells.size(); i++)
+			{
+				if (!cells[i].empty()) return false;
+			}
+
+			return true;
+		}
+
+		u_int64_t InvertibleBloomFilter::key(const dtn::data::BundleID &id)
+		{
+			const std::string data = id.toString();
+
+			// 64-bit FNV-1a
+			u_int64_t hash = 14695981039346656037ULL;
+			for (std::string::const_iterator iter = data.begin(); iter != data.end(); iter++)
+			{
+				hash ^= (unsigned char)(*iter);
+				hash *= 1099511628211ULL;
+			}
+
+			return mix(hash);
+		}
+
+		void InvertibleBloomFilter::update(std::vector<Cell> &cells, const u_int64_t key, const int32_t count) const
+		{
+			const u_int32_t hash = check(key);
+
+			for (size_t p = 0; p < HASHES; p++)
+			{
+				Cell &c = cells[index(key, p)];
+				c.count += count;
+				c.keysum ^= key;
+				c.hashsum ^= hash;
+			}
+		}
+
+		size_t InvertibleBloomFilter::index(const u_int64_t key, const size_t partition) const
+		{
+			const size_t part = _cells.size() / HASHES;
+			const u_int64_t hash = mix(key + ((partition + 1) * 0x9e3779b97f4a7c15ULL));
+			return (partition * part) + (size_t)(hash & (part - 1));
+		}
+
+		u_int64_t InvertibleBloomFilter::mix(u_int64_t value)
+		{
+			// finalizer of splitmix64
+			value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+			return value ^ (value >> 31);
+		}
+
+		u_int32_t InvertibleBloomFilter::check(const u_int64_t key)
+		{
+			return (u_int32_t)(mix(key ^ 0xc2b2ae3d27d4eb4fULL) >> 32);
+		}
+
+		size_t InvertibleBloomFilter::getLength() const
+		{
+			return dtn::data::SDNV(_cells.size()).getLength() + (_cells.size() * CELL_LENGTH);
+		}
+
+		std::ostream &operator<<(std::ostream &stream, const InvertibleBloomFilter &obj)
+		{
+			dtn::data::SDNV size(obj._cells.size());
+			stream << size;
+
+			// all values are written in network byte order
+			for (std::vector<InvertibleBloomFilter::Cell>::const_iterator iter = obj._cells.begin(); iter != obj._cells.end(); iter++)
+			{
+				const InvertibleBloomFilter::Cell &c = (*iter);
+				char data[InvertibleBloomFilter::CELL_LENGTH];
+
+				for (int i = 0; i < 8; i++) data[i] = (char)(c.keysum >> (56 - (8 * i)));
+				for (int i = 0; i < 4; i++) data[8 + i] = (char)((u_int32_t)c.count >> (24 - (8 * i)));
+				for (int i = 0; i < 4; i++) data[12 + i] = (char)(c.hashsum >> (24 - (8 * i)));
+
+				stream.write(data, InvertibleBloomFilter::CELL_LENGTH);
+			}
+
+			return stream;
+		}
+
+		std::istream &operator>>(std::istream &stream, InvertibleBloomFilter &obj)
+		{
+			dtn::data::SDNV size;
+			stream >> size;
+
+			const size_t cells = size.getValue();
+
+			if ((cells < InvertibleBloomFilter::HASHES) || (cells > MAX_CELLS) || ((cells & (cells - 1)) != 0))
+			{
+				throw dtn::InvalidDataException("invalid size of invertible bloom filter");
+			}
+
+			obj._cells.assign(cells, InvertibleBloomFilter::Cell());
+
+			for (std::vector<InvertibleBloomFilter::Cell>::iterator iter = obj._cells.begin(); iter != obj._cells.end(); iter++)
+			{
+				InvertibleBloomFilter::Cell &c = (*iter);
+				unsigned char data[InvertibleBloomFilter::CELL_LENGTH];
+
+				if (!stream.read((char*)data, InvertibleBloomFilter::CELL_LENGTH))
+				{
+					throw dtn::InvalidDataException("invertible bloom filter is truncated");
+				}
+
+				u_int32_t count = 0;
+				for (int i = 0; i < 8; i++) c.keysum = (c.keysum << 8) | data[i];
+				for (int i = 0; i < 4; i++) count = (count << 8) | data[8 + i];
+				for (int i = 0; i < 4; i++) c.hashsum = (c.hashsum << 8) | data[12 + i];
+				c.count = (int32_t)count;
+			}
+
+			return stream;
+		}
+	}
+}
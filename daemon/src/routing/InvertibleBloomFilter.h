@@ -0,0 +1,125 @@
+/*
+ * InvertibleBloomFilter.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef INVERTIBLEBLOOMFILTER_H_
+#define INVERTIBLEBLOOMFILTER_H_
+
+#include <ibrdtn/data/BundleID.h>
+#include <sys/types.h>
+#include <iostream>
+#include <vector>
+#include <set>
+
+namespace dtn
+{
+	namespace routing
+	{
+		/**
+		 * An invertible Bloom lookup table of bundle IDs. The difference of two tables
+		 * can be decoded into the IDs contained in only one of the sets, as long as the
+		 * difference is small compared to the number of cells. Each bundle ID is
+		 * represented by a 64-bit key, thus the decoded difference consists of keys.
+		 *
+		 * The cells are split into one partition per hash function. The number of cells
+		 * is a power of two, which allows to fold a table into a smaller one without
+		 * knowledge of the contained keys.
+		 */
+		class InvertibleBloomFilter
+		{
+		public:
+			/**
+			 * Number of hash functions (and partitions) of each table.
+			 */
+			static const size_t HASHES = 4;
+
+			/**
+			 * @param cells Number of cells, rounded up to a power of two.
+			 */
+			InvertibleBloomFilter(size_t cells = 512);
+			virtual ~InvertibleBloomFilter();
+
+			void insert(const dtn::data::BundleID &id);
+			void remove(const dtn::data::BundleID &id);
+			void clear();
+
+			/**
+			 * Returns the number of cells.
+			 */
+			size_t size() const;
+
+			/**
+			 * Add all keys of another table with the same size.
+			 */
+			InvertibleBloomFilter& operator+=(const InvertibleBloomFilter &other);
+
+			/**
+			 * Remove all keys of another table with the same size.
+			 */
+			InvertibleBloomFilter& operator-=(const InvertibleBloomFilter &other);
+
+			/**
+			 * Returns a copy of this table reduced to the given number of cells.
+			 * The size is rounded up to a power of two and never exceeds the own size.
+			 */
+			InvertibleBloomFilter fold(size_t cells) const;
+
+			/**
+			 * Decode the keys of this table. If this table is the difference of two
+			 * tables A - B, the keys only in A are returned as positive keys and the
+			 * keys only in B as negative keys.
+			 * @return True, if the table has been decoded completely.
+			 */
+			bool decode(std::set<u_int64_t> &positive, std::set<u_int64_t> &negative) const;
+
+			/**
+			 * Returns the key representing a bundle ID.
+			 */
+			static u_int64_t key(const dtn::data::BundleID &id);
+
+			/**
+			 * Returns the length of the serialized table.
+			 */
+			size_t getLength() const;
+
+			friend std::ostream &operator<<(std::ostream &stream, const InvertibleBloomFilter &obj);
+			friend std::istream &operator>>(std::istream &stream, InvertibleBloomFilter &obj);
+
+		private:
+			class Cell
+			{
+			public:
+				Cell();
+
+				bool empty() const;
+				bool pure() const;
+
+				u_int64_t keysum;
+				int32_t count;
+				u_int32_t hashsum;
+			};
+
+			/**
+			 * Add the key to all its cells or remove it from them.
+			 */
+			void update(std::vector<Cell> &cells, const u_int64_t key, const int32_t count) const;
+
+			/**
+			 * Returns the cell of the key in the given partition.
+			 */
+			size_t index(const u_int64_t key, const size_t partition) const;
+
+			static u_int64_t mix(u_int64_t value);
+			static u_int32_t check(const u_int64_t key);
+
+			// size of the serialized cells in bytes
+			static const size_t CELL_LENGTH = 16;
+
+			std::vector<Cell> _cells;
+		};
+	}
+}
+
+#endif /* INVERTIBLEBLOOMFILTER_H_ */
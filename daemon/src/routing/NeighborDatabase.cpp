@@ -6,6 +6,7 @@
  */
 
 #include "routing/NeighborDatabase.h"
+#include "routing/InvertibleBloomFilter.h"
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
 #include <limits>
@@ -26,9 +27,15 @@ namespace dtn
 		{ }
 
 		void NeighborDatabase::NeighborEntry::update(const ibrcommon::BloomFilter &bf, const size_t lifetime)
+		{
+			update(bf, std::set<u_int64_t>(), lifetime);
+		}
+
+		void NeighborDatabase::NeighborEntry::update(const ibrcommon::BloomFilter &bf, const std::set<u_int64_t> &missing, const size_t lifetime)
 		{
 			ibrcommon::ThreadsafeState<FILTER_REQUEST_STATE>::Locked l = _filter_state.lock();
 			_filter = bf;
+			_filter_missing = missing;
 
 			if (lifetime == 0)
 			{
@@ -64,7 +71,11 @@ namespace dtn
 
 			if (_filter_state == FILTER_AVAILABLE)
 			{
-				if (_filter.contains(id.toString()))
+				// bundles reported missing by a set reconciliation are unknown to the neighbor
+				const bool missing = !_filter_missing.empty() &&
+						(_filter_missing.find(InvertibleBloomFilter::key(id)) != _filter_missing.end());
+
+				if (!missing && _filter.contains(id.toString()))
 					return true;
 			}
 
@@ -16,6 +16,7 @@
 #include <ibrcommon/Exceptions.h>
 #include <ibrcommon/thread/ThreadsafeState.h>
 #include <map>
+#include <set>
 
 namespace dtn
 {
@@ -75,6 +76,14 @@ namespace dtn
 				 */
 				void update(const ibrcommon::BloomFilter &bf, const size_t lifetime = 0);
 
+				/**
+				 * updates the bloomfilter of this entry with the result of a set reconciliation
+				 * @param bf The bloomfilter object
+				 * @param missing Keys of bundles in the bloomfilter, which are unknown to the neighbor
+				 * @param lifetime The desired lifetime of this bloomfilter
+				 */
+				void update(const ibrcommon::BloomFilter &bf, const std::set<u_int64_t> &missing, const size_t lifetime = 0);
+
 				void reset();
 
 				void add(const dtn::data::MetaBundle&);
@@ -116,6 +125,7 @@ namespace dtn
 
 				// bloomfilter used as summary vector
 				ibrcommon::BloomFilter _filter;
+				std::set<u_int64_t> _filter_missing;
 				BundleSummary _summary;
 				size_t _filter_expire;
 
@@ -44,6 +44,19 @@ namespace dtn
 			return (_requests.find(identifier) != _requests.end());
 		}
 
+		void NodeHandshake::addRequest(const size_t identifier, const size_t parameter)
+		{
+			_requests.insert(identifier);
+			_request_parameters[identifier] = parameter;
+		}
+
+		size_t NodeHandshake::getRequestParameter(const size_t identifier) const
+		{
+			std::map<size_t, size_t>::const_iterator iter = _request_parameters.find(identifier);
+			if (iter == _request_parameters.end()) return 0;
+			return iter->second;
+		}
+
 		void NodeHandshake::addItem(NodeHandshakeItem *item)
 		{
 			_items.push_back(item);
@@ -98,6 +111,20 @@ namespace dtn
 					dtn::data::SDNV req(*iter);
 					stream << req;
 				}
+
+				// then the parameters of the requests, if there are any
+				if (!hs._request_parameters.empty())
+				{
+					dtn::data::SDNV number_of_parameters(hs._request_parameters.size());
+					stream << number_of_parameters;
+
+					for (std::map<size_t, size_t>::const_iterator iter = hs._request_parameters.begin(); iter != hs._request_parameters.end(); iter++)
+					{
+						dtn::data::SDNV id(iter->first);
+						dtn::data::SDNV value(iter->second);
+						stream << id << value;
+					}
+				}
 			}
 			else if (hs._type == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
@@ -147,6 +174,20 @@ namespace dtn
 					stream >> req;
 					hs._requests.insert(req.getValue());
 				}
+
+				// requests of older implementations end here
+				if (stream.peek() != std::char_traits<char>::eof())
+				{
+					dtn::data::SDNV number_of_parameters;
+					stream >> number_of_parameters;
+
+					for (size_t i = 0; i < number_of_parameters.getValue(); i++)
+					{
+						dtn::data::SDNV id, value;
+						stream >> id >> value;
+						hs._request_parameters[id.getValue()] = value.getValue();
+					}
+				}
 			}
 			else if (hs._type == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
@@ -263,7 +304,49 @@ namespace dtn
 			return stream;
 		}
 
-		size_t BloomFilterPurgeVector::identifier = 1;
+		size_t BloomFilterPurgeVector::identifier = 2;
+
+		InvertibleSummaryVector::InvertibleSummaryVector(const InvertibleBloomFilter &table)
+		 : _table(table)
+		{
+		}
+
+		InvertibleSummaryVector::InvertibleSummaryVector()
+		{
+		}
+
+		InvertibleSummaryVector::~InvertibleSummaryVector()
+		{
+		}
+
+		size_t InvertibleSummaryVector::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		size_t InvertibleSummaryVector::getLength() const
+		{
+			return _table.getLength();
+		}
+
+		const InvertibleBloomFilter& InvertibleSummaryVector::getTable() const
+		{
+			return _table;
+		}
+
+		std::ostream& InvertibleSummaryVector::serialize(std::ostream &stream) const
+		{
+			stream << _table;
+			return stream;
+		}
+
+		std::istream& InvertibleSummaryVector::deserialize(std::istream &stream)
+		{
+			stream >> _table;
+			return stream;
+		}
+
+		size_t InvertibleSummaryVector::identifier = 3;
 
 	} /* namespace routing */
 } /* namespace dtn */
@@ -9,6 +9,7 @@
 #define NODEHANDSHAKE_H_
 
 #include "routing/SummaryVector.h"
+#include "routing/InvertibleBloomFilter.h"
 #include <ibrdtn/data/SDNV.h>
 #include <iostream>
 #include <sstream>
@@ -66,6 +67,28 @@ namespace dtn
 			SummaryVector _vector;
 		};
 
+		/**
+		 * A lookup table of all known bundles. The receiver subtracts its own table
+		 * to get the difference of both sets.
+		 */
+		class InvertibleSummaryVector : public NodeHandshakeItem
+		{
+		public:
+			InvertibleSummaryVector();
+			InvertibleSummaryVector(const InvertibleBloomFilter &table);
+			virtual ~InvertibleSummaryVector();
+			size_t getIdentifier() const;
+			size_t getLength() const;
+			std::ostream& serialize(std::ostream&) const;
+			std::istream& deserialize(std::istream&);
+			static size_t identifier;
+
+			const InvertibleBloomFilter& getTable() const;
+
+		private:
+			InvertibleBloomFilter _table;
+		};
+
 		class NodeHandshake
 		{
 		public:
@@ -83,6 +106,17 @@ namespace dtn
 
 			void addRequest(const size_t identifier);
 			bool hasRequest(const size_t identifier) const;
+
+			/**
+			 * Add a request with a parameter for the item. The parameters are appended
+			 * to the request, thus they are ignored by nodes not knowing them.
+			 */
+			void addRequest(const size_t identifier, const size_t parameter);
+
+			/**
+			 * Returns the parameter of a request or zero if there is none.
+			 */
+			size_t getRequestParameter(const size_t identifier) const;
 			void addItem(NodeHandshakeItem *item);
 			bool hasItem(const size_t identifier) const;
 
@@ -102,6 +136,7 @@ namespace dtn
 			size_t _lifetime;
 
 			std::set<size_t> _requests;
+			std::map<size_t, size_t> _request_parameters;
 			std::list<NodeHandshakeItem*> _items;
 			std::map<size_t, std::stringstream* > _raw_items;
 
@@ -20,10 +20,20 @@
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
 
+#include <limits>
+#include <math.h>
+
 namespace dtn
 {
 	namespace routing
 	{
+		const size_t NodeHandshakeExtension::DELTA_CELLS_MIN;
+		const size_t NodeHandshakeExtension::DELTA_CELLS_DEFAULT;
+		const size_t NodeHandshakeExtension::DELTA_CELLS_MAX;
+
+		// number of hash functions used by all summary vectors
+		static const size_t SUMMARY_VECTOR_HASHES = 2;
+
 		NodeHandshakeExtension::NodeHandshakeExtension()
 		 : _endpoint(*this)
 		{
@@ -33,9 +43,30 @@ namespace dtn
 		{
 		}
 
-		void NodeHandshakeExtension::requestHandshake(const dtn::data::EID&, NodeHandshake &request) const
+		NodeHandshakeExtension::DeltaState::DeltaState()
+		 : cells(DELTA_CELLS_DEFAULT), fallback(false), requested(false)
+		{
+		}
+
+		void NodeHandshakeExtension::requestHandshake(const dtn::data::EID &destination, NodeHandshake &request) const
 		{
 			request.addRequest(BloomFilterPurgeVector::identifier);
+
+			ibrcommon::MutexLock l(_delta_lock);
+			DeltaState &state = _delta_state[destination.getNode()];
+
+			if ((state.cells == 0) || state.fallback)
+			{
+				// request the complete summary vector
+				request.addRequest(BloomFilterSummaryVector::identifier);
+				state.requested = false;
+			}
+			else
+			{
+				// request a lookup table to get the difference to the own summary vector
+				request.addRequest(InvertibleSummaryVector::identifier, state.cells);
+				state.requested = true;
+			}
 		}
 
 		void NodeHandshakeExtension::responseHandshake(const dtn::data::EID&, const NodeHandshake &request, NodeHandshake &answer)
@@ -43,10 +74,23 @@ namespace dtn
 			if (request.hasRequest(BloomFilterSummaryVector::identifier))
 			{
 				// add own summary vector to the message
-				const SummaryVector vec = (**this).getSummaryVector();
+				const refcnt_ptr<SummaryVector> vec = (**this).getSummaryVector();
+
+				// create an item
+				BloomFilterSummaryVector *item = new BloomFilterSummaryVector(*vec);
+
+				// add it to the handshake
+				answer.addItem(item);
+			}
+
+			if (request.hasRequest(InvertibleSummaryVector::identifier))
+			{
+				// add own lookup table in the requested size to the message
+				const refcnt_ptr<InvertibleBloomFilter> table = (**this).getInvertibleSummaryVector();
+				const size_t cells = request.getRequestParameter(InvertibleSummaryVector::identifier);
 
 				// create an item
-				BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
+				InvertibleSummaryVector *item = new InvertibleSummaryVector(table->fold((cells > 0) ? cells : DELTA_CELLS_DEFAULT));
 
 				// add it to the handshake
 				answer.addItem(item);
@@ -55,10 +99,10 @@ namespace dtn
 			if (request.hasRequest(BloomFilterPurgeVector::identifier))
 			{
 				// add own purge vector to the message
-				const SummaryVector vec = (**this).getPurgedBundles();
+				const refcnt_ptr<SummaryVector> vec = (**this).getPurgedBundles();
 
 				// create an item
-				BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
+				BloomFilterPurgeVector *item = new BloomFilterPurgeVector(*vec);
 
 				// add it to the handshake
 				answer.addItem(item);
@@ -67,6 +111,12 @@ namespace dtn
 
 		void NodeHandshakeExtension::processHandshake(const dtn::data::EID &source, NodeHandshake &answer)
 		{
+			if (!processDelta(source, answer))
+			{
+				// request the complete summary vector right now
+				_endpoint.query(source.getNode(), true);
+			}
+
 			try {
 				const BloomFilterSummaryVector bfsv = answer.get<BloomFilterSummaryVector>();
 
@@ -82,6 +132,9 @@ namespace dtn
 				ibrcommon::MutexLock l(db);
 				NeighborDatabase::NeighborEntry &entry = db.get(source.getNode());
 				entry.update(filter, answer.getLifetime());
+
+				// size the next set reconciliation by the received filter
+				adjustDelta(source.getNode(), filter);
 			} catch (std::exception&) { };
 
 			try {
@@ -109,6 +162,138 @@ namespace dtn
 			} catch (std::exception&) { };
 		}
 
+		bool NodeHandshakeExtension::processDelta(const dtn::data::EID &source, NodeHandshake &answer)
+		{
+			const dtn::data::EID node = source.getNode();
+
+			{
+				ibrcommon::MutexLock l(_delta_lock);
+				DeltaState &state = _delta_state[node];
+
+				// nothing to do if no lookup table has been requested
+				if (!state.requested) return true;
+				state.requested = false;
+			}
+
+			try {
+				const InvertibleSummaryVector &isv = answer.get<InvertibleSummaryVector>();
+				const InvertibleBloomFilter &remote = isv.getTable();
+
+				// get the own summary vector and its lookup table in the size of the received one
+				const refcnt_ptr<SummaryVector> vec = (**this).getSummaryVector();
+				const InvertibleBloomFilter local = (**this).getInvertibleSummaryVector()->fold(remote.size());
+
+				std::set<u_int64_t> remote_only;
+				std::set<u_int64_t> local_only;
+
+				InvertibleBloomFilter diff = remote;
+				diff -= local;
+
+				if ((local.size() == remote.size()) && diff.decode(remote_only, local_only))
+				{
+					const size_t difference = remote_only.size() + local_only.size();
+
+					IBRCOMMON_LOGGER_DEBUG(10) << "set reconciliation with " << node.getString() << ": " << difference << " bundles differ" << IBRCOMMON_LOGGER_ENDL;
+
+					{
+						/**
+						 * The neighbor knows all own bundles, except of the bundles
+						 * only in the own set.
+						 */
+						NeighborDatabase &db = (**this).getNeighborDB();
+						ibrcommon::MutexLock l(db);
+						NeighborDatabase::NeighborEntry &entry = db.get(node);
+						entry.update(vec->getBloomFilter(), local_only, answer.getLifetime());
+					}
+
+					// size the next table by the current difference
+					const size_t next = getDeltaCells(difference);
+
+					ibrcommon::MutexLock l(_delta_lock);
+					_delta_state[node].cells = (next > 0) ? next : DELTA_CELLS_MAX;
+					return true;
+				}
+
+				// the difference is too large, the next table is sized by the bloomfilter
+				IBRCOMMON_LOGGER_DEBUG(10) << "set reconciliation with " << node.getString() << " failed with " << remote.size() << " cells" << IBRCOMMON_LOGGER_ENDL;
+			} catch (const NeighborDatabase::NeighborNotAvailableException&) {
+				// the neighbor is gone
+				return true;
+			} catch (const ibrcommon::Exception&) {
+				// the neighbor does not support set reconciliation
+				IBRCOMMON_LOGGER_DEBUG(10) << "set reconciliation is not supported by " << node.getString() << IBRCOMMON_LOGGER_ENDL;
+
+				ibrcommon::MutexLock l(_delta_lock);
+				_delta_state[node].cells = 0;
+				return false;
+			}
+
+			ibrcommon::MutexLock l(_delta_lock);
+			_delta_state[node].fallback = true;
+
+			return false;
+		}
+
+		void NodeHandshakeExtension::adjustDelta(const dtn::data::EID &node, const ibrcommon::BloomFilter &filter)
+		{
+			const refcnt_ptr<SummaryVector> vec = (**this).getSummaryVector();
+
+			ibrcommon::MutexLock l(_delta_lock);
+			std::map<dtn::data::EID, DeltaState>::iterator iter = _delta_state.find(node);
+
+			// only a fallback to the bloomfilter has to be adjusted
+			if ((iter == _delta_state.end()) || (iter->second.cells == 0) || !iter->second.fallback) return;
+
+			const size_t difference = estimateDifference(vec->getBloomFilter(), filter);
+			const size_t cells = getDeltaCells(difference);
+
+			IBRCOMMON_LOGGER_DEBUG(10) << "estimated difference to " << node.getString() << ": " << difference << " bundles" << IBRCOMMON_LOGGER_ENDL;
+
+			// stay with the bloomfilter until the difference fits into a table
+			if (cells > 0)
+			{
+				iter->second.cells = cells;
+				iter->second.fallback = false;
+			}
+		}
+
+		size_t NodeHandshakeExtension::getDeltaCells(const size_t difference)
+		{
+			// twice the difference keeps the probability of a failed decoding low
+			size_t cells = DELTA_CELLS_MIN;
+			while (cells < (2 * difference)) cells <<= 1;
+			return (cells > DELTA_CELLS_MAX) ? 0 : cells;
+		}
+
+		static double estimateSize(const size_t bits, const size_t set)
+		{
+			if (set >= bits) return (double)bits;
+			return -((double)bits / SUMMARY_VECTOR_HASHES) * log(1.0 - ((double)set / bits));
+		}
+
+		size_t NodeHandshakeExtension::estimateDifference(const ibrcommon::BloomFilter &a, const ibrcommon::BloomFilter &b)
+		{
+			// filters of different size can not be compared
+			if ((a.size() != b.size()) || (a.size() == 0)) return std::numeric_limits<size_t>::max() / 4;
+
+			const unsigned char *ta = a.table();
+			const unsigned char *tb = b.table();
+			size_t set_a = 0, set_b = 0, set_union = 0;
+
+			for (size_t i = 0; i < a.size(); i++)
+			{
+				set_a += __builtin_popcount(ta[i]);
+				set_b += __builtin_popcount(tb[i]);
+				set_union += __builtin_popcount(ta[i] | tb[i]);
+			}
+
+			// the number of elements is estimated by the number of set bits
+			const size_t bits = a.size() * 8;
+			const double difference = (2 * estimateSize(bits, set_union)) - estimateSize(bits, set_a) - estimateSize(bits, set_b);
+
+			return (difference > 0) ? (size_t)(difference + 0.5) : 0;
+		}
+
 		void NodeHandshakeExtension::notify(const dtn::core::Event *evt)
 		{
 			try {
@@ -185,12 +370,12 @@ namespace dtn
 			_blacklist.erase(eid);
 		}
 
-		void NodeHandshakeExtension::HandshakeEndpoint::query(const dtn::data::EID &origin)
+		void NodeHandshakeExtension::HandshakeEndpoint::query(const dtn::data::EID &origin, bool force)
 		{
 			{
 				ibrcommon::MutexLock l(_blacklist_lock);
 				// only query once each 60 seconds
-				if (_blacklist[origin] > dtn::utils::Clock::getUnixTimestamp()) return;
+				if (!force && (_blacklist[origin] > dtn::utils::Clock::getUnixTimestamp())) return;
 				_blacklist[origin] = dtn::utils::Clock::getUnixTimestamp() + 60;
 			}
 
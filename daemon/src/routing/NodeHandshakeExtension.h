@@ -42,11 +42,72 @@ namespace dtn
 			 */
 			void processHandshake(const dtn::data::EID &source, NodeHandshake &answer);
 
+			/**
+			 * Smallest number of cells of a requested lookup table.
+			 */
+			static const size_t DELTA_CELLS_MIN = 32;
+
+			/**
+			 * Initial number of cells of the lookup table requested from a neighbor.
+			 */
+			static const size_t DELTA_CELLS_DEFAULT = 64;
+
+			/**
+			 * Beyond this size of the lookup table the bloomfilter is smaller.
+			 */
+			static const size_t DELTA_CELLS_MAX = 512;
+
+			/**
+			 * Returns the number of cells needed for the given difference or
+			 * zero if the bloomfilter is smaller.
+			 */
+			static size_t getDeltaCells(const size_t difference);
+
+			/**
+			 * Estimate the number of bundles contained in only one of two summary vectors.
+			 */
+			static size_t estimateDifference(const ibrcommon::BloomFilter &a, const ibrcommon::BloomFilter &b);
+
 		protected:
 			void processHandshake(const dtn::data::Bundle &bundle);
 			const std::list<BaseRouter::Extension*>& getExtensions();
 
 		private:
+			/**
+			 * Subtract the own lookup table from the received one and update
+			 * the summary vector of the neighbor with the difference.
+			 * @return False, if the neighbor has not been updated.
+			 */
+			bool processDelta(const dtn::data::EID &source, NodeHandshake &answer);
+
+			/**
+			 * Size the next lookup table requested from a neighbor after a fallback
+			 * to the bloomfilter.
+			 */
+			void adjustDelta(const dtn::data::EID &node, const ibrcommon::BloomFilter &filter);
+
+			/**
+			 * State of the set reconciliation with a neighbor.
+			 */
+			class DeltaState
+			{
+			public:
+				DeltaState();
+
+				// number of cells to request, zero if the neighbor does not support it
+				size_t cells;
+
+				// request the bloomfilter until the difference fits into a table
+				bool fallback;
+
+				// a lookup table has been requested
+				bool requested;
+			};
+
+			// the state is updated on requests, which are created by a const method
+			mutable ibrcommon::Mutex _delta_lock;
+			mutable std::map<dtn::data::EID, DeltaState> _delta_state;
+
 			class HandshakeEndpoint : public dtn::core::AbstractWorker
 			{
 			public:
@@ -54,7 +115,7 @@ namespace dtn
 				virtual ~HandshakeEndpoint();
 
 				void callbackBundleReceived(const Bundle &b);
-				void query(const dtn::data::EID &eid);
+				void query(const dtn::data::EID &eid, bool force = false);
 
 				void send(const dtn::data::Bundle &b);
 
@@ -7,6 +7,7 @@
 
 #include "routing/QueueBundleEvent.h"
 #include "core/BundleCore.h"
+#include "core/Tracer.h"
 
 namespace dtn
 {
@@ -25,6 +26,8 @@ namespace dtn
 
 		void QueueBundleEvent::raise(const dtn::data::MetaBundle &bundle, const dtn::data::EID &origin)
 		{
+			dtn::core::Tracer::getInstance().record(bundle, dtn::core::Tracer::STAGE_QUEUED);
+
 			// raise the new event
 			raiseEvent( new QueueBundleEvent(bundle, origin) );
 		}
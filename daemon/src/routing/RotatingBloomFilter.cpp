@@ -0,0 +1,191 @@
+/*
+ * RotatingBloomFilter.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "routing/RotatingBloomFilter.h"
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/Logger.h>
+#include <math.h>
+
+namespace dtn
+{
+	namespace routing
+	{
+		RotatingBloomFilter::RotatingBloomFilter(size_t buckets, size_t interval, size_t size, size_t hashes, size_t cells)
+		 : _interval((interval > 0) ? interval : 1), _buckets((buckets > 0) ? buckets : 1, ibrcommon::BloomFilter(size, hashes)),
+		   _members(_buckets.size()), _first_slot(dtn::utils::Clock::getTime() / _interval), _merged(size, hashes),
+		   _snapshot(new SummaryVector(_merged)), _dirty(false),
+		   _merged_table(cells), _table_snapshot(new InvertibleBloomFilter(_merged_table)), _table_dirty(false)
+		{
+			if (cells > 0)
+			{
+				_tables.assign(_buckets.size(), InvertibleBloomFilter(cells));
+			}
+		}
+
+		RotatingBloomFilter::~RotatingBloomFilter()
+		{
+		}
+
+		void RotatingBloomFilter::add(const dtn::data::MetaBundle &bundle)
+		{
+			const dtn::data::BundleID &id = bundle;
+			const std::string data = id.toString();
+
+			// a hit of the Bloom filters may be a false positive, thus ask the members
+			if (has(id)) return;
+
+			const size_t index = getSlot(bundle.expiretime) % _buckets.size();
+
+			_members[index].insert(id);
+			_buckets[index].insert(data);
+			_merged.insert(data);
+			_dirty = true;
+
+			if (!_tables.empty())
+			{
+				_tables[index].insert(id);
+				_merged_table.insert(id);
+				_table_dirty = true;
+			}
+		}
+
+		bool RotatingBloomFilter::contains(const dtn::data::BundleID &id) const
+		{
+			return _merged.contains(id.toString());
+		}
+
+		bool RotatingBloomFilter::has(const dtn::data::BundleID &id) const
+		{
+			// the bucket of a bundle moves with the window, thus search all of them
+			for (std::vector<std::set<dtn::data::BundleID> >::const_iterator iter = _members.begin(); iter != _members.end(); iter++)
+			{
+				if ((*iter).find(id) != (*iter).end()) return true;
+			}
+
+			return false;
+		}
+
+		void RotatingBloomFilter::clear()
+		{
+			for (std::vector<ibrcommon::BloomFilter>::iterator iter = _buckets.begin(); iter != _buckets.end(); iter++)
+			{
+				(*iter).clear();
+			}
+
+			for (std::vector<std::set<dtn::data::BundleID> >::iterator iter = _members.begin(); iter != _members.end(); iter++)
+			{
+				(*iter).clear();
+			}
+
+			_merged.clear();
+			_dirty = true;
+
+			for (std::vector<InvertibleBloomFilter>::iterator iter = _tables.begin(); iter != _tables.end(); iter++)
+			{
+				(*iter).clear();
+			}
+
+			_merged_table.clear();
+			_table_dirty = true;
+		}
+
+		void RotatingBloomFilter::expire(const size_t timestamp)
+		{
+			// we can not expire bundles if we have no idea of time
+			if (dtn::utils::Clock::quality == 0) return;
+
+			const size_t slot = timestamp / _interval;
+			if (slot <= _first_slot) return;
+
+			// drop all buckets of passed slots, but clear each bucket only once
+			size_t passed = slot - _first_slot;
+			if (passed > _buckets.size()) passed = _buckets.size();
+
+			for (size_t i = 0; i < passed; i++)
+			{
+				const size_t index = (_first_slot + i) % _buckets.size();
+				_buckets[index].clear();
+				_members[index].clear();
+
+				// the tables are linear, thus a dropped table is subtracted from the sum
+				if (!_tables.empty())
+				{
+					_merged_table -= _tables[index];
+					_tables[index].clear();
+					_table_dirty = true;
+				}
+			}
+
+			_first_slot = slot;
+
+			rebuild();
+		}
+
+		const refcnt_ptr<SummaryVector>& RotatingBloomFilter::getSummaryVector()
+		{
+			if (_dirty)
+			{
+				// the old snapshot stays valid for all its holders
+				_snapshot = refcnt_ptr<SummaryVector>(new SummaryVector(_merged));
+				_dirty = false;
+			}
+
+			return _snapshot;
+		}
+
+		const refcnt_ptr<InvertibleBloomFilter>& RotatingBloomFilter::getInvertibleBloomFilter()
+		{
+			if (_table_dirty)
+			{
+				_table_snapshot = refcnt_ptr<InvertibleBloomFilter>(new InvertibleBloomFilter(_merged_table));
+				_table_dirty = false;
+			}
+
+			return _table_snapshot;
+		}
+
+		size_t RotatingBloomFilter::getSize(const size_t elements, const double probability, const size_t hashes)
+		{
+			// p = (1 - e^(-kn/m))^k, thus m = -kn / ln(1 - p^(1/k))
+			const double k = (hashes > 0) ? (double)hashes : 1.0;
+			const double bits = -(k * (double)elements) / ::log(1.0 - ::pow(probability, 1.0 / k));
+
+			// at least one byte per hash function
+			const size_t size = (size_t)::ceil(bits / 8.0);
+			return (size > hashes) ? size : hashes;
+		}
+
+		size_t RotatingBloomFilter::getSlot(const size_t expiretime) const
+		{
+			size_t slot = expiretime / _interval;
+
+			// keep the bundle in the ring, even if it is expired or expires beyond the window
+			if (slot < _first_slot) slot = _first_slot;
+			if (slot >= (_first_slot + _buckets.size())) slot = _first_slot + _buckets.size() - 1;
+
+			return slot;
+		}
+
+		void RotatingBloomFilter::rebuild()
+		{
+			IBRCOMMON_LOGGER_DEBUG(60) << "rebuild of the rotating bloomfilter" << IBRCOMMON_LOGGER_ENDL;
+
+			std::vector<unsigned char> table(_merged.size(), 0);
+
+			for (std::vector<ibrcommon::BloomFilter>::const_iterator iter = _buckets.begin(); iter != _buckets.end(); iter++)
+			{
+				const unsigned char *data = (*iter).table();
+				for (size_t i = 0; i < table.size(); i++)
+				{
+					table[i] |= data[i];
+				}
+			}
+
+			_merged.load(&table[0], table.size());
+			_dirty = true;
+		}
+	}
+}
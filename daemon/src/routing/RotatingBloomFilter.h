@@ -0,0 +1,132 @@
+/*
+ * RotatingBloomFilter.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef ROTATINGBLOOMFILTER_H_
+#define ROTATINGBLOOMFILTER_H_
+
+#include "routing/SummaryVector.h"
+#include "routing/InvertibleBloomFilter.h"
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/data/BloomFilter.h>
+#include <ibrcommon/refcnt_ptr.h>
+#include <vector>
+#include <set>
+
+namespace dtn
+{
+	namespace routing
+	{
+		/**
+		 * A set of bundle IDs. The bundles are sorted into a ring of Bloom filters by
+		 * their expiration time. Each filter covers a fixed interval of time and is
+		 * dropped as a whole once the interval has passed. Bundles expiring beyond the
+		 * covered window are put into the last filter, thus they are forgotten after
+		 * the full window at the latest. The IDs of each filter are kept along with
+		 * it, since a false positive of a filter must not be taken as a known bundle.
+		 *
+		 * Optionally, each filter is accompanied by an invertible Bloom lookup table of
+		 * the same bundles, which allows a set reconciliation with other nodes.
+		 */
+		class RotatingBloomFilter
+		{
+		public:
+			/**
+			 * @param buckets Number of Bloom filters in the ring.
+			 * @param interval Seconds of expiration time covered by each filter.
+			 * @param size Size of each Bloom filter in bytes.
+			 * @param hashes Number of hash functions used by the Bloom filters.
+			 * @param cells Number of cells of the lookup tables, zero disables the tables.
+			 */
+			RotatingBloomFilter(size_t buckets = 24, size_t interval = 3600, size_t size = 8192, size_t hashes = 2, size_t cells = 0);
+			virtual ~RotatingBloomFilter();
+
+			/**
+			 * Add a bundle to the set. A bundle which has been added already is not
+			 * added again, since the lookup tables would count it twice.
+			 */
+			void add(const dtn::data::MetaBundle &bundle);
+
+			/**
+			 * Returns true if the Bloom filters contain the bundle. As for the
+			 * summary vector, this may be a false positive.
+			 */
+			bool contains(const dtn::data::BundleID &id) const;
+
+			/**
+			 * Returns true if the bundle has been added and its filter is not
+			 * dropped yet. Unlike contains(), there are no false positives.
+			 */
+			bool has(const dtn::data::BundleID &id) const;
+
+			void clear();
+
+			/**
+			 * Drop all filters whose interval has passed.
+			 * @param timestamp The current DTN time.
+			 */
+			void expire(const size_t timestamp);
+
+			/**
+			 * Returns the size in bytes of a Bloom filter, which holds the given
+			 * number of elements with the given false positive probability.
+			 * @param elements Expected number of elements.
+			 * @param probability Accepted false positive probability.
+			 * @param hashes Number of hash functions of the filter.
+			 */
+			static size_t getSize(const size_t elements, const double probability, const size_t hashes);
+
+			/**
+			 * Returns a snapshot of all bundles in the set. The snapshot is shared
+			 * between all callers until the set is modified and must not be changed.
+			 */
+			const refcnt_ptr<SummaryVector>& getSummaryVector();
+
+			/**
+			 * Returns a snapshot of the lookup table of all bundles in the set. The
+			 * snapshot is shared like the summary vector and must not be changed.
+			 */
+			const refcnt_ptr<InvertibleBloomFilter>& getInvertibleBloomFilter();
+
+		private:
+			/**
+			 * Returns the slot of a given expiration time.
+			 */
+			size_t getSlot(const size_t expiretime) const;
+
+			/**
+			 * Rebuild the union of all buckets.
+			 */
+			void rebuild();
+
+			const size_t _interval;
+
+			// ring of filters, the filter of a slot is located at slot modulo size
+			std::vector<ibrcommon::BloomFilter> _buckets;
+
+			// the bundles of each filter
+			std::vector<std::set<dtn::data::BundleID> > _members;
+
+			// the oldest slot held by the ring
+			size_t _first_slot;
+
+			// union of all buckets
+			ibrcommon::BloomFilter _merged;
+
+			refcnt_ptr<SummaryVector> _snapshot;
+			bool _dirty;
+
+			// lookup tables of the buckets and their sum, empty if disabled
+			std::vector<InvertibleBloomFilter> _tables;
+			InvertibleBloomFilter _merged_table;
+
+			refcnt_ptr<InvertibleBloomFilter> _table_snapshot;
+			bool _table_dirty;
+		};
+	}
+}
+
+#endif /* ROTATINGBLOOMFILTER_H_ */
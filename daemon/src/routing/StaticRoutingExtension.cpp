@@ -12,19 +12,22 @@
 #include "net/ConnectionEvent.h"
 #include "routing/RequeueBundleEvent.h"
 #include "core/NodeEvent.h"
+#include "core/GlobalEvent.h"
 #include "core/SimpleBundleStorage.h"
+#include "Configuration.h"
 
 #include <ibrcommon/Logger.h>
 #include <ibrcommon/AutoDelete.h>
 
 #include <typeinfo>
+#include <algorithm>
 
 namespace dtn
 {
 	namespace routing
 	{
 		StaticRoutingExtension::StaticRoutingExtension(const std::list<StaticRoutingExtension::StaticRoute> &routes)
-		 : _routes(routes)
+		 : _table(new RouteTable(routes))
 		{
 		}
 
@@ -45,13 +48,28 @@ namespace dtn
 			return true;
 		}
 
+		void StaticRoutingExtension::setRoutes(const std::list<StaticRoutingExtension::StaticRoute> &routes)
+		{
+			// compile the new table without holding the lock
+			refcnt_ptr<RouteTable> table(new RouteTable(routes));
+
+			ibrcommon::MutexLock l(_table_lock);
+			_table = table;
+		}
+
+		refcnt_ptr<StaticRoutingExtension::RouteTable> StaticRoutingExtension::getTable()
+		{
+			ibrcommon::MutexLock l(_table_lock);
+			return _table;
+		}
+
 		void StaticRoutingExtension::run()
 		{
 			class BundleFilter : public dtn::core::BundleStorage::BundleFilterCallback
 			{
 			public:
-				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const std::list<StaticRoutingExtension::StaticRoute> &routes)
-				 : _entry(entry), _routes(routes)
+				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const RouteTable &table, const dtn::data::EID &hop)
+				 : _entry(entry), _table(table), _hop(hop)
 				{};
 
 				virtual ~BundleFilter() {};
@@ -73,19 +91,8 @@ namespace dtn
 						return false;
 					}
 
-					// search for one rule that match
-					for (std::list<StaticRoutingExtension::StaticRoute>::const_iterator iter = _routes.begin();
-							iter != _routes.end(); iter++)
-					{
-						const StaticRoutingExtension::StaticRoute &route = (*iter);
-
-						if (route.match(meta.destination))
-						{
-							return true;
-						}
-					}
-
-					return false;
+					// search for one rule via this hop that match
+					return _table.match(meta.destination, _hop);
 				};
 
 				void blacklist(const dtn::data::EID& id)
@@ -96,7 +103,8 @@ namespace dtn
 			private:
 				std::set<dtn::data::EID> _blacklist;
 				const NeighborDatabase::NeighborEntry &_entry;
-				const std::list<StaticRoutingExtension::StaticRoute> _routes;
+				const RouteTable &_table;
+				const dtn::data::EID &_hop;
 			};
 
 			dtn::core::BundleStorage &storage = (**this).getStorage();
@@ -114,28 +122,18 @@ namespace dtn
 					try {
 						SearchNextBundleTask &task = dynamic_cast<SearchNextBundleTask&>(*t);
 
-						std::list<StaticRoutingExtension::StaticRoute> routes;
+						// hold the current routing table while processing this task
+						refcnt_ptr<RouteTable> table = getTable();
 
 						// look for routes to this node
-						for (std::list<StaticRoutingExtension::StaticRoute>::const_iterator iter = _routes.begin();
-								iter != _routes.end(); iter++)
-						{
-							const StaticRoutingExtension::StaticRoute &route = (*iter);
-							if (route.getDestination() == task.eid)
-							{
-								// add to the valid routes
-								routes.push_back(route);
-							}
-						}
-
-						if (routes.size() > 0)
+						if (table->hasHop(task.eid))
 						{
 							// this destination is not handles by any static route
 							ibrcommon::MutexLock l(db);
 							NeighborDatabase::NeighborEntry &entry = db.get(task.eid);
 
 							// get the bundle filter of the neighbor
-							BundleFilter filter(entry, routes);
+							BundleFilter filter(entry, *table, task.eid);
 
 							// some debug
 							IBRCOMMON_LOGGER_DEBUG(40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
@@ -163,19 +161,16 @@ namespace dtn
 						const ProcessBundleTask &task = dynamic_cast<ProcessBundleTask&>(*t);
 
 						// look for routes to this node
-						for (std::list<StaticRoutingExtension::StaticRoute>::const_iterator iter = _routes.begin();
-								iter != _routes.end(); iter++)
+						const std::list<dtn::data::EID> hops = getTable()->lookup(task.bundle.destination);
+
+						for (std::list<dtn::data::EID>::const_iterator iter = hops.begin(); iter != hops.end(); iter++)
 						{
-							const StaticRoutingExtension::StaticRoute &route = (*iter);
 							try {
-								if (route.match(task.bundle.destination))
-								{
-									ibrcommon::MutexLock l(db);
-									NeighborDatabase::NeighborEntry &n = db.get(route.getDestination());
+								ibrcommon::MutexLock l(db);
+								NeighborDatabase::NeighborEntry &n = db.get(*iter);
 
-									// transfer the bundle to the neighbor
-									transferTo(n, task.bundle);
-								}
+								// transfer the bundle to the neighbor
+								transferTo(n, task.bundle);
 							} catch (const NeighborDatabase::NeighborNotAvailableException&) {
 								// neighbor is not available, can not forward this bundle
 							} catch (const NeighborDatabase::NoMoreTransfersAvailable&) {
@@ -235,87 +230,264 @@ namespace dtn
 				_taskqueue.push( new SearchNextBundleTask(completed.getPeer()) );
 				return;
 			} catch (const std::bad_cast&) { };
+
+			// reload the static routes of the configuration
+			try {
+				const dtn::core::GlobalEvent &global = dynamic_cast<const dtn::core::GlobalEvent&>(*evt);
+
+				if (global.getAction() == dtn::core::GlobalEvent::GLOBAL_RELOAD)
+				{
+					setRoutes( dtn::daemon::Configuration::getInstance().readStaticRoutes() );
+					IBRCOMMON_LOGGER(info) << "static routes reloaded" << IBRCOMMON_LOGGER_ENDL;
+				}
+				return;
+			} catch (const std::bad_cast&) { };
 		}
 
 		StaticRoutingExtension::StaticRoute::StaticRoute(const std::string &regex, const std::string &dest)
-			: _dest(dest), _regex_str(regex), _invalid(false)
+			: _dest(dest), _regex_str(regex), _expr(new Expression(regex))
 		{
-			if ( regcomp(&_regex, regex.c_str(), 0) )
-			{
-				IBRCOMMON_LOGGER(error) << "Could not compile regex: " << regex << IBRCOMMON_LOGGER_ENDL;
-				_invalid = true;
-			}
 		}
 
 		StaticRoutingExtension::StaticRoute::~StaticRoute()
 		{
-			if (!_invalid)
-				regfree(&_regex);
 		}
 
-		StaticRoutingExtension::StaticRoute::StaticRoute(const StaticRoutingExtension::StaticRoute &obj)
-			: _dest(obj._dest), _regex_str(obj._regex_str), _invalid(obj._invalid)
+		bool StaticRoutingExtension::StaticRoute::match(const dtn::data::EID &eid) const
 		{
-			if ( regcomp(&_regex, _regex_str.c_str(), 0) )
+			if (_expr->invalid) return false;
+
+			const std::string dest = eid.getString();
+
+			// test against the regular expression
+			int reti = regexec(&_expr->regex, dest.c_str(), 0, NULL, 0);
+
+			if( !reti )
+			{
+				// the expression match
+				return true;
+			}
+			else if( reti == REG_NOMATCH )
+			{
+				// the expression not match
+				return false;
+			}
+			else
 			{
-				_invalid = true;
+				char msgbuf[100];
+				regerror(reti, &_expr->regex, msgbuf, sizeof(msgbuf));
+				IBRCOMMON_LOGGER(error) << "Regex match failed: " << std::string(msgbuf) << IBRCOMMON_LOGGER_ENDL;
+				return false;
 			}
 		}
 
-		StaticRoutingExtension::StaticRoute& StaticRoutingExtension::StaticRoute::operator=(const StaticRoutingExtension::StaticRoute &obj)
+		const std::string& StaticRoutingExtension::StaticRoute::getPattern() const
 		{
-			if (!_invalid)
+			return _regex_str;
+		}
+
+		StaticRoutingExtension::StaticRoute::Expression::Expression(const std::string &regex)
+		 : invalid(false)
+		{
+			if ( regcomp(&this->regex, regex.c_str(), 0) )
 			{
-				regfree(&_regex);
+				IBRCOMMON_LOGGER(error) << "Could not compile regex: " << regex << IBRCOMMON_LOGGER_ENDL;
+				invalid = true;
 			}
+		}
 
-			_dest = obj._dest;
-			_regex_str = obj._regex_str;
-			_invalid = obj._invalid;
+		StaticRoutingExtension::StaticRoute::Expression::~Expression()
+		{
+			if (!invalid)
+				regfree(&regex);
+		}
 
-			if (!_invalid)
+		const dtn::data::EID& StaticRoutingExtension::StaticRoute::getDestination() const
+		{
+			return _dest;
+		}
+
+		/****************************************/
+
+		StaticRoutingExtension::RouteTable::RouteTable(const std::list<StaticRoutingExtension::StaticRoute> &routes)
+		 : _routes(routes.begin(), routes.end())
+		{
+			for (size_t i = 0; i < _routes.size(); i++)
 			{
-				if ( regcomp(&_regex, obj._regex_str.c_str(), 0) )
+				std::vector<int> pattern;
+				bool exact = false;
+
+				if (!compile(_routes[i].getPattern(), pattern, exact))
+				{
+					// evaluate this route using the regular expression
+					_fallback.push_back(i);
+					continue;
+				}
+
+				// walk down the tree and create all missing nodes
+				Node *node = &_root;
+				for (std::vector<int>::const_iterator iter = pattern.begin(); iter != pattern.end(); iter++)
 				{
-					IBRCOMMON_LOGGER(error) << "Could not compile regex: " << _regex_str << IBRCOMMON_LOGGER_ENDL;
-					_invalid = true;
+					node = node->get(*iter, true);
 				}
+
+				if (exact)
+					node->exact.insert(i);
+				else
+					node->prefix.insert(i);
 			}
 
-			return *this;
+			IBRCOMMON_LOGGER_DEBUG(10) << "static routing table compiled, " << (_routes.size() - _fallback.size()) << " prefix routes, " << _fallback.size() << " regex routes" << IBRCOMMON_LOGGER_ENDL;
 		}
 
-		bool StaticRoutingExtension::StaticRoute::match(const dtn::data::EID &eid) const
+		StaticRoutingExtension::RouteTable::~RouteTable()
 		{
-			if (_invalid) return false;
+		}
 
-			const std::string dest = eid.getString();
+		const std::list<dtn::data::EID> StaticRoutingExtension::RouteTable::lookup(const dtn::data::EID &destination) const
+		{
+			const std::string dest = destination.getString();
 
-			// test against the regular expression
-			int reti = regexec(&_regex, dest.c_str(), 0, NULL, 0);
+			{
+				ibrcommon::MutexLock l(_cache_lock);
+				std::map<std::string, std::list<dtn::data::EID> >::const_iterator iter = _cache.find(dest);
+				if (iter != _cache.end()) return (*iter).second;
+			}
 
-			if( !reti )
+			// collect all matching routes, ordered as configured
+			std::set<size_t> result;
+			search(_root, dest, 0, result);
+
+			for (std::list<size_t>::const_iterator iter = _fallback.begin(); iter != _fallback.end(); iter++)
 			{
-				// the expression match
-				return true;
+				if (_routes[*iter].match(destination)) result.insert(*iter);
 			}
-			else if( reti == REG_NOMATCH )
+
+			std::list<dtn::data::EID> hops;
+			for (std::set<size_t>::const_iterator iter = result.begin(); iter != result.end(); iter++)
 			{
-				// the expression not match
-				return false;
+				const dtn::data::EID &hop = _routes[*iter].getDestination();
+				if (std::find(hops.begin(), hops.end(), hop) == hops.end()) hops.push_back(hop);
 			}
-			else
+
+			ibrcommon::MutexLock l(_cache_lock);
+			if (_cache.size() >= CACHE_LIMIT) _cache.clear();
+			_cache[dest] = hops;
+
+			return hops;
+		}
+
+		bool StaticRoutingExtension::RouteTable::match(const dtn::data::EID &destination, const dtn::data::EID &hop) const
+		{
+			const std::list<dtn::data::EID> hops = lookup(destination);
+			return (std::find(hops.begin(), hops.end(), hop) != hops.end());
+		}
+
+		bool StaticRoutingExtension::RouteTable::hasHop(const dtn::data::EID &hop) const
+		{
+			for (std::vector<StaticRoutingExtension::StaticRoute>::const_iterator iter = _routes.begin(); iter != _routes.end(); iter++)
 			{
-				char msgbuf[100];
-				regerror(reti, &_regex, msgbuf, sizeof(msgbuf));
-				IBRCOMMON_LOGGER(error) << "Regex match failed: " << std::string(msgbuf) << IBRCOMMON_LOGGER_ENDL;
-				return false;
+				if ((*iter).getDestination() == hop) return true;
 			}
+
+			return false;
 		}
 
-		const dtn::data::EID& StaticRoutingExtension::StaticRoute::getDestination() const
+		void StaticRoutingExtension::RouteTable::search(const Node &node, const std::string &dest, size_t pos, std::set<size_t> &result) const
 		{
-			return _dest;
+			// all prefix routes of this node match
+			result.insert(node.prefix.begin(), node.prefix.end());
+
+			if (pos == dest.length())
+			{
+				result.insert(node.exact.begin(), node.exact.end());
+				return;
+			}
+
+			std::map<int, Node*>::const_iterator iter = node.children.find((unsigned char)dest[pos]);
+			if (iter != node.children.end()) search(*(*iter).second, dest, pos + 1, result);
+
+			iter = node.children.find(ANY);
+			if (iter != node.children.end()) search(*(*iter).second, dest, pos + 1, result);
+		}
+
+		bool StaticRoutingExtension::RouteTable::compile(const std::string &regex, std::vector<int> &pattern, bool &exact)
+		{
+			// only expressions anchored at the beginning are prefixes
+			if ((regex.length() == 0) || (regex[0] != '^')) return false;
+
+			std::string expr = regex.substr(1);
+			exact = false;
+
+			// a trailing "$" requires an exact match
+			if ((expr.length() > 0) && (expr[expr.length() - 1] == '$') &&
+					!((expr.length() > 1) && (expr[expr.length() - 2] == '\\')))
+			{
+				expr.erase(expr.length() - 1);
+				exact = true;
+			}
+
+			// a trailing ".*" matches any suffix
+			if ((expr.length() > 1) && (expr.substr(expr.length() - 2) == ".*") &&
+					!((expr.length() > 2) && (expr[expr.length() - 3] == '\\')))
+			{
+				expr.erase(expr.length() - 2);
+				exact = false;
+			}
+
+			for (size_t i = 0; i < expr.length(); i++)
+			{
+				const char c = expr[i];
+
+				switch (c)
+				{
+				case '.':
+					pattern.push_back(ANY);
+					break;
+
+				case '\\':
+					// only escaped special characters are literals
+					if (++i == expr.length()) return false;
+					if (std::string(".*[]\\^$/").find(expr[i]) == std::string::npos) return false;
+					pattern.push_back((unsigned char)expr[i]);
+					break;
+
+				case '*':
+				case '[':
+				case '^':
+				case '$':
+					return false;
+
+				default:
+					pattern.push_back((unsigned char)c);
+					break;
+				}
+			}
+
+			return true;
+		}
+
+		StaticRoutingExtension::RouteTable::Node::Node()
+		{
+		}
+
+		StaticRoutingExtension::RouteTable::Node::~Node()
+		{
+			for (std::map<int, Node*>::iterator iter = children.begin(); iter != children.end(); iter++)
+			{
+				delete (*iter).second;
+			}
+		}
+
+		StaticRoutingExtension::RouteTable::Node* StaticRoutingExtension::RouteTable::Node::get(int c, bool create)
+		{
+			std::map<int, Node*>::iterator iter = children.find(c);
+			if (iter != children.end()) return (*iter).second;
+			if (!create) return NULL;
+
+			Node *n = new Node();
+			children[c] = n;
+			return n;
 		}
 
 		/****************************************/
@@ -11,7 +11,12 @@
 #include "routing/BaseRouter.h"
 #include <ibrdtn/data/MetaBundle.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/refcnt_ptr.h>
 #include <regex.h>
+#include <vector>
+#include <map>
+#include <set>
 
 namespace dtn
 {
@@ -28,20 +33,29 @@ namespace dtn
 
 				bool match(const dtn::data::EID &eid) const;
 				const dtn::data::EID& getDestination() const;
+				const std::string& getPattern() const;
 
+			private:
 				/**
-				 * copy and assignment operators
-				 * @param obj The object to copy
-				 * @return
+				 * The compiled regular expression is shared between all copies of a route.
 				 */
-				StaticRoute(const StaticRoute &obj);
-				StaticRoute& operator=(const StaticRoute &obj);
+				class Expression
+				{
+				public:
+					Expression(const std::string &regex);
+					~Expression();
+
+					regex_t regex;
+					bool invalid;
+
+				private:
+					Expression(const Expression&);
+					Expression& operator=(const Expression&);
+				};
 
-			private:
 				dtn::data::EID _dest;
 				std::string _regex_str;
-				regex_t _regex;
-				bool _invalid;
+				refcnt_ptr<Expression> _expr;
 			};
 
 			StaticRoutingExtension(const std::list<StaticRoutingExtension::StaticRoute> &routes);
@@ -51,6 +65,78 @@ namespace dtn
 
 			virtual void stopExtension();
 
+			/**
+			 * Replace the static routes. The new routes are compiled before the
+			 * routing table is exchanged, thus the routing is not interrupted.
+			 * @param routes The new list of static routes.
+			 */
+			void setRoutes(const std::list<StaticRoutingExtension::StaticRoute> &routes);
+
+			/**
+			 * The routing table compiles all routes with a pattern like "^dtn://node/app.*"
+			 * into a prefix tree of the destination EID. All other patterns are evaluated
+			 * as regular expression. The result of a lookup is cached per destination.
+			 */
+			class RouteTable
+			{
+			public:
+				RouteTable(const std::list<StaticRoutingExtension::StaticRoute> &routes);
+				virtual ~RouteTable();
+
+				/**
+				 * Returns the next hops of all routes matching the destination.
+				 */
+				const std::list<dtn::data::EID> lookup(const dtn::data::EID &destination) const;
+
+				/**
+				 * Returns true, if a route via the given next hop matches the destination.
+				 */
+				bool match(const dtn::data::EID &destination, const dtn::data::EID &hop) const;
+
+				/**
+				 * Returns true, if at least one route uses the given next hop.
+				 */
+				bool hasHop(const dtn::data::EID &hop) const;
+
+				// maximum number of destinations in the lookup cache
+				static const size_t CACHE_LIMIT = 1024;
+
+			private:
+				class Node
+				{
+				public:
+					Node();
+					~Node();
+
+					Node* get(int c, bool create);
+
+					std::map<int, Node*> children;
+
+					// routes ending at this node
+					std::set<size_t> exact;
+
+					// routes matching all EIDs with this prefix
+					std::set<size_t> prefix;
+				};
+
+				/**
+				 * Translate a regular expression into a sequence of characters. A dot
+				 * is translated to ANY. Returns false, if the expression is not a simple prefix.
+				 */
+				static bool compile(const std::string &regex, std::vector<int> &pattern, bool &exact);
+
+				void search(const Node &node, const std::string &dest, size_t pos, std::set<size_t> &result) const;
+
+				static const int ANY = -1;
+
+				std::vector<StaticRoutingExtension::StaticRoute> _routes;
+				std::list<size_t> _fallback;
+				Node _root;
+
+				mutable ibrcommon::Mutex _cache_lock;
+				mutable std::map<std::string, std::list<dtn::data::EID> > _cache;
+			};
+
 		protected:
 			void run();
 			bool __cancellation();
@@ -92,9 +178,15 @@ namespace dtn
 			ibrcommon::Queue<StaticRoutingExtension::Task* > _taskqueue;
 
 			/**
-			 * static list of routes
+			 * Returns the current routing table.
+			 */
+			refcnt_ptr<RouteTable> getTable();
+
+			/**
+			 * compiled table of static routes
 			 */
-			const std::list<StaticRoutingExtension::StaticRoute> _routes;
+			ibrcommon::Mutex _table_lock;
+			refcnt_ptr<RouteTable> _table;
 		};
 	}
 }
@@ -19,6 +19,11 @@ namespace dtn
 			add(list);
 		}
 
+		SummaryVector::SummaryVector(const ibrcommon::BloomFilter &filter)
+		 : _bf(filter)
+		{
+		}
+
 		SummaryVector::SummaryVector()
 		 : _bf(8192, 2)
 		{
@@ -23,6 +23,7 @@ namespace dtn
 		{
 		public:
 			SummaryVector(const std::set<dtn::data::MetaBundle> &list);
+			SummaryVector(const ibrcommon::BloomFilter &filter);
 			SummaryVector();
 			virtual ~SummaryVector();
 
@@ -91,6 +91,24 @@ namespace dtn
 
 					if (pib.isSecurityDestination(bundle, dtn::core::BundleCore::local))
 					{
+						// the payload is decrypted on delivery and the signature is verified
+						// within the same pass once more, thus the PIB is kept and the bundle
+						// is stored as received
+						if (isDecryptedLocally(bundle))
+						{
+							try {
+								dtn::security::PayloadIntegrityBlock::verify(bundle, key);
+
+								// set the verify bit, after verification
+								bundle.set(dtn::data::Bundle::DTNSEC_STATUS_VERIFIED, true);
+
+								IBRCOMMON_LOGGER_DEBUG(5) << "Bundle from " << bundle._source.getString() << " successfully verified using PayloadIntegrityBlock" << IBRCOMMON_LOGGER_ENDL;
+								return;
+							} catch (const ibrcommon::Exception&) {
+								throw VerificationFailedException();
+							}
+						}
+
 						try {
 							dtn::security::PayloadIntegrityBlock::strip(bundle, key);
 
@@ -122,6 +140,43 @@ namespace dtn
 			}
 		}
 
+		bool SecurityManager::isDecryptedLocally(const dtn::data::Bundle &bundle) const
+		{
+			if (!bundle.has<dtn::security::PayloadConfidentialBlock>()) return false;
+			if (!bundle.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON)) return false;
+			return bundle._destination.sameHost(dtn::core::BundleCore::local);
+		}
+
+		bool SecurityManager::decryptAndVerify(dtn::data::Bundle &bundle, const SecurityKey &private_key) const
+		{
+			// get all PIBs of this bundle
+			const std::list<const dtn::security::PayloadIntegrityBlock*> pibs = bundle.getBlocks<dtn::security::PayloadIntegrityBlock>();
+
+			for (std::list<const dtn::security::PayloadIntegrityBlock*>::const_iterator it = pibs.begin(); it != pibs.end(); it++)
+			{
+				const dtn::security::PayloadIntegrityBlock& pib = (**it);
+
+				if (!pib.isSecurityDestination(bundle, dtn::core::BundleCore::local)) continue;
+
+				try {
+					const SecurityKey key = SecurityKeyManager::getInstance().get(pib.getSecuritySource(bundle), SecurityKey::KEY_PUBLIC);
+
+					dtn::security::PayloadConfidentialBlock::decrypt(bundle, private_key, pib, key);
+
+					// set the verify bit, after verification
+					bundle.set(dtn::data::Bundle::DTNSEC_STATUS_VERIFIED, true);
+
+					IBRCOMMON_LOGGER_DEBUG(5) << "Bundle from " << bundle._source.getString() << " successfully verified and decrypted" << IBRCOMMON_LOGGER_ENDL;
+					return true;
+				} catch (const ibrcommon::Exception &ex) {
+					// the bundle is not changed, try the next PIB
+					IBRCOMMON_LOGGER_DEBUG(10) << "combined decryption and verification failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
+			return false;
+		}
+
 		void SecurityManager::verifyBAB(dtn::data::Bundle &bundle) const throw (VerificationFailedException)
 		{
 			IBRCOMMON_LOGGER_DEBUG(10) << "verify authenticated bundle: " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
@@ -171,8 +226,7 @@ namespace dtn
 				//throw VerificationFailedException("Bundle is not encrypted");
 				IBRCOMMON_LOGGER_DEBUG(10) << "encryption required, verify bundle: " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
 
-				const std::list<const dtn::security::PayloadConfidentialBlock* > pcbs = bundle.getBlocks<dtn::security::PayloadConfidentialBlock>();
-				if (pcbs.size() == 0) throw VerificationFailedException("No PCB available!");
+				if (!bundle.has<dtn::security::PayloadConfidentialBlock>()) throw VerificationFailedException("No PCB available!");
 			}
 
 			if (secconf.getLevel() & dtn::daemon::Configuration::Security::SECURITY_LEVEL_AUTHENTICATED)
@@ -181,15 +235,14 @@ namespace dtn
 				//throw VerificationFailedException("Bundle is not signed");
 				IBRCOMMON_LOGGER_DEBUG(10) << "authentication required, verify bundle: " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
 
-				const std::list<const dtn::security::BundleAuthenticationBlock* > babs = bundle.getBlocks<dtn::security::BundleAuthenticationBlock>();
-				if (babs.size() == 0) throw VerificationFailedException("No BAB available!");
+				if (!bundle.has<dtn::security::BundleAuthenticationBlock>()) throw VerificationFailedException("No BAB available!");
 			}
 		}
 
 		void SecurityManager::decrypt(dtn::data::Bundle &bundle) const throw (DecryptException, KeyMissingException)
 		{
 			// check if the bundle has to be decrypted, return when not
-			if (bundle.getBlocks<dtn::security::PayloadConfidentialBlock>().size() <= 0) return;
+			if (!bundle.has<dtn::security::PayloadConfidentialBlock>()) return;
 
 			// decrypt
 			try {
@@ -198,8 +251,12 @@ namespace dtn
 				// get the encryption key
 				dtn::security::SecurityKey key = SecurityKeyManager::getInstance().get(dtn::core::BundleCore::local, dtn::security::SecurityKey::KEY_PRIVATE);
 
-				// encrypt the payload of the bundle
-				dtn::security::PayloadConfidentialBlock::decrypt(bundle, key);
+				// verify a signature addressed to this node while the payload is decrypted,
+				// otherwise decrypt the payload only
+				if (!decryptAndVerify(bundle, key))
+				{
+					dtn::security::PayloadConfidentialBlock::decrypt(bundle, key);
+				}
 
 				bundle.set(dtn::data::Bundle::DTNSEC_STATUS_CONFIDENTIAL, true);
 			} catch (const ibrcommon::Exception &ex) {
@@ -221,5 +278,27 @@ namespace dtn
 				throw EncryptException(ex.what());
 			}
 		}
+
+		void SecurityManager::encryptAndSign(dtn::data::Bundle &bundle) const throw (EncryptException, KeyMissingException)
+		{
+			IBRCOMMON_LOGGER_DEBUG(10) << "encrypt and sign bundle: " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+
+			try {
+				// get the encryption key
+				const SecurityKey key = SecurityKeyManager::getInstance().get(bundle._destination, SecurityKey::KEY_PUBLIC);
+
+				// try to load the local key
+				const SecurityKey sign_key = SecurityKeyManager::getInstance().get(dtn::core::BundleCore::local, SecurityKey::KEY_PRIVATE);
+
+				try {
+					// encrypt the payload of the bundle and sign it within one pass
+					dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, dtn::core::BundleCore::local, sign_key);
+				} catch (const ibrcommon::Exception &ex) {
+					throw EncryptException(ex.what());
+				}
+			} catch (const SecurityKeyManager::KeyNotFoundException &ex) {
+				throw KeyMissingException(ex.what());
+			}
+		}
 	}
 }
@@ -99,8 +99,9 @@ namespace dtn
 				void fastverify(const dtn::data::Bundle &bundle) const throw (VerificationFailedException);
 
 				/**
-				 * This method decrypts encrypted payload of a bundle. It is necessary to
-				 * remove all integrity or auth block before the payload can decrypted.
+				 * This method decrypts encrypted payload of a bundle. A PIB addressed to
+				 * this node is verified while the payload is decrypted, all other
+				 * integrity or auth blocks have to be removed before.
 				 * @param bundle
 				 */
 				void decrypt(dtn::data::Bundle &bundle) const throw (DecryptException, KeyMissingException);
@@ -113,6 +114,15 @@ namespace dtn
 				 */
 				void encrypt(dtn::data::Bundle &bundle) const throw (EncryptException, KeyMissingException);
 
+				/**
+				 * This method encrypts the payload of a given bundle and signs it with
+				 * the own private key afterwards, like encrypt() followed by sign(). The
+				 * payload is read and written only once. If one of the keys is not
+				 * available a KeyMissingException is thrown and the bundle is not changed.
+				 * @param bundle
+				 */
+				void encryptAndSign(dtn::data::Bundle &bundle) const throw (EncryptException, KeyMissingException);
+
 			protected:
 				/**
 				need a list of nodes, their security blocks type and the key
@@ -123,6 +133,20 @@ namespace dtn
 				virtual ~SecurityManager();
 
 			private:
+				/**
+				 * Returns true, if the payload of the bundle is decrypted by this
+				 * node on delivery.
+				 */
+				bool isDecryptedLocally(const dtn::data::Bundle &bundle) const;
+
+				/**
+				 * Decrypts the payload of a bundle while the signature of a PIB
+				 * addressed to this node is verified.
+				 * @return true, if the payload is decrypted and the signature is valid.
+				 * Otherwise the bundle is not changed.
+				 */
+				bool decryptAndVerify(dtn::data::Bundle &bundle, const SecurityKey &private_key) const;
+
 				bool _accept_only_bab;
 				bool _accept_only_pib;
 		};
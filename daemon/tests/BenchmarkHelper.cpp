@@ -0,0 +1,84 @@
+/*
+ * BenchmarkHelper.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/BenchmarkHelper.h"
+#include <cppunit/TestAssert.h>
+#include <sstream>
+#include <list>
+#include <stdlib.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	std::vector<std::string> getList(const char *name, const std::string &def)
+	{
+		const char *value = ::getenv(name);
+		std::stringstream ss((value == NULL) ? def : std::string(value));
+
+		std::vector<std::string> ret;
+		std::string item;
+		while (std::getline(ss, item, ','))
+		{
+			if (item.length() > 0) ret.push_back(item);
+		}
+		return ret;
+	}
+
+	std::vector<size_t> getSizes(const char *name, const std::string &def)
+	{
+		const std::vector<std::string> items = getList(name, def);
+
+		std::vector<size_t> ret;
+		for (std::vector<std::string>::const_iterator iter = items.begin(); iter != items.end(); iter++)
+		{
+			const size_t value = ::strtoul((*iter).c_str(), NULL, 10);
+			if (value > 0) ret.push_back(value);
+		}
+		return ret;
+	}
+
+	size_t countFiles(const ibrcommon::File &path)
+	{
+		std::list<ibrcommon::File> files;
+		path.getFiles(files);
+
+		size_t ret = 0;
+		for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); iter++)
+		{
+			if (!(*iter).isSystem()) ret++;
+		}
+		return ret;
+	}
+
+	BenchmarkOutput::BenchmarkOutput(const char *name, const std::string &header)
+	 : _stream(&std::cout)
+	{
+		const char *output = ::getenv(name);
+		if (output != NULL)
+		{
+			_file.open(output, std::ios::out | std::ios::trunc);
+			CPPUNIT_ASSERT(_file.good());
+			_stream = &_file;
+		}
+		else
+		{
+			std::cout << std::endl;
+		}
+
+		(*_stream) << header << std::endl;
+	}
+
+	BenchmarkOutput::~BenchmarkOutput()
+	{
+	}
+
+	std::ostream& BenchmarkOutput::stream()
+	{
+		return (*_stream);
+	}
+}
+}
@@ -0,0 +1,63 @@
+/*
+ * BenchmarkHelper.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BENCHMARKHELPER_H_
+#define BENCHMARKHELPER_H_
+
+#include <ibrcommon/data/File.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Returns the comma separated items of an environment variable.
+	 * @param name Name of the variable.
+	 * @param def Items used if the variable is not set.
+	 */
+	std::vector<std::string> getList(const char *name, const std::string &def);
+
+	/**
+	 * Returns the comma separated numbers of an environment variable.
+	 * Items which are not a positive number are skipped.
+	 */
+	std::vector<size_t> getSizes(const char *name, const std::string &def);
+
+	/**
+	 * Returns the number of files in a directory, e.g. to wait until a
+	 * storage has written all bundles to disk.
+	 */
+	size_t countFiles(const ibrcommon::File &path);
+
+	/**
+	 * The CSV results of a benchmark. They are written into the file named by
+	 * an environment variable or to the standard output, if it is not set.
+	 */
+	class BenchmarkOutput
+	{
+	public:
+		/**
+		 * Open the output and write the header line.
+		 * @param name Name of the environment variable.
+		 * @param header The column names.
+		 */
+		BenchmarkOutput(const char *name, const std::string &header);
+		~BenchmarkOutput();
+
+		std::ostream& stream();
+
+	private:
+		std::ofstream _file;
+		std::ostream *_stream;
+	};
+}
+}
+
+#endif /* BENCHMARKHELPER_H_ */
@@ -0,0 +1,289 @@
+/*
+ * BundleAllocationBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/BundleAllocationBenchmark.h"
+#include "tests/BenchmarkHelper.h"
+#include "tests/tools/EventSwitchLoop.h"
+#include "src/core/MemoryBundleStorage.h"
+#include "src/core/SimpleBundleStorage.h"
+#include "src/core/GlobalEvent.h"
+#include "src/Component.h"
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrcommon/data/BLOB.h>
+
+#include <sstream>
+#include <streambuf>
+#include <vector>
+#include <new>
+#include <stdlib.h>
+#include <unistd.h>
+
+// number of allocations and allocated bytes of the whole program
+static size_t __allocations = 0;
+static size_t __allocated_bytes = 0;
+
+// number of allocations of the current thread
+static __thread size_t __thread_allocations = 0;
+
+void* operator new(size_t size) throw (std::bad_alloc)
+{
+	__sync_fetch_and_add(&__allocations, 1);
+	__sync_fetch_and_add(&__allocated_bytes, size);
+	__thread_allocations++;
+
+	void *p = ::malloc((size == 0) ? 1 : size);
+	if (p == NULL) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void *p) throw ()
+{
+	::free(p);
+}
+
+namespace dtn
+{
+namespace testsuite
+{
+	CPPUNIT_TEST_SUITE_REGISTRATION (BundleAllocationBenchmark);
+
+	// give up waiting for the storage after this number of seconds
+	static const size_t TIMEOUT = 600;
+
+	/**
+	 * Discards all data, thus the serialization does not allocate any buffer.
+	 */
+	class NullBuffer : public std::streambuf
+	{
+	protected:
+		virtual int overflow(int c) { return c; };
+		virtual std::streamsize xsputn(const char*, std::streamsize n) { return n; };
+	};
+
+	/**
+	 * Counts the allocations between its creation and the call of stop().
+	 */
+	class AllocationCounter
+	{
+	public:
+		AllocationCounter()
+		 : _allocations(__allocations), _bytes(__allocated_bytes), _thread_allocations(__thread_allocations)
+		{ };
+
+		void stop()
+		{
+			_allocations = __allocations - _allocations;
+			_bytes = __allocated_bytes - _bytes;
+			_thread_allocations = __thread_allocations - _thread_allocations;
+		};
+
+		size_t getAllocations() const { return _allocations; };
+		size_t getBytes() const { return _bytes; };
+
+		/**
+		 * Returns the allocations of the thread which created the counter,
+		 * without the allocations of the background threads.
+		 */
+		size_t getThreadAllocations() const { return _thread_allocations; };
+
+	private:
+		size_t _allocations;
+		size_t _bytes;
+		size_t _thread_allocations;
+	};
+
+	void BundleAllocationBenchmark::setUp()
+	{
+		_path = ibrcommon::File("/tmp/allocation-benchmark");
+		_output = &std::cout;
+	}
+
+	void BundleAllocationBenchmark::tearDown()
+	{
+		_path.remove(true);
+	}
+
+	void BundleAllocationBenchmark::report(const std::string &storage, const std::string &stage, size_t bundles, size_t allocations, size_t bytes)
+	{
+		(*_output) << storage << "," << stage << "," << bundles << "," << allocations << ","
+				<< ((double)allocations / bundles) << "," << ((double)bytes / bundles) << std::endl;
+	}
+
+	void BundleAllocationBenchmark::run(const std::string &name, size_t bundles)
+	{
+		// start with an empty storage
+		_path.remove(true);
+		ibrcommon::File::createDirectory(_path);
+
+		ibrtest::EventSwitchLoop esl;
+		esl.start();
+
+		dtn::core::BundleStorage *storage = NULL;
+		if (name == "simple")
+		{
+			storage = new dtn::core::SimpleBundleStorage(_path);
+		}
+		else
+		{
+			storage = new dtn::core::MemoryBundleStorage();
+		}
+
+		dtn::daemon::IntegratedComponent &c = dynamic_cast<dtn::daemon::IntegratedComponent&>(*storage);
+		c.initialize();
+		c.startup();
+
+		// the bundles as they are received from a neighbor
+		std::vector<std::string> received;
+		received.reserve(bundles);
+
+		for (size_t i = 0; i < bundles; i++)
+		{
+			dtn::data::Bundle b;
+			b._source = dtn::data::EID("dtn://benchmark/app");
+			b._destination = dtn::data::EID("dtn://destination/app");
+			b._lifetime = 3600;
+
+			ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+			(*ref.iostream()) << std::string(64, 'x');
+			b.push_back(ref);
+
+			std::stringstream ss;
+			dtn::data::DefaultSerializer(ss) << b;
+			received.push_back(ss.str());
+		}
+
+		std::vector<dtn::data::Bundle> incoming(bundles);
+		std::vector<dtn::data::PrimaryBlock> headers;
+		std::vector<dtn::data::Bundle> events;
+		std::vector<dtn::data::Bundle> outgoing;
+		headers.reserve(2 * bundles);
+		events.reserve(2 * bundles);
+		outgoing.reserve(bundles);
+
+		// receive
+		{
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				std::stringstream ss(received[i]);
+				dtn::data::DefaultDeserializer(ss) >> incoming[i];
+			}
+			counter.stop();
+			report(name, "receive", bundles, counter.getAllocations(), counter.getBytes());
+		}
+
+		// the allocations to copy the EIDs of the primary blocks
+		size_t header_allocations = 0;
+		{
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				headers.push_back(incoming[i]);
+				headers.push_back(incoming[i]);
+			}
+			counter.stop();
+			header_allocations = counter.getThreadAllocations();
+		}
+
+		// the received and the queued event hold a copy of each bundle
+		{
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				events.push_back(incoming[i]);
+				events.push_back(incoming[i]);
+			}
+			counter.stop();
+			report(name, "copy", bundles, counter.getAllocations(), counter.getBytes());
+
+			// the copies share the block list, thus they allocate no more than the primary blocks
+			CPPUNIT_ASSERT(counter.getThreadAllocations() <= header_allocations);
+		}
+
+		// store
+		{
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				storage->store(incoming[i]);
+			}
+
+			// the simple storage writes the bundles in a background thread
+			if (name == "simple")
+			{
+				for (size_t i = 0; (i < TIMEOUT * 100) && (countFiles(_path) < bundles); i++)
+				{
+					::usleep(10000);
+				}
+			}
+			counter.stop();
+			report(name, "store", bundles, counter.getAllocations(), counter.getBytes());
+		}
+
+		CPPUNIT_ASSERT_EQUAL((unsigned int)bundles, storage->count());
+
+		// get each bundle for the transmission
+		{
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				outgoing.push_back(storage->get(dtn::data::BundleID(incoming[i])));
+			}
+			counter.stop();
+			report(name, "get", bundles, counter.getAllocations(), counter.getBytes());
+		}
+
+		// serialize each bundle for the next hop
+		{
+			NullBuffer buf;
+			std::ostream stream(&buf);
+
+			AllocationCounter counter;
+			for (size_t i = 0; i < bundles; i++)
+			{
+				dtn::data::DefaultSerializer(stream) << outgoing[i];
+			}
+			counter.stop();
+			report(name, "forward", bundles, counter.getAllocations(), counter.getBytes());
+		}
+
+		headers.clear();
+		events.clear();
+		outgoing.clear();
+
+		c.terminate();
+		delete storage;
+
+		dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+		esl.join();
+	}
+
+	void BundleAllocationBenchmark::storeForwardTest()
+	{
+		const std::vector<std::string> backends = getList("BENCH_ALLOC_BACKENDS", "memory,simple");
+		const std::vector<size_t> bundles = getSizes("BENCH_ALLOC_BUNDLES", "1000");
+
+		BenchmarkOutput output("BENCH_ALLOC_OUTPUT", "storage,stage,bundles,allocations,allocations_per_bundle,bytes_per_bundle");
+		_output = &output.stream();
+
+		for (std::vector<std::string>::const_iterator b = backends.begin(); b != backends.end(); b++)
+		{
+			if (((*b) != "memory") && ((*b) != "simple")) continue;
+
+			for (std::vector<size_t>::const_iterator n = bundles.begin(); n != bundles.end(); n++)
+			{
+				run(*b, *n);
+			}
+		}
+
+		_output = &std::cout;
+	}
+}
+}
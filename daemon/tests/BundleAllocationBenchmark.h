@@ -0,0 +1,66 @@
+/*
+ * BundleAllocationBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BUNDLEALLOCATIONBENCHMARK_H_
+#define BUNDLEALLOCATIONBENCHMARK_H_
+
+#include "config.h"
+#include "src/core/BundleStorage.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrcommon/data/File.h>
+#include <iostream>
+#include <string>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Counts the heap allocations of each step a bundle takes on its way
+	 * through a node: deserialization of the received bundle, the copies
+	 * handed to the events, store, get and the serialization for the next hop.
+	 * The allocations are counted by replacing the global operator new of the
+	 * program, thus allocations of background threads are included. The copies
+	 * of a bundle must not allocate more than the copies of its primary block.
+	 *
+	 * The parameters are taken from the environment:
+	 *   BENCH_ALLOC_BACKENDS  storages to test (default: memory,simple)
+	 *   BENCH_ALLOC_BUNDLES   number of bundles, comma separated (default: 1000)
+	 *   BENCH_ALLOC_OUTPUT    file for the results (default: standard output)
+	 *
+	 * The results are written as CSV with the columns
+	 * storage,stage,bundles,allocations,allocations_per_bundle,bytes_per_bundle
+	 */
+	class BundleAllocationBenchmark : public CPPUNIT_NS::TestFixture
+	{
+		CPPUNIT_TEST_SUITE(BundleAllocationBenchmark);
+		CPPUNIT_TEST(storeForwardTest);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp();
+		void tearDown();
+
+	protected:
+		void storeForwardTest();
+
+	private:
+		/**
+		 * Pass the given number of bundles through a fresh storage.
+		 * @param storage The name of the storage (memory or simple).
+		 */
+		void run(const std::string &storage, size_t bundles);
+
+		void report(const std::string &storage, const std::string &stage, size_t bundles, size_t allocations, size_t bytes);
+
+		ibrcommon::File _path;
+		std::ostream *_output;
+	};
+}
+}
+
+#endif /* BUNDLEALLOCATIONBENCHMARK_H_ */
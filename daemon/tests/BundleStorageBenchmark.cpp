@@ -0,0 +1,313 @@
+/*
+ * BundleStorageBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/BundleStorageBenchmark.h"
+#include "tests/BenchmarkHelper.h"
+#include "tests/tools/EventSwitchLoop.h"
+#include "src/core/MemoryBundleStorage.h"
+#include "src/core/SimpleBundleStorage.h"
+#include "src/core/TimeEvent.h"
+#include "src/core/GlobalEvent.h"
+#include "src/Component.h"
+
+#ifdef HAVE_SQLITE
+#include "src/core/SQLiteBundleStorage.h"
+#endif
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	CPPUNIT_TEST_SUITE_REGISTRATION (BundleStorageBenchmark);
+
+	// number of different destinations
+	static const size_t DESTINATIONS = 8;
+
+	// lifetime of the stored bundles
+	static const size_t LIFETIME = 3600;
+
+	// maximum number of filter queries per run
+	static const size_t QUERIES = 1000;
+
+	// give up waiting for the storage after this number of seconds
+	static const size_t TIMEOUT = 600;
+
+	/**
+	 * Selects up to ten bundles of one destination. The sqlite storage
+	 * evaluates the filter as sql query.
+	 */
+	class BenchmarkQuery : public dtn::core::BundleStorage::BundleFilterCallback
+#ifdef HAVE_SQLITE
+		, public dtn::core::SQLiteBundleStorage::SQLBundleQuery
+#endif
+	{
+	public:
+		BenchmarkQuery(const dtn::data::EID &destination)
+		 : _destination(destination)
+		{};
+
+		virtual ~BenchmarkQuery() {};
+
+		virtual size_t limit() const { return 10; };
+
+		virtual bool shouldAdd(const dtn::data::MetaBundle &meta) const
+		{
+			return (meta.destination == _destination);
+		};
+
+#ifdef HAVE_SQLITE
+		const std::string getWhere() const
+		{
+			return "destination = ?";
+		};
+
+		size_t bind(sqlite3_stmt *st, size_t offset) const
+		{
+			const std::string data = _destination.getString();
+			sqlite3_bind_text(st, offset, data.c_str(), data.size(), SQLITE_TRANSIENT);
+			return offset + 1;
+		}
+#endif
+
+	private:
+		const dtn::data::EID _destination;
+	};
+
+	void BundleStorageBenchmark::setUp()
+	{
+		_path = ibrcommon::File("/tmp/storage-benchmark");
+		_output = &std::cout;
+	}
+
+	void BundleStorageBenchmark::tearDown()
+	{
+		_path.remove(true);
+	}
+
+	const std::string BundleStorageBenchmark::getName(StorageType type)
+	{
+		switch (type)
+		{
+		case STORAGE_MEMORY:
+			return "memory";
+		case STORAGE_SIMPLE:
+			return "simple";
+		case STORAGE_SQLITE:
+			return "sqlite";
+		}
+
+		return "unknown";
+	}
+
+	dtn::core::BundleStorage* BundleStorageBenchmark::open(StorageType type)
+	{
+		dtn::core::BundleStorage *storage = NULL;
+
+		switch (type)
+		{
+		case STORAGE_MEMORY:
+			storage = new dtn::core::MemoryBundleStorage();
+			break;
+
+		case STORAGE_SIMPLE:
+			storage = new dtn::core::SimpleBundleStorage(_path);
+			break;
+
+		case STORAGE_SQLITE:
+#ifdef HAVE_SQLITE
+			storage = new dtn::core::SQLiteBundleStorage(_path, 0);
+#endif
+			break;
+		}
+
+		CPPUNIT_ASSERT(storage != NULL);
+
+		dtn::daemon::IntegratedComponent &c = dynamic_cast<dtn::daemon::IntegratedComponent&>(*storage);
+		c.initialize();
+		c.startup();
+
+		return storage;
+	}
+
+	void BundleStorageBenchmark::close(dtn::core::BundleStorage *storage)
+	{
+		dynamic_cast<dtn::daemon::IntegratedComponent&>(*storage).terminate();
+		delete storage;
+	}
+
+	void BundleStorageBenchmark::flush(StorageType type, size_t bundles)
+	{
+		// the simple storage writes the bundles in a background thread
+		if (type != STORAGE_SIMPLE) return;
+
+		for (size_t i = 0; (i < TIMEOUT * 100) && (countFiles(_path) < bundles); i++)
+		{
+			::usleep(10000);
+		}
+	}
+
+	void BundleStorageBenchmark::report(StorageType type, const std::string &operation, size_t bundles, size_t payload, size_t operations, double seconds)
+	{
+		(*_output) << getName(type) << "," << operation << "," << bundles << "," << payload << ","
+				<< operations << "," << seconds << "," << ((seconds > 0) ? (operations / seconds) : 0) << std::endl;
+	}
+
+	void BundleStorageBenchmark::run(StorageType type, size_t bundles, size_t payload)
+	{
+		// start with an empty storage
+		_path.remove(true);
+		ibrcommon::File::createDirectory(_path);
+
+		ibrtest::EventSwitchLoop esl;
+		esl.start();
+
+		// all bundles share the same payload
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		(*ref.iostream()) << std::string(payload, 'x');
+
+		const dtn::data::EID source("dtn://benchmark/app");
+		std::vector<dtn::data::EID> destinations;
+		for (size_t i = 0; i < DESTINATIONS; i++)
+		{
+			std::stringstream ss; ss << "dtn://node" << i << "/app";
+			destinations.push_back(dtn::data::EID(ss.str()));
+		}
+
+		std::vector<dtn::data::BundleID> ids;
+		ids.reserve(bundles);
+
+		dtn::core::BundleStorage *storage = open(type);
+		ibrcommon::TimeMeasurement tm;
+
+		// store
+		tm.start();
+		for (size_t i = 0; i < bundles; i++)
+		{
+			dtn::data::Bundle b;
+			b._source = source;
+			b._destination = destinations[i % DESTINATIONS];
+			b._lifetime = LIFETIME;
+			b.push_back(ref);
+
+			storage->store(b);
+			ids.push_back(dtn::data::BundleID(b));
+		}
+		flush(type, bundles);
+		tm.stop();
+		report(type, "store", bundles, payload, bundles, tm.getMilliseconds() / 1000.0);
+
+		CPPUNIT_ASSERT_EQUAL((unsigned int)bundles, storage->count());
+
+		// get in random order
+		std::random_shuffle(ids.begin(), ids.end());
+
+		tm.start();
+		for (std::vector<dtn::data::BundleID>::const_iterator iter = ids.begin(); iter != ids.end(); iter++)
+		{
+			storage->get(*iter);
+		}
+		tm.stop();
+		report(type, "get", bundles, payload, bundles, tm.getMilliseconds() / 1000.0);
+
+		// filter query
+		const size_t queries = std::min(bundles, QUERIES);
+
+		tm.start();
+		for (size_t i = 0; i < queries; i++)
+		{
+			BenchmarkQuery query(destinations[i % DESTINATIONS]);
+			storage->get(query);
+		}
+		tm.stop();
+		report(type, "query", bundles, payload, queries, tm.getMilliseconds() / 1000.0);
+
+		// restore the bundles of a persistent storage on startup
+		if (type != STORAGE_MEMORY)
+		{
+			close(storage);
+
+			tm.start();
+			storage = open(type);
+			tm.stop();
+			report(type, "restore", bundles, payload, bundles, tm.getMilliseconds() / 1000.0);
+
+			CPPUNIT_ASSERT_EQUAL((unsigned int)bundles, storage->count());
+		}
+
+		// remove every second bundle
+		const size_t removals = bundles / 2;
+
+		tm.start();
+		for (size_t i = 0; i < removals; i++)
+		{
+			storage->remove(ids[i]);
+		}
+		tm.stop();
+		report(type, "remove", bundles, payload, removals, tm.getMilliseconds() / 1000.0);
+
+		// let all remaining bundles expire at once
+		const size_t remaining = storage->count();
+
+		tm.start();
+		dtn::core::TimeEvent::raise(dtn::utils::Clock::getTime() + (2 * LIFETIME), dtn::utils::Clock::getUnixTimestamp() + (2 * LIFETIME), dtn::core::TIME_SECOND_TICK);
+		for (size_t i = 0; (i < TIMEOUT * 1000) && (storage->count() > 0); i++)
+		{
+			::usleep(1000);
+		}
+		tm.stop();
+		report(type, "expire", bundles, payload, remaining - storage->count(), tm.getMilliseconds() / 1000.0);
+
+		close(storage);
+
+		dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+		esl.join();
+	}
+
+	void BundleStorageBenchmark::workloadTest()
+	{
+		const std::vector<std::string> backends = getList("BENCH_STORAGE_BACKENDS", "memory,simple,sqlite");
+		const std::vector<size_t> bundles = getSizes("BENCH_STORAGE_BUNDLES", "1000");
+		const std::vector<size_t> payloads = getSizes("BENCH_STORAGE_PAYLOAD", "64");
+
+		BenchmarkOutput output("BENCH_STORAGE_OUTPUT", "storage,operation,bundles,payload,operations,seconds,ops_per_second");
+		_output = &output.stream();
+
+		for (std::vector<std::string>::const_iterator b = backends.begin(); b != backends.end(); b++)
+		{
+			StorageType type;
+
+			if ((*b) == "memory") type = STORAGE_MEMORY;
+			else if ((*b) == "simple") type = STORAGE_SIMPLE;
+#ifdef HAVE_SQLITE
+			else if ((*b) == "sqlite") type = STORAGE_SQLITE;
+#endif
+			else continue;
+
+			for (std::vector<size_t>::const_iterator n = bundles.begin(); n != bundles.end(); n++)
+			{
+				for (std::vector<size_t>::const_iterator p = payloads.begin(); p != payloads.end(); p++)
+				{
+					run(type, *n, *p);
+				}
+			}
+		}
+
+		_output = &std::cout;
+	}
+}
+}
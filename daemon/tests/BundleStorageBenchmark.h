@@ -0,0 +1,89 @@
+/*
+ * BundleStorageBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef BUNDLESTORAGEBENCHMARK_H_
+#define BUNDLESTORAGEBENCHMARK_H_
+
+#include "config.h"
+#include "src/core/BundleStorage.h"
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrcommon/data/File.h>
+#include <iostream>
+#include <string>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Runs the same workloads against every bundle storage: store, get,
+	 * filter query, restore on startup, remove and an expiry storm.
+	 *
+	 * The parameters are taken from the environment:
+	 *   BENCH_STORAGE_BACKENDS  storages to test (default: memory,simple,sqlite)
+	 *   BENCH_STORAGE_BUNDLES   number of bundles, comma separated (default: 1000)
+	 *   BENCH_STORAGE_PAYLOAD   payload sizes in bytes, comma separated (default: 64)
+	 *   BENCH_STORAGE_OUTPUT    file for the results (default: standard output)
+	 *
+	 * The results are written as CSV with the columns
+	 * storage,operation,bundles,payload,operations,seconds,ops_per_second
+	 */
+	class BundleStorageBenchmark : public CPPUNIT_NS::TestFixture
+	{
+		CPPUNIT_TEST_SUITE(BundleStorageBenchmark);
+		CPPUNIT_TEST(workloadTest);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp();
+		void tearDown();
+
+	protected:
+		void workloadTest();
+
+	private:
+		enum StorageType
+		{
+			STORAGE_MEMORY = 0,
+			STORAGE_SIMPLE = 1,
+			STORAGE_SQLITE = 2
+		};
+
+		/**
+		 * Run all workloads on a fresh storage.
+		 * @param type The storage to test.
+		 * @param bundles Number of bundles to store.
+		 * @param payload Size of the payload of each bundle in bytes.
+		 */
+		void run(StorageType type, size_t bundles, size_t payload);
+
+		/**
+		 * Create and start up a storage working on the benchmark path.
+		 */
+		dtn::core::BundleStorage* open(StorageType type);
+
+		/**
+		 * Shut down and delete a storage created by open().
+		 */
+		void close(dtn::core::BundleStorage *storage);
+
+		/**
+		 * Wait until all bundles of a storage are written to disk.
+		 */
+		void flush(StorageType type, size_t bundles);
+
+		void report(StorageType type, const std::string &operation, size_t bundles, size_t payload, size_t operations, double seconds);
+
+		static const std::string getName(StorageType type);
+
+		ibrcommon::File _path;
+		std::ostream *_output;
+	};
+}
+}
+
+#endif /* BUNDLESTORAGEBENCHMARK_H_ */
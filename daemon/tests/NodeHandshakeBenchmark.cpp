@@ -0,0 +1,125 @@
+/*
+ * NodeHandshakeBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/NodeHandshakeBenchmark.h"
+#include "src/routing/NodeHandshake.h"
+#include "src/routing/NodeHandshakeExtension.h"
+#include <ibrdtn/data/MetaBundle.h>
+
+#include <iostream>
+#include <sstream>
+
+namespace dtn
+{
+namespace testsuite
+{
+	CPPUNIT_TEST_SUITE_REGISTRATION (NodeHandshakeBenchmark);
+
+	static dtn::data::MetaBundle createBundle(size_t num)
+	{
+		return dtn::data::MetaBundle(dtn::data::BundleID(dtn::data::EID("dtn://node1/app"), 1000, num));
+	}
+
+	/**
+	 * Returns the size of a handshake response with the given item.
+	 */
+	static size_t getResponseLength(dtn::routing::NodeHandshakeItem *item)
+	{
+		dtn::routing::NodeHandshake response(dtn::routing::NodeHandshake::HANDSHAKE_RESPONSE);
+		response.addItem(item);
+
+		std::stringstream ss;
+		ss << response;
+		return ss.str().length();
+	}
+
+	void NodeHandshakeBenchmark::setUp()
+	{
+	}
+
+	void NodeHandshakeBenchmark::tearDown()
+	{
+	}
+
+	void NodeHandshakeBenchmark::handshakeSizeTest()
+	{
+		const size_t stores[] = { 100, 1000, 10000 };
+		const size_t differences[] = { 0, 10, 100, 1000 };
+
+		std::cout << std::endl << "known bundles, difference, bloomfilter bytes, first reconciliation bytes, adapted reconciliation bytes" << std::endl;
+
+		for (size_t s = 0; s < 3; s++)
+		{
+			for (size_t d = 0; d < 4; d++)
+			{
+				if (differences[d] > stores[s]) continue;
+
+				dtn::routing::SummaryVector remote_vector, local_vector;
+				dtn::routing::InvertibleBloomFilter remote(dtn::routing::NodeHandshakeExtension::DELTA_CELLS_MAX);
+				dtn::routing::InvertibleBloomFilter local(dtn::routing::NodeHandshakeExtension::DELTA_CELLS_MAX);
+
+				// both nodes share all bundles except of the difference, which is split between them
+				for (size_t i = 0; i < stores[s]; i++)
+				{
+					const dtn::data::MetaBundle b = createBundle(i);
+
+					if (i >= (differences[d] / 2))
+					{
+						local_vector.add(b);
+						local.insert(b);
+					}
+
+					if (i < (stores[s] - ((differences[d] + 1) / 2)))
+					{
+						remote_vector.add(b);
+						remote.insert(b);
+					}
+				}
+
+				const size_t bloomfilter = getResponseLength(new dtn::routing::BloomFilterSummaryVector(remote_vector));
+
+				// play two contacts with the same rules as the handshake extension
+				size_t cells = dtn::routing::NodeHandshakeExtension::DELTA_CELLS_DEFAULT;
+				bool fallback = false;
+				size_t contacts[2] = { 0, 0 };
+
+				for (size_t c = 0; c < 2; c++)
+				{
+					if (!fallback)
+					{
+						const dtn::routing::InvertibleBloomFilter table = remote.fold(cells);
+						contacts[c] += getResponseLength(new dtn::routing::InvertibleSummaryVector(table));
+
+						dtn::routing::InvertibleBloomFilter diff = table;
+						diff -= local.fold(cells);
+
+						std::set<u_int64_t> positive, negative;
+						if (diff.decode(positive, negative))
+						{
+							CPPUNIT_ASSERT_EQUAL(differences[d], positive.size() + negative.size());
+
+							const size_t next = dtn::routing::NodeHandshakeExtension::getDeltaCells(differences[d]);
+							cells = (next > 0) ? next : (size_t)dtn::routing::NodeHandshakeExtension::DELTA_CELLS_MAX;
+							continue;
+						}
+					}
+
+					// the bloomfilter is requested after a failed reconciliation
+					contacts[c] += bloomfilter;
+
+					const size_t estimated = dtn::routing::NodeHandshakeExtension::estimateDifference(local_vector.getBloomFilter(), remote_vector.getBloomFilter());
+					const size_t next = dtn::routing::NodeHandshakeExtension::getDeltaCells(estimated);
+
+					fallback = (next == 0);
+					if (next > 0) cells = next;
+				}
+
+				std::cout << stores[s] << ", " << differences[d] << ", " << bloomfilter << ", " << contacts[0] << ", " << contacts[1] << std::endl;
+			}
+		}
+	}
+}
+}
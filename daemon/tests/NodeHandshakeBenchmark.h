@@ -0,0 +1,38 @@
+/*
+ * NodeHandshakeBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef NODEHANDSHAKEBENCHMARK_H_
+#define NODEHANDSHAKEBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Compares the size of the handshake responses carrying a complete
+	 * bloomfilter with the ones used for a set reconciliation, depending on
+	 * the number of known bundles and the size of the difference.
+	 */
+	class NodeHandshakeBenchmark : public CPPUNIT_NS::TestFixture
+	{
+		CPPUNIT_TEST_SUITE(NodeHandshakeBenchmark);
+		CPPUNIT_TEST(handshakeSizeTest);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp();
+		void tearDown();
+
+	protected:
+		void handshakeSizeTest();
+	};
+}
+}
+
+#endif /* NODEHANDSHAKEBENCHMARK_H_ */
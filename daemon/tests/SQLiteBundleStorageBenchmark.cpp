@@ -0,0 +1,233 @@
+/*
+ * SQLiteBundleStorageBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/SQLiteBundleStorageBenchmark.h"
+#include "src/core/SQLiteBundleStorage.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdlib.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	CPPUNIT_TEST_SUITE_REGISTRATION (SQLiteBundleStorageBenchmark);
+
+	// number of operations done by each client thread
+	static const size_t OPERATIONS = 2000;
+
+	// number of bundles in the storage before the load starts
+	static const size_t PRELOAD = 200;
+
+	// number of different destinations
+	static const size_t DESTINATIONS = 8;
+
+	static dtn::data::EID getDestination(size_t num)
+	{
+		std::stringstream ss;
+		ss << "dtn://node" << (num % DESTINATIONS) << "/app";
+		return dtn::data::EID(ss.str());
+	}
+
+	static dtn::data::Bundle createBundle(const dtn::data::EID &source, const dtn::data::EID &destination)
+	{
+		dtn::data::Bundle b;
+		b._source = source;
+		b._destination = destination;
+		b._lifetime = 3600;
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+
+		(*ref.iostream()) << "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+
+		return b;
+	}
+
+	class DestinationFilter : public dtn::core::BundleStorage::BundleFilterCallback, public dtn::core::SQLiteBundleStorage::SQLBundleQuery
+	{
+	public:
+		DestinationFilter(const dtn::data::EID &destination)
+		 : _destination(destination)
+		{};
+
+		virtual ~DestinationFilter() {};
+
+		virtual size_t limit() const { return 10; };
+
+		virtual bool shouldAdd(const dtn::data::MetaBundle &meta) const
+		{
+			return (meta.destination == _destination);
+		};
+
+		const std::string getWhere() const
+		{
+			return "destination = ?";
+		};
+
+		size_t bind(sqlite3_stmt *st, size_t offset) const
+		{
+			const std::string data = _destination.getString();
+			sqlite3_bind_text(st, offset, data.c_str(), data.size(), SQLITE_TRANSIENT);
+			return offset + 1;
+		}
+
+	private:
+		const dtn::data::EID _destination;
+	};
+
+	/**
+	 * A client does one store for every four queries.
+	 */
+	class LoadClient : public ibrcommon::JoinableThread
+	{
+	public:
+		LoadClient(dtn::core::SQLiteBundleStorage &storage, const std::vector<dtn::data::BundleID> &ids, size_t num)
+		 : failures(0), _storage(storage), _ids(ids), _seed(num), _source("dtn://client" + toString(num) + "/app")
+		{};
+
+		virtual ~LoadClient()
+		{
+			join();
+		};
+
+		size_t failures;
+
+	protected:
+		void run()
+		{
+			for (size_t i = 0; i < OPERATIONS; i++)
+			{
+				try {
+					switch (i % 5)
+					{
+					case 0:
+						_storage.store(createBundle(_source, getDestination(rand_r(&_seed))));
+						break;
+
+					case 1:
+					case 2:
+						_storage.get(_ids[rand_r(&_seed) % _ids.size()]);
+						break;
+
+					case 3:
+					{
+						DestinationFilter filter(getDestination(rand_r(&_seed)));
+						_storage.get(filter);
+						break;
+					}
+
+					default:
+						_storage.count();
+						break;
+					}
+				} catch (const std::exception&) {
+					failures++;
+				}
+			}
+		}
+
+		bool __cancellation()
+		{
+			return false;
+		}
+
+	private:
+		static std::string toString(size_t num)
+		{
+			std::stringstream ss; ss << num;
+			return ss.str();
+		}
+
+		dtn::core::SQLiteBundleStorage &_storage;
+		const std::vector<dtn::data::BundleID> &_ids;
+		unsigned int _seed;
+		const dtn::data::EID _source;
+	};
+
+	void SQLiteBundleStorageBenchmark::setUp()
+	{
+		_path = ibrcommon::File("/tmp/sqlite-benchmark");
+	}
+
+	void SQLiteBundleStorageBenchmark::tearDown()
+	{
+		_path.remove(true);
+	}
+
+	double SQLiteBundleStorageBenchmark::run(size_t readers, size_t threads)
+	{
+		// start with an empty database
+		_path.remove(true);
+		ibrcommon::File::createDirectory(_path);
+
+		dtn::core::SQLiteBundleStorage storage(_path, 0, readers);
+		storage.initialize();
+		storage.startup();
+
+		std::vector<dtn::data::BundleID> ids;
+		for (size_t i = 0; i < PRELOAD; i++)
+		{
+			const dtn::data::Bundle b = createBundle(dtn::data::EID("dtn://preload/app"), getDestination(i));
+			storage.store(b);
+			ids.push_back(dtn::data::BundleID(b));
+		}
+
+		std::vector<LoadClient*> clients;
+		for (size_t i = 0; i < threads; i++)
+		{
+			clients.push_back(new LoadClient(storage, ids, i));
+		}
+
+		ibrcommon::TimeMeasurement tm;
+		tm.start();
+
+		for (std::vector<LoadClient*>::iterator iter = clients.begin(); iter != clients.end(); iter++)
+		{
+			(*iter)->start();
+		}
+
+		size_t failures = 0;
+		for (std::vector<LoadClient*>::iterator iter = clients.begin(); iter != clients.end(); iter++)
+		{
+			(*iter)->join();
+			failures += (*iter)->failures;
+			delete (*iter);
+		}
+
+		tm.stop();
+
+		storage.terminate();
+
+		CPPUNIT_ASSERT_EQUAL((size_t)0, failures);
+
+		return (double)(threads * OPERATIONS) / (tm.getMilliseconds() / 1000.0);
+	}
+
+	void SQLiteBundleStorageBenchmark::mixedLoadTest()
+	{
+		const size_t threads[] = { 1, 4, 8 };
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			const double single = run(0, threads[i]);
+			const double pooled = run(threads[i], threads[i]);
+
+			std::cout << std::endl << "mixed load with " << threads[i] << " threads: "
+					<< single << " ops/s single connection, "
+					<< pooled << " ops/s WAL with " << threads[i] << " readers" << std::endl;
+		}
+	}
+}
+}
@@ -0,0 +1,50 @@
+/*
+ * SQLiteBundleStorageBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef SQLITEBUNDLESTORAGEBENCHMARK_H_
+#define SQLITEBUNDLESTORAGEBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrcommon/data/File.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Measures the throughput of the sqlite storage under a mixed load of
+	 * stores and queries, once with the main connection only and once with
+	 * the WAL journal and a pool of read-only connections.
+	 */
+	class SQLiteBundleStorageBenchmark : public CPPUNIT_NS::TestFixture
+	{
+		CPPUNIT_TEST_SUITE(SQLiteBundleStorageBenchmark);
+		CPPUNIT_TEST(mixedLoadTest);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp();
+		void tearDown();
+
+	protected:
+		void mixedLoadTest();
+
+	private:
+		/**
+		 * Run the mixed load on a fresh storage.
+		 * @param readers Number of read-only connections of the storage.
+		 * @param threads Number of concurrent client threads.
+		 * @return The number of operations per second.
+		 */
+		double run(size_t readers, size_t threads);
+
+		ibrcommon::File _path;
+	};
+}
+}
+
+#endif /* SQLITEBUNDLESTORAGEBENCHMARK_H_ */
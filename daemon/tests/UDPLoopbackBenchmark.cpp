@@ -0,0 +1,236 @@
+/*
+ * UDPLoopbackBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "tests/UDPLoopbackBenchmark.h"
+#include "src/net/DatagramBatch.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	CPPUNIT_TEST_SUITE_REGISTRATION (UDPLoopbackBenchmark);
+
+	// number of datagrams in one batch, same as in the UDP convergence layer
+	static const size_t BATCH = 32;
+
+	// size of each datagram
+	static const size_t SIZE = 1280;
+
+	// number of transferred raw datagrams
+	static const size_t DATAGRAMS = 200000;
+
+	// number of transferred bundles
+	static const size_t BUNDLES = 50000;
+
+	static dtn::data::Bundle createBundle()
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://sender/app");
+		b._destination = dtn::data::EID("dtn://receiver/app");
+		b._lifetime = 3600;
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+
+		(*ref.iostream()) << std::string(1024, 'x');
+
+		return b;
+	}
+
+	void UDPLoopbackBenchmark::setUp()
+	{
+		_send_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+		_recv_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+		CPPUNIT_ASSERT(_send_fd != -1);
+		CPPUNIT_ASSERT(_recv_fd != -1);
+
+		// a full batch must fit into the receive buffer
+		int rcvbuf = 1024 * 1024;
+		::setsockopt(_recv_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+		::memset(&_addr, 0, sizeof(_addr));
+		_addr.sin_family = AF_INET;
+		_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		_addr.sin_port = 0;
+
+		CPPUNIT_ASSERT_EQUAL(0, ::bind(_recv_fd, (struct sockaddr*)&_addr, sizeof(_addr)));
+
+		// get the assigned port
+		socklen_t len = sizeof(_addr);
+		CPPUNIT_ASSERT_EQUAL(0, ::getsockname(_recv_fd, (struct sockaddr*)&_addr, &len));
+	}
+
+	void UDPLoopbackBenchmark::tearDown()
+	{
+		::close(_send_fd);
+		::close(_recv_fd);
+	}
+
+	double UDPLoopbackBenchmark::runDatagrams(bool batched)
+	{
+		char data[SIZE];
+		::memset(data, 0, SIZE);
+
+		dtn::net::DatagramBatch out(BATCH, SIZE);
+		dtn::net::DatagramBatch in(BATCH, SIZE);
+
+		size_t received = 0;
+
+		ibrcommon::TimeMeasurement tm;
+		tm.start();
+
+		for (size_t i = 0; i < DATAGRAMS; i += BATCH)
+		{
+			if (batched)
+			{
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					out.push(SIZE, (struct sockaddr*)&_addr, sizeof(_addr));
+				}
+
+				CPPUNIT_ASSERT_EQUAL(BATCH, out.send(_send_fd));
+
+				for (size_t n = 0; n < BATCH; )
+				{
+					const size_t ret = in.receive(_recv_fd);
+					n += ret; received += ret;
+				}
+			}
+			else
+			{
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					CPPUNIT_ASSERT_EQUAL((ssize_t)SIZE, ::sendto(_send_fd, data, SIZE, 0, (struct sockaddr*)&_addr, sizeof(_addr)));
+				}
+
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					if (::recvfrom(_recv_fd, data, SIZE, 0, NULL, NULL) > 0) received++;
+				}
+			}
+		}
+
+		tm.stop();
+
+		CPPUNIT_ASSERT(received >= DATAGRAMS);
+
+		return (double)received / (tm.getMilliseconds() / 1000.0);
+	}
+
+	double UDPLoopbackBenchmark::runBundles(bool batched)
+	{
+		const dtn::data::Bundle bundle = createBundle();
+
+		dtn::net::DatagramBatch out(BATCH, SIZE);
+		dtn::net::DatagramBatch in(BATCH, SIZE);
+
+		size_t received = 0;
+
+		ibrcommon::TimeMeasurement tm;
+		tm.start();
+
+		for (size_t i = 0; i < BUNDLES; i += BATCH)
+		{
+			if (batched)
+			{
+				// serialize directly into the send buffers
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					dtn::net::DatagramBatch::Buffer buf(out.next(), SIZE);
+					std::ostream stream(&buf);
+					dtn::data::DefaultSerializer(stream) << bundle;
+					out.push(buf.written(), (struct sockaddr*)&_addr, sizeof(_addr));
+				}
+
+				CPPUNIT_ASSERT_EQUAL(BATCH, out.send(_send_fd));
+
+				for (size_t n = 0; n < BATCH; )
+				{
+					const size_t ret = in.receive(_recv_fd);
+
+					// parse directly out of the receive buffers
+					for (size_t j = 0; j < ret; j++)
+					{
+						dtn::net::DatagramBatch::Buffer buf(const_cast<char*>(in.getData(j)), in.getLength(j));
+						std::istream stream(&buf);
+
+						dtn::data::Bundle b;
+						dtn::data::DefaultDeserializer(stream) >> b;
+						received++;
+					}
+
+					n += ret;
+				}
+			}
+			else
+			{
+				// the way of the UDP convergence layer before the batches
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					std::stringstream ss;
+					dtn::data::DefaultSerializer(ss) << bundle;
+					const std::string data = ss.str();
+
+					CPPUNIT_ASSERT_EQUAL((ssize_t)data.length(), ::sendto(_send_fd, data.c_str(), data.length(), 0, (struct sockaddr*)&_addr, sizeof(_addr)));
+				}
+
+				for (size_t j = 0; j < BATCH; j++)
+				{
+					char data[SIZE];
+					const ssize_t len = ::recvfrom(_recv_fd, data, SIZE, 0, NULL, NULL);
+					if (len <= 0) continue;
+
+					std::stringstream ss;
+					ss.write(data, len);
+
+					dtn::data::Bundle b;
+					dtn::data::DefaultDeserializer(ss) >> b;
+					received++;
+				}
+			}
+		}
+
+		tm.stop();
+
+		CPPUNIT_ASSERT(received >= BUNDLES);
+
+		return (double)received / (tm.getMilliseconds() / 1000.0);
+	}
+
+	void UDPLoopbackBenchmark::datagramTest()
+	{
+		const double single = runDatagrams(false);
+		const double batched = runDatagrams(true);
+
+		std::cout << std::endl << "loopback datagrams of " << SIZE << " bytes: "
+				<< single << " datagrams/s one by one, "
+				<< batched << " datagrams/s in batches of " << BATCH << std::endl;
+	}
+
+	void UDPLoopbackBenchmark::bundleTest()
+	{
+		const double single = runBundles(false);
+		const double batched = runBundles(true);
+
+		std::cout << std::endl << "loopback bundles: "
+				<< single << " bundles/s one by one, "
+				<< batched << " bundles/s in batches of " << BATCH << std::endl;
+	}
+}
+}
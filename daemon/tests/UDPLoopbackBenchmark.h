@@ -0,0 +1,57 @@
+/*
+ * UDPLoopbackBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef UDPLOOPBACKBENCHMARK_H_
+#define UDPLOOPBACKBENCHMARK_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <netinet/in.h>
+
+namespace dtn
+{
+namespace testsuite
+{
+	/**
+	 * Compares the transfer of datagrams over the loopback interface with
+	 * one system call per datagram against the batched transfer of the
+	 * DatagramBatch used by the UDP convergence layer.
+	 */
+	class UDPLoopbackBenchmark : public CPPUNIT_NS::TestFixture
+	{
+		CPPUNIT_TEST_SUITE(UDPLoopbackBenchmark);
+		CPPUNIT_TEST(datagramTest);
+		CPPUNIT_TEST(bundleTest);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp();
+		void tearDown();
+
+	protected:
+		/**
+		 * Raw datagrams per second.
+		 */
+		void datagramTest();
+
+		/**
+		 * Bundles per second, including the serialization
+		 * and parsing of each bundle.
+		 */
+		void bundleTest();
+
+	private:
+		double runDatagrams(bool batched);
+		double runBundles(bool batched);
+
+		int _send_fd;
+		int _recv_fd;
+		struct sockaddr_in _addr;
+	};
+}
+}
+
+#endif /* UDPLOOPBACKBENCHMARK_H_ */
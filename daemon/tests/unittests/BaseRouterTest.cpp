@@ -172,6 +172,72 @@ void BaseRouterTest::testSetKnown()
 	CPPUNIT_ASSERT_EQUAL(true, router.isKnown(b));
 }
 
+void BaseRouterTest::testFalsePositive()
+{
+	// a router sized for a single bundle, thus the summary vector is saturated soon
+	dtn::routing::BaseRouter router(_storage, 1);
+
+	for (size_t i = 0; i < 200; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://testcase-one/foo");
+		b._sequencenumber = i;
+		router.setKnown(b);
+	}
+
+	// all bundles are known until they expire, even without the storage
+	for (size_t i = 0; i < 200; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://testcase-one/foo");
+		b._sequencenumber = i;
+		CPPUNIT_ASSERT_EQUAL(true, router.isKnown(b));
+	}
+
+	// a new bundle is not dropped, even if the summary vector contains it
+	for (size_t i = 1000; i < 1100; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://testcase-one/foo");
+		b._sequencenumber = i;
+		CPPUNIT_ASSERT_EQUAL(true, router.getSummaryVector()->contains(b));
+		CPPUNIT_ASSERT_EQUAL(false, router.isKnown(b));
+	}
+}
+
+void BaseRouterTest::testLocalFalsePositive()
+{
+	dtn::data::EID eid("dtn://no-neighbor");
+
+	ibrtest::EventSwitchLoop esl; esl.start();
+	dtn::routing::BaseRouter router(_storage, 1);
+	router.initialize();
+
+	for (size_t i = 0; i < 200; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://testcase-one/foo");
+		b._sequencenumber = i;
+		router.setKnown(b);
+	}
+
+	// the summary vector contains the local bundle before it is received
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://testcase-one/foo");
+	b._sequencenumber = 1000;
+	CPPUNIT_ASSERT_EQUAL(true, router.getSummaryVector()->contains(b));
+
+	dtn::net::BundleReceivedEvent::raise(eid, b, true);
+
+	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+	esl.join();
+
+	router.terminate();
+
+	// the stored bundle is known nevertheless
+	CPPUNIT_ASSERT_EQUAL(true, router.isKnown(b));
+}
+
 void BaseRouterTest::testGetSummaryVector()
 {
 	/* test signature () */
@@ -184,7 +250,7 @@ void BaseRouterTest::testGetSummaryVector()
 
 	router.setKnown(b);
 
-	CPPUNIT_ASSERT_EQUAL(true, router.getSummaryVector().contains(b));
+	CPPUNIT_ASSERT_EQUAL(true, router.getSummaryVector()->contains(b));
 }
 
 /*=== END   tests for class 'BaseRouter' ===*/
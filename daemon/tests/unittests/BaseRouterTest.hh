@@ -35,6 +35,8 @@ class BaseRouterTest : public CppUnit::TestFixture {
 		void testGetStorage();
 		void testIsKnown();
 		void testSetKnown();
+		void testFalsePositive();
+		void testLocalFalsePositive();
 		void testGetSummaryVector();
 		/*=== END   tests for class 'BaseRouter' ===*/
 
@@ -51,6 +53,8 @@ class BaseRouterTest : public CppUnit::TestFixture {
 			CPPUNIT_TEST(testGetStorage);
 			CPPUNIT_TEST(testIsKnown);
 			CPPUNIT_TEST(testSetKnown);
+			CPPUNIT_TEST(testFalsePositive);
+			CPPUNIT_TEST(testLocalFalsePositive);
 			CPPUNIT_TEST(testGetSummaryVector);
 		CPPUNIT_TEST_SUITE_END();
 };
@@ -0,0 +1,269 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        CachedBundleStorageTest.cpp
+/// @brief       CPPUnit-Tests for class CachedBundleStorage
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "CachedBundleStorageTest.hh"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <sstream>
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CachedBundleStorageTest);
+
+/**
+ * A memory storage which counts the bundles read out of it.
+ */
+class CountingBundleStorage : public dtn::core::MemoryBundleStorage
+{
+public:
+	CountingBundleStorage() : gets(0) {};
+	virtual ~CountingBundleStorage() {};
+
+	dtn::data::Bundle get(const dtn::data::BundleID &id)
+	{
+		gets++;
+		return dtn::core::MemoryBundleStorage::get(id);
+	}
+
+	size_t gets;
+};
+
+/**
+ * A memory storage which takes custody of all bundles like the
+ * persistent storages do.
+ */
+class CustodyBundleStorage : public dtn::core::MemoryBundleStorage
+{
+public:
+	CustodyBundleStorage() {};
+	virtual ~CustodyBundleStorage() {};
+
+	void store(const dtn::data::Bundle &bundle)
+	{
+		dtn::data::Bundle b = bundle;
+		if (b.get(dtn::data::PrimaryBlock::CUSTODY_REQUESTED)) b._custodian = dtn::data::EID("dtn://local");
+		dtn::core::MemoryBundleStorage::store(b);
+	}
+};
+
+static dtn::data::Bundle createBundle(size_t sequencenumber, size_t payload)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node-one/test");
+	b._destination = dtn::data::EID("dtn://node-two/test");
+	b._sequencenumber = sequencenumber;
+
+	dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+	(*p.getBLOB().iostream()) << std::string(payload, 'x') << std::flush;
+
+	return b;
+}
+
+static std::string getPayload(const dtn::data::Bundle &b)
+{
+	const dtn::data::PayloadBlock &p = b.getBlock<dtn::data::PayloadBlock>();
+	ibrcommon::BLOB::Reference ref = p.getBLOB();
+	ibrcommon::BLOB::iostream stream = ref.iostream();
+
+	std::stringstream ss;
+	ss << (*stream).rdbuf();
+	return ss.str();
+}
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'CachedBundleStorage' ===*/
+void CachedBundleStorageTest::testStoreGet()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	const dtn::data::Bundle b = createBundle(1, 100);
+	cache.store(b);
+
+	// the bundle is not cached until it is read back
+	CPPUNIT_ASSERT_EQUAL((unsigned int)1, cache.count());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+
+	const dtn::data::Bundle ret = cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT(dtn::data::BundleID(ret) == dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, storage.gets);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+
+	// further reads are served out of the cache
+	cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, storage.gets);
+
+	// storing the bundle again drops the cached copy
+	cache.store(b);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+}
+
+void CachedBundleStorageTest::testReadThrough()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	// a bundle stored without the cache is loaded once
+	const dtn::data::Bundle b = createBundle(2, 100);
+	storage.store(b);
+
+	cache.get(dtn::data::BundleID(b));
+	cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, storage.gets);
+
+	// unknown bundles are not cached
+	CPPUNIT_ASSERT_THROW(cache.get(dtn::data::BundleID(createBundle(3, 100))), dtn::core::BundleStorage::NoBundleFoundException);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+}
+
+void CachedBundleStorageTest::testRemove()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	const dtn::data::Bundle b = createBundle(4, 100);
+	cache.store(b);
+	cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+
+	cache.remove(dtn::data::BundleID(b));
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+	CPPUNIT_ASSERT_THROW(cache.get(dtn::data::BundleID(b)), dtn::core::BundleStorage::NoBundleFoundException);
+}
+
+void CachedBundleStorageTest::testLimit()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 2048);
+
+	const dtn::data::Bundle a = createBundle(5, 800);
+	const dtn::data::Bundle b = createBundle(6, 800);
+	const dtn::data::Bundle c = createBundle(7, 800);
+
+	cache.store(a);
+	cache.store(b);
+	cache.store(c);
+
+	cache.get(dtn::data::BundleID(a));
+	cache.get(dtn::data::BundleID(b));
+
+	// make a the most recently used bundle
+	cache.get(dtn::data::BundleID(a));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, storage.gets);
+
+	// the least recently used bundle gives way
+	cache.get(dtn::data::BundleID(c));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, storage.gets);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, cache.getEntries());
+	CPPUNIT_ASSERT(cache.getSize() <= 2048);
+
+	cache.get(dtn::data::BundleID(a));
+	cache.get(dtn::data::BundleID(c));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, storage.gets);
+
+	cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, storage.gets);
+
+	// bundles larger than the cache are not cached at all
+	const dtn::data::Bundle large = createBundle(8, 4096);
+	cache.store(large);
+	cache.get(dtn::data::BundleID(large));
+	cache.get(dtn::data::BundleID(large));
+	CPPUNIT_ASSERT_EQUAL((size_t)6, storage.gets);
+	CPPUNIT_ASSERT_EQUAL((unsigned int)4, cache.count());
+	CPPUNIT_ASSERT(cache.getSize() <= 2048);
+}
+
+void CachedBundleStorageTest::testClear()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	const dtn::data::Bundle a = createBundle(9, 100);
+	const dtn::data::Bundle b = createBundle(10, 100);
+	cache.store(a);
+	cache.store(b);
+	cache.get(dtn::data::BundleID(a));
+	cache.get(dtn::data::BundleID(b));
+	cache.clear();
+
+	CPPUNIT_ASSERT(cache.empty());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+}
+
+void CachedBundleStorageTest::testCustody()
+{
+	CustodyBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	dtn::data::Bundle b = createBundle(11, 100);
+	b.set(dtn::data::PrimaryBlock::CUSTODY_REQUESTED, true);
+	b._custodian = dtn::data::EID("dtn://node-one");
+	cache.store(b);
+
+	// the bundle is returned as stored, with the new custodian
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://local"), cache.get(dtn::data::BundleID(b))._custodian.getString());
+	CPPUNIT_ASSERT_EQUAL(std::string("dtn://local"), cache.get(dtn::data::BundleID(b))._custodian.getString());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+
+	// a cached bundle is dropped when its custody is released
+	cache.releaseCustody(dtn::data::EID("dtn://local"), dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+}
+
+void CachedBundleStorageTest::testModify()
+{
+	CountingBundleStorage storage;
+	dtn::core::CachedBundleStorage cache(storage, 1024 * 1024);
+
+	const dtn::data::Bundle b = createBundle(12, 100);
+	cache.store(b);
+	cache.get(dtn::data::BundleID(b));
+
+	// change the payload and the blocks in place like a decryption or
+	// an authentication block does
+	dtn::data::Bundle ret = cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, storage.gets);
+
+	dtn::data::PayloadBlock &p = ret.getBlock<dtn::data::PayloadBlock>();
+	{
+		ibrcommon::BLOB::Reference ref = p.getBLOB();
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		stream.clear();
+		(*stream) << std::string(50, 'y') << std::flush;
+	}
+	p.set(dtn::data::Block::LAST_BLOCK, false);
+	ret.push_back<dtn::data::PayloadBlock>();
+
+	// the cached bundle is not changed
+	const dtn::data::Bundle next = cache.get(dtn::data::BundleID(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, storage.gets);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, next.getBlocks().size());
+	CPPUNIT_ASSERT(next.getBlock<dtn::data::PayloadBlock>().get(dtn::data::Block::LAST_BLOCK));
+	CPPUNIT_ASSERT_EQUAL(std::string(100, 'x'), getPayload(next));
+}
+/*=== END   tests for class 'CachedBundleStorage' ===*/
+
+void CachedBundleStorageTest::setUp()
+{
+}
+
+void CachedBundleStorageTest::tearDown()
+{
+}
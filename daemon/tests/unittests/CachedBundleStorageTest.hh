@@ -0,0 +1,49 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        CachedBundleStorageTest.hh
+/// @brief       CPPUnit-Tests for class CachedBundleStorage
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/core/CachedBundleStorage.h"
+#include "src/core/MemoryBundleStorage.h"
+
+#ifndef CACHEDBUNDLESTORAGETEST_HH
+#define CACHEDBUNDLESTORAGETEST_HH
+class CachedBundleStorageTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'CachedBundleStorage' ===*/
+		void testStoreGet();
+		void testReadThrough();
+		void testRemove();
+		void testLimit();
+		void testClear();
+		void testCustody();
+		void testModify();
+		/*=== END   tests for class 'CachedBundleStorage' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(CachedBundleStorageTest);
+			CPPUNIT_TEST(testStoreGet);
+			CPPUNIT_TEST(testReadThrough);
+			CPPUNIT_TEST(testRemove);
+			CPPUNIT_TEST(testLimit);
+			CPPUNIT_TEST(testClear);
+			CPPUNIT_TEST(testCustody);
+			CPPUNIT_TEST(testModify);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* CACHEDBUNDLESTORAGETEST_HH */
@@ -123,6 +123,13 @@ void ConfigurationTest::testGetLimit()
 	dtn::daemon::Configuration &conf = dtn::daemon::Configuration::getInstance();
 	CPPUNIT_ASSERT_EQUAL((size_t)0, conf.getLimit("test"));
 	CPPUNIT_ASSERT_EQUAL((size_t)20000000, conf.getLimit("storage"));
+
+	/* test signature (std::string, const size_t) */
+	CPPUNIT_ASSERT_EQUAL((size_t)1024, conf.getLimit("test", 1024));
+	CPPUNIT_ASSERT_EQUAL((size_t)20000000, conf.getLimit("storage", 1024));
+
+	// an explicit zero is not replaced by the default
+	CPPUNIT_ASSERT_EQUAL((size_t)0, conf.getLimit("storage_inline", 1024));
 }
 
 /*=== BEGIN tests for class 'Discovery' ===*/
@@ -378,6 +385,7 @@ ConfigurationTest::FakeConfiguration::FakeConfiguration()
 		<< "timezone = +1" << std::endl
 		<< "limit_blocksize = 1.3G" << std::endl
 		<< "limit_storage = 20M" << std::endl
+		<< "limit_storage_inline = 0" << std::endl
 		<< "" << std::endl
 		<< "statistic_type = stdout" << std::endl
 		<< "statistic_interval = 2" << std::endl
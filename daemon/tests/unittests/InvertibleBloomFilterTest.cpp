@@ -0,0 +1,162 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        InvertibleBloomFilterTest.cpp
+/// @brief       CPPUnit-Tests for class InvertibleBloomFilter
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "InvertibleBloomFilterTest.hh"
+#include "src/routing/InvertibleBloomFilter.h"
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InvertibleBloomFilterTest);
+
+static dtn::data::BundleID createID(size_t num)
+{
+	return dtn::data::BundleID(dtn::data::EID("dtn://test1/app0"), 1000, num);
+}
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'InvertibleBloomFilter' ===*/
+void InvertibleBloomFilterTest::testDecode()
+{
+	/* test signature (std::set<u_int64_t> &positive, std::set<u_int64_t> &negative) */
+	dtn::routing::InvertibleBloomFilter a(64), b(64);
+
+	// both sets share 1000 bundles
+	for (size_t i = 0; i < 1000; i++)
+	{
+		a.insert(createID(i));
+		b.insert(createID(i));
+	}
+
+	// and differ in a few
+	a.insert(createID(2000));
+	a.insert(createID(2001));
+	b.insert(createID(3000));
+
+	std::set<u_int64_t> positive, negative;
+
+	// a full table can not be decoded
+	CPPUNIT_ASSERT(!a.decode(positive, negative));
+
+	dtn::routing::InvertibleBloomFilter diff = a;
+	diff -= b;
+
+	positive.clear(); negative.clear();
+	CPPUNIT_ASSERT(diff.decode(positive, negative));
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, positive.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, negative.size());
+	CPPUNIT_ASSERT(positive.find(dtn::routing::InvertibleBloomFilter::key(createID(2001))) != positive.end());
+	CPPUNIT_ASSERT(negative.find(dtn::routing::InvertibleBloomFilter::key(createID(3000))) != negative.end());
+
+	// removed bundles disappear from the difference
+	a.remove(createID(2000));
+	a.remove(createID(2001));
+	a.insert(createID(3000));
+
+	diff = a;
+	diff -= b;
+
+	positive.clear(); negative.clear();
+	CPPUNIT_ASSERT(diff.decode(positive, negative));
+	CPPUNIT_ASSERT(positive.empty());
+	CPPUNIT_ASSERT(negative.empty());
+}
+
+void InvertibleBloomFilterTest::testFold()
+{
+	/* test signature (size_t cells) */
+	dtn::routing::InvertibleBloomFilter a(512), b(512);
+
+	for (size_t i = 0; i < 500; i++)
+	{
+		a.insert(createID(i));
+		b.insert(createID(i));
+	}
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		b.insert(createID(1000 + i));
+	}
+
+	// the folded tables have the same difference
+	dtn::routing::InvertibleBloomFilter diff = a.fold(32);
+	diff -= b.fold(32);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)32, diff.size());
+
+	std::set<u_int64_t> positive, negative;
+	CPPUNIT_ASSERT(diff.decode(positive, negative));
+	CPPUNIT_ASSERT(positive.empty());
+	CPPUNIT_ASSERT_EQUAL((size_t)10, negative.size());
+
+	// tables are never folded up
+	CPPUNIT_ASSERT_EQUAL((size_t)512, a.fold(4096).size());
+}
+
+void InvertibleBloomFilterTest::testOverload()
+{
+	/* test signature (std::set<u_int64_t> &positive, std::set<u_int64_t> &negative) */
+	dtn::routing::InvertibleBloomFilter a(16), b(16);
+
+	for (size_t i = 0; i < 100; i++)
+	{
+		a.insert(createID(i));
+	}
+
+	dtn::routing::InvertibleBloomFilter diff = a;
+	diff -= b;
+
+	// the difference exceeds the size of the table
+	std::set<u_int64_t> positive, negative;
+	CPPUNIT_ASSERT(!diff.decode(positive, negative));
+}
+
+void InvertibleBloomFilterTest::testSerialize()
+{
+	/* test signature (std::ostream &stream, const InvertibleBloomFilter &obj) */
+	dtn::routing::InvertibleBloomFilter a(64), b;
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		a.insert(createID(i));
+	}
+
+	std::stringstream ss;
+	ss << a;
+
+	CPPUNIT_ASSERT_EQUAL(a.getLength(), ss.str().length());
+
+	ss >> b;
+
+	CPPUNIT_ASSERT_EQUAL((size_t)64, b.size());
+
+	// both tables are equal
+	b -= a;
+
+	std::set<u_int64_t> positive, negative;
+	CPPUNIT_ASSERT(b.decode(positive, negative));
+	CPPUNIT_ASSERT(positive.empty());
+	CPPUNIT_ASSERT(negative.empty());
+}
+
+/*=== END   tests for class 'InvertibleBloomFilter' ===*/
+
+void InvertibleBloomFilterTest::setUp()
+{
+}
+
+void InvertibleBloomFilterTest::tearDown()
+{
+}
@@ -0,0 +1,43 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        InvertibleBloomFilterTest.hh
+/// @brief       CPPUnit-Tests for class InvertibleBloomFilter
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/routing/InvertibleBloomFilter.h"
+#include <iostream>
+
+#ifndef INVERTIBLEBLOOMFILTERTEST_HH
+#define INVERTIBLEBLOOMFILTERTEST_HH
+class InvertibleBloomFilterTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'InvertibleBloomFilter' ===*/
+		void testDecode();
+		void testFold();
+		void testOverload();
+		void testSerialize();
+		/*=== END   tests for class 'InvertibleBloomFilter' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(InvertibleBloomFilterTest);
+			CPPUNIT_TEST(testDecode);
+			CPPUNIT_TEST(testFold);
+			CPPUNIT_TEST(testOverload);
+			CPPUNIT_TEST(testSerialize);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* INVERTIBLEBLOOMFILTERTEST_HH */
@@ -0,0 +1,132 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        MetricsTest.cpp
+/// @brief       CPPUnit-Tests for class Metrics
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "MetricsTest.hh"
+#include "src/core/Metrics.h"
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MetricsTest);
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'Metrics' ===*/
+void MetricsTest::testCounter()
+{
+	dtn::core::Metrics::Counter c;
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)0, c.get());
+
+	c.add();
+	c.add(41);
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)42, c.get());
+
+	// the registry returns the same counter for the same name and labels
+	dtn::core::Metrics &m = dtn::core::Metrics::getInstance();
+	dtn::core::Metrics::Counter &a = m.getCounter("test_counter_total", "Test counter.", "id=\"a\"");
+	dtn::core::Metrics::Counter &b = m.getCounter("test_counter_total", "Test counter.", "id=\"b\"");
+	CPPUNIT_ASSERT(&a == &m.getCounter("test_counter_total", "Test counter.", "id=\"a\""));
+	CPPUNIT_ASSERT(&a != &b);
+}
+
+void MetricsTest::testHistogramBuckets()
+{
+	typedef dtn::core::Metrics::Histogram Histogram;
+
+	// small values are exact
+	for (u_int64_t v = 0; v < Histogram::SUB_BUCKETS; v++)
+	{
+		CPPUNIT_ASSERT_EQUAL((size_t)v, Histogram::getBucket(v));
+	}
+
+	// each value lies within the bounds of its bucket
+	for (u_int64_t v = 1; v < 10000000; v = (v * 3) + 1)
+	{
+		const size_t b = Histogram::getBucket(v);
+		CPPUNIT_ASSERT(v <= Histogram::getUpperBound(b));
+		CPPUNIT_ASSERT(v > Histogram::getUpperBound(b - 1));
+	}
+
+	// the buckets are adjacent
+	for (size_t b = 1; b < Histogram::BUCKETS; b++)
+	{
+		CPPUNIT_ASSERT_EQUAL(b, Histogram::getBucket(Histogram::getUpperBound(b - 1) + 1));
+	}
+
+	// huge values end up in the last bucket
+	CPPUNIT_ASSERT_EQUAL(Histogram::BUCKETS - 1, Histogram::getBucket(~0ULL));
+}
+
+void MetricsTest::testHistogramPercentile()
+{
+	dtn::core::Metrics::Histogram h;
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)0, h.getPercentile(50));
+
+	for (u_int64_t v = 1; v <= 1000; v++)
+	{
+		h.record(v);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)1000, h.getCount());
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)500500, h.getSum());
+
+	// the error is bounded by the width of the buckets
+	const u_int64_t p50 = h.getPercentile(50);
+	CPPUNIT_ASSERT(p50 >= 500);
+	CPPUNIT_ASSERT(p50 <= 500 + (500 / 8));
+
+	const u_int64_t p99 = h.getPercentile(99);
+	CPPUNIT_ASSERT(p99 >= 990);
+	CPPUNIT_ASSERT(p99 <= 990 + (990 / 8));
+
+	CPPUNIT_ASSERT(h.getPercentile(100) >= 1000);
+}
+
+void MetricsTest::testWrite()
+{
+	dtn::core::Metrics &m = dtn::core::Metrics::getInstance();
+
+	m.getCounter("test_write_total", "Test counter.").add(3);
+
+	dtn::core::Metrics::Histogram &h = m.getHistogram("test_write_seconds", "Test histogram.", "id=\"x\"");
+	h.record(1500000);
+	h.record(3);
+
+	std::stringstream ss;
+	m.write(ss);
+	const std::string data = ss.str();
+
+	CPPUNIT_ASSERT(data.find("# TYPE test_write_total counter\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("test_write_total 3\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("# TYPE test_write_seconds histogram\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("test_write_seconds_bucket{id=\"x\",le=\"0.000007\"} 1\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("test_write_seconds_bucket{id=\"x\",le=\"+Inf\"} 2\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("test_write_seconds_sum{id=\"x\"} 1.500003\n") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("test_write_seconds_count{id=\"x\"} 2\n") != std::string::npos);
+
+	// the well-known metrics are always exported
+	CPPUNIT_ASSERT(data.find("dtnd_event_queue_wait_seconds_count") != std::string::npos);
+
+	// the exposition format contains no empty lines
+	CPPUNIT_ASSERT(data.find("\n\n") == std::string::npos);
+}
+
+/*=== END   tests for class 'Metrics' ===*/
+
+void MetricsTest::setUp()
+{
+}
+
+void MetricsTest::tearDown()
+{
+}
@@ -0,0 +1,43 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        MetricsTest.hh
+/// @brief       CPPUnit-Tests for class Metrics
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/core/Metrics.h"
+#include <iostream>
+
+#ifndef METRICSTEST_HH
+#define METRICSTEST_HH
+class MetricsTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'Metrics' ===*/
+		void testCounter();
+		void testHistogramBuckets();
+		void testHistogramPercentile();
+		void testWrite();
+		/*=== END   tests for class 'Metrics' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(MetricsTest);
+			CPPUNIT_TEST(testCounter);
+			CPPUNIT_TEST(testHistogramBuckets);
+			CPPUNIT_TEST(testHistogramPercentile);
+			CPPUNIT_TEST(testWrite);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* METRICSTEST_HH */
@@ -0,0 +1,226 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        ReceivePipelineTest.cpp
+/// @brief       CPPUnit-Tests for class ReceivePipeline
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "ReceivePipelineTest.hh"
+#include "src/core/EventReceiver.h"
+#include "src/core/Metrics.h"
+#include "src/net/BundleReceivedEvent.h"
+#include "tests/tools/EventSwitchLoop.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <unistd.h>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ReceivePipelineTest);
+
+/**
+ * Collects all bundles leaving the pipeline.
+ */
+class ReceivedCollector : public dtn::core::EventReceiver
+{
+public:
+	ReceivedCollector()
+	{
+		bindEvent(dtn::net::BundleReceivedEvent::className);
+	}
+
+	virtual ~ReceivedCollector()
+	{
+		unbindEvent(dtn::net::BundleReceivedEvent::className);
+	}
+
+	void raiseEvent(const dtn::core::Event *evt)
+	{
+		try {
+			const dtn::net::BundleReceivedEvent &received = dynamic_cast<const dtn::net::BundleReceivedEvent&>(*evt);
+
+			ibrcommon::MutexLock l(_lock);
+			_bundles.push_back(received.bundle);
+		} catch (const std::bad_cast&) { }
+	}
+
+	std::list<dtn::data::Bundle> getBundles()
+	{
+		ibrcommon::MutexLock l(_lock);
+		return _bundles;
+	}
+
+	/**
+	 * Wait up to five seconds for the given number of bundles.
+	 */
+	bool waitFor(size_t count)
+	{
+		for (size_t i = 0; i < 500; i++)
+		{
+			if (getBundles().size() >= count) return true;
+			::usleep(10000);
+		}
+		return false;
+	}
+
+private:
+	ibrcommon::Mutex _lock;
+	std::list<dtn::data::Bundle> _bundles;
+};
+
+static dtn::data::Bundle createBundle(const std::string &source, const std::string &destination, size_t sequencenumber)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID(source);
+	b._destination = dtn::data::EID(destination);
+	b._sequencenumber = sequencenumber;
+	b._lifetime = 3600;
+	return b;
+}
+
+static u_int64_t getDropped(const std::string &stage)
+{
+	return dtn::core::Metrics::getInstance().getCounter("dtnd_receive_pipeline_dropped_total",
+			"Bundles dropped by a stage of the receive pipeline.", "stage=\"" + stage + "\"").get();
+}
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'ReceivePipeline' ===*/
+void ReceivePipelineTest::testInactive()
+{
+	dtn::core::ReceivePipeline &pipeline = dtn::core::ReceivePipeline::getInstance();
+	const dtn::data::Bundle b = createBundle("dtn://node-one/test", "dtn://node-two/test", 1);
+
+	// a disabled pipeline does not take over bundles
+	pipeline.setup(0, 0);
+	pipeline.initialize();
+	CPPUNIT_ASSERT(!pipeline.isActive());
+	CPPUNIT_ASSERT(!pipeline.push(dtn::data::EID("dtn://node-one"), b, true));
+	pipeline.terminate();
+
+	// a stopped pipeline refuses bundles, thus the caller processes them
+	pipeline.setup(2, 4);
+	pipeline.initialize();
+	CPPUNIT_ASSERT(pipeline.isActive());
+	pipeline.terminate();
+
+	CPPUNIT_ASSERT(!pipeline.isActive());
+	CPPUNIT_ASSERT(!pipeline.push(dtn::data::EID("dtn://node-one"), b, true));
+}
+
+void ReceivePipelineTest::testOrder()
+{
+	ibrtest::EventSwitchLoop esl; esl.start();
+	ReceivedCollector collector;
+
+	dtn::core::ReceivePipeline &pipeline = dtn::core::ReceivePipeline::getInstance();
+	pipeline.setup(3, 2);
+	pipeline.initialize();
+
+	// interleave the bundles of two sources
+	for (size_t i = 0; i < 20; i++)
+	{
+		CPPUNIT_ASSERT(pipeline.push(dtn::data::EID("dtn://node-one"), createBundle("dtn://node-one/test", "dtn://node-three/test", i), true));
+		CPPUNIT_ASSERT(pipeline.push(dtn::data::EID("dtn://node-two"), createBundle("dtn://node-two/test", "dtn://node-three/test", i), true));
+	}
+
+	CPPUNIT_ASSERT(collector.waitFor(40));
+
+	pipeline.terminate();
+
+	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+	esl.join();
+
+	// the bundles of each source leave the pipeline in the order of reception
+	size_t next_one = 0;
+	size_t next_two = 0;
+
+	const std::list<dtn::data::Bundle> bundles = collector.getBundles();
+	for (std::list<dtn::data::Bundle>::const_iterator iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		if ((*iter)._source == dtn::data::EID("dtn://node-one/test"))
+		{
+			CPPUNIT_ASSERT_EQUAL(next_one, (size_t)(*iter)._sequencenumber);
+			next_one++;
+		}
+		else
+		{
+			CPPUNIT_ASSERT_EQUAL(next_two, (size_t)(*iter)._sequencenumber);
+			next_two++;
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)20, next_one);
+	CPPUNIT_ASSERT_EQUAL((size_t)20, next_two);
+}
+
+void ReceivePipelineTest::testDropped()
+{
+	ibrtest::EventSwitchLoop esl; esl.start();
+	ReceivedCollector collector;
+
+	dtn::core::ReceivePipeline &pipeline = dtn::core::ReceivePipeline::getInstance();
+	pipeline.setup(1, 4);
+	pipeline.initialize();
+
+	const u_int64_t dropped = getDropped("validate");
+
+	// the bundle is taken over, but dropped by the validation
+	CPPUNIT_ASSERT(pipeline.push(dtn::data::EID("dtn://node-one"), createBundle("dtn://node-one/test", "dtn:null", 1), true));
+
+	// a bundle of the same source passes the pipeline behind the dropped one
+	CPPUNIT_ASSERT(pipeline.push(dtn::data::EID("dtn://node-one"), createBundle("dtn://node-one/test", "dtn://node-two/test", 2), true));
+	CPPUNIT_ASSERT(collector.waitFor(1));
+
+	pipeline.terminate();
+
+	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+	esl.join();
+
+	const std::list<dtn::data::Bundle> bundles = collector.getBundles();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, bundles.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, (size_t)bundles.front()._sequencenumber);
+	CPPUNIT_ASSERT_EQUAL(dropped + 1, getDropped("validate"));
+}
+
+void ReceivePipelineTest::testRestart()
+{
+	ibrtest::EventSwitchLoop esl; esl.start();
+	ReceivedCollector collector;
+
+	dtn::core::ReceivePipeline &pipeline = dtn::core::ReceivePipeline::getInstance();
+	pipeline.setup(2, 2);
+
+	// the lanes are released on shutdown and created again on start up
+	for (size_t i = 0; i < 3; i++)
+	{
+		pipeline.initialize();
+		CPPUNIT_ASSERT(pipeline.push(dtn::data::EID("dtn://node-one"), createBundle("dtn://node-one/test", "dtn://node-two/test", i), true));
+		CPPUNIT_ASSERT(collector.waitFor(i + 1));
+		pipeline.terminate();
+	}
+
+	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+	esl.join();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)3, collector.getBundles().size());
+}
+/*=== END   tests for class 'ReceivePipeline' ===*/
+
+void ReceivePipelineTest::setUp()
+{
+}
+
+void ReceivePipelineTest::tearDown()
+{
+	dtn::core::ReceivePipeline::getInstance().setup(0, 0);
+}
@@ -0,0 +1,42 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        ReceivePipelineTest.hh
+/// @brief       CPPUnit-Tests for class ReceivePipeline
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/core/ReceivePipeline.h"
+
+#ifndef RECEIVEPIPELINETEST_HH
+#define RECEIVEPIPELINETEST_HH
+class ReceivePipelineTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'ReceivePipeline' ===*/
+		void testInactive();
+		void testOrder();
+		void testDropped();
+		void testRestart();
+		/*=== END   tests for class 'ReceivePipeline' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(ReceivePipelineTest);
+			CPPUNIT_TEST(testInactive);
+			CPPUNIT_TEST(testOrder);
+			CPPUNIT_TEST(testDropped);
+			CPPUNIT_TEST(testRestart);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* RECEIVEPIPELINETEST_HH */
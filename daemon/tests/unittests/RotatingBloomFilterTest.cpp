@@ -0,0 +1,239 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        RotatingBloomFilterTest.cpp
+/// @brief       CPPUnit-Tests for class RotatingBloomFilter
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "RotatingBloomFilterTest.hh"
+#include <ibrdtn/utils/Clock.h>
+#include "src/routing/RotatingBloomFilter.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RotatingBloomFilterTest);
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'RotatingBloomFilter' ===*/
+void RotatingBloomFilterTest::testAdd()
+{
+	/* test signature (const dtn::data::MetaBundle &bundle) */
+	dtn::routing::RotatingBloomFilter f;
+
+	// define bundle one
+	dtn::data::Bundle b1;
+	b1._lifetime = 20;
+	b1._timestamp = 0;
+	b1._sequencenumber = 23;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+
+	CPPUNIT_ASSERT(!f.contains(b1));
+
+	f.add(b1);
+
+	CPPUNIT_ASSERT(f.contains(b1));
+}
+
+void RotatingBloomFilterTest::testClear()
+{
+	/* test signature () */
+	dtn::routing::RotatingBloomFilter f;
+
+	// define bundle one
+	dtn::data::Bundle b1;
+	b1._lifetime = 20;
+	b1._timestamp = 0;
+	b1._sequencenumber = 23;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+
+	f.add(b1);
+	f.clear();
+
+	CPPUNIT_ASSERT(!f.contains(b1));
+}
+
+void RotatingBloomFilterTest::testExpire()
+{
+	/* test signature (const size_t timestamp) */
+	dtn::routing::RotatingBloomFilter f(4, 10);
+	size_t now = dtn::utils::Clock::getTime();
+
+	// bundle one expires within the next two intervals
+	dtn::data::Bundle b1;
+	b1._lifetime = 5;
+	b1._timestamp = now;
+	b1._sequencenumber = 23;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+
+	// bundle two expires far beyond the window of the filter
+	dtn::data::Bundle b2;
+	b2._lifetime = 3600;
+	b2._timestamp = now;
+	b2._sequencenumber = 42;
+	b2._source = dtn::data::EID("dtn://test2/app0");
+
+	f.add(b1);
+	f.add(b2);
+
+	f.expire(now);
+	CPPUNIT_ASSERT(f.contains(b1));
+	CPPUNIT_ASSERT(f.contains(b2));
+
+	// the bucket of bundle one has passed
+	f.expire(now + 20);
+	CPPUNIT_ASSERT(!f.contains(b1));
+	CPPUNIT_ASSERT(f.contains(b2));
+
+	// bundle two is kept for the whole window only
+	f.expire(now + 50);
+	CPPUNIT_ASSERT(!f.contains(b2));
+}
+
+void RotatingBloomFilterTest::testGetSummaryVector()
+{
+	/* test signature () */
+	dtn::routing::RotatingBloomFilter f;
+
+	// define bundle one
+	dtn::data::Bundle b1;
+	b1._lifetime = 20;
+	b1._timestamp = 0;
+	b1._sequencenumber = 23;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+
+	refcnt_ptr<dtn::routing::SummaryVector> empty = f.getSummaryVector();
+
+	f.add(b1);
+
+	refcnt_ptr<dtn::routing::SummaryVector> vec = f.getSummaryVector();
+
+	// old snapshots are not changed
+	CPPUNIT_ASSERT(!empty->contains(b1));
+	CPPUNIT_ASSERT(vec->contains(b1));
+
+	// unchanged filters hand out the same snapshot
+	CPPUNIT_ASSERT(vec.getPointer() == f.getSummaryVector().getPointer());
+}
+
+void RotatingBloomFilterTest::testGetInvertibleBloomFilter()
+{
+	/* test signature () */
+	dtn::routing::RotatingBloomFilter f(4, 10, 1024, 2, 64);
+	size_t now = dtn::utils::Clock::getTime();
+
+	// bundle one expires within the next two intervals
+	dtn::data::Bundle b1;
+	b1._lifetime = 5;
+	b1._timestamp = now;
+	b1._sequencenumber = 23;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+
+	// bundle two expires at the end of the window
+	dtn::data::Bundle b2;
+	b2._lifetime = 3600;
+	b2._timestamp = now;
+	b2._sequencenumber = 42;
+	b2._source = dtn::data::EID("dtn://test2/app0");
+
+	f.add(b1);
+	f.add(b2);
+
+	// a bundle added twice is held only once
+	f.add(b2);
+
+	std::set<u_int64_t> positive, negative;
+	CPPUNIT_ASSERT(f.getInvertibleBloomFilter()->decode(positive, negative));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, positive.size());
+
+	// the table of an expired bucket is removed from the sum
+	f.expire(now + 20);
+
+	positive.clear(); negative.clear();
+	CPPUNIT_ASSERT(f.getInvertibleBloomFilter()->decode(positive, negative));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, positive.size());
+	CPPUNIT_ASSERT(positive.find(dtn::routing::InvertibleBloomFilter::key(b2)) != positive.end());
+	CPPUNIT_ASSERT(negative.empty());
+}
+
+void RotatingBloomFilterTest::testGetSize()
+{
+	/* test signature (const size_t elements, const double probability, const size_t hashes) */
+	const size_t size = dtn::routing::RotatingBloomFilter::getSize(1000, 0.01, 2);
+
+	// more elements or fewer false positives need a larger filter
+	CPPUNIT_ASSERT(dtn::routing::RotatingBloomFilter::getSize(2000, 0.01, 2) > size);
+	CPPUNIT_ASSERT(dtn::routing::RotatingBloomFilter::getSize(1000, 0.001, 2) > size);
+
+	// fill a filter with the expected number of bundles
+	dtn::routing::RotatingBloomFilter f(1, 3600, size, 2);
+
+	for (size_t i = 0; i < 1000; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://test1/app0");
+		b._sequencenumber = i;
+		f.add(b);
+	}
+
+	size_t positives = 0;
+	for (size_t i = 1000; i < 11000; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://test1/app0");
+		b._sequencenumber = i;
+		if (f.contains(b)) positives++;
+	}
+
+	// allow twice the requested rate of false positives
+	CPPUNIT_ASSERT(positives < 200);
+}
+void RotatingBloomFilterTest::testFalsePositive()
+{
+	/* test signature (const dtn::data::MetaBundle &bundle) */
+
+	// a filter of one byte is full after a few bundles
+	dtn::routing::RotatingBloomFilter f(1, 3600, 1, 2, 64);
+
+	dtn::data::Bundle b1;
+	b1._source = dtn::data::EID("dtn://test1/app0");
+	b1._sequencenumber = 1000;
+
+	size_t added = 0;
+	for (size_t i = 0; (i < 20) && !f.contains(b1); i++, added++)
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://test2/app0");
+		b._sequencenumber = i;
+		f.add(b);
+	}
+
+	// the filter reports the bundle, but it has not been added
+	CPPUNIT_ASSERT(f.contains(b1));
+	CPPUNIT_ASSERT(!f.has(b1));
+
+	f.add(b1);
+	CPPUNIT_ASSERT(f.has(b1));
+
+	// the bundle is in the lookup table nevertheless
+	std::set<u_int64_t> positive, negative;
+	CPPUNIT_ASSERT(f.getInvertibleBloomFilter()->decode(positive, negative));
+	CPPUNIT_ASSERT_EQUAL(added + 1, positive.size());
+	CPPUNIT_ASSERT(positive.find(dtn::routing::InvertibleBloomFilter::key(b1)) != positive.end());
+}
+/*=== END   tests for class 'RotatingBloomFilter' ===*/
+
+void RotatingBloomFilterTest::setUp()
+{
+	dtn::utils::Clock::quality = 1;
+}
+
+void RotatingBloomFilterTest::tearDown()
+{
+}
@@ -0,0 +1,49 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        RotatingBloomFilterTest.hh
+/// @brief       CPPUnit-Tests for class RotatingBloomFilter
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/routing/RotatingBloomFilter.h"
+#include <iostream>
+
+#ifndef ROTATINGBLOOMFILTERTEST_HH
+#define ROTATINGBLOOMFILTERTEST_HH
+class RotatingBloomFilterTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'RotatingBloomFilter' ===*/
+		void testAdd();
+		void testClear();
+		void testExpire();
+		void testGetSummaryVector();
+		void testGetInvertibleBloomFilter();
+		void testGetSize();
+		void testFalsePositive();
+		/*=== END   tests for class 'RotatingBloomFilter' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(RotatingBloomFilterTest);
+			CPPUNIT_TEST(testAdd);
+			CPPUNIT_TEST(testClear);
+			CPPUNIT_TEST(testExpire);
+			CPPUNIT_TEST(testGetSummaryVector);
+			CPPUNIT_TEST(testGetInvertibleBloomFilter);
+			CPPUNIT_TEST(testGetSize);
+			CPPUNIT_TEST(testFalsePositive);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* ROTATINGBLOOMFILTERTEST_HH */
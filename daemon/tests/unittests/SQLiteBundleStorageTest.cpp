@@ -5,194 +5,161 @@
 /// @brief       CPPUnit-Tests for class SQLiteBundleStorage
 /// @author      Author Name (email@mail.address)
 /// @date        Created at 2010-11-01
-/// 
+///
 /// @version     $Revision: 2241 $
 /// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
 ///              by $Author: fischer $
 ///
 
- 
 
-#include "SQLiteBundleStorageTest.hh"
 
+#include "SQLiteBundleStorageTest.hh"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrcommon/data/BLOB.h>
+#include <sqlite3.h>
+#include <sstream>
+#include <string>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SQLiteBundleStorageTest);
 
-/*========================== tests below ==========================*/
-
-/*=== BEGIN tests for class 'SQLiteBundleStorage' ===*/
-void SQLiteBundleStorageTest::testStore()
+static dtn::data::Bundle createBundle(size_t payload)
 {
-	/* test signature (const dtn::data::Bundle &bundle) */
-	CPPUNIT_FAIL("not implemented");
-}
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node-one/test");
+	b._destination = dtn::data::EID("dtn://node-two/test");
+	b._lifetime = 3600;
 
-void SQLiteBundleStorageTest::testStoreBundleRoutingInfo()
-{
-	/* test signature (const data::BundleID &BundleID, const int &key, const string &routingInfo) */
-	CPPUNIT_FAIL("not implemented");
-}
+	dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+	(*p.getBLOB().iostream()) << std::string(payload, 'x') << std::flush;
 
-void SQLiteBundleStorageTest::testStoreNodeRoutingInfo()
-{
-	/* test signature (const data::EID &nodel, const int &key, const std::string &routingInfo) */
-	CPPUNIT_FAIL("not implemented");
+	return b;
 }
 
-void SQLiteBundleStorageTest::testStoreRoutingInfo()
+static std::string getPayload(const dtn::data::Bundle &b)
 {
-	/* test signature (const int &key, const std::string &routingInfo) */
-	CPPUNIT_FAIL("not implemented");
-}
+	const dtn::data::PayloadBlock &p = b.getBlock<dtn::data::PayloadBlock>();
+	ibrcommon::BLOB::Reference ref = p.getBLOB();
+	ibrcommon::BLOB::iostream stream = ref.iostream();
 
-void SQLiteBundleStorageTest::testGet()
-{
-	/* test signature (const dtn::data::BundleID &id) */
-	/* test signature (const dtn::data::EID &eid) */
-	/* test signature (const ibrcommon::BloomFilter &filter) */
-	CPPUNIT_FAIL("not implemented");
+	std::stringstream ss;
+	ss << (*stream).rdbuf();
+	return ss.str();
 }
 
-void SQLiteBundleStorageTest::testGetBundleRoutingInfo()
+SQLiteBundleStorageTest::BlockLocation SQLiteBundleStorageTest::getLocation(dtn::core::SQLiteBundleStorage &storage)
 {
-	/* test signature (const data::BundleID &bundleID, const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	const std::string query = "SELECT length(data), filename FROM blocks WHERE blocktype = ?;";
 
-void SQLiteBundleStorageTest::testGetNodeRoutingInfo()
-{
-	/* test signature (const data::EID &eid, const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	sqlite3_stmt *st = NULL;
+	CPPUNIT_ASSERT_EQUAL(SQLITE_OK, sqlite3_prepare_v2(storage._database, query.c_str(), query.length(), &st, NULL));
+	sqlite3_bind_int(st, 1, dtn::data::PayloadBlock::BLOCK_TYPE);
 
-void SQLiteBundleStorageTest::testGetRoutingInfo()
-{
-	/* test signature (const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	const int ret = sqlite3_step(st);
+	const bool indb = (sqlite3_column_type(st, 0) != SQLITE_NULL);
+	const size_t length = sqlite3_column_int64(st, 0);
+	const std::string filename = (sqlite3_column_text(st, 1) == NULL) ? "" : (const char*)sqlite3_column_text(st, 1);
+	sqlite3_finalize(st);
 
-void SQLiteBundleStorageTest::testRemoveBundleRoutingInfo()
-{
-	/* test signature (const data::BundleID &bundleID, const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	CPPUNIT_ASSERT_EQUAL(SQLITE_ROW, ret);
 
-void SQLiteBundleStorageTest::testRemoveNodeRoutingInfo()
-{
-	/* test signature (const data::EID &eid, const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	if (!indb)
+	{
+		CPPUNIT_ASSERT(filename.length() > 0);
+		CPPUNIT_ASSERT(ibrcommon::File(filename).exists());
+		return BLOCK_FILE;
+	}
 
-void SQLiteBundleStorageTest::testRemoveRoutingInfo()
-{
-	/* test signature (const int &key) */
-	CPPUNIT_FAIL("not implemented");
-}
+	// blocks in the database have no file
+	CPPUNIT_ASSERT_EQUAL(std::string(""), filename);
 
-void SQLiteBundleStorageTest::testRemove()
-{
-	/* test signature (const dtn::data::BundleID &id) */
-	CPPUNIT_FAIL("not implemented");
+	return (length <= storage._inline_limit) ? BLOCK_INLINE : BLOCK_BLOB;
 }
 
-void SQLiteBundleStorageTest::testClear()
+void SQLiteBundleStorageTest::checkStore(size_t inline_limit, size_t blob_limit, size_t payload, BlockLocation expected)
 {
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
-}
+	dtn::core::SQLiteBundleStorage storage(_path, 0);
+	storage.setBlockLimits(inline_limit, blob_limit);
+	storage.initialize();
+	storage.startup();
 
-void SQLiteBundleStorageTest::testClearAll()
-{
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
-}
+	const dtn::data::Bundle b = createBundle(payload);
+	storage.store(b);
 
-void SQLiteBundleStorageTest::testEmpty()
-{
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
-}
+	CPPUNIT_ASSERT_EQUAL(expected, getLocation(storage));
 
-void SQLiteBundleStorageTest::testCount()
-{
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
-}
+	const dtn::data::Bundle r = storage.get(b);
+	CPPUNIT_ASSERT_EQUAL(std::string(payload, 'x'), getPayload(r));
 
-void SQLiteBundleStorageTest::testReleaseCustody()
-{
-	/* test signature (dtn::data::BundleID &bundle) */
-	CPPUNIT_FAIL("not implemented");
-}
+	storage.remove(b);
+	CPPUNIT_ASSERT_EQUAL((unsigned int)0, storage.count());
 
-void SQLiteBundleStorageTest::testSetPriority()
-{
-	/* test signature (const int priority,const dtn::data::BundleID &id) */
-	CPPUNIT_FAIL("not implemented");
+	storage.terminate();
 }
 
-void SQLiteBundleStorageTest::testGetBundleBySize()
-{
-	/* test signature (const int &limit) */
-	CPPUNIT_FAIL("not implemented");
-}
+/*========================== tests below ==========================*/
 
-void SQLiteBundleStorageTest::testGetBundleByTTL()
+/*=== BEGIN tests for class 'SQLiteBundleStorage' ===*/
+void SQLiteBundleStorageTest::testStoreInline()
 {
-	/* test signature (const int &limit) */
-	CPPUNIT_FAIL("not implemented");
+	/* test signature (const dtn::data::Bundle &bundle) */
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 100, BLOCK_INLINE);
 }
 
-void SQLiteBundleStorageTest::testGetBundlesBySource()
+void SQLiteBundleStorageTest::testStoreBlob()
 {
-	/* test signature (const dtn::data::EID &sourceID) */
-	CPPUNIT_FAIL("not implemented");
+	/* test signature (const dtn::data::Bundle &bundle) */
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 4096, BLOCK_BLOB);
 }
 
-void SQLiteBundleStorageTest::testGetBundlesByDestination()
+void SQLiteBundleStorageTest::testStoreFile()
 {
-	/* test signature (const dtn::data::EID &sourceID) */
-	CPPUNIT_FAIL("not implemented");
+	/* test signature (const dtn::data::Bundle &bundle) */
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 100000, BLOCK_FILE);
 }
 
-void SQLiteBundleStorageTest::testGetBlock()
+void SQLiteBundleStorageTest::testStoreFilesOnly()
 {
-	/* test signature (const data::BundleID &bundleID,const char &blocktype) */
-	CPPUNIT_FAIL("not implemented");
-}
+	/* test signature (const size_t inline_limit, const size_t blob_limit) */
+	checkStore(0, 0, 100, BLOCK_FILE);
 
-void SQLiteBundleStorageTest::testOccupiedSpace()
-{
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
+	// blocks up to the inline limit are never streamed
+	checkStore(4096, 0, 4000, BLOCK_INLINE);
 }
 
-void SQLiteBundleStorageTest::testRaiseEvent()
+void SQLiteBundleStorageTest::testUpgradeDatabase()
 {
-	/* test signature (const Event *evt) */
-	CPPUNIT_FAIL("not implemented");
-}
+	/* test signature (const ibrcommon::File &path) */
 
-void SQLiteBundleStorageTest::testRun()
-{
-	/* test signature (void) */
-	CPPUNIT_FAIL("not implemented");
-}
+	// create a database with the block table of older versions
+	{
+		sqlite3 *db = NULL;
+		CPPUNIT_ASSERT_EQUAL(SQLITE_OK, sqlite3_open(_path.get("sqlite.db").getPath().c_str(), &db));
+		CPPUNIT_ASSERT_EQUAL(SQLITE_OK, sqlite3_exec(db, "CREATE TABLE `blocks` ( `key` INTEGER PRIMARY KEY ASC, `source_id` TEXT NOT NULL, `timestamp` INTEGER NOT NULL, `sequencenumber` INTEGER NOT NULL, `fragmentoffset` INTEGER DEFAULT NULL, `blocktype` INTEGER NOT NULL, `filename` TEXT NOT NULL, `ordernumber` INTEGER NOT NULL);", NULL, NULL, NULL));
+		sqlite3_close(db);
+	}
 
-void SQLiteBundleStorageTest::test__cancellation()
-{
-	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
+	// the data column is added on startup
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 100, BLOCK_INLINE);
+
+	// a database already upgraded is opened as it is
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 4096, BLOCK_BLOB);
+	checkStore(dtn::core::SQLiteBundleStorage::DEFAULT_INLINE_LIMIT, dtn::core::SQLiteBundleStorage::DEFAULT_BLOB_LIMIT, 100000, BLOCK_FILE);
 }
 
 /*=== END   tests for class 'SQLiteBundleStorage' ===*/
 
 void SQLiteBundleStorageTest::setUp()
 {
+	_path = ibrcommon::File("/tmp/sqlite-storage-test");
+	_path.remove(true);
+	ibrcommon::File::createDirectory(_path);
 }
 
 void SQLiteBundleStorageTest::tearDown()
 {
+	_path.remove(true);
 }
-
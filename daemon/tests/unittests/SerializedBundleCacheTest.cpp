@@ -0,0 +1,335 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        SerializedBundleCacheTest.cpp
+/// @brief       CPPUnit-Tests for class SerializedBundleCache
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "SerializedBundleCacheTest.hh"
+#include "src/net/SerializedBundleCache.h"
+#include "src/core/BundleStorage.h"
+#include "src/core/BundleEvent.h"
+#include "src/core/BundleExpiredEvent.h"
+#include "tests/tools/EventSwitchLoop.h"
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SerializedBundleCacheTest);
+
+/**
+ * Creates bundles with a payload of a fixed size and counts the loads.
+ */
+class TestLoader : public dtn::net::SerializedBundleCache::Loader
+{
+public:
+	TestLoader(size_t payload) : loads(0), missing(false), age(false), _payload(payload) {};
+	virtual ~TestLoader() {};
+
+	void load(const dtn::data::BundleID &id, dtn::data::Bundle &bundle)
+	{
+		loads++;
+
+		if (missing) throw dtn::core::BundleStorage::NoBundleFoundException();
+
+		bundle._source = id.source;
+		bundle._timestamp = id.timestamp;
+		bundle._sequencenumber = id.sequencenumber;
+		bundle._destination = dtn::data::EID("dtn://destination/app");
+
+		dtn::data::PayloadBlock &p = bundle.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << std::string(_payload, 'x') << std::flush;
+
+		if (age) bundle.push_front<dtn::data::AgeBlock>();
+	}
+
+	size_t loads;
+	bool missing;
+	bool age;
+
+private:
+	const size_t _payload;
+};
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'SerializedBundleCache' ===*/
+void SerializedBundleCacheTest::testDisabled()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(0, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 1);
+	TestLoader loader(100);
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+		dtn::net::SerializedBundleCache::Reference b(cache, id, loader);
+
+		// each sender loads the bundle on its own
+		CPPUNIT_ASSERT(!a.isCached());
+		CPPUNIT_ASSERT(!b.isCached());
+		CPPUNIT_ASSERT_EQUAL((size_t)2, loader.loads);
+		CPPUNIT_ASSERT(dtn::data::BundleID(a.getBundle()) == id);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+}
+
+void SerializedBundleCacheTest::testShared()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 2);
+	TestLoader loader(100);
+
+	// the expected serialized bundle
+	dtn::data::Bundle bundle;
+	loader.load(id, bundle);
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << bundle;
+	loader.loads = 0;
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+		dtn::net::SerializedBundleCache::Reference b(cache, id, loader);
+
+		// one load serves both senders
+		CPPUNIT_ASSERT(a.isCached());
+		CPPUNIT_ASSERT(b.isCached());
+		CPPUNIT_ASSERT_EQUAL((size_t)1, loader.loads);
+		CPPUNIT_ASSERT(&a.getData() == &b.getData());
+		CPPUNIT_ASSERT(ss.str() == a.getData());
+		CPPUNIT_ASSERT(a.getMeta() == id);
+
+		CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+		CPPUNIT_ASSERT_EQUAL(ss.str().length(), cache.getSize());
+	}
+}
+
+void SerializedBundleCacheTest::testLinger()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 3);
+	TestLoader loader(100);
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+	}
+
+	// a sender asking a little later gets the released bundle
+	{
+		dtn::net::SerializedBundleCache::Reference b(cache, id, loader);
+		CPPUNIT_ASSERT(b.isCached());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)1, loader.loads);
+
+	// released bundles are dropped without linger time
+	cache.setup(1024 * 1024, 0);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+
+	{
+		dtn::net::SerializedBundleCache::Reference c(cache, id, loader);
+		CPPUNIT_ASSERT(c.isCached());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)2, loader.loads);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+}
+
+void SerializedBundleCacheTest::testLimit()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024, 10);
+
+	const dtn::data::BundleID a(dtn::data::EID("dtn://node/app"), 1000, 4);
+	const dtn::data::BundleID b(dtn::data::EID("dtn://node/app"), 1000, 5);
+	const dtn::data::BundleID c(dtn::data::EID("dtn://node/app"), 1000, 6);
+
+	// a bundle larger than the limit is passed through
+	{
+		TestLoader loader(2048);
+		dtn::net::SerializedBundleCache::Reference ref(cache, a, loader);
+		CPPUNIT_ASSERT(!ref.isCached());
+		CPPUNIT_ASSERT(dtn::data::BundleID(ref.getBundle()) == a);
+		CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	}
+
+	TestLoader loader(600);
+
+	{
+		dtn::net::SerializedBundleCache::Reference rb(cache, b, loader);
+		CPPUNIT_ASSERT(rb.isCached());
+
+		// a pinned bundle is not evicted, thus the second does not fit
+		dtn::net::SerializedBundleCache::Reference rc(cache, c, loader);
+		CPPUNIT_ASSERT(!rc.isCached());
+	}
+
+	// the released bundle gives way to the next one
+	{
+		dtn::net::SerializedBundleCache::Reference rc(cache, c, loader);
+		CPPUNIT_ASSERT(rc.isCached());
+		CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+		CPPUNIT_ASSERT(cache.getSize() <= 1024);
+	}
+}
+
+void SerializedBundleCacheTest::testLoadFailed()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 7);
+	TestLoader loader(100);
+	loader.missing = true;
+
+	CPPUNIT_ASSERT_THROW(dtn::net::SerializedBundleCache::Reference ref(cache, id, loader), dtn::core::BundleStorage::NoBundleFoundException);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+
+	// the next sender tries again
+	loader.missing = false;
+	{
+		dtn::net::SerializedBundleCache::Reference ref(cache, id, loader);
+		CPPUNIT_ASSERT(ref.isCached());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)2, loader.loads);
+}
+
+void SerializedBundleCacheTest::testRemove()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 8);
+	TestLoader loader(100);
+
+	// a released bundle is dropped at once
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+
+	cache.remove(id);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+		CPPUNIT_ASSERT_EQUAL((size_t)2, loader.loads);
+
+		// a pinned bundle stays valid for its sender
+		cache.remove(id);
+		CPPUNIT_ASSERT(a.isCached());
+		CPPUNIT_ASSERT(a.getMeta() == id);
+		CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+
+		// the next sender loads the bundle again
+		dtn::net::SerializedBundleCache::Reference b(cache, id, loader);
+		CPPUNIT_ASSERT(b.isCached());
+		CPPUNIT_ASSERT(&a.getData() != &b.getData());
+		CPPUNIT_ASSERT_EQUAL((size_t)3, loader.loads);
+	}
+
+	// the detached entry is deleted with its last reference
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+	cache.remove(id);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+}
+
+void SerializedBundleCacheTest::testAgeBlock()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 9);
+	TestLoader loader(100);
+	loader.age = true;
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, id, loader);
+		dtn::net::SerializedBundleCache::Reference b(cache, id, loader);
+
+		// concurrent senders still share the data
+		CPPUNIT_ASSERT(a.isCached());
+		CPPUNIT_ASSERT(b.isCached());
+		CPPUNIT_ASSERT_EQUAL((size_t)1, loader.loads);
+	}
+
+	// the age is outdated once the bundle is released
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getEntries());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, cache.getSize());
+
+	{
+		dtn::net::SerializedBundleCache::Reference c(cache, id, loader);
+		CPPUNIT_ASSERT(c.isCached());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)2, loader.loads);
+}
+
+void SerializedBundleCacheTest::testEvents()
+{
+	dtn::net::SerializedBundleCache &cache = dtn::net::SerializedBundleCache::getInstance();
+	cache.setup(1024 * 1024, 10);
+
+	const dtn::data::BundleID deleted(dtn::data::EID("dtn://node/app"), 1000, 10);
+	const dtn::data::BundleID expired(dtn::data::EID("dtn://node/app"), 1000, 11);
+	const dtn::data::BundleID forwarded(dtn::data::EID("dtn://node/app"), 1000, 12);
+	TestLoader loader(100);
+
+	{
+		dtn::net::SerializedBundleCache::Reference a(cache, deleted, loader);
+		dtn::net::SerializedBundleCache::Reference b(cache, expired, loader);
+		dtn::net::SerializedBundleCache::Reference c(cache, forwarded, loader);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)3, cache.getEntries());
+
+	ibrtest::EventSwitchLoop esl; esl.start();
+	cache.initialize();
+
+	dtn::data::Bundle b1, b2;
+	loader.load(deleted, b1);
+	loader.load(forwarded, b2);
+
+	dtn::core::BundleEvent::raise(b1, dtn::core::BUNDLE_DELETED);
+	dtn::core::BundleExpiredEvent::raise(expired);
+	dtn::core::BundleEvent::raise(b2, dtn::core::BUNDLE_FORWARDED);
+
+	dtn::core::GlobalEvent::raise(dtn::core::GlobalEvent::GLOBAL_SHUTDOWN);
+	esl.join();
+
+	cache.terminate();
+
+	// only the forwarded bundle is left
+	CPPUNIT_ASSERT_EQUAL((size_t)1, cache.getEntries());
+
+	{
+		dtn::net::SerializedBundleCache::Reference c(cache, forwarded, loader);
+		CPPUNIT_ASSERT(c.isCached());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)5, loader.loads);
+}
+/*=== END   tests for class 'SerializedBundleCache' ===*/
+
+void SerializedBundleCacheTest::setUp()
+{
+}
+
+void SerializedBundleCacheTest::tearDown()
+{
+	// drop all released bundles
+	dtn::net::SerializedBundleCache::getInstance().setup(0, 0);
+}
@@ -0,0 +1,51 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        SerializedBundleCacheTest.hh
+/// @brief       CPPUnit-Tests for class SerializedBundleCache
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/net/SerializedBundleCache.h"
+#include <iostream>
+
+#ifndef SERIALIZEDBUNDLECACHETEST_HH
+#define SERIALIZEDBUNDLECACHETEST_HH
+class SerializedBundleCacheTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'SerializedBundleCache' ===*/
+		void testDisabled();
+		void testShared();
+		void testLinger();
+		void testLimit();
+		void testLoadFailed();
+		void testRemove();
+		void testAgeBlock();
+		void testEvents();
+		/*=== END   tests for class 'SerializedBundleCache' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(SerializedBundleCacheTest);
+			CPPUNIT_TEST(testDisabled);
+			CPPUNIT_TEST(testShared);
+			CPPUNIT_TEST(testLinger);
+			CPPUNIT_TEST(testLimit);
+			CPPUNIT_TEST(testLoadFailed);
+			CPPUNIT_TEST(testRemove);
+			CPPUNIT_TEST(testAgeBlock);
+			CPPUNIT_TEST(testEvents);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* SERIALIZEDBUNDLECACHETEST_HH */
@@ -26,23 +26,84 @@ CPPUNIT_TEST_SUITE_REGISTRATION(StaticRoutingExtensionTest);
 void StaticRoutingExtensionTest::testMatch()
 {
 	/* test signature (const dtn::data::EID &eid) */
-	CPPUNIT_FAIL("not implemented");
+	dtn::routing::StaticRoutingExtension::StaticRoute route("^dtn://[[:alpha:]]*.moon.dtn/", "dtn://router.dtn");
+
+	CPPUNIT_ASSERT(route.match(dtn::data::EID("dtn://base.moon.dtn/app")));
+	CPPUNIT_ASSERT(!route.match(dtn::data::EID("dtn://base.mars.dtn/app")));
+
+	// copies share the compiled expression
+	dtn::routing::StaticRoutingExtension::StaticRoute copy = route;
+	CPPUNIT_ASSERT(copy.match(dtn::data::EID("dtn://base.moon.dtn/app")));
 }
 
 void StaticRoutingExtensionTest::testGetDestination()
 {
 	/* test signature () */
-	CPPUNIT_FAIL("not implemented");
+	dtn::routing::StaticRoutingExtension::StaticRoute route("^dtn://moon.dtn/", "dtn://router.dtn");
+	CPPUNIT_ASSERT(route.getDestination() == dtn::data::EID("dtn://router.dtn"));
 }
 
 /*=== END   tests for class 'StaticRoute' ===*/
 
-void StaticRoutingExtensionTest::testNotify()
+/*=== BEGIN tests for class 'RouteTable' ===*/
+void StaticRoutingExtensionTest::testLookup()
 {
-	/* test signature (const dtn::core::Event *evt) */
-	CPPUNIT_FAIL("not implemented");
+	/* test signature (const dtn::data::EID &destination) */
+	std::list<dtn::routing::StaticRoutingExtension::StaticRoute> routes;
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("^dtn://moon.dtn/.*", "dtn://router1.dtn") );
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("^dtn://moon.dtn/app$", "dtn://router2.dtn") );
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("^dtn://mars\\.dtn/", "dtn://router3.dtn") );
+
+	dtn::routing::StaticRoutingExtension::RouteTable table(routes);
+
+	std::list<dtn::data::EID> hops = table.lookup(dtn::data::EID("dtn://moon.dtn/app"));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, hops.size());
+	CPPUNIT_ASSERT(hops.front() == dtn::data::EID("dtn://router1.dtn"));
+	CPPUNIT_ASSERT(hops.back() == dtn::data::EID("dtn://router2.dtn"));
+
+	// the dot matches any character
+	hops = table.lookup(dtn::data::EID("dtn://moonxdtn/app2"));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, hops.size());
+
+	// the escaped dot matches only a dot
+	CPPUNIT_ASSERT(table.match(dtn::data::EID("dtn://mars.dtn/app"), dtn::data::EID("dtn://router3.dtn")));
+	CPPUNIT_ASSERT(!table.match(dtn::data::EID("dtn://marsxdtn/app"), dtn::data::EID("dtn://router3.dtn")));
+
+	// the result is the same with a cached lookup
+	hops = table.lookup(dtn::data::EID("dtn://moon.dtn/app"));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, hops.size());
 }
 
+void StaticRoutingExtensionTest::testLookupRegex()
+{
+	/* test signature (const dtn::data::EID &destination) */
+	std::list<dtn::routing::StaticRoutingExtension::StaticRoute> routes;
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("^dtn://[[:alpha:]]*.moon.dtn/", "dtn://router1.dtn") );
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("moon", "dtn://router2.dtn") );
+
+	dtn::routing::StaticRoutingExtension::RouteTable table(routes);
+
+	std::list<dtn::data::EID> hops = table.lookup(dtn::data::EID("dtn://base.moon.dtn/app"));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, hops.size());
+
+	hops = table.lookup(dtn::data::EID("dtn://mars.dtn/app"));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, hops.size());
+}
+
+void StaticRoutingExtensionTest::testHasHop()
+{
+	/* test signature (const dtn::data::EID &hop) */
+	std::list<dtn::routing::StaticRoutingExtension::StaticRoute> routes;
+	routes.push_back( dtn::routing::StaticRoutingExtension::StaticRoute("^dtn://moon.dtn/", "dtn://router1.dtn") );
+
+	dtn::routing::StaticRoutingExtension::RouteTable table(routes);
+
+	CPPUNIT_ASSERT(table.hasHop(dtn::data::EID("dtn://router1.dtn")));
+	CPPUNIT_ASSERT(!table.hasHop(dtn::data::EID("dtn://router2.dtn")));
+}
+
+/*=== END   tests for class 'RouteTable' ===*/
+
 /*=== END   tests for class 'StaticRoutingExtension' ===*/
 
 void StaticRoutingExtensionTest::setUp()
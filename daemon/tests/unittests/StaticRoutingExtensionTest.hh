@@ -14,6 +14,7 @@
  
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include "src/routing/StaticRoutingExtension.h"
 
 #ifndef STATICROUTINGEXTENSIONTEST_HH
 #define STATICROUTINGEXTENSIONTEST_HH
@@ -26,7 +27,11 @@ class StaticRoutingExtensionTest : public CppUnit::TestFixture {
 		void testGetDestination();
 		/*=== END   tests for class 'StaticRoute' ===*/
 
-		void testNotify();
+		/*=== BEGIN tests for class 'RouteTable' ===*/
+		void testLookup();
+		void testLookupRegex();
+		void testHasHop();
+		/*=== END   tests for class 'RouteTable' ===*/
 		/*=== END   tests for class 'StaticRoutingExtension' ===*/
 
 		void setUp();
@@ -36,7 +41,9 @@ class StaticRoutingExtensionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(StaticRoutingExtensionTest);
 			CPPUNIT_TEST(testMatch);
 			CPPUNIT_TEST(testGetDestination);
-			CPPUNIT_TEST(testNotify);
+			CPPUNIT_TEST(testLookup);
+			CPPUNIT_TEST(testLookupRegex);
+			CPPUNIT_TEST(testHasHop);
 		CPPUNIT_TEST_SUITE_END();
 };
 #endif /* STATICROUTINGEXTENSIONTEST_HH */
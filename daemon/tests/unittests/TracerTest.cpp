@@ -0,0 +1,119 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        TracerTest.cpp
+/// @brief       CPPUnit-Tests for class Tracer
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+
+#include "TracerTest.hh"
+#include "src/core/Tracer.h"
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TracerTest);
+
+/*========================== tests below ==========================*/
+
+/*=== BEGIN tests for class 'Tracer' ===*/
+void TracerTest::testSampling()
+{
+	dtn::core::Tracer &t = dtn::core::Tracer::getInstance();
+
+	t.setup(0, 16);
+	CPPUNIT_ASSERT(!t.isSampled(1000, 1));
+
+	t.setSampling(1);
+	CPPUNIT_ASSERT(t.isSampled(1000, 1));
+
+	// about one of four bundles is traced
+	t.setSampling(4);
+	size_t sampled = 0;
+	for (size_t i = 0; i < 4000; i++)
+	{
+		const bool s = t.isSampled(1000, i);
+		if (s) sampled++;
+
+		// the decision is the same at each stage
+		CPPUNIT_ASSERT_EQUAL(s, t.isSampled(1000, i));
+	}
+
+	CPPUNIT_ASSERT(sampled > 800);
+	CPPUNIT_ASSERT(sampled < 1200);
+}
+
+void TracerTest::testRingBuffer()
+{
+	dtn::core::Tracer &t = dtn::core::Tracer::getInstance();
+	t.setup(1, 4);
+
+	const dtn::data::BundleID id(dtn::data::EID("dtn://node/app"), 1000, 1);
+
+	// the first two records are overwritten
+	t.record(id, dtn::core::Tracer::STAGE_CL_RECEIVE_START, 1);
+	t.record(id, dtn::core::Tracer::STAGE_CL_RECEIVE_END, 2);
+	t.record(id, dtn::core::Tracer::STAGE_VALIDATED, 3);
+	t.record(id, dtn::core::Tracer::STAGE_RECEIVED_EVENT, 4);
+	t.record(id, dtn::core::Tracer::STAGE_STORED, 5);
+	t.record(id, dtn::core::Tracer::STAGE_QUEUED, 6);
+
+	std::stringstream ss;
+	t.write(ss);
+	const std::string data = ss.str();
+
+	CPPUNIT_ASSERT(data.find("cl_receive_start") == std::string::npos);
+	CPPUNIT_ASSERT(data.find("cl_receive_end") == std::string::npos);
+	CPPUNIT_ASSERT(data.find("\"validated\"") != std::string::npos);
+	CPPUNIT_ASSERT(data.find("\"queued\"") != std::string::npos);
+}
+
+void TracerTest::testWrite()
+{
+	dtn::core::Tracer &t = dtn::core::Tracer::getInstance();
+	t.setup(1, 16);
+
+	const dtn::data::BundleID a(dtn::data::EID("dtn://node/app"), 1000, 1);
+	const dtn::data::BundleID b(dtn::data::EID("dtn://node/app"), 1000, 2);
+
+	t.record(a, dtn::core::Tracer::STAGE_CL_RECEIVE_START, 100);
+	t.record(b, dtn::core::Tracer::STAGE_CL_RECEIVE_START, 110);
+	t.record(a, dtn::core::Tracer::STAGE_STORED, 250);
+
+	std::stringstream ss;
+	t.write(ss);
+	const std::string data = ss.str();
+
+	// one track per bundle
+	CPPUNIT_ASSERT(data.find(a.toString()) != std::string::npos);
+	CPPUNIT_ASSERT(data.find(b.toString()) != std::string::npos);
+
+	// the time until the storage is a slice
+	CPPUNIT_ASSERT(data.find("\"name\": \"stored\", \"cat\": \"bundle\", \"ph\": \"X\", \"ts\": 100, \"dur\": 150") != std::string::npos);
+
+	// the management API ends a reply with an empty line
+	CPPUNIT_ASSERT(data.find("\n\n") == std::string::npos);
+
+	t.clear();
+
+	std::stringstream empty;
+	t.write(empty);
+	CPPUNIT_ASSERT(empty.str().find("stored") == std::string::npos);
+	CPPUNIT_ASSERT(empty.str().find("\n\n") == std::string::npos);
+
+	t.setup(0, 16);
+}
+/*=== END   tests for class 'Tracer' ===*/
+
+void TracerTest::setUp()
+{
+}
+
+void TracerTest::tearDown()
+{
+}
@@ -0,0 +1,41 @@
+/* $Id: templateengine.py 2241 2006-05-22 07:58:58Z fischer $ */
+
+///
+/// @file        TracerTest.hh
+/// @brief       CPPUnit-Tests for class Tracer
+/// @author      Author Name (email@mail.address)
+/// @date        Created at 2026-10-19
+/// 
+/// @version     $Revision: 2241 $
+/// @note        Last modification: $Date: 2006-05-22 09:58:58 +0200 (Mon, 22 May 2006) $
+///              by $Author: fischer $
+///
+
+ 
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "src/core/Tracer.h"
+#include <iostream>
+
+#ifndef TRACERTEST_HH
+#define TRACERTEST_HH
+class TracerTest : public CppUnit::TestFixture {
+	private:
+	public:
+		/*=== BEGIN tests for class 'Tracer' ===*/
+		void testSampling();
+		void testRingBuffer();
+		void testWrite();
+		/*=== END   tests for class 'Tracer' ===*/
+
+		void setUp();
+		void tearDown();
+
+
+		CPPUNIT_TEST_SUITE(TracerTest);
+			CPPUNIT_TEST(testSampling);
+			CPPUNIT_TEST(testRingBuffer);
+			CPPUNIT_TEST(testWrite);
+		CPPUNIT_TEST_SUITE_END();
+};
+#endif /* TRACERTEST_HH */
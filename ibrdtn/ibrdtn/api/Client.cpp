@@ -69,12 +69,12 @@ namespace dtn
 		}
 
 		Client::Client(const std::string &app, const dtn::data::EID &group, ibrcommon::tcpstream &stream, const COMMUNICATION_MODE mode)
-		  : StreamConnection(*this, stream), _stream(stream), _mode(mode), _app(app), _group(group), _receiver(*this)
+		  : StreamConnection(*this, stream), _stream(stream), _mode(mode), _app(app), _group(group), _receiver(*this), _window(32), _batch(1), _unflushed(0), _writing(false), _aborted(false)
 		{
 		}
 
 		Client::Client(const std::string &app, ibrcommon::tcpstream &stream, const COMMUNICATION_MODE mode)
-		  : StreamConnection(*this, stream), _stream(stream), _mode(mode), _app(app), _receiver(*this)
+		  : StreamConnection(*this, stream), _stream(stream), _mode(mode), _app(app), _receiver(*this), _window(32), _batch(1), _unflushed(0), _writing(false), _aborted(false)
 		{
 		}
 
@@ -155,6 +155,20 @@ namespace dtn
 		{
 			_inqueue.abort();
 
+			// release blocking send() calls
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+				_aborted = true;
+				_inflight_cond.signal(true);
+			}
+
+			// all unacknowledged bundles are lost
+			dtn::data::BundleID id;
+			while (__pop_inflight(id))
+			{
+				eventTransferAborted(id);
+			}
+
 			try {
 				_receiver.stop();
 			} catch (const ibrcommon::ThreadException &ex) {
@@ -167,6 +181,181 @@ namespace dtn
 			lastack = ack;
 		}
 
+		void Client::eventBundleForwarded()
+		{
+			dtn::data::BundleID id;
+			if (__pop_inflight(id)) eventTransferCompleted(id);
+		}
+
+		void Client::eventBundleRefused()
+		{
+			dtn::data::BundleID id;
+			if (__pop_inflight(id)) eventTransferAborted(id);
+		}
+
+		bool Client::__pop_inflight(dtn::data::BundleID &id)
+		{
+			bool idle = false;
+
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+				if (_inflight.empty()) return false;
+
+				id = _inflight.front();
+				_inflight.pop();
+				_inflight_cond.signal(true);
+
+				// a bundle written by send() at the moment is flushed by send() itself
+				idle = !_aborted && !_writing && __idle();
+				if (idle)
+				{
+					_unflushed = 0;
+					_writing = true;
+				}
+			}
+
+			// nothing is on the way to the daemon, write out the pending bundles
+			if (idle) __flush();
+
+			return true;
+		}
+
+		void Client::__flush()
+		{
+			// the lock is not held, the receiver has to go on reading ACKs
+			flushDeferred();
+
+			ibrcommon::MutexLock l(_inflight_cond);
+			_writing = false;
+			_inflight_cond.signal(true);
+		}
+
+		bool Client::__idle() const
+		{
+			// all bundles in the window are still in the buffer of the stream
+			return (_unflushed > 0) && (_inflight.size() <= _unflushed);
+		}
+
+		void Client::setWindow(size_t window, size_t batch)
+		{
+			ibrcommon::MutexLock l(_inflight_cond);
+			_window = (window > 0) ? window : 1;
+			_batch = (batch > 0) ? batch : 1;
+
+			// a batch larger than the window would never be flushed
+			if (_batch > _window) _batch = _window;
+		}
+
+		dtn::data::BundleID Client::send(const dtn::api::Bundle &b) throw (ConnectionException)
+		{
+			const dtn::data::BundleID id(b._b);
+			bool complete = false;
+			bool full = false;
+
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+
+				// the daemon acknowledges only bundles it has received,
+				// so write out the current batch before waiting
+				full = (_inflight.size() >= _window) && (_unflushed > 0) && !_writing;
+				if (full)
+				{
+					_unflushed = 0;
+					_writing = true;
+				}
+			}
+
+			if (full) __flush();
+
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+
+				while (!_aborted && ((_inflight.size() >= _window) || _writing))
+				{
+					_inflight_cond.wait();
+				}
+
+				if (_aborted) throw ConnectionAbortedException();
+
+				// queue the id before the bundle is written, the ACK
+				// may arrive before the write returns
+				_inflight.push(id);
+				_unflushed++;
+				_writing = true;
+
+				// flush the underlying stream only after a complete batch
+				complete = (_unflushed >= _batch);
+				if (complete) _unflushed = 0;
+			}
+
+			try {
+				deferFlush(!complete);
+				(*this) << b;
+			} catch (const std::exception &ex) {
+				ibrcommon::MutexLock l(_inflight_cond);
+				_writing = false;
+				_inflight_cond.signal(true);
+				throw ConnectionException(ex.what());
+			}
+
+			bool idle = false;
+
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+
+				// all earlier bundles may have been acknowledged during the write,
+				// then no ACK is left to flush the partial batch
+				idle = __idle();
+				if (idle)
+				{
+					_unflushed = 0;
+				}
+				else
+				{
+					_writing = false;
+					_inflight_cond.signal(true);
+				}
+			}
+
+			if (idle) __flush();
+
+			return id;
+		}
+
+		void Client::waitCompleted() throw (ConnectionException)
+		{
+			bool pending = false;
+
+			{
+				ibrcommon::MutexLock l(_inflight_cond);
+
+				while (!_aborted && _writing)
+				{
+					_inflight_cond.wait();
+				}
+
+				pending = (_unflushed > 0);
+				if (pending)
+				{
+					_unflushed = 0;
+					_writing = true;
+				}
+			}
+
+			if (pending) __flush();
+
+			// later bundles written with the stream operator are flushed at once
+			deferFlush(false);
+
+			ibrcommon::MutexLock l(_inflight_cond);
+			while (!_aborted && !_inflight.empty())
+			{
+				_inflight_cond.wait();
+			}
+
+			if (_aborted) throw ConnectionAbortedException();
+		}
+
 		void Client::received(const dtn::api::Bundle &b)
 		{
 			// if we are in send only mode...
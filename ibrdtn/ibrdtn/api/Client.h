@@ -11,12 +11,15 @@
 
 #include "ibrdtn/api/Bundle.h"
 #include "ibrdtn/data/Bundle.h"
+#include "ibrdtn/data/BundleID.h"
 #include "ibrdtn/streams/StreamConnection.h"
 #include <ibrcommon/net/tcpstream.h>
 #include <ibrcommon/thread/Mutex.h>
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Exceptions.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <queue>
 
 using namespace dtn::data;
 using namespace dtn::streams;
@@ -66,6 +69,11 @@ namespace dtn
 		 * For asynchronous reception of bundle this class contains a thread which deals the
 		 * receiving part of the communication and calls the received() methods which should be
 		 * overwritten.
+		 *
+		 * Bundles written with the stream operator are sent one at a time. The send() method
+		 * instead queues a bundle without waiting for the acknowledgement of the daemon and
+		 * signals the result later with eventTransferCompleted() or eventTransferAborted().
+		 * Both ways should not be mixed on the same connection.
 		 */
 		class Client : public StreamConnection, public StreamConnection::Callback
 		{
@@ -176,6 +184,45 @@ namespace dtn
 			 */
 			virtual void eventConnectionDown();
 
+			/**
+			 * Set the parameters of the asynchronous send. At most "window" bundles sent
+			 * with send() are unacknowledged at the same time, further calls of send() block
+			 * until the daemon acknowledged an earlier bundle. The underlying stream is
+			 * flushed after each "batch" bundles. A smaller batch is flushed as soon as
+			 * all flushed bundles are acknowledged, so the bundles of a partial batch
+			 * never wait for the next call of send().
+			 * @param window Maximum number of unacknowledged bundles.
+			 * @param batch Number of bundles per write to the underlying stream.
+			 */
+			void setWindow(size_t window, size_t batch = 1);
+
+			/**
+			 * Send a bundle without waiting for its acknowledgement. The result of the
+			 * transfer is signaled with eventTransferCompleted() or eventTransferAborted().
+			 * @param b The bundle to send.
+			 * @return The id of the bundle used in the events.
+			 */
+			dtn::data::BundleID send(const dtn::api::Bundle &b) throw (ConnectionException);
+
+			/**
+			 * Flush all bundles queued by send() and block until all of them are
+			 * acknowledged by the daemon.
+			 */
+			void waitCompleted() throw (ConnectionException);
+
+			/**
+			 * This method is called when the daemon accepted a bundle sent by send().
+			 * @param id The id of the bundle.
+			 */
+			virtual void eventTransferCompleted(const dtn::data::BundleID&) {};
+
+			/**
+			 * This method is called when a bundle sent by send() is refused by the daemon
+			 * or the connection went down before it was acknowledged.
+			 * @param id The id of the bundle.
+			 */
+			virtual void eventTransferAborted(const dtn::data::BundleID&) {};
+
 			/**
 			 * The bundle ack event is called by the StreamConnection object and stores
 			 * the last ACK'd bundle size in the lastack variable.
@@ -210,15 +257,17 @@ namespace dtn
 
 			/**
 			 * The bundle refused event callback method can overloaded to handle
-			 * a bundle refused by the porresponding daemon.
+			 * a bundle refused by the porresponding daemon. If you use send() you
+			 * must call the super method.
 			 */
-			virtual void eventBundleRefused() {};
+			virtual void eventBundleRefused();
 
 			/**
 			 * The bundle forwarded event callback method can overloaded to determine
-			 * when a bundle is forwarded to the daemon.
+			 * when a bundle is forwarded to the daemon. If you use send() you must
+			 * call the super method.
 			 */
-			virtual void eventBundleForwarded() {};
+			virtual void eventBundleForwarded();
 
 			/**
 			 * This method is for synchronous API usage only. It blocks until a bundle
@@ -265,6 +314,36 @@ namespace dtn
 
 			// the queue for incoming bundles, when used in synchronous mode
 			ibrcommon::Queue<dtn::api::Bundle> _inqueue;
+
+			/**
+			 * Remove the oldest bundle sent by send() from the window. If only
+			 * unflushed bundles are left, they are flushed.
+			 * @return False, if no bundle is in the window.
+			 */
+			bool __pop_inflight(dtn::data::BundleID &id);
+
+			/**
+			 * Flush the underlying stream and clear the writing flag. The flag
+			 * has to be set by the caller, the lock must not be held.
+			 */
+			void __flush();
+
+			/**
+			 * @return True, if no flushed bundle waits for an acknowledgement, but
+			 * unflushed bundles are left. The lock has to be held.
+			 */
+			bool __idle() const;
+
+			// bundles sent by send() and not acknowledged yet, in order of transmission
+			ibrcommon::Conditional _inflight_cond;
+			std::queue<dtn::data::BundleID> _inflight;
+			size_t _window;
+			size_t _batch;
+			size_t _unflushed;
+
+			// set while the stream is written or flushed by send() or an ACK
+			bool _writing;
+			bool _aborted;
 		};
 	}
 }
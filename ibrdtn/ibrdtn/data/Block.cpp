@@ -16,7 +16,7 @@ namespace dtn
 	namespace data
 	{
 		Block::Block(char blocktype)
-		 : _blocktype(blocktype), _procflags(0)
+		 : _blocktype(blocktype), _procflags(0), _revision(0)
 		{
 		}
 
@@ -27,11 +27,20 @@ namespace dtn
 		void Block::addEID(const EID &eid)
 		{
 			_eids.push_back(eid);
+			_revision++;
 
 			// add proc flag if not set
 			_procflags |= Block::BLOCK_CONTAINS_EIDS;
 		}
 
+		void Block::clearEIDs()
+		{
+			_eids.clear();
+			_revision++;
+
+			_procflags &= ~(Block::BLOCK_CONTAINS_EIDS);
+		}
+
 		std::list<dtn::data::EID> Block::getEIDList() const
 		{
 			return _eids;
@@ -99,15 +99,24 @@ namespace dtn
 			*/
 			virtual std::ostream &serialize_strict(std::ostream &stream, size_t &length) const;
 
+			/**
+			 * Remove all EID references of this block.
+			 */
+			void clearEIDs();
+
 			// block type of this block
 			char _blocktype;
 
-			// the list of EID references embedded in this block
+			// the list of EID references embedded in this block, change it
+			// only with addEID() and clearEIDs() to renew the dictionary
 			std::list<dtn::data::EID> _eids;
 
 		private:
 			// block processing flags
 			size_t _procflags;
+
+			// incremented on each change of the EID references
+			size_t _revision;
 		};
 	}
 }
@@ -10,6 +10,9 @@
 #include "ibrdtn/data/CustodySignalBlock.h"
 #include "ibrdtn/data/Serializer.h"
 #include "ibrdtn/data/AgeBlock.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <algorithm>
+#include <string.h>
 
 namespace dtn
 {
@@ -30,60 +33,151 @@ namespace dtn
 			clearBlocks();
 		}
 
+		Bundle::BlockList::Storage::Storage()
+		 : refs(1)
+		{
+			::memset(first, 0, sizeof(first));
+		}
+
+		Bundle::BlockList::Storage::Storage(const Storage &other)
+		 : blocks(other.blocks), refs(1)
+		{
+			::memcpy(first, other.first, sizeof(first));
+		}
+
+		void Bundle::BlockList::Storage::index(size_t pos)
+		{
+			unsigned char &entry = first[(unsigned char)blocks[pos]->getType()];
+			if (entry != 0) return;
+
+			if (pos < (size_t)(INDEX_LIMIT - 1))
+				entry = (unsigned char)(pos + 1);
+			else
+				entry = INDEX_LIMIT;
+		}
+
 		Bundle::BlockList::BlockList()
+		 : _storage(NULL), _revision(0)
 		{
 		}
 
+		Bundle::BlockList::BlockList(const Bundle::BlockList &ref)
+		 : _storage(ref._storage), _revision(ref._revision)
+		{
+			if (_storage != NULL) __sync_add_and_fetch(&_storage->refs, 1);
+		}
+
 		Bundle::BlockList::~BlockList()
 		{
+			release(_storage);
 		}
 
 		Bundle::BlockList& Bundle::BlockList::operator=(const Bundle::BlockList &ref)
 		{
-			_blocks.clear();
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = ref._blocks.begin(); iter != ref._blocks.end(); iter++)
+			// take the new reference first, the storage may be the same
+			if (ref._storage != NULL) __sync_add_and_fetch(&ref._storage->refs, 1);
+			release(_storage);
+
+			_storage = ref._storage;
+			_revision++;
+			return *this;
+		}
+
+		void Bundle::BlockList::release(Storage *storage)
+		{
+			if (storage == NULL) return;
+			if (__sync_sub_and_fetch(&storage->refs, 1) == 0) delete storage;
+		}
+
+		void Bundle::BlockList::detach()
+		{
+			if (_storage == NULL)
 			{
-				const refcnt_ptr<Block> &obj = (*iter);
-				_blocks.push_back(obj);
+				_storage = new Storage();
+				return;
 			}
-			return *this;
+
+			// the storage is not shared, no other list can take a reference now
+			if (_storage->refs == 1) return;
+
+			Storage *storage = new Storage(*_storage);
+			release(_storage);
+			_storage = storage;
+		}
+
+		const std::vector<refcnt_ptr<Block> >& Bundle::BlockList::getVector() const
+		{
+			static const std::vector<refcnt_ptr<Block> > empty;
+			if (_storage == NULL) return empty;
+			return _storage->blocks;
+		}
+
+		size_t Bundle::BlockList::getPosition(char type) const
+		{
+			if (_storage == NULL) return 0;
+
+			const std::vector<refcnt_ptr<Block> > &blocks = _storage->blocks;
+			const unsigned char entry = _storage->first[(unsigned char)type];
+
+			if (entry == 0) return blocks.size();
+			if (entry < Storage::INDEX_LIMIT) return entry - 1;
+
+			// the block is behind the positions of the index
+			for (size_t pos = Storage::INDEX_LIMIT - 1; pos < blocks.size(); pos++)
+			{
+				if (blocks[pos]->getType() == type) return pos;
+			}
+
+			return blocks.size();
 		}
 
 		void Bundle::BlockList::push_front(Block *block)
 		{
-			if (_blocks.empty())
+			detach();
+
+			if (_storage->blocks.empty())
 			{
 				// set the last block flag
 				block->set(dtn::data::Block::LAST_BLOCK, true);
 			}
 
-			_blocks.push_front(refcnt_ptr<Block>(block));
+			_storage->blocks.insert(_storage->blocks.begin(), refcnt_ptr<Block>(block));
+			reindex();
+			_revision++;
 		}
 
 		void Bundle::BlockList::push_back(Block *block)
 		{
+			detach();
+
 			// set the last block flag
 			block->set(dtn::data::Block::LAST_BLOCK, true);
 
-			if (!_blocks.empty())
+			if (!_storage->blocks.empty())
 			{
 				// remove the last block flag of the previous block
-				dtn::data::Block *lastblock = (_blocks.back().getPointer());
+				dtn::data::Block *lastblock = (_storage->blocks.back().getPointer());
 				lastblock->set(dtn::data::Block::LAST_BLOCK, false);
 			}
 
-			_blocks.push_back(refcnt_ptr<Block>(block));
+			_storage->blocks.push_back(refcnt_ptr<Block>(block));
+			_storage->index(_storage->blocks.size() - 1);
+			_revision++;
 		}
 
 		void Bundle::BlockList::insert(Block *block, const Block *before)
 		{
-			for (std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+			detach();
+
+			for (std::vector<refcnt_ptr<Block> >::iterator iter = _storage->blocks.begin(); iter != _storage->blocks.end(); iter++)
 			{
 				const dtn::data::Block *lb = (*iter).getPointer();
 
 				if (lb == before)
 				{
-					_blocks.insert(iter, refcnt_ptr<Block>(block) );
+					_storage->blocks.insert(iter, refcnt_ptr<Block>(block) );
+					reindex();
+					_revision++;
 					return;
 				}
 			}
@@ -91,17 +185,22 @@ namespace dtn
 
 		void Bundle::BlockList::remove(const Block *block)
 		{
+			if (_storage == NULL) return;
+			detach();
+
 			// delete all blocks
-			for (std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+			for (std::vector<refcnt_ptr<Block> >::iterator iter = _storage->blocks.begin(); iter != _storage->blocks.end(); iter++)
 			{
 				const dtn::data::Block &lb = (*(*iter));
 				if ( &lb == block )
 				{
-					_blocks.erase(iter++);
+					_storage->blocks.erase(iter);
+					reindex();
+					_revision++;
 
 					// set the last block bit
-					if (!_blocks.empty())
-						(*_blocks.back()).set(dtn::data::Block::LAST_BLOCK, true);
+					if (!_storage->blocks.empty())
+						(*_storage->blocks.back()).set(dtn::data::Block::LAST_BLOCK, true);
 
 					return;
 				}
@@ -110,15 +209,27 @@ namespace dtn
 
 		void Bundle::BlockList::clear()
 		{
-			// clear the list of objects
-			_blocks.clear();
+			// drop the list of objects
+			release(_storage);
+			_storage = NULL;
+			_revision++;
+		}
+
+		void Bundle::BlockList::reindex()
+		{
+			::memset(_storage->first, 0, sizeof(_storage->first));
+			for (size_t pos = 0; pos < _storage->blocks.size(); pos++)
+			{
+				_storage->index(pos);
+			}
 		}
 
 		const std::list<const Block*> Bundle::BlockList::getList() const
 		{
 			std::list<const dtn::data::Block*> ret;
 
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+			const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = blocks.begin(); iter != blocks.end(); iter++)
 			{
 				ret.push_back( (*iter).getPointer() );
 			}
@@ -130,7 +241,8 @@ namespace dtn
 		{
 			std::set<dtn::data::EID> ret;
 
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+			const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = blocks.begin(); iter != blocks.end(); iter++)
 			{
 				std::list<EID> elist = (*iter)->getEIDList();
 
@@ -275,21 +387,141 @@ namespace dtn
 
 		size_t Bundle::BlockList::size() const
 		{
-			return _blocks.size();
+			return getVector().size();
+		}
+
+		size_t Bundle::BlockList::getRevision() const
+		{
+			return _revision;
+		}
+
+		Bundle::DictionaryCache::DictionaryCache()
+		 : valid(false), revision(0), block_revision(0), compressable(false), primary_length(0)
+		{
+		}
+
+		Bundle::DictionaryCache::DictionaryCache(const DictionaryCache&)
+		 : valid(false), revision(0), block_revision(0), compressable(false), primary_length(0)
+		{
+		}
+
+		Bundle::DictionaryCache::~DictionaryCache()
+		{
+		}
+
+		Bundle::DictionaryCache& Bundle::DictionaryCache::operator=(const DictionaryCache&)
+		{
+			// the cache is rebuilt on demand
+			valid = false;
+			primary_length = 0;
+
+			return (*this);
+		}
+
+		const Dictionary Bundle::getDictionary() const
+		{
+			ibrcommon::MutexLock l(_cache.lock);
+			validate();
+			return _cache.dictionary;
+		}
+
+		bool Bundle::isCompressable() const
+		{
+			ibrcommon::MutexLock l(_cache.lock);
+			validate();
+			return _cache.compressable;
+		}
+
+		void Bundle::validate() const
+		{
+			const size_t revision = _blocks.getRevision();
+			const std::vector<refcnt_ptr<Block> > &blocks = _blocks.getVector();
+			size_t block_revision = 0;
+
+			// the revisions of the blocks only grow, thus their sum changes on each new EID
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = blocks.begin(); iter != blocks.end(); iter++)
+			{
+				block_revision += (*iter)->_revision;
+			}
+
+			// the EIDs of the primary block are public, thus compare them with the cached ones
+			if (_cache.valid && (_cache.revision == revision) && (_cache.block_revision == block_revision)
+					&& (_cache.eids[0] == _destination) && (_cache.eids[1] == _source)
+					&& (_cache.eids[2] == _reportto) && (_cache.eids[3] == _custodian))
+			{
+				return;
+			}
+
+			_cache.eids[0] = _destination;
+			_cache.eids[1] = _source;
+			_cache.eids[2] = _reportto;
+			_cache.eids[3] = _custodian;
+
+			// rebuild the dictionary
+			_cache.dictionary.clear();
+			_cache.compressable = true;
+
+			for (int i = 0; i < 4; i++)
+			{
+				_cache.dictionary.add(_cache.eids[i]);
+				_cache.compressable &= _cache.eids[i].isCompressable();
+			}
+
+			// add EID of all secondary blocks
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = blocks.begin(); iter != blocks.end(); iter++)
+			{
+				const std::list<dtn::data::EID> eids = (*iter)->getEIDList();
+				_cache.dictionary.add(eids);
+
+				for (std::list<dtn::data::EID>::const_iterator eit = eids.begin(); eit != eids.end(); eit++)
+				{
+					_cache.compressable &= (*eit).isCompressable();
+				}
+			}
+
+			_cache.revision = revision;
+			_cache.block_revision = block_revision;
+			_cache.valid = true;
+
+			// the references to the dictionary may have been changed
+			_cache.primary_length = 0;
+		}
+
+		size_t Bundle::getPrimaryLength() const
+		{
+			ibrcommon::MutexLock l(_cache.lock);
+			validate();
+
+			if (_cache.primary_length == 0) return 0;
+
+			const size_t values[6] = { _procflags, _timestamp, _sequencenumber, _lifetime, _fragmentoffset, _appdatalength };
+			if (!std::equal(values, values + 6, _cache.primary_values)) return 0;
+
+			return _cache.primary_length;
+		}
+
+		void Bundle::setPrimaryLength(const size_t length) const
+		{
+			ibrcommon::MutexLock l(_cache.lock);
+			validate();
+
+			const size_t values[6] = { _procflags, _timestamp, _sequencenumber, _lifetime, _fragmentoffset, _appdatalength };
+			std::copy(values, values + 6, _cache.primary_values);
+			_cache.primary_length = length;
 		}
 
 		template<>
 		CustodySignalBlock& Bundle::BlockList::get<CustodySignalBlock>()
 		{
 			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+				// the administrative record is the first payload block
+				const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+				const size_t pos = getPosition(PayloadBlock::BLOCK_TYPE);
+
+				if (pos < blocks.size())
 				{
-					if ((*iter)->getType() == PayloadBlock::BLOCK_TYPE)
-					{
-						Block *b = (*iter).getPointer();
-						return dynamic_cast<CustodySignalBlock&>(*b);
-					}
+					Block *b = blocks[pos].getPointer();
+					return dynamic_cast<CustodySignalBlock&>(*b);
 				}
 			} catch (const std::bad_cast&) {
 
@@ -300,38 +532,38 @@ namespace dtn
 
 		const Block& Bundle::BlockList::get(int index) const
 		{
-			if(index < 0 || index >= _blocks.size()){
+			const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+
+			if(index < 0 || index >= blocks.size()){
 				throw NoSuchBlockFoundException();
 			}
 
-			std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin();
-			std::advance(iter, index);
-			return *((*iter).getPointer());
+			return *(blocks[index].getPointer());
 		}
 
 		Block& Bundle::BlockList::get(int index)
 		{
-			if(index < 0 || index >= _blocks.size()){
+			const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+
+			if(index < 0 || index >= blocks.size()){
 				throw NoSuchBlockFoundException();
 			}
 
-			std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin();
-			std::advance(iter, index);
-			return *((*iter).getPointer());
+			return *(blocks[index].getPointer());
 		}
 
 		template<>
 		const CustodySignalBlock& Bundle::BlockList::get<const CustodySignalBlock>() const
 		{
 			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+				// the administrative record is the first payload block
+				const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+				const size_t pos = getPosition(PayloadBlock::BLOCK_TYPE);
+
+				if (pos < blocks.size())
 				{
-					if ((*iter)->getType() == PayloadBlock::BLOCK_TYPE)
-					{
-						const Block *b = (*iter).getPointer();
-						return dynamic_cast<const CustodySignalBlock&>(*b);
-					}
+					const Block *b = blocks[pos].getPointer();
+					return dynamic_cast<const CustodySignalBlock&>(*b);
 				}
 			} catch (const std::bad_cast&) {
 
@@ -344,14 +576,14 @@ namespace dtn
 		StatusReportBlock& Bundle::BlockList::get<StatusReportBlock> ()
 		{
 			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+				// the administrative record is the first payload block
+				const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+				const size_t pos = getPosition(PayloadBlock::BLOCK_TYPE);
+
+				if (pos < blocks.size())
 				{
-					if ((*iter)->getType() == PayloadBlock::BLOCK_TYPE)
-					{
-						Block *b = (*iter).getPointer();
-						return dynamic_cast<StatusReportBlock&>(*b);
-					}
+					Block *b = blocks[pos].getPointer();
+					return dynamic_cast<StatusReportBlock&>(*b);
 				}
 			} catch (const std::bad_cast&) {
 
@@ -364,14 +596,14 @@ namespace dtn
 		const StatusReportBlock& Bundle::BlockList::get<const StatusReportBlock>() const
 		{
 			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+				// the administrative record is the first payload block
+				const std::vector<refcnt_ptr<Block> > &blocks = getVector();
+				const size_t pos = getPosition(PayloadBlock::BLOCK_TYPE);
+
+				if (pos < blocks.size())
 				{
-					if ((*iter)->getType() == PayloadBlock::BLOCK_TYPE)
-					{
-						const Block *b = (*iter).getPointer();
-						return dynamic_cast<const StatusReportBlock&>(*b);
-					}
+					const Block *b = blocks[pos].getPointer();
+					return dynamic_cast<const StatusReportBlock&>(*b);
 				}
 			} catch (const std::bad_cast&) {
 
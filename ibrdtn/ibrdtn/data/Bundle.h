@@ -15,12 +15,14 @@
 #include "ibrdtn/data/EID.h"
 #include "ibrdtn/data/ExtensionBlock.h"
 #include "ibrcommon/refcnt_ptr.h"
+#include <ibrcommon/thread/Mutex.h>
 #include <ostream>
 #ifdef __DEVELOPMENT_ASSERTIONS__
 #include <cassert>
 #endif
 #include <set>
 #include <map>
+#include <vector>
 #include <typeinfo>
 
 namespace dtn
@@ -52,8 +54,99 @@ namespace dtn
 					};
 			};
 
+			/**
+			 * A view on all blocks of one type. The view does not copy the list of
+			 * blocks and is only valid as long as the blocks of the bundle are unchanged.
+			 * The iteration starts at the first block of the type, which is looked up
+			 * in the index of the block list.
+			 */
+			template<class T>
+			class BlockView
+			{
+			public:
+				class const_iterator
+				{
+				public:
+					const_iterator(std::vector<refcnt_ptr<Block> >::const_iterator iter, std::vector<refcnt_ptr<Block> >::const_iterator end)
+					 : _iter(iter), _end(end)
+					{
+						next();
+					};
+
+					const T& operator*() const { return dynamic_cast<const T&>(*(*_iter)); };
+					const T* operator->() const { return &(**this); };
+
+					const_iterator& operator++()
+					{
+						_iter++;
+						next();
+						return (*this);
+					};
+
+					const_iterator operator++(int)
+					{
+						const_iterator ret = (*this);
+						++(*this);
+						return ret;
+					};
+
+					bool operator==(const const_iterator &other) const { return _iter == other._iter; };
+					bool operator!=(const const_iterator &other) const { return _iter != other._iter; };
+
+				private:
+					// move forward to the next block of the type T
+					void next()
+					{
+						for (; _iter != _end; _iter++)
+						{
+							if (((*_iter)->getType() == T::BLOCK_TYPE) && (dynamic_cast<const T*>((*_iter).getPointer()) != NULL)) return;
+						}
+					};
+
+					std::vector<refcnt_ptr<Block> >::const_iterator _iter;
+					std::vector<refcnt_ptr<Block> >::const_iterator _end;
+				};
+
+				BlockView(const std::vector<refcnt_ptr<Block> > &blocks, size_t first)
+				 : _blocks(blocks), _first(first)
+				{ };
+
+				const_iterator begin() const
+				{
+					return const_iterator(_blocks.begin() + _first, _blocks.end());
+				};
+
+				const_iterator end() const
+				{
+					return const_iterator(_blocks.end(), _blocks.end());
+				};
+
+				bool empty() const
+				{
+					return begin() == end();
+				};
+
+				size_t size() const
+				{
+					size_t ret = 0;
+					for (const_iterator iter = begin(); iter != end(); iter++) ret++;
+					return ret;
+				};
+
+			private:
+				const std::vector<refcnt_ptr<Block> > &_blocks;
+				const size_t _first;
+			};
+
+			/**
+			 * The list of blocks of a bundle. Copies of a list share the vector of
+			 * blocks until one of them adds or removes a block, thus copying a
+			 * bundle does not copy its blocks. The blocks themselves are shared
+			 * between all copies as before.
+			 */
 			class BlockList
 			{
+				friend class Bundle;
 				friend class DefaultSerializer;
 				friend class DefaultDeserializer;
 				friend class dtn::security::StrictSerializer;
@@ -61,6 +154,7 @@ namespace dtn
 
 			public:
 				BlockList();
+				BlockList(const BlockList &ref);
 				virtual ~BlockList();
 
 				BlockList& operator=(const BlockList &ref);
@@ -83,10 +177,82 @@ namespace dtn
 
 				const std::list<const Block*> getList() const;
 
+				/**
+				 * Returns true if the list contains a block of the type T or of
+				 * a subclass of T.
+				 */
+				template<class T>
+				bool has() const;
+
+				template<class T>
+				BlockView<T> getView() const;
+
 				size_t size() const;
 
+				/**
+				 * Returns the number of changes of the list itself.
+				 */
+				size_t getRevision() const;
+
 			private:
-				std::list<refcnt_ptr<Block> > _blocks;
+				/**
+				 * The blocks of one or more lists.
+				 */
+				class Storage
+				{
+				public:
+					Storage();
+					Storage(const Storage &other);
+
+					/**
+					 * Add a block at the given position to the index, if it is the
+					 * first block of its type.
+					 */
+					void index(size_t pos);
+
+					// positions from INDEX_LIMIT - 1 on are not stored in the index
+					static const unsigned char INDEX_LIMIT = 255;
+
+					std::vector<refcnt_ptr<Block> > blocks;
+
+					// the position plus one of the first block of each type, zero if
+					// there is no block of the type and INDEX_LIMIT if the position
+					// is too large for the index
+					unsigned char first[256];
+
+					// number of lists sharing this storage
+					size_t refs;
+				};
+
+				/**
+				 * Returns the vector of blocks.
+				 */
+				const std::vector<refcnt_ptr<Block> >& getVector() const;
+
+				/**
+				 * Returns the position of the first block of a type or the number
+				 * of blocks, if there is no block of this type.
+				 */
+				size_t getPosition(char type) const;
+
+				/**
+				 * Get an own copy of the storage, before the list is changed.
+				 */
+				void detach();
+
+				/**
+				 * Drop one reference of the storage and delete it with the last one.
+				 */
+				static void release(Storage *storage);
+
+				/**
+				 * Rebuild the index of the block types.
+				 */
+				void reindex();
+
+				// NULL as long as the list is empty
+				Storage *_storage;
+				size_t _revision;
 			};
 
 			Bundle();
@@ -111,6 +277,18 @@ namespace dtn
 			template<class T>
 			const std::list<const T*> getBlocks() const;
 
+			/**
+			 * Returns a view on all blocks of the type T without copying them.
+			 */
+			template<class T>
+			BlockView<T> getBlockView() const;
+
+			/**
+			 * Returns true if the bundle contains a block of the type T.
+			 */
+			template<class T>
+			bool has() const;
+
 			template<class T>
 			T& push_front();
 
@@ -135,8 +313,67 @@ namespace dtn
 
 			size_t blockCount() const;
 
+			/**
+			 * Returns the dictionary of all EIDs of this bundle. The dictionary is
+			 * cached and only rebuilt if an EID or the list of blocks has been changed.
+			 */
+			const Dictionary getDictionary() const;
+
+			/**
+			 * Returns true if all EIDs of this bundle can be written in compressed form.
+			 * The value is cached along with the dictionary.
+			 */
+			bool isCompressable() const;
+
 		private:
+			/**
+			 * The cached dictionary and the state of the bundle it was built for.
+			 * A copy of the cache is empty, since the copied bundle is changed
+			 * in most cases before it is serialized.
+			 */
+			class DictionaryCache
+			{
+			public:
+				DictionaryCache();
+				DictionaryCache(const DictionaryCache &other);
+				virtual ~DictionaryCache();
+
+				DictionaryCache& operator=(const DictionaryCache &other);
+
+				ibrcommon::Mutex lock;
+				bool valid;
+				size_t revision;
+				size_t block_revision;
+				EID eids[4];
+				Dictionary dictionary;
+				bool compressable;
+
+				// serialized length of the primary block, zero if unknown
+				size_t primary_length;
+
+				// values of the primary block the length was computed for
+				size_t primary_values[6];
+			};
+
+			/**
+			 * Rebuild the cache if the bundle has been changed. The lock of
+			 * the cache has to be held by the caller.
+			 */
+			void validate() const;
+
+			/**
+			 * Returns the cached serialized length of the primary block or zero,
+			 * if the bundle has been changed since it was set.
+			 */
+			size_t getPrimaryLength() const;
+
+			/**
+			 * Set the serialized length of the primary block.
+			 */
+			void setPrimaryLength(const size_t length) const;
+
 			BlockList _blocks;
+			mutable DictionaryCache _cache;
 		};
 
 		template<class T>
@@ -145,6 +382,18 @@ namespace dtn
 			return _blocks.getList<T>();
 		}
 
+		template<class T>
+		Bundle::BlockView<T> Bundle::getBlockView() const
+		{
+			return _blocks.getView<T>();
+		}
+
+		template<class T>
+		bool Bundle::has() const
+		{
+			return _blocks.has<T>();
+		}
+
 		template<class T>
 		T& Bundle::getBlock()
 		{
@@ -170,43 +419,35 @@ namespace dtn
 		const StatusReportBlock& Bundle::BlockList::get<const StatusReportBlock>() const;
 
 		template<class T>
-		const T& Bundle::BlockList::get() const
+		bool Bundle::BlockList::has() const
 		{
-			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
-				{
-					if ((*iter)->getType() == T::BLOCK_TYPE)
-					{
-						const Block *b = (*iter).getPointer();
-						return dynamic_cast<const T&>(*b);
-					}
-				}
-			} catch (const std::bad_cast&) {
-
-			}
+			return !getView<T>().empty();
+		}
 
-			throw NoSuchBlockFoundException();
+		template<class T>
+		Bundle::BlockView<T> Bundle::BlockList::getView() const
+		{
+			return BlockView<T>(getVector(), getPosition(T::BLOCK_TYPE));
 		}
 
 		template<class T>
-		T& Bundle::BlockList::get()
+		const T& Bundle::BlockList::get() const
 		{
-			try {
-				// copy all blocks to the list
-				for (std::list<refcnt_ptr<Block> >::iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
-				{
-					if ((*iter)->getType() == T::BLOCK_TYPE)
-					{
-						Block *b = (*iter).getPointer();
-						return dynamic_cast<T&>(*b);
-					}
-				}
-			} catch (const std::bad_cast&) {
+			// the first block of the type T, blocks which are no T are skipped
+			const BlockView<T> view = getView<T>();
+			typename BlockView<T>::const_iterator iter = view.begin();
+			if (iter == view.end()) throw NoSuchBlockFoundException();
 
-			}
+			return (*iter);
+		}
 
-			throw NoSuchBlockFoundException();
+		template<class T>
+		T& Bundle::BlockList::get()
+		{
+			// the blocks are shared with the copies of this list, thus they
+			// are changed in place
+			const BlockList &list = (*this);
+			return const_cast<T&>(list.get<T>());
 		}
 
 		template<class T>
@@ -216,17 +457,10 @@ namespace dtn
 			std::list<const T*> ret;
 
 			// copy all blocks to the list
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = _blocks.begin(); iter != _blocks.end(); iter++)
+			const BlockView<T> view = getView<T>();
+			for (typename BlockView<T>::const_iterator iter = view.begin(); iter != view.end(); iter++)
 			{
-				if ((*(*iter)).getType() == T::BLOCK_TYPE)
-				{
-					const T* obj = dynamic_cast<const T*>((*iter).getPointer());
-
-					if (obj != NULL)
-					{
-						ret.push_back( obj );
-					}
-				}
+				ret.push_back( &(*iter) );
 			}
 
 			return ret;
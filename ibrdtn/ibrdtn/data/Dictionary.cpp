@@ -21,6 +21,7 @@ namespace dtn
 namespace data
 {
 	Dictionary::Dictionary()
+	 : _indexed(true)
 	{
 	}
 
@@ -28,6 +29,7 @@ namespace data
 	 * create a dictionary with all EID of the given bundle
 	 */
 	Dictionary::Dictionary(const dtn::data::Bundle &bundle)
+	 : _indexed(true)
 	{
 		// rebuild the dictionary
 		add(bundle._destination);
@@ -46,8 +48,8 @@ namespace data
 	}
 
 	Dictionary::Dictionary(const Dictionary &d)
+	 : _bytes(d._bytes), _offsets(d._offsets), _indexed(d._indexed)
 	{
-		this->operator=(d);
 	}
 
 	/**
@@ -55,8 +57,9 @@ namespace data
 	 */
 	Dictionary& Dictionary::operator=(const Dictionary &d)
 	{
-		_bytestream.str("");
-		_bytestream << d._bytestream.rdbuf();
+		_bytes = d._bytes;
+		_offsets = d._offsets;
+		_indexed = d._indexed;
 		return (*this);
 	}
 
@@ -64,58 +67,26 @@ namespace data
 	{
 	}
 
-	size_t Dictionary::get(const std::string value) const
+	size_t Dictionary::get(const std::string &value) const
 	{
-		std::string bytes = _bytestream.str();
-		const char *bytebegin = bytes.c_str();
-		const char *bytepos = bytebegin;
-		const char *byteend = bytebegin + bytes.length() + 1;
-
-		if (bytes.length() <= 0) return std::string::npos;
-
-		while (bytepos < byteend)
-		{
-			std::string dictstr(bytepos);
-
-			if (dictstr == value)
-			{
-				return bytepos - bytebegin;
-			}
-
-			bytepos += dictstr.length() + 1;
-		}
-
-		return std::string::npos;
+		index();
+		std::map<std::string, size_t>::const_iterator iter = _offsets.find(value);
+		if (iter == _offsets.end()) return std::string::npos;
+		return (*iter).second;
 	}
 
-	bool Dictionary::exists(const std::string value) const
+	bool Dictionary::exists(const std::string &value) const
 	{
-		std::string bytes = _bytestream.str();
-		const char *bytepos = bytes.c_str();
-		const char *byteend = bytepos + bytes.length();
-
-		if (bytes.length() <= 0) return false;
-
-		while (bytepos < byteend)
-		{
-			std::string dictstr(bytepos);
-
-			if (dictstr == value)
-			{
-				return true;
-			}
-
-			bytepos += dictstr.length() + 1;
-		}
-
-		return false;
+		index();
+		return (_offsets.find(value) != _offsets.end());
 	}
 
-	void Dictionary::add(const std::string value)
+	void Dictionary::add(const std::string &value)
 	{
 		if (!exists(value))
 		{
-			_bytestream << value << '\0';
+			_offsets[value] = _bytes.size();
+			_bytes.append(value.c_str(), value.size() + 1);
 		}
 	}
 
@@ -136,43 +107,65 @@ namespace data
 		}
 	}
 
-	EID Dictionary::get(size_t scheme, size_t ssp)
+	std::string Dictionary::getString(size_t offset) const
+	{
+		if (offset >= _bytes.size()) return std::string();
+
+		// the bytearray is always null-terminated by c_str()
+		return std::string(_bytes.c_str() + offset);
+	}
+
+	EID Dictionary::get(size_t scheme, size_t ssp) const
+	{
+		return EID(getString(scheme), getString(ssp));
+	}
+
+	void Dictionary::load(const char *data, const size_t length)
 	{
-		char buffer[1024];
+		_bytes.assign(data, length);
+		_offsets.clear();
 
-		_bytestream.seekg(scheme);
-		_bytestream.get(buffer, 1024, '\0');
-		string scheme_str(buffer);
+		// a received dictionary is mostly used to look up strings by their offset
+		_indexed = false;
+	}
 
-		_bytestream.seekg(ssp);
-		_bytestream.get(buffer, 1024, '\0');
-		string ssp_str(buffer);
+	void Dictionary::index() const
+	{
+		if (_indexed) return;
+		_indexed = true;
 
-		return EID(scheme_str, ssp_str);
+		// index all strings, the first occurrence of a string wins
+		size_t offset = 0;
+		while (offset < _bytes.size())
+		{
+			const std::string value = getString(offset);
+			if (_offsets.find(value) == _offsets.end()) _offsets[value] = offset;
+			offset += value.size() + 1;
+		}
 	}
 
 	void Dictionary::clear()
 	{
-		_bytestream.str("");
+		_bytes.clear();
+		_offsets.clear();
+		_indexed = true;
 	}
 
 	size_t Dictionary::getSize() const
 	{
-		return _bytestream.str().length();
+		return _bytes.size();
 	}
 
 	pair<size_t, size_t> Dictionary::getRef(const EID &eid) const
 	{
-		const string scheme = eid.getScheme();
-		const string ssp = eid.getSSP();
-		return make_pair(get(scheme), get(ssp));
+		return make_pair(get(eid.getScheme()), get(eid.getSSP()));
 	}
 
 	std::ostream &operator<<(std::ostream &stream, const dtn::data::Dictionary &obj)
 	{
 		dtn::data::SDNV length(obj.getSize());
 		stream << length;
-		stream << obj._bytestream.rdbuf();
+		stream.write(obj._bytes.data(), obj._bytes.size());
 
 		return stream;
 	}
@@ -186,10 +179,9 @@ namespace data
 		if (length.getValue() <= 0)
 			throw dtn::InvalidDataException("Dictionary size is zero!");
 
-		obj._bytestream.str("");
-		char data[length.getValue()];
-		stream.read(data, length.getValue());
-		obj._bytestream.write(data, length.getValue());
+		std::string data(length.getValue(), '\0');
+		stream.read(&data[0], data.size());
+		obj.load(data.data(), stream.gcount());
 
 		return stream;
 	}
@@ -12,8 +12,9 @@
 
 #include "ibrdtn/data/EID.h"
 #include <list>
+#include <map>
 #include <sstream>
-#include <list>
+#include <string>
 
 using namespace std;
 
@@ -23,6 +24,11 @@ namespace dtn
 	{
 		class Bundle;
 
+		/**
+		 * The dictionary is kept as contiguous byte array. The offset of each
+		 * string in the array is indexed, thus the references of an EID are
+		 * looked up without scanning the array.
+		 */
 		class Dictionary
 		{
 		public:
@@ -64,7 +70,12 @@ namespace dtn
 			/**
 			 * return the eid for the reference [scheme,ssp]
 			 */
-			EID get(size_t scheme, size_t ssp);
+			EID get(size_t scheme, size_t ssp) const;
+
+			/**
+			 * replace the content of the dictionary with the given bytearray
+			 */
+			void load(const char *data, const size_t length);
 
 			/**
 			 * clear the dictionary
@@ -85,11 +96,26 @@ namespace dtn
 			friend std::istream &operator>>(std::istream &stream, dtn::data::Dictionary &obj);
 
 		private:
-			bool exists(const std::string) const;
-			void add(const std::string);
-			size_t get(const std::string) const;
+			bool exists(const std::string &value) const;
+			void add(const std::string &value);
+			size_t get(const std::string &value) const;
+
+			/**
+			 * returns the string at the given offset of the bytearray
+			 */
+			std::string getString(size_t offset) const;
+
+			/**
+			 * build the index of a loaded bytearray
+			 */
+			void index() const;
+
+			// the bytearray of null-terminated strings
+			std::string _bytes;
 
-			stringstream _bytestream;
+			// offset of each string in the bytearray, built on first use after load()
+			mutable std::map<std::string, size_t> _offsets;
+			mutable bool _indexed;
 		};
 	}
 }
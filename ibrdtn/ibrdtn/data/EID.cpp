@@ -191,12 +191,12 @@ namespace dtn
 			return _ssp.substr(0, application_start);
 		}
 
-		std::string EID::getScheme() const
+		const std::string& EID::getScheme() const
 		{
 			return _scheme;
 		}
 
-		std::string EID::getSSP() const
+		const std::string& EID::getSSP() const
 		{
 			return _ssp;
 		}
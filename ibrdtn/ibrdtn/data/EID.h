@@ -55,8 +55,8 @@ namespace dtn
 			string getString() const;
 			string getApplication() const throw (ibrcommon::Exception);
 			string getHost() const throw (ibrcommon::Exception);
-			string getScheme() const;
-			string getSSP() const;
+			const std::string& getScheme() const;
+			const std::string& getSSP() const;
 
 			EID getNode() const throw (ibrcommon::Exception);
 
@@ -22,6 +22,7 @@ using namespace std;
 #include "ibrdtn/data/Exceptions.h"
 #include <cstdlib>
 #include <cstring>
+#include <cstddef>
 
 namespace dtn
 {
@@ -107,13 +108,79 @@ namespace dtn
 			return (_value & value);
 		}
 
+		char* SDNV::write(char *data, const u_int64_t value)
+		{
+			// fast path for values of one or two bytes
+			if (value < 0x80)
+			{
+				data[0] = (char)value;
+				return data + 1;
+			}
+
+			if (value < 0x4000)
+			{
+				data[0] = (char)(0x80 | (value >> 7));
+				data[1] = (char)(value & 0x7f);
+				return data + 2;
+			}
+
+			// fill the buffer backwards, the last octet has no high bit
+			const size_t val_len = encoding_len(value);
+			u_char *bp = (u_char*)data + val_len - 1;
+			u_int64_t val = value;
+
+			*bp = (u_char)(val & 0x7f);
+			while (bp != (u_char*)data)
+			{
+				val >>= 7;
+				*(--bp) = (u_char)(0x80 | (val & 0x7f));
+			}
+
+			return data + val_len;
+		}
+
+		const char* SDNV::read(const char *data, const char *end, u_int64_t &value)
+		{
+			const u_char *bp = (const u_char*)data;
+			const u_char *bend = (const u_char*)end;
+
+			// fast path for values of one byte
+			if ((bp < bend) && !(*bp & 0x80))
+			{
+				value = *bp;
+				return data + 1;
+			}
+
+			// do not read more than the maximum length of a SDNV
+			if (bend - bp > (ptrdiff_t)MAX_LENGTH) bend = bp + MAX_LENGTH;
+
+			u_int64_t val = 0;
+			for (const u_char *p = bp; p < bend; p++)
+			{
+				val = (val << 7) | (*p & 0x7f);
+
+				if (!(*p & 0x80))
+				{
+					// the only valid SDNV of maximum length stores one bit in the first byte
+					if (((p - bp + 1) == (ptrdiff_t)MAX_LENGTH) && (*bp != 0x81))
+					{
+						throw InvalidDataException("ERROR(SDNV): overflow value in sdnv");
+					}
+
+					value = val;
+					return (const char*)(p + 1);
+				}
+			}
+
+			if ((bend - bp) == (ptrdiff_t)MAX_LENGTH) throw InvalidDataException("ERROR(SDNV): overflow value in sdnv");
+			throw InvalidDataException("ERROR(SDNV): buffer too short");
+		}
+
 		std::ostream &operator<<(std::ostream &stream, const dtn::data::SDNV &obj)
 		{
-			size_t len = obj.getLength();
-			char* data = (char*)calloc(len, sizeof(char));
-			obj.encode(data, len);
-			stream.write(data, len);
-			free(data);
+			char data[dtn::data::SDNV::MAX_LENGTH];
+			const char *end = dtn::data::SDNV::write(data, obj._value);
+			stream.write(data, end - data);
 
 			return stream;
 		}
@@ -121,20 +188,26 @@ namespace dtn
 		std::istream &operator>>(std::istream &stream, dtn::data::SDNV &obj)
 		{
 			char sdnv[dtn::data::SDNV::MAX_LENGTH];
-			char *sdnv_buf = sdnv;
 			size_t sdnv_length = 0;
+			std::streambuf *buf = stream.rdbuf();
 
-			stream.read(sdnv_buf, sizeof(char));
-			sdnv_length++;
-
-			while ( *sdnv_buf & 0x80)
+			// take the bytes directly from the buffer of the stream
+			while (sdnv_length < dtn::data::SDNV::MAX_LENGTH)
 			{
-				sdnv_buf++;
-				stream.read(sdnv_buf, sizeof(char));
-				sdnv_length++;
+				const std::streambuf::int_type c = (buf == NULL) ? std::streambuf::traits_type::eof() : buf->sbumpc();
+
+				if (std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()))
+				{
+					stream.setstate(std::ios::eofbit | std::ios::failbit);
+					obj._value = 0;
+					return stream;
+				}
+
+				sdnv[sdnv_length++] = std::streambuf::traits_type::to_char_type(c);
+				if (!(sdnv[sdnv_length - 1] & 0x80)) break;
 			}
 
-			dtn::data::SDNV::decode(sdnv, sdnv_length, &obj._value);
+			dtn::data::SDNV::read(sdnv, sdnv + sdnv_length, obj._value);
 
 			return stream;
 		}
@@ -158,37 +231,12 @@ namespace dtn
 		* @return The number of bytes used, or -1 on ERROR(SDNV).
 		*/
 		int SDNV::encode(u_int64_t val, u_char* bp, size_t len){
-		  u_char* start = bp;
-
-		  //Figure out how many bytes we need for the encoding.
-		  size_t val_len = 0;
-		  u_int64_t tmp = val;
-
-		  do {
-			tmp = tmp >> 7;
-			val_len++;
-		  } while (tmp != 0);
-
-		  if (!(val_len > 0)) throw InvalidDataException("ERROR(SDNV): !(val_len > 0)");
-		  if (!(val_len <= MAX_LENGTH)) throw InvalidDataException("ERROR(SDNV): !(val_len <= MAX_LENGTH)");
 		  // Make sure we have enough buffer space.
-		  if (len < val_len) {
+		  if (len < encoding_len(val)) {
 			return -1;
 		  }
 
-		  // Now advance bp to the last byte and fill it in backwards with the value bytes.
-		  bp += val_len;
-		  u_char high_bit = 0; // for the last octet
-		  do {
-			--bp;
-			*bp = (u_char)(high_bit | (val & 0x7f));
-			high_bit = (1 << 7); // for all but the last octet
-			val = val >> 7;
-		  } while (val != 0);
-
-		  if (!(bp == start)) throw InvalidDataException("ERROR(SDNV): !(bp == start)");
-
-		  return val_len;
+		  return write((char*)bp, val) - (char*)bp;
 		}
 
 
@@ -196,10 +244,9 @@ namespace dtn
 		* Return the number of bytes needed to encode the given value.
 		*/
 		size_t SDNV::encoding_len(u_int64_t val){
-		  u_char buf[16];
-		  int ret = encode(val, buf, sizeof(buf));
-		  if (!(ret != -1 && ret != 0)) throw InvalidDataException("ERROR(SDNV): !(ret != -1 && ret != 0)");
-		  return ret;
+		  // each byte holds seven bits of the value
+		  const size_t bits = 64 - __builtin_clzll(val | 1);
+		  return (bits + 6) / 7;
 		}
 
 		/**
@@ -220,43 +267,24 @@ namespace dtn
 		* @return The number of bytes of bp consumed, or -1 on ERROR(SDNV).
 		*/
 		int SDNV::decode(const u_char* bp, size_t len, u_int64_t* val){
-		  const u_char* start = bp;
-
 		  if (!val) {
 			throw InvalidDataException();
 		  }
 
 		  // Zero out the existing value, then shift in the bytes of the
 		  // encoding one by one until we hit a byte that has a zero high-order bit.
-		  size_t val_len = 0;
 		  *val = 0;
-		  do {
-			if (len == 0)
-			  return -1; // buffer too short
-
-			*val = (*val << 7) | (*bp & 0x7f);
-			++val_len;
-
-			if ((*bp & (1 << 7)) == 0)
-			  break; // all done;
-
-			++bp;
-			--len;
-		  } while (1);
 
+		  // the buffer is too short if it does not contain the last octet
+		  const u_char *p = bp;
+		  const u_char *end = bp + ((len > MAX_LENGTH) ? MAX_LENGTH : len);
+		  while ((p < end) && (*p & 0x80)) p++;
+		  if ((p == end) && (len <= MAX_LENGTH)) return -1;
 
 		  // Since the spec allows for infinite length values but this
-		  // implementation only handles up to 64 bits, check for overflow.
-		  // Note that the only supportable 10 byte SDNV must store exactly
-		  // one bit in the first byte of the encoding (i.e. the 64'th bit
-		  // of the original value).
-		  // This is OK because a spec update says that behavior
-		  // is undefined for values > 64 bits.
-		  if ((val_len > MAX_LENGTH) || ((val_len == MAX_LENGTH) && (*start != 0x81))){
-			throw InvalidDataException("ERROR(SDNV): overflow value in sdnv");
-		  }
-
-		  return val_len;
+		  // implementation only handles up to 64 bits, read() checks for overflow.
+		  const char *ret = read((const char*)bp, (const char*)bp + len, *val);
+		  return ret - (const char*)bp;
 		}
 
 		/**
@@ -96,6 +96,25 @@ namespace dtn
 			 */
 			size_t encode(char *data, const size_t len) const;
 
+			/**
+			 * Encode a value into a contiguous buffer. There are no bounds checks,
+			 * the buffer needs space for at least MAX_LENGTH bytes.
+			 * @param data The position to write to.
+			 * @param value The value to encode.
+			 * @return The position behind the written data.
+			 */
+			static char* write(char *data, const u_int64_t value);
+
+			/**
+			 * Decode a value from a contiguous buffer.
+			 * @param data The position to read from.
+			 * @param end The end of the buffer.
+			 * @param value Is set to the decoded value.
+			 * @return The position behind the read data.
+			 * @throw InvalidDataException if the buffer ends within the SDNV or the value overflows.
+			 */
+			static const char* read(const char *data, const char *end, u_int64_t &value);
+
 			size_t operator=(const size_t &value);
 
 			bool operator==(const SDNV &value) const;
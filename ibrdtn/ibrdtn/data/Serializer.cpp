@@ -11,6 +11,7 @@
 #include <ibrcommon/refcnt_ptr.h>
 #include <ibrcommon/Logger.h>
 #include <list>
+#include <vector>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 #include <cassert>
@@ -20,6 +21,47 @@ namespace dtn
 {
 	namespace data
 	{
+		/**
+		 * Collects the fields of a block header in a buffer on the stack,
+		 * thus the header is written to the stream with a single call.
+		 */
+		class HeaderBuffer
+		{
+		public:
+			HeaderBuffer(std::ostream &stream)
+			 : _stream(stream), _pos(_data)
+			{ };
+
+			void put(const char c)
+			{
+				reserve(1);
+				*(_pos++) = c;
+			};
+
+			void sdnv(const u_int64_t value)
+			{
+				reserve(SDNV::MAX_LENGTH);
+				_pos = SDNV::write(_pos, value);
+			};
+
+			void flush()
+			{
+				if (_pos == _data) return;
+				_stream.write(_data, _pos - _data);
+				_pos = _data;
+			};
+
+		private:
+			void reserve(const size_t length)
+			{
+				if ((_pos + length) > (_data + sizeof(_data))) flush();
+			};
+
+			std::ostream &_stream;
+			char _data[256];
+			char *_pos;
+		};
+
 		DefaultSerializer::DefaultSerializer(std::ostream& stream)
 		 : _stream(stream), _compressable(false)
 		{
@@ -32,23 +74,8 @@ namespace dtn
 
 		void DefaultSerializer::rebuildDictionary(const dtn::data::Bundle &obj)
 		{
-			// clear the dictionary
-			_dictionary.clear();
-
-			// rebuild the dictionary
-			_dictionary.add(obj._destination);
-			_dictionary.add(obj._source);
-			_dictionary.add(obj._reportto);
-			_dictionary.add(obj._custodian);
-
-			// add EID of all secondary blocks
-			std::list<refcnt_ptr<Block> > list = obj._blocks._blocks;
-
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
-			{
-				const Block &b = (*(*iter));
-				_dictionary.add( b.getEIDList() );
-			}
+			// the bundle keeps the dictionary until one of its EIDs is changed
+			_dictionary = obj.getDictionary();
 		}
 
 		Serializer& DefaultSerializer::operator <<(const dtn::data::Bundle& obj)
@@ -63,9 +90,9 @@ namespace dtn
 			(*this) << (PrimaryBlock&)obj;
 
 			// serialize all secondary blocks
-			std::list<refcnt_ptr<Block> > list = obj._blocks._blocks;
+			const std::vector<refcnt_ptr<Block> > &list = obj._blocks.getVector();
 			
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
 			{
 				const Block &b = (*(*iter));
 				(*this) << b;
@@ -95,10 +122,10 @@ namespace dtn
 			(*this) << prim;
 
 			// serialize all secondary blocks
-			std::list<refcnt_ptr<Block> > list = obj._bundle._blocks._blocks;
+			const std::vector<refcnt_ptr<Block> > &list = obj._bundle._blocks.getVector();
 			bool post_payload = false;
 
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
 			{
 				const Block &b = (*(*iter));
 
@@ -127,119 +154,88 @@ namespace dtn
 
 		bool DefaultSerializer::isCompressable(const dtn::data::Bundle &obj) const
 		{
-			// check if all EID are compressable
-			bool compressable = ( obj._source.isCompressable() &&
-					obj._destination.isCompressable() &&
-					obj._reportto.isCompressable() &&
-					obj._custodian.isCompressable() );
-
-			if (compressable)
-			{
-				// add EID of all secondary blocks
-				std::list<refcnt_ptr<Block> > list = obj._blocks._blocks;
-
-				for (std::list<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
-				{
-					const Block &b = (*(*iter));
-					const std::list<dtn::data::EID> eids = b.getEIDList();
-
-					for (std::list<dtn::data::EID>::const_iterator eit = eids.begin(); eit != eids.end(); eit++)
-					{
-						const dtn::data::EID &eid = (*eit);
-						if (!eid.isCompressable())
-						{
-							return false;
-						}
-					}
-				}
-			}
-
-			return compressable;
+			// check if all EID are compressable, the result is cached by the bundle
+			return obj.isCompressable();
 		}
 
 		Serializer& DefaultSerializer::operator <<(const dtn::data::PrimaryBlock& obj)
 		{
-			_stream << dtn::data::BUNDLE_VERSION;		// bundle version
-			_stream << dtn::data::SDNV(obj._procflags);	// processing flags
-
-			// predict the block length
-			size_t len = 0;
-			dtn::data::SDNV primaryheader[14];
-
-			primaryheader[8] = SDNV(obj._timestamp);		// timestamp
-			primaryheader[9] = SDNV(obj._sequencenumber);	// sequence number
-			primaryheader[10] = SDNV(obj._lifetime);		// lifetime
-
+			// values of the primary header
+			u_int64_t primaryheader[14];
 			pair<size_t, size_t> ref;
+			size_t dictsize = 0;
 
 			if (_compressable)
 			{
 				// destination reference
 				ref = obj._destination.getCompressed();
-				primaryheader[0] = SDNV(ref.first);
-				primaryheader[1] = SDNV(ref.second);
+				primaryheader[0] = ref.first;
+				primaryheader[1] = ref.second;
 
 				// source reference
 				ref = obj._source.getCompressed();
-				primaryheader[2] = SDNV(ref.first);
-				primaryheader[3] = SDNV(ref.second);
+				primaryheader[2] = ref.first;
+				primaryheader[3] = ref.second;
 
 				// reportto reference
 				ref = obj._reportto.getCompressed();
-				primaryheader[4] = SDNV(ref.first);
-				primaryheader[5] = SDNV(ref.second);
+				primaryheader[4] = ref.first;
+				primaryheader[5] = ref.second;
 
 				// custodian reference
 				ref = obj._custodian.getCompressed();
-				primaryheader[6] = SDNV(ref.first);
-				primaryheader[7] = SDNV(ref.second);
-
-				// dictionary size is zero in a compressed bundle header
-				primaryheader[11] = SDNV(0);
+				primaryheader[6] = ref.first;
+				primaryheader[7] = ref.second;
 			}
 			else
 			{
 				// destination reference
 				ref = _dictionary.getRef(obj._destination);
-				primaryheader[0] = SDNV(ref.first);
-				primaryheader[1] = SDNV(ref.second);
+				primaryheader[0] = ref.first;
+				primaryheader[1] = ref.second;
 
 				// source reference
 				ref = _dictionary.getRef(obj._source);
-				primaryheader[2] = SDNV(ref.first);
-				primaryheader[3] = SDNV(ref.second);
+				primaryheader[2] = ref.first;
+				primaryheader[3] = ref.second;
 
 				// reportto reference
 				ref = _dictionary.getRef(obj._reportto);
-				primaryheader[4] = SDNV(ref.first);
-				primaryheader[5] = SDNV(ref.second);
+				primaryheader[4] = ref.first;
+				primaryheader[5] = ref.second;
 
 				// custodian reference
 				ref = _dictionary.getRef(obj._custodian);
-				primaryheader[6] = SDNV(ref.first);
-				primaryheader[7] = SDNV(ref.second);
+				primaryheader[6] = ref.first;
+				primaryheader[7] = ref.second;
 
-				// dictionary size
-				primaryheader[11] = SDNV(_dictionary.getSize());
-				len += _dictionary.getSize();
+				dictsize = _dictionary.getSize();
 			}
 
-			for (int i = 0; i < 12; i++)
-			{
-				len += primaryheader[i].getLength();
-			}
+			primaryheader[8] = obj._timestamp;		// timestamp
+			primaryheader[9] = obj._sequencenumber;	// sequence number
+			primaryheader[10] = obj._lifetime;		// lifetime
 
-			if (obj.get(dtn::data::Bundle::FRAGMENT))
-			{
-				primaryheader[12] = SDNV(obj._fragmentoffset);
-				primaryheader[13] = SDNV(obj._appdatalength);
+			// dictionary size is zero in a compressed bundle header
+			primaryheader[11] = dictsize;
 
-				len += primaryheader[12].getLength();
-				len += primaryheader[13].getLength();
+			primaryheader[12] = obj._fragmentoffset;	// FRAGMENTATION_OFFSET
+			primaryheader[13] = obj._appdatalength;	// APPLICATION_DATA_LENGTH
+
+			const int fields = obj.get(dtn::data::Bundle::FRAGMENT) ? 14 : 12;
+
+			// predict the block length
+			size_t len = dictsize;
+			for (int i = 0; i < fields; i++)
+			{
+				len += SDNV::getLength(primaryheader[i]);
 			}
 
-			// write the block length
-			_stream << SDNV(len);
+			// collect the header in a buffer to write it at once
+			HeaderBuffer buf(_stream);
+			buf.put(dtn::data::BUNDLE_VERSION);		// bundle version
+			buf.sdnv(obj._procflags);				// processing flags
+			buf.sdnv(len);							// block length
 
 			/*
 			 * write the ref block of the dictionary
@@ -247,33 +243,37 @@ namespace dtn
 			 */
 			for (int i = 0; i < 11; i++)
 			{
-				_stream << primaryheader[i];
+				buf.sdnv(primaryheader[i]);
 			}
 
 			if (_compressable)
 			{
 				// write the size of the dictionary (always zero here)
-				_stream << primaryheader[11];
+				buf.sdnv(primaryheader[11]);
 			}
 			else
 			{
 				// write size of dictionary + bytearray
+				buf.flush();
 				_stream << _dictionary;
 			}
 
-			if (obj.get(dtn::data::Bundle::FRAGMENT))
+			for (int i = 12; i < fields; i++)
 			{
-				_stream << primaryheader[12]; // FRAGMENTATION_OFFSET
-				_stream << primaryheader[13]; // APPLICATION_DATA_LENGTH
+				buf.sdnv(primaryheader[i]);
 			}
-			
+
+			buf.flush();
+
 			return (*this);
 		}
 
 		Serializer& DefaultSerializer::operator <<(const dtn::data::Block& obj)
 		{
-			_stream << obj._blocktype;
-			_stream << dtn::data::SDNV(obj._procflags);
+			// collect the header in a buffer to write it at once
+			HeaderBuffer buf(_stream);
+			buf.put(obj._blocktype);
+			buf.sdnv(obj._procflags);
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 			// test: BLOCK_CONTAINS_EIDS => (_eids.size() > 0)
@@ -282,7 +282,7 @@ namespace dtn
 
 			if (obj.get(Block::BLOCK_CONTAINS_EIDS))
 			{
-				_stream << SDNV(obj._eids.size());
+				buf.sdnv(obj._eids.size());
 				for (std::list<dtn::data::EID>::const_iterator it = obj._eids.begin(); it != obj._eids.end(); it++)
 				{
 					pair<size_t, size_t> offsets;
@@ -296,13 +296,14 @@ namespace dtn
 						offsets = _dictionary.getRef(*it);
 					}
 
-					_stream << SDNV(offsets.first);
-					_stream << SDNV(offsets.second);
+					buf.sdnv(offsets.first);
+					buf.sdnv(offsets.second);
 				}
 			}
 
 			// write size of the payload in the block
-			_stream << SDNV(obj.getLength());
+			buf.sdnv(obj.getLength());
+			buf.flush();
 
 			// write the payload of the block
 			size_t slength = 0;
@@ -313,8 +314,10 @@ namespace dtn
 
 		Serializer& DefaultSerializer::serialize(const dtn::data::PayloadBlock& obj, size_t clip_offset, size_t clip_length)
 		{
-			_stream << obj._blocktype;
-			_stream << dtn::data::SDNV(obj._procflags);
+			// collect the header in a buffer to write it at once
+			HeaderBuffer buf(_stream);
+			buf.put(obj._blocktype);
+			buf.sdnv(obj._procflags);
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 			// test: BLOCK_CONTAINS_EIDS => (_eids.size() > 0)
@@ -323,7 +326,7 @@ namespace dtn
 
 			if (obj.get(Block::BLOCK_CONTAINS_EIDS))
 			{
-				_stream << SDNV(obj._eids.size());
+				buf.sdnv(obj._eids.size());
 				for (std::list<dtn::data::EID>::const_iterator it = obj._eids.begin(); it != obj._eids.end(); it++)
 				{
 					pair<size_t, size_t> offsets;
@@ -337,13 +340,14 @@ namespace dtn
 						offsets = _dictionary.getRef(*it);
 					}
 
-					_stream << SDNV(offsets.first);
-					_stream << SDNV(offsets.second);
+					buf.sdnv(offsets.first);
+					buf.sdnv(offsets.second);
 				}
 			}
 
 			// write size of the payload in the block
-			_stream << SDNV(clip_length);
+			buf.sdnv(clip_length);
+			buf.flush();
 
 			// now skip the <offset>-bytes and all bytes after <offset + length>
 			obj.serialize( _stream, clip_offset, clip_length );
@@ -356,13 +360,22 @@ namespace dtn
 			// rebuild the dictionary
 			rebuildDictionary(obj);
 
-			size_t len = 0;
-			len += getLength( (PrimaryBlock&)obj );
+			// check if the bundle header could be compressed
+			_compressable = isCompressable(obj);
+
+			// the length of the primary block is cached by the bundle
+			size_t len = obj.getPrimaryLength();
+
+			if (len == 0)
+			{
+				len = DefaultSerializer::getLength( (PrimaryBlock&)obj );
+				obj.setPrimaryLength(len);
+			}
 			
 			// add size of all blocks
-			std::list<refcnt_ptr<Block> > list = obj._blocks._blocks;
+			const std::vector<refcnt_ptr<Block> > &list = obj._blocks.getVector();
 
-			for (std::list<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
+			for (std::vector<refcnt_ptr<Block> >::const_iterator iter = list.begin(); iter != list.end(); iter++)
 			{
 				const Block &b = (*(*iter));
 				len += getLength( b );
@@ -496,8 +509,10 @@ namespace dtn
 				}
 			}
 
-			// size of the payload in the block
-			len += obj.getLength();
+			// size of the payload in the block and its length field
+			const size_t length = obj.getLength();
+			len += dtn::data::SDNV(length).getLength();
+			len += length;
 
 			return len;
 		}
@@ -680,53 +695,82 @@ namespace dtn
 			// BLOCK LENGTH
 			_stream >> blocklength;
 
+			// do not allocate memory for a length announced by a broken or malicious peer
+			if (blocklength.getValue() > MAX_PRIMARY_BLOCK_LENGTH) throw dtn::InvalidDataException("primary block is too large");
+
+			// read the whole block at once and decode it from memory
+			const size_t length = blocklength.getValue();
+			char stackbuf[256];
+			std::vector<char> heapbuf;
+			char *data = stackbuf;
+
+			if (length > sizeof(stackbuf))
+			{
+				heapbuf.resize(length);
+				data = &heapbuf[0];
+			}
+
+			_stream.read(data, length);
+			if ((size_t)_stream.gcount() != length) throw dtn::InvalidDataException("primary block is incomplete");
+
+			const char *pos = data;
+			const char *end = data + length;
+
 			// EID References
-			pair<SDNV, SDNV> ref[4];
-			for (int i = 0; i < 4; i++)
+			u_int64_t ref[8];
+			for (int i = 0; i < 8; i++)
 			{
-				_stream >> ref[i].first;
-				_stream >> ref[i].second;
+				pos = SDNV::read(pos, end, ref[i]);
 			}
 
+			u_int64_t value = 0;
+
 			// timestamp
-			_stream >> tmpsdnv;
-			obj._timestamp = tmpsdnv.getValue();
+			pos = SDNV::read(pos, end, value);
+			obj._timestamp = value;
 
 			// sequence number
-			_stream >> tmpsdnv;
-			obj._sequencenumber = tmpsdnv.getValue();
+			pos = SDNV::read(pos, end, value);
+			obj._sequencenumber = value;
 
 			// lifetime
-			_stream >> tmpsdnv;
-			obj._lifetime = tmpsdnv.getValue();
+			pos = SDNV::read(pos, end, value);
+			obj._lifetime = value;
+
+			// dictionary
+			pos = SDNV::read(pos, end, value);
 
-			try {
-				// dictionary
-				_stream >> _dictionary;
+			if (value > 0)
+			{
+				if (value > (u_int64_t)(end - pos)) throw dtn::InvalidDataException("dictionary exceeds the primary block");
+				_dictionary.load(pos, value);
+				pos += value;
 
 				// decode EIDs
-				obj._destination = _dictionary.get(ref[0].first.getValue(), ref[0].second.getValue());
-				obj._source = _dictionary.get(ref[1].first.getValue(), ref[1].second.getValue());
-				obj._reportto = _dictionary.get(ref[2].first.getValue(), ref[2].second.getValue());
-				obj._custodian = _dictionary.get(ref[3].first.getValue(), ref[3].second.getValue());
+				obj._destination = _dictionary.get(ref[0], ref[1]);
+				obj._source = _dictionary.get(ref[2], ref[3]);
+				obj._reportto = _dictionary.get(ref[4], ref[5]);
+				obj._custodian = _dictionary.get(ref[6], ref[7]);
 				_compressed = false;
-			} catch (const dtn::InvalidDataException&) {
-				// error while reading the dictionary. We assume that this is a compressed bundle header.
-				obj._destination = dtn::data::EID(ref[0].first.getValue(), ref[0].second.getValue());
-				obj._source = dtn::data::EID(ref[1].first.getValue(), ref[1].second.getValue());
-				obj._reportto = dtn::data::EID(ref[2].first.getValue(), ref[2].second.getValue());
-				obj._custodian = dtn::data::EID(ref[3].first.getValue(), ref[3].second.getValue());
+			}
+			else
+			{
+				// a dictionary size of zero indicates a compressed bundle header
+				obj._destination = dtn::data::EID(ref[0], ref[1]);
+				obj._source = dtn::data::EID(ref[2], ref[3]);
+				obj._reportto = dtn::data::EID(ref[4], ref[5]);
+				obj._custodian = dtn::data::EID(ref[6], ref[7]);
 				_compressed = true;
 			}
 
 			// fragmentation?
 			if (obj.get(dtn::data::Bundle::FRAGMENT))
 			{
-				_stream >> tmpsdnv;
-				obj._fragmentoffset = tmpsdnv.getValue();
+				pos = SDNV::read(pos, end, value);
+				obj._fragmentoffset = value;
 
-				_stream >> tmpsdnv;
-				obj._appdatalength = tmpsdnv.getValue();
+				pos = SDNV::read(pos, end, value);
+				obj._appdatalength = value;
 			}
 			
 			// validate this primary block
@@ -863,8 +907,10 @@ namespace dtn
 				}
 			}
 
-			// size of the payload in the block
-			len += obj.getLength();
+			// size of the payload in the block and its length field
+			const size_t length = obj.getLength();
+			len += dtn::data::SDNV(length).getLength();
+			len += length;
 
 			return len;
 		}
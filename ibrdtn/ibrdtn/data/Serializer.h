@@ -160,6 +160,13 @@ namespace dtn
 			virtual Deserializer &operator>>(dtn::data::Block &obj);
 			virtual Deserializer &operator>>(dtn::data::MetaBundle &obj);
 
+			/**
+			 * Maximum length of a primary block accepted by the deserializer.
+			 * The length is announced by the peer, thus it is checked before
+			 * any memory is allocated.
+			 */
+			static const size_t MAX_PRIMARY_BLOCK_LENGTH = 65536;
+
 		protected:
 			std::istream &_stream;
 			Validator &_validator;
@@ -0,0 +1,380 @@
+#include "ibrdtn/security/ChunkedPayloadCipher.h"
+
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Exceptions.h>
+#include <openssl/rand.h>
+#include <string.h>
+#include <unistd.h>
+#include <deque>
+
+namespace dtn
+{
+	namespace security
+	{
+		ChunkedPayloadCipher::Chunk::Chunk(const size_t i, const std::streamoff o, const size_t length, const bool l)
+		 : index(i), offset(o), last(l), data(length), queued(false), done(false), valid(true)
+		{
+			::memset(tag, 0, tag_len);
+		}
+
+		ChunkedPayloadCipher::Pool::Job::Job()
+		 : cipher(NULL), chunk(NULL)
+		{
+		}
+
+		ChunkedPayloadCipher::Pool::Job::Job(const ChunkedPayloadCipher &c, Chunk *ch)
+		 : cipher(&c), chunk(ch)
+		{
+		}
+
+		ChunkedPayloadCipher::Pool::Worker::Worker(Pool &pool)
+		 : _pool(pool)
+		{
+		}
+
+		ChunkedPayloadCipher::Pool::Worker::~Worker()
+		{
+			join();
+		}
+
+		bool ChunkedPayloadCipher::Pool::Worker::__cancellation()
+		{
+			ibrcommon::MutexLock l(_pool._cond);
+			_pool._running = false;
+			_pool._cond.signal(true);
+			return true;
+		}
+
+		void ChunkedPayloadCipher::Pool::Worker::run()
+		{
+			Job job;
+
+			while (_pool.next(job))
+			{
+				job.cipher->transform(*job.chunk);
+
+				ibrcommon::MutexLock l(_pool._cond);
+				job.chunk->done = true;
+				_pool._cond.signal(true);
+			}
+		}
+
+		ChunkedPayloadCipher::Pool::Pool()
+		 : _running(true)
+		{
+		}
+
+		ChunkedPayloadCipher::Pool::~Pool()
+		{
+			{
+				ibrcommon::MutexLock l(_cond);
+				_running = false;
+				_cond.signal(true);
+			}
+
+			for (std::list<Worker*>::iterator iter = _workers.begin(); iter != _workers.end(); iter++)
+			{
+				delete (*iter);
+			}
+		}
+
+		ChunkedPayloadCipher::Pool& ChunkedPayloadCipher::Pool::getInstance()
+		{
+			static Pool instance;
+			return instance;
+		}
+
+		void ChunkedPayloadCipher::Pool::reserve(const size_t threads)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			const size_t limit = (threads < MAX_THREADS) ? threads : MAX_THREADS;
+
+			while (_running && (_workers.size() < limit))
+			{
+				Worker *w = new Worker(*this);
+				_workers.push_back(w);
+				w->start();
+			}
+		}
+
+		void ChunkedPayloadCipher::Pool::push(const ChunkedPayloadCipher &cipher, Chunk *chunk)
+		{
+			ibrcommon::MutexLock l(_cond);
+			chunk->queued = true;
+			_jobs.push_back(Job(cipher, chunk));
+			_cond.signal(true);
+		}
+
+		void ChunkedPayloadCipher::Pool::wait(const Chunk &chunk)
+		{
+			ibrcommon::MutexLock l(_cond);
+			while (!chunk.done) _cond.wait();
+		}
+
+		void ChunkedPayloadCipher::Pool::cancel(const ChunkedPayloadCipher &cipher)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			std::deque<Job>::iterator iter = _jobs.begin();
+			while (iter != _jobs.end())
+			{
+				if ((*iter).cipher == &cipher)
+				{
+					(*iter).chunk->valid = false;
+					(*iter).chunk->done = true;
+					iter = _jobs.erase(iter);
+				}
+				else
+				{
+					iter++;
+				}
+			}
+		}
+
+		bool ChunkedPayloadCipher::Pool::next(Job &job)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			while (_running && _jobs.empty())
+			{
+				_cond.wait();
+			}
+
+			if (!_running) return false;
+
+			job = _jobs.front();
+			_jobs.pop_front();
+			return true;
+		}
+
+		ChunkedPayloadCipher::ChunkedPayloadCipher(const PayloadCipher::Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt,
+				const size_t chunk_size, const size_t threads)
+		 : _mode(mode), _salt(salt), _chunk_size(chunk_size), _threads(threads), _length(0), _valid(false)
+		{
+			// create a random IV
+			if (!RAND_bytes(_iv, iv_len))
+			{
+				throw ibrcommon::Exception("failed to create a random IV");
+			}
+
+			::memcpy(_key, key, key_size_in_bytes);
+		}
+
+		ChunkedPayloadCipher::ChunkedPayloadCipher(const PayloadCipher::Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt,
+				const unsigned char iv[iv_len], const size_t chunk_size, const size_t threads, const std::string &tags)
+		 : _mode(mode), _salt(salt), _chunk_size(chunk_size), _threads(threads), _tags(tags), _length(0), _valid(false)
+		{
+			::memcpy(_iv, iv, iv_len);
+			::memcpy(_key, key, key_size_in_bytes);
+		}
+
+		ChunkedPayloadCipher::~ChunkedPayloadCipher()
+		{
+			// do not leave the key in memory
+			::memset(_key, 0, key_size_in_bytes);
+		}
+
+		size_t ChunkedPayloadCipher::getChunks(const size_t length, const size_t chunk_size)
+		{
+			// an empty payload is one empty chunk, thus there is always a tag to verify
+			if (length == 0) return 1;
+			return (length + chunk_size - 1) / chunk_size;
+		}
+
+		void ChunkedPayloadCipher::process(std::iostream &stream, std::ostream *ciphertext)
+		{
+			if ((_chunk_size < MIN_CHUNK_SIZE) || (_chunk_size > MAX_CHUNK_SIZE)) throw ibrcommon::Exception("invalid chunk size");
+
+			stream.clear();
+			stream.seekg(0, std::ios::end);
+			const std::streamoff size = stream.tellg();
+			const size_t chunks = getChunks((size_t)size, _chunk_size);
+
+			if (_mode == PayloadCipher::CIPHER_ENCRYPT)
+			{
+				_tags.clear();
+				_valid = true;
+			}
+			else
+			{
+				// a missing or an additional tag means a modified payload
+				_valid = (_tags.size() == (chunks * tag_len));
+			}
+
+			if (_threads == 0)
+			{
+				const long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+				_threads = (cpus > 0) ? (size_t)cpus : 1;
+			}
+
+			// a single chunk is processed without the pool
+			const size_t workers = (_threads < chunks) ? _threads : chunks;
+			const bool pooled = (workers > 1);
+
+			// limit the number of chunks in memory, the workers never run dry while the
+			// oldest chunk is written back
+			const size_t window = pooled ? (2 * workers) : 1;
+
+			Pool &pool = Pool::getInstance();
+			if (pooled) pool.reserve(workers);
+
+			std::deque<Chunk*> inflight;
+
+			try {
+				size_t index = 0;
+				while ((index < chunks) || !inflight.empty())
+				{
+					// read ahead until the window is full
+					while ((index < chunks) && (inflight.size() < window))
+					{
+						const std::streamoff offset = (std::streamoff)index * _chunk_size;
+						const size_t len = ((size - offset) < (std::streamoff)_chunk_size) ? (size_t)(size - offset) : _chunk_size;
+
+						Chunk *chunk = new Chunk(index, offset, len, (index + 1) == chunks);
+						inflight.push_back(chunk);
+
+						if (len > 0)
+						{
+							stream.seekg(offset, std::ios::beg);
+							stream.read(&chunk->data[0], len);
+							if ((size_t)stream.gcount() != len) throw ibrcommon::IOException("read of the payload failed");
+						}
+
+						if (_mode == PayloadCipher::CIPHER_DECRYPT)
+						{
+							if (_tags.size() >= ((index + 1) * tag_len))
+							{
+								::memcpy(chunk->tag, _tags.data() + (index * tag_len), tag_len);
+							}
+
+							if ((ciphertext != NULL) && (len > 0)) ciphertext->write(&chunk->data[0], len);
+						}
+
+						if (pooled)
+						{
+							pool.push(*this, chunk);
+						}
+						else
+						{
+							transform(*chunk);
+							chunk->done = true;
+						}
+
+						index++;
+					}
+
+					// write back the oldest chunk as soon as it is done
+					Chunk *chunk = inflight.front();
+
+					if (pooled) pool.wait(*chunk);
+
+					if (_mode == PayloadCipher::CIPHER_ENCRYPT)
+					{
+						if (!chunk->valid) throw ibrcommon::Exception("cipher operation failed");
+						_tags.append((const char*)chunk->tag, tag_len);
+					}
+					else if (!chunk->valid)
+					{
+						_valid = false;
+					}
+
+					const size_t len = chunk->data.size();
+					if (len > 0)
+					{
+						if ((ciphertext != NULL) && (_mode == PayloadCipher::CIPHER_ENCRYPT)) ciphertext->write(&chunk->data[0], len);
+
+						// write the data back at the same position
+						stream.seekp(chunk->offset, std::ios::beg);
+						stream.write(&chunk->data[0], len);
+					}
+
+					_length += len;
+
+					inflight.pop_front();
+					delete chunk;
+				}
+
+			} catch (...) {
+				shutdown(inflight);
+				_valid = false;
+				throw;
+			}
+
+			stream.flush();
+			if (!stream.good()) throw ibrcommon::IOException("write of the payload failed");
+		}
+
+		void ChunkedPayloadCipher::transform(Chunk &chunk) const
+		{
+			// the IV of the chunk is the IV of the payload XOR the index
+			unsigned char iv[iv_len];
+			::memcpy(iv, _iv, iv_len);
+
+			u_int64_t index = chunk.index;
+			for (size_t i = iv_len; i > 0; i--)
+			{
+				iv[i - 1] ^= (unsigned char)(index & 0xff);
+				index >>= 8;
+			}
+
+			try {
+				PayloadCipher cipher(_mode, _key, _salt, iv);
+
+				// authenticate the end of the payload
+				const char last = chunk.last ? 1 : 0;
+				cipher.authenticate(&last, 1);
+
+				if (!chunk.data.empty())
+				{
+					cipher.update(&chunk.data[0], &chunk.data[0], chunk.data.size());
+				}
+
+				if (_mode == PayloadCipher::CIPHER_ENCRYPT)
+				{
+					cipher.getTag(chunk.tag);
+				}
+				else
+				{
+					chunk.valid = cipher.verify(chunk.tag);
+				}
+			} catch (const ibrcommon::Exception&) {
+				chunk.valid = false;
+			}
+		}
+
+		void ChunkedPayloadCipher::shutdown(std::deque<Chunk*> &inflight)
+		{
+			Pool &pool = Pool::getInstance();
+			pool.cancel(*this);
+
+			// the chunks are owned by process(), but a worker may still use them
+			for (std::deque<Chunk*>::iterator iter = inflight.begin(); iter != inflight.end(); iter++)
+			{
+				if ((*iter)->queued) pool.wait(**iter);
+				delete (*iter);
+			}
+			inflight.clear();
+		}
+
+		void ChunkedPayloadCipher::getIV(unsigned char iv[iv_len]) const
+		{
+			::memcpy(iv, _iv, iv_len);
+		}
+
+		size_t ChunkedPayloadCipher::getLength() const
+		{
+			return _length;
+		}
+
+		const std::string& ChunkedPayloadCipher::getTags() const
+		{
+			return _tags;
+		}
+
+		bool ChunkedPayloadCipher::verify() const
+		{
+			return (_mode == PayloadCipher::CIPHER_DECRYPT) && _valid;
+		}
+	}
+}
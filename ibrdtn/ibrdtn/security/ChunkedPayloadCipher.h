@@ -0,0 +1,222 @@
+#ifndef _CHUNKED_PAYLOAD_CIPHER_H_
+#define _CHUNKED_PAYLOAD_CIPHER_H_
+
+#include "ibrdtn/security/PayloadCipher.h"
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <sys/types.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+
+namespace dtn
+{
+	namespace security
+	{
+		/**
+		Encrypts or decrypts a payload with AES-128 in Galois/Counter Mode in
+		chunks of a fixed size. Each chunk has its own nonce and tag, thus the
+		chunks are independent of each other and processed by a pool of
+		threads. The pool is shared by all ciphers and limited to MAX_THREADS
+		threads, thus concurrent payloads do not multiply the number of
+		threads. The payload is read and written back in order, so the
+		ciphertext of the first chunks is available while later chunks are
+		still in progress.
+
+		The IV of a chunk is the IV of the payload XOR the index of the chunk
+		as 64-bit big endian number. A flag, which marks the last chunk, is
+		authenticated with each chunk, thus a payload cut at a chunk boundary
+		does not verify. The tags of all chunks are concatenated in order.
+		*/
+		class ChunkedPayloadCipher : public PayloadFilter
+		{
+			public:
+				static const size_t key_size_in_bytes = PayloadCipher::key_size_in_bytes;
+				static const size_t iv_len = PayloadCipher::iv_len;
+				static const size_t tag_len = PayloadCipher::tag_len;
+
+				/**
+				The limits of the chunk size. A received chunk size outside of
+				these limits is rejected, since it is used to allocate the chunks.
+				*/
+				static const size_t MIN_CHUNK_SIZE = 4096;
+				static const size_t MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+
+				/**
+				The maximum number of threads in the shared pool.
+				*/
+				static const size_t MAX_THREADS = 32;
+
+				/**
+				Creates a cipher with a random IV.
+				@param key the AES key
+				@param salt the salt, which is part of the nonce of every chunk
+				@param chunk_size the size of the chunks in bytes, between MIN_CHUNK_SIZE and MAX_CHUNK_SIZE
+				@param threads the number of threads working on this payload, 0 uses one
+				thread per CPU. The shared pool is grown to this number of threads.
+				*/
+				ChunkedPayloadCipher(const PayloadCipher::Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt,
+						const size_t chunk_size, const size_t threads = 0);
+
+				/**
+				Creates a cipher with a given IV, e.g. to decrypt a received payload.
+				@param tags the concatenated tags of all chunks, which are expected
+				by the decryption
+				*/
+				ChunkedPayloadCipher(const PayloadCipher::Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt,
+						const unsigned char iv[iv_len], const size_t chunk_size, const size_t threads = 0, const std::string &tags = "");
+
+				virtual ~ChunkedPayloadCipher();
+
+				/**
+				Encrypts or decrypts the whole content of stream in place. The chunks
+				are written back and to ciphertext in their original order.
+				@throw ibrcommon::Exception if the chunk size is out of its limits
+				@throw ibrcommon::IOException if the stream could not be read or written
+				*/
+				virtual void process(std::iostream &stream, std::ostream *ciphertext = NULL);
+
+				/**
+				Returns the IV of the payload.
+				*/
+				void getIV(unsigned char iv[iv_len]) const;
+
+				/**
+				Returns the number of bytes processed so far.
+				*/
+				virtual size_t getLength() const;
+
+				/**
+				Returns the concatenated tags of all encrypted chunks.
+				*/
+				const std::string& getTags() const;
+
+				/**
+				Returns true, if the payload has been decrypted and the tag of every
+				chunk matches.
+				*/
+				bool verify() const;
+
+				/**
+				Returns the number of chunks of a payload with the given length.
+				*/
+				static size_t getChunks(const size_t length, const size_t chunk_size);
+
+			private:
+				ChunkedPayloadCipher(const ChunkedPayloadCipher&);
+				ChunkedPayloadCipher& operator=(const ChunkedPayloadCipher&);
+
+				class Chunk
+				{
+				public:
+					Chunk(const size_t index, const std::streamoff offset, const size_t length, const bool last);
+
+					const size_t index;
+					const std::streamoff offset;
+					const bool last;
+					std::vector<char> data;
+					unsigned char tag[tag_len];
+
+					// handed over to the pool
+					bool queued;
+					bool done;
+					bool valid;
+				};
+
+				/**
+				The threads shared by all ciphers. The threads are started on
+				demand and run until the process exits.
+				*/
+				class Pool
+				{
+				public:
+					static Pool& getInstance();
+
+					/**
+					Start threads until the pool has the given number of threads,
+					but not more than MAX_THREADS.
+					*/
+					void reserve(const size_t threads);
+
+					/**
+					Queue a chunk of a cipher.
+					*/
+					void push(const ChunkedPayloadCipher &cipher, Chunk *chunk);
+
+					/**
+					Wait until a chunk is done.
+					*/
+					void wait(const Chunk &chunk);
+
+					/**
+					Drop all queued chunks of a cipher. The chunks are marked as
+					done, thus wait() returns once the running ones are finished.
+					*/
+					void cancel(const ChunkedPayloadCipher &cipher);
+
+				private:
+					class Job
+					{
+					public:
+						Job();
+						Job(const ChunkedPayloadCipher &cipher, Chunk *chunk);
+
+						const ChunkedPayloadCipher *cipher;
+						Chunk *chunk;
+					};
+
+					class Worker : public ibrcommon::JoinableThread
+					{
+					public:
+						Worker(Pool &pool);
+						virtual ~Worker();
+
+					protected:
+						void run();
+						bool __cancellation();
+
+					private:
+						Pool &_pool;
+					};
+
+					Pool();
+					virtual ~Pool();
+
+					/**
+					Returns false, if the workers should stop.
+					*/
+					bool next(Job &job);
+
+					ibrcommon::Conditional _cond;
+					std::deque<Job> _jobs;
+					std::list<Worker*> _workers;
+					bool _running;
+				};
+
+				/**
+				Encrypts or decrypts a single chunk.
+				*/
+				void transform(Chunk &chunk) const;
+
+				/**
+				Drops the queued chunks and waits for the running ones.
+				*/
+				void shutdown(std::deque<Chunk*> &inflight);
+
+				const PayloadCipher::Mode _mode;
+				unsigned char _key[key_size_in_bytes];
+				const u_int32_t _salt;
+				unsigned char _iv[iv_len];
+				const size_t _chunk_size;
+				size_t _threads;
+
+				std::string _tags;
+				size_t _length;
+				bool _valid;
+		};
+	}
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "ibrdtn/data/Block.h"
 #include "ibrdtn/data/EID.h"
 #include "ibrdtn/security/SecurityBlock.h"
+#include "ibrdtn/security/PayloadCipher.h"
 #include <ibrcommon/Logger.h>
 
 #include <arpa/inet.h>
@@ -24,8 +25,8 @@ namespace dtn
 {
 	namespace security
 	{
-		MutualSerializer::MutualSerializer(std::ostream& stream, const dtn::data::Block *ignore)
-		 : dtn::data::DefaultSerializer(stream), _ignore(ignore), _ignore_previous_bundles(ignore != NULL)
+		MutualSerializer::MutualSerializer(std::ostream& stream, const dtn::data::Block *ignore, PayloadFilter *cipher)
+		 : dtn::data::DefaultSerializer(stream), _ignore(ignore), _ignore_previous_bundles(ignore != NULL), _cipher(cipher)
 		 {
 		 }
 
@@ -110,9 +111,20 @@ namespace dtn
 				// write size of the payload in the block
 				(*this) << dtn::data::SDNV(obj.getLength());
 
-				// write the payload of the block
-				size_t slength = 0;
-				obj.serialize(_stream, slength);
+				if ((_cipher != NULL) && (obj.getType() == dtn::data::PayloadBlock::BLOCK_TYPE))
+				{
+					// transform the payload and write the ciphertext within one pass
+					const dtn::data::PayloadBlock &plb = dynamic_cast<const dtn::data::PayloadBlock&>(obj);
+					ibrcommon::BLOB::Reference blobref = plb.getBLOB();
+					ibrcommon::BLOB::iostream stream = blobref.iostream();
+					_cipher->process(*stream, &_stream);
+				}
+				else
+				{
+					// write the payload of the block
+					size_t slength = 0;
+					obj.serialize(_stream, slength);
+				}
 			};
 
 			return (*this);
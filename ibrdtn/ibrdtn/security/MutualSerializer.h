@@ -11,6 +11,7 @@ namespace dtn
 	namespace security
 	{
 		class SecurityBlock;
+		class PayloadFilter;
 
 		/**
 		Serializes a bundle in mutable canonical form into a given stream. In 
@@ -32,8 +33,10 @@ namespace dtn
 				Creates a MutualSerializer which will stream into stream
 				@param stream the stream in which the mutable canonical form will be 
 				written into
+				@param cipher if set, the payload is encrypted or decrypted in place
+				while it is serialized and the ciphertext is written into stream
 				*/
-				MutualSerializer(std::ostream& stream, const dtn::data::Block *ignore = NULL);
+				MutualSerializer(std::ostream& stream, const dtn::data::Block *ignore = NULL, PayloadFilter *cipher = NULL);
 				
 				/** does nothing */
 				virtual ~MutualSerializer();
@@ -109,6 +112,7 @@ namespace dtn
 			private:
 				const dtn::data::Block *_ignore;
 				bool _ignore_previous_bundles;
+				PayloadFilter *_cipher;
 		};
 	}
 }
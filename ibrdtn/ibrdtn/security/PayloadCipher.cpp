@@ -0,0 +1,152 @@
+#include "ibrdtn/security/PayloadCipher.h"
+
+#include <ibrcommon/Exceptions.h>
+#include <openssl/rand.h>
+#include <string.h>
+#include <vector>
+
+namespace dtn
+{
+	namespace security
+	{
+		PayloadCipher::PayloadCipher(const Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt)
+		 : _mode(mode), _ctx(NULL), _length(0), _finished(false)
+		{
+			// create a random IV
+			if (!RAND_bytes(_iv, iv_len))
+			{
+				throw ibrcommon::Exception("failed to create a random IV");
+			}
+
+			init(key, salt);
+		}
+
+		PayloadCipher::PayloadCipher(const Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt, const unsigned char iv[iv_len])
+		 : _mode(mode), _ctx(NULL), _length(0), _finished(false)
+		{
+			::memcpy(_iv, iv, iv_len);
+			init(key, salt);
+		}
+
+		PayloadCipher::~PayloadCipher()
+		{
+			EVP_CIPHER_CTX_free(_ctx);
+		}
+
+		void PayloadCipher::init(const unsigned char key[key_size_in_bytes], const u_int32_t salt)
+		{
+			// the nonce is the salt followed by the IV, the salt is copied in host
+			// byte order like ibrcommon::AES128Stream does
+			unsigned char nonce[sizeof(u_int32_t) + iv_len];
+			::memcpy(nonce, &salt, sizeof(u_int32_t));
+			::memcpy(nonce + sizeof(u_int32_t), _iv, iv_len);
+
+			const int enc = (_mode == CIPHER_ENCRYPT) ? 1 : 0;
+
+			_ctx = EVP_CIPHER_CTX_new();
+			if (_ctx == NULL) throw ibrcommon::Exception("failed to create the cipher context");
+
+			if (!EVP_CipherInit_ex(_ctx, EVP_aes_128_gcm(), NULL, NULL, NULL, enc) ||
+				!EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_SET_IVLEN, sizeof(nonce), NULL) ||
+				!EVP_CipherInit_ex(_ctx, NULL, NULL, key, nonce, enc))
+			{
+				EVP_CIPHER_CTX_free(_ctx);
+				_ctx = NULL;
+				throw ibrcommon::Exception("failed to initialize the cipher");
+			}
+		}
+
+		void PayloadCipher::authenticate(const char *data, const size_t len)
+		{
+			int outl = 0;
+			if (!EVP_CipherUpdate(_ctx, NULL, &outl, (const unsigned char*)data, len))
+			{
+				throw ibrcommon::Exception("cipher operation failed");
+			}
+		}
+
+		void PayloadCipher::update(const char *in, char *out, const size_t len)
+		{
+			int outl = 0;
+			if (!EVP_CipherUpdate(_ctx, (unsigned char*)out, &outl, (const unsigned char*)in, len))
+			{
+				throw ibrcommon::Exception("cipher operation failed");
+			}
+			_length += len;
+		}
+
+		void PayloadCipher::process(std::iostream &stream, std::ostream *ciphertext)
+		{
+			std::vector<char> buf(BUFFER_SIZE);
+
+			stream.clear();
+			stream.seekg(0, std::ios::end);
+			const std::streamoff size = stream.tellg();
+
+			for (std::streamoff offset = 0; offset < size;)
+			{
+				const size_t len = ((size - offset) < (std::streamoff)BUFFER_SIZE) ? (size_t)(size - offset) : BUFFER_SIZE;
+
+				stream.seekg(offset, std::ios::beg);
+				stream.read(&buf[0], len);
+				if ((size_t)stream.gcount() != len) throw ibrcommon::IOException("read of the payload failed");
+
+				if ((ciphertext != NULL) && (_mode == CIPHER_DECRYPT)) ciphertext->write(&buf[0], len);
+
+				update(&buf[0], &buf[0], len);
+
+				if ((ciphertext != NULL) && (_mode == CIPHER_ENCRYPT)) ciphertext->write(&buf[0], len);
+
+				// write the data back at the same position
+				stream.seekp(offset, std::ios::beg);
+				stream.write(&buf[0], len);
+
+				offset += len;
+			}
+
+			stream.flush();
+			if (!stream.good()) throw ibrcommon::IOException("write of the payload failed");
+		}
+
+		void PayloadCipher::getIV(unsigned char iv[iv_len]) const
+		{
+			::memcpy(iv, _iv, iv_len);
+		}
+
+		size_t PayloadCipher::getLength() const
+		{
+			return _length;
+		}
+
+		void PayloadCipher::getTag(unsigned char tag[tag_len])
+		{
+			if (!_finished)
+			{
+				// GCM does not produce any output here
+				unsigned char buf[EVP_MAX_BLOCK_LENGTH];
+				int outl = 0;
+				if (!EVP_CipherFinal_ex(_ctx, buf, &outl)) throw ibrcommon::Exception("cipher operation failed");
+				_finished = true;
+			}
+
+			if (!EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_GET_TAG, tag_len, tag))
+			{
+				throw ibrcommon::Exception("failed to get the authentication tag");
+			}
+		}
+
+		bool PayloadCipher::verify(const unsigned char tag[tag_len])
+		{
+			if (_finished) return false;
+			_finished = true;
+
+			unsigned char expected[tag_len];
+			::memcpy(expected, tag, tag_len);
+			if (!EVP_CIPHER_CTX_ctrl(_ctx, EVP_CTRL_GCM_SET_TAG, tag_len, expected)) return false;
+
+			unsigned char buf[EVP_MAX_BLOCK_LENGTH];
+			int outl = 0;
+			return (EVP_CipherFinal_ex(_ctx, buf, &outl) > 0);
+		}
+	}
+}
@@ -0,0 +1,133 @@
+#ifndef _PAYLOAD_CIPHER_H_
+#define _PAYLOAD_CIPHER_H_
+
+#include <ibrcommon/ssl/AES128Stream.h>
+#include <openssl/evp.h>
+#include <sys/types.h>
+#include <iostream>
+
+namespace dtn
+{
+	namespace security
+	{
+		/**
+		A transformation of the payload, which is done in place within a
+		single pass. The encrypted data can be written into a second stream
+		on the way, e.g. into a signature.
+		*/
+		class PayloadFilter
+		{
+			public:
+				virtual ~PayloadFilter() {};
+
+				/**
+				Transforms the whole content of stream in place. Every chunk of
+				ciphertext is written to ciphertext, if it is not NULL.
+				@param stream the stream to transform, e.g. of a BLOB
+				@param ciphertext receives the encrypted data, the output of the
+				encryption or the input of the decryption
+				*/
+				virtual void process(std::iostream &stream, std::ostream *ciphertext = NULL) = 0;
+
+				/**
+				Returns the number of bytes processed so far.
+				*/
+				virtual size_t getLength() const = 0;
+		};
+
+		/**
+		Encrypts or decrypts a payload with AES-128 in Galois/Counter Mode using
+		the EVP interface of OpenSSL, which makes use of AES-NI and carry-less
+		multiplication if the CPU supports them. The nonce is composed of the
+		salt and the IV in the same way as in ibrcommon::AES128Stream, thus data
+		encrypted with one of them can be decrypted with the other one.
+
+		The payload is transformed in place within a single pass. Each chunk of
+		ciphertext can be written into a second stream on the way, e.g. into a
+		signature, so that encryption and integrity need no additional pass.
+		*/
+		class PayloadCipher : public PayloadFilter
+		{
+			public:
+				enum Mode
+				{
+					CIPHER_ENCRYPT = 0,
+					CIPHER_DECRYPT = 1
+				};
+
+				static const size_t key_size_in_bytes = ibrcommon::AES128Stream::key_size_in_bytes;
+				static const size_t iv_len = ibrcommon::AES128Stream::iv_len;
+				static const size_t tag_len = ibrcommon::AES128Stream::tag_len;
+
+				/**
+				Creates a cipher with a random IV.
+				@param key the AES key
+				@param salt the salt, which is part of the nonce
+				*/
+				PayloadCipher(const Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt);
+
+				/**
+				Creates a cipher with a given IV, e.g. to decrypt a received payload.
+				*/
+				PayloadCipher(const Mode mode, const unsigned char key[key_size_in_bytes], const u_int32_t salt, const unsigned char iv[iv_len]);
+
+				/** frees the cipher context */
+				virtual ~PayloadCipher();
+
+				/**
+				Adds len bytes of additional data, which are covered by the tag but
+				not encrypted. This has to be done before the first call of update().
+				*/
+				void authenticate(const char *data, const size_t len);
+
+				/**
+				Encrypts or decrypts len bytes. in and out may point to the same buffer.
+				*/
+				void update(const char *in, char *out, const size_t len);
+
+				/**
+				Encrypts or decrypts the whole content of stream in place. Every chunk
+				of ciphertext is written to ciphertext, if it is not NULL.
+				*/
+				virtual void process(std::iostream &stream, std::ostream *ciphertext = NULL);
+
+				/**
+				Returns the IV used for this cipher.
+				*/
+				void getIV(unsigned char iv[iv_len]) const;
+
+				/**
+				Returns the number of bytes processed so far.
+				*/
+				virtual size_t getLength() const;
+
+				/**
+				Finishes the encryption and returns the authentication tag.
+				*/
+				void getTag(unsigned char tag[tag_len]);
+
+				/**
+				Finishes the decryption and compares the authentication tag.
+				@return true if the tag matches
+				*/
+				bool verify(const unsigned char tag[tag_len]);
+
+			private:
+				PayloadCipher(const PayloadCipher&);
+				PayloadCipher& operator=(const PayloadCipher&);
+
+				void init(const unsigned char key[key_size_in_bytes], const u_int32_t salt);
+
+				/** size of the chunks processed by process() */
+				static const size_t BUFFER_SIZE = 65536;
+
+				const Mode _mode;
+				EVP_CIPHER_CTX *_ctx;
+				unsigned char _iv[iv_len];
+				size_t _length;
+				bool _finished;
+		};
+	}
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "ibrdtn/security/PayloadConfidentialBlock.h"
 #include "ibrdtn/security/PayloadIntegrityBlock.h"
+#include "ibrdtn/security/ChunkedPayloadCipher.h"
 #include "ibrdtn/data/Bundle.h"
 #include "ibrdtn/data/SDNV.h"
 
@@ -7,8 +8,10 @@
 #include <openssl/rsa.h>
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
+#include <arpa/inet.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <typeinfo>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
@@ -19,6 +22,9 @@ namespace dtn
 {
 	namespace security
 	{
+		size_t PayloadConfidentialBlock::chunk_size = 0;
+		size_t PayloadConfidentialBlock::chunk_threads = 0;
+
 		dtn::data::Block* PayloadConfidentialBlock::Factory::create()
 		{
 			return new PayloadConfidentialBlock();
@@ -34,6 +40,16 @@ namespace dtn
 		}
 
 		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source)
+		{
+			encrypt(bundle, long_key, source, NULL);
+		}
+
+		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const dtn::security::SecurityKey &sign_key)
+		{
+			encrypt(bundle, long_key, source, &sign_key);
+		}
+
+		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const dtn::security::SecurityKey *sign_key)
 		{
 			// contains the random salt
 			u_int32_t salt;
@@ -56,31 +72,28 @@ namespace dtn
 			// create a random salt and key
 			createSaltAndKey(salt, ephemeral_key, ibrcommon::AES128Stream::key_size_in_bytes);
 
-			// encrypt payload - BEGIN
 			dtn::data::PayloadBlock& plb = bundle.getBlock<dtn::data::PayloadBlock>();
 			ibrcommon::BLOB::Reference blobref = plb.getBLOB();
 
-			{
-				ibrcommon::BLOB::iostream stream = blobref.iostream();
-				ibrcommon::AES128Stream aes_stream(ibrcommon::CipherStream::CIPHER_ENCRYPT, *stream, ephemeral_key, salt);
+			// large payloads are encrypted in chunks by several threads
+			const size_t length = plb.getLength();
+			const bool chunked = (chunk_size > 0) && (length > chunk_size);
 
-				// encrypt in place
-				((ibrcommon::CipherStream&)aes_stream).encrypt(*stream);
+			// the cipher for the payload, the IV is known before the payload is encrypted
+			PayloadCipher cipher(PayloadCipher::CIPHER_ENCRYPT, ephemeral_key, salt);
+			cipher.getIV(iv);
 
-				// check if this is a fragment
-				if (bundle.get(dtn::data::PrimaryBlock::FRAGMENT))
-				{
-					// ... and set the corresponding cipher suit params
-					addFragmentRange(pcb._ciphersuite_params, bundle._fragmentoffset, stream.size());
-				}
+			ChunkedPayloadCipher chunks(PayloadCipher::CIPHER_ENCRYPT, ephemeral_key, salt, iv, chunk_size, chunk_threads);
+			PayloadFilter &filter = chunked ? (PayloadFilter&)chunks : (PayloadFilter&)cipher;
 
-				// get the IV
-				aes_stream.getIV(iv);
+			// check if this is a fragment
+			if (bundle.get(dtn::data::PrimaryBlock::FRAGMENT))
+			{
+				ibrcommon::BLOB::iostream stream = blobref.iostream();
 
-				// get the tag
-				aes_stream.getTag(tag);
+				// ... and set the corresponding cipher suit params
+				addFragmentRange(pcb._ciphersuite_params, bundle._fragmentoffset, stream.size());
 			}
-			// encrypt payload - END
 
 			// set the source and destination address of the new block
 			if (source != bundle._source.getNode()) pcb.setSecuritySource( source );
@@ -104,7 +117,17 @@ namespace dtn
 			pcb._ciphersuite_params.set(SecurityBlock::initialization_vector, iv, ibrcommon::AES128Stream::iv_len);
 			pcb._ciphersuite_flags |= SecurityBlock::CONTAINS_CIPHERSUITE_PARAMS;
 
-			pcb._security_result.set(SecurityBlock::PCB_integrity_check_value, tag, ibrcommon::AES128Stream::tag_len);
+			if (chunked)
+			{
+				pcb._ciphersuite_id = SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED;
+
+				const u_int32_t nsize = htonl(chunk_size);
+				pcb._ciphersuite_params.set(SecurityBlock::chunk_size, (const unsigned char*)&nsize, sizeof(nsize));
+			}
+
+			// reserve the space of the tags, the tags are not covered by a signature
+			const size_t tags_len = (chunked ? ChunkedPayloadCipher::getChunks(length, chunk_size) : 1) * ibrcommon::AES128Stream::tag_len;
+			pcb._security_result.set(SecurityBlock::PCB_integrity_check_value, std::string(tags_len, '\0'));
 			pcb._ciphersuite_flags |= SecurityBlock::CONTAINS_SECURITY_RESULT;
 
 			// create correlator
@@ -119,9 +142,44 @@ namespace dtn
 
 			for (std::list<const PayloadIntegrityBlock*>::const_iterator it = pibs.begin(); it != pibs.end(); it++)
 				SecurityBlock::encryptBlock<PayloadConfidentialBlock>(bundle, (dtn::data::Block&)**it, salt, ephemeral_key).setCorrelator(correlator);
+
+			// encrypt payload - BEGIN
+			if (sign_key == NULL)
+			{
+				// encrypt in place
+				ibrcommon::BLOB::iostream stream = blobref.iostream();
+				filter.process(*stream);
+			}
+			else
+			{
+				// sign the bundle while the payload is encrypted
+				PayloadIntegrityBlock::sign(bundle, *sign_key, bundle._destination.getNode(), filter);
+			}
+
+			// get the tag
+			if (chunked)
+			{
+				pcb._security_result.set(SecurityBlock::PCB_integrity_check_value, chunks.getTags());
+			}
+			else
+			{
+				cipher.getTag(tag);
+				pcb._security_result.set(SecurityBlock::PCB_integrity_check_value, tag, ibrcommon::AES128Stream::tag_len);
+			}
+			// encrypt payload - END
 		}
 
 		void PayloadConfidentialBlock::decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key)
+		{
+			decrypt(bundle, long_key, NULL, NULL);
+		}
+
+		void PayloadConfidentialBlock::decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const PayloadIntegrityBlock &pib, const dtn::security::SecurityKey &verify_key)
+		{
+			decrypt(bundle, long_key, &pib, &verify_key);
+		}
+
+		void PayloadConfidentialBlock::decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const PayloadIntegrityBlock *pib, const dtn::security::SecurityKey *verify_key)
 		{
 			// list of block to delete if the process is successful
 			std::list<const dtn::data::Block*> erasure_list;
@@ -175,7 +233,8 @@ namespace dtn
 						}
 						// if security destination does match the key, then try to decrypt the payload
 						else if (pcb.isSecurityDestination(bundle, long_key.reference) &&
-							(pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB))
+							((pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB) ||
+							 (pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED)))
 						{
 							// try to decrypt the symmetric AES key
 							if (!getKey(pcb._ciphersuite_params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key))
@@ -184,12 +243,10 @@ namespace dtn
 								throw ibrcommon::Exception("decrypt failed - could not get symmetric key decrypted");
 							}
 
-							// try to decrypt the payload
-							if (!decryptPayload(bundle, key, salt))
+							// try to decrypt the payload, the encrypted payload is restored on failure
+							if (!decryptPayload(bundle, key, salt, pib, verify_key))
 							{
-								// reverse decryption
-								IBRCOMMON_LOGGER(critical) << "tag verfication failed, reversing decryption..." << IBRCOMMON_LOGGER_ENDL;
-								decryptPayload(bundle, key, salt);
+								IBRCOMMON_LOGGER(critical) << "tag verfication failed, decryption reversed" << IBRCOMMON_LOGGER_ENDL;
 								throw ibrcommon::Exception("decrypt reversed - tag verfication failed");
 							}
 
@@ -233,7 +290,8 @@ namespace dtn
 			long_key.free(rsa_key);
 		}
 
-		bool PayloadConfidentialBlock::decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const u_int32_t salt)
+		bool PayloadConfidentialBlock::decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const u_int32_t salt,
+				const PayloadIntegrityBlock *pib, const dtn::security::SecurityKey *verify_key)
 		{
 			// TODO handle fragmentation
 			PayloadConfidentialBlock& pcb = bundle.getBlock<PayloadConfidentialBlock>();
@@ -247,24 +305,84 @@ namespace dtn
 			unsigned char tag[ibrcommon::AES128Stream::tag_len];
 			pcb._security_result.get(SecurityBlock::PCB_integrity_check_value, tag, ibrcommon::AES128Stream::tag_len);
 
+			// the size of the chunks, if the payload is encrypted in chunks
+			const bool chunked = (pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED);
+			u_int32_t nsize = 0;
+			if (chunked)
+			{
+				pcb._ciphersuite_params.get(SecurityBlock::chunk_size, (unsigned char*)&nsize, sizeof(nsize));
+			}
+			const size_t size = ntohl(nsize);
+
+			// do not allocate chunks of any size a sender asks for
+			if (chunked && ((size < ChunkedPayloadCipher::MIN_CHUNK_SIZE) || (size > ChunkedPayloadCipher::MAX_CHUNK_SIZE)))
+			{
+				throw ibrcommon::Exception("decrypt failed - invalid chunk size");
+			}
+			const std::string tags = pcb._security_result.get(SecurityBlock::PCB_integrity_check_value);
+
 			// get the reference to the corresponding BLOB object
 			ibrcommon::BLOB::Reference blobref = plb.getBLOB();
+			const size_t length = plb.getLength();
 
 			// decrypt the payload and get the integrity signature (tag)
 			{
-				ibrcommon::BLOB::iostream stream = blobref.iostream();
-				ibrcommon::AES128Stream decrypt(ibrcommon::CipherStream::CIPHER_DECRYPT, *stream, ephemeral_key, salt, iv);
-				((ibrcommon::CipherStream&)decrypt).decrypt(*stream);
+				PayloadCipher cipher(PayloadCipher::CIPHER_DECRYPT, ephemeral_key, salt, iv);
+				ChunkedPayloadCipher chunks(PayloadCipher::CIPHER_DECRYPT, ephemeral_key, salt, iv, size, chunk_threads, tags);
+				PayloadFilter &filter = chunked ? (PayloadFilter&)chunks : (PayloadFilter&)cipher;
+				bool valid = true;
+
+				if (pib == NULL)
+				{
+					ibrcommon::BLOB::iostream stream = blobref.iostream();
+					filter.process(*stream);
+				}
+				else
+				{
+					// verify the signature over the encrypted payload while it is decrypted
+					try {
+						PayloadIntegrityBlock::verify(bundle, *verify_key, *pib, filter);
+					} catch (const ibrcommon::Exception &ex) {
+						IBRCOMMON_LOGGER(error) << "signature of the encrypted payload is invalid: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+						valid = false;
+					}
+				}
 
 				// get the decrypt tag
-				if (!decrypt.verify(tag))
+				if (!(chunked ? chunks.verify() : cipher.verify(tag)))
 				{
 					IBRCOMMON_LOGGER(error) << "integrity signature of the decrypted payload is invalid" << IBRCOMMON_LOGGER_ENDL;
-					return false;
+					valid = false;
+				}
+
+				if (valid) return true;
+
+				// nothing to restore if the payload has not been touched
+				if (filter.getLength() == 0) return false;
+
+				if (filter.getLength() != length)
+				{
+					throw ibrcommon::IOException("decryption of the payload aborted");
+				}
+			}
+
+			// restore the encrypted payload
+			{
+				ibrcommon::BLOB::iostream stream = blobref.iostream();
+
+				if (chunked)
+				{
+					ChunkedPayloadCipher chunks(PayloadCipher::CIPHER_ENCRYPT, ephemeral_key, salt, iv, size, chunk_threads);
+					chunks.process(*stream);
+				}
+				else
+				{
+					PayloadCipher cipher(PayloadCipher::CIPHER_DECRYPT, ephemeral_key, salt, iv);
+					cipher.process(*stream);
 				}
 			}
 
-			return true;
+			return false;
 		}
 	}
 }
@@ -2,6 +2,7 @@
 #define _PAYLOAD_CONFIDENTIAL_BLOCK_H_
 #include "ibrdtn/security/SecurityBlock.h"
 #include "ibrdtn/security/SecurityKey.h"
+#include "ibrdtn/security/PayloadCipher.h"
 #include "ibrdtn/data/PayloadBlock.h"
 #include "ibrdtn/data/ExtensionBlock.h"
 
@@ -9,6 +10,8 @@ namespace dtn
 {
 	namespace security
 	{
+		class PayloadIntegrityBlock;
+
 		/**
 		The PayloadConfidentialBlock encrypts the payload, PayloadConfidentialBlocks,
 		which are already there and PayloadIntegrityBlocks, which are already there.
@@ -41,6 +44,17 @@ namespace dtn
 				/** The block type of this class. */
 				static const char BLOCK_TYPE = SecurityBlock::PAYLOAD_CONFIDENTIAL_BLOCK;
 
+				/**
+				Payloads larger than chunk_size bytes are encrypted in chunks of this
+				size with the ciphersuite PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED. The
+				chunks are processed in parallel by chunk_threads threads, 0 means one
+				thread per CPU. A chunk_size of 0 disables the chunked encryption,
+				any other value has to be within the limits of ChunkedPayloadCipher.
+				Received payloads are decrypted with the chunk size of their PCB.
+				*/
+				static size_t chunk_size;
+				static size_t chunk_threads;
+
 				/** does nothing */
 				virtual ~PayloadConfidentialBlock();
 
@@ -53,6 +67,16 @@ namespace dtn
 				*/
 				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source);
 
+				/**
+				Encrypts the Payload like encrypt() and signs the bundle with a
+				PayloadIntegrityBlock afterwards, like PayloadIntegrityBlock::sign()
+				does. The signature is calculated over the ciphertext while the
+				payload is encrypted, thus the payload is read and written once.
+				@param bundle the bundle with the to be encrypted payload
+				@param sign_key the private key for the signature
+				*/
+				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const dtn::security::SecurityKey &sign_key);
+
 				/**
 				Decrypts the Payload inside this Bundle. All correlated Blocks, which
 				are found, will be decrypted, too, placed at the position, where their 
@@ -66,6 +90,17 @@ namespace dtn
 				*/
 				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key);
 
+				/**
+				Decrypts the Payload like decrypt() and verifies the signature of a
+				PayloadIntegrityBlock, which covers the encrypted payload, within the
+				same pass over the payload. If the signature or the tag does not match,
+				the encrypted payload is restored and an exception is thrown.
+				@param bundle the bundle with the to be decrypted payload
+				@param pib the PayloadIntegrityBlock to verify
+				@param verify_key the public key of the security source of pib
+				*/
+				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const PayloadIntegrityBlock &pib, const dtn::security::SecurityKey &verify_key);
+
 			protected:
 				/**
 				Creates an empty PayloadConfidentialBlock. With ciphersuite_id set to
@@ -73,14 +108,21 @@ namespace dtn
 				*/
 				PayloadConfidentialBlock();
 
+				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const dtn::security::SecurityKey *sign_key);
+
+				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const PayloadIntegrityBlock *pib, const dtn::security::SecurityKey *verify_key);
+
 				/**
-				Decrypts the payload using the ephemeral_key and salt.
+				Decrypts the payload using the ephemeral_key and salt. If a pib is
+				given, its signature is verified within the same pass.
 				@param bundle the payload containing bundle
 				@param ephemeral_key the AES key
 				@param salt the salt
-				@return true if tag verification succeeded, false otherwise
+				@return true if tag verification succeeded, false otherwise. Then the
+				encrypted payload is restored.
 				*/
-				static bool decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const u_int32_t salt);
+				static bool decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const u_int32_t salt,
+						const PayloadIntegrityBlock *pib = NULL, const dtn::security::SecurityKey *verify_key = NULL);
 		};
 
 		/**
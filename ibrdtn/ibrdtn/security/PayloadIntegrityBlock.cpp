@@ -40,6 +40,16 @@ namespace dtn
 		}
 
 		void PayloadIntegrityBlock::sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination)
+		{
+			sign(bundle, key, destination, NULL);
+		}
+
+		void PayloadIntegrityBlock::sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination, PayloadFilter &cipher)
+		{
+			sign(bundle, key, destination, &cipher);
+		}
+
+		void PayloadIntegrityBlock::sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination, PayloadFilter *cipher)
 		{
 			PayloadIntegrityBlock& pib = bundle.push_front<PayloadIntegrityBlock>();
 			pib.set(REPLICATE_IN_EVERY_FRAGMENT, true);
@@ -60,17 +70,17 @@ namespace dtn
 			pib.setResultSize(key);
 			pib.setCiphersuiteId(SecurityBlock::PIB_RSA_SHA256);
 			pib._ciphersuite_flags |= CONTAINS_SECURITY_RESULT;
-			std::string sign = calcHash(bundle, key, pib);
+			std::string sign = calcHash(bundle, key, pib, cipher);
 			pib._security_result.set(SecurityBlock::integrity_signature, sign);
 		}
 
-		const std::string PayloadIntegrityBlock::calcHash(const dtn::data::Bundle &bundle, const SecurityKey &key, PayloadIntegrityBlock& ignore)
+		const std::string PayloadIntegrityBlock::calcHash(const dtn::data::Bundle &bundle, const SecurityKey &key, PayloadIntegrityBlock& ignore, PayloadFilter *cipher)
 		{
 			EVP_PKEY *pkey = key.getEVP();
 			ibrcommon::RSASHA256Stream rs2s(pkey);
 
 			// serialize the bundle in the mutable form
-			dtn::security::MutualSerializer ms(rs2s, &ignore);
+			dtn::security::MutualSerializer ms(rs2s, &ignore, cipher);
 			(dtn::data::DefaultSerializer&)ms << bundle; rs2s << std::flush;
 
 			int return_code = rs2s.getSign().first;
@@ -87,7 +97,12 @@ namespace dtn
 			}
 		}
 
-		void PayloadIntegrityBlock::verify(const dtn::data::Bundle& bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, const bool use_eid)
+		void PayloadIntegrityBlock::verify(const dtn::data::Bundle &bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, PayloadFilter &cipher)
+		{
+			verify(bundle, key, sb, true, &cipher);
+		}
+
+		void PayloadIntegrityBlock::verify(const dtn::data::Bundle& bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, const bool use_eid, PayloadFilter *cipher)
 		{
 			// check if we have the public key of the security source
 			if (use_eid)
@@ -110,7 +125,7 @@ namespace dtn
 			ibrcommon::RSASHA256Stream rs2s(pkey, true);
 
 			// serialize the bundle in the mutable form
-			dtn::security::MutualSerializer ms(rs2s, &sb);
+			dtn::security::MutualSerializer ms(rs2s, &sb, cipher);
 			(dtn::data::DefaultSerializer&)ms << bundle; rs2s << std::flush;
 
 			int ret = rs2s.getVerification(sb._security_result.get(SecurityBlock::integrity_signature));
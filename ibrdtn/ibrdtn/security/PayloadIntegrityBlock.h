@@ -3,6 +3,7 @@
 
 #include "ibrdtn/security/SecurityBlock.h"
 #include "ibrdtn/security/SecurityKey.h"
+#include "ibrdtn/security/PayloadCipher.h"
 #include "ibrdtn/data/ExtensionBlock.h"
 #include "ibrdtn/data/Bundle.h"
 #include <openssl/evp.h>
@@ -45,6 +46,16 @@ namespace dtn
 				*/
 				static void sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination);
 
+				/**
+				Like sign(), but the payload is encrypted by the cipher while it is
+				hashed. The signature covers the encrypted payload, thus the result
+				equals an encryption followed by sign(), with one pass less over the
+				payload.
+				@param bundle the bundle to be hashed and signed
+				@param cipher an encrypting cipher
+				*/
+				static void sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination, PayloadFilter &cipher);
+
 				/**
 				Tests if the bundles signatures is correct. There might be multiple PIBs
 				inside the bundle, which may be tested and the result will be 1 if one 
@@ -55,6 +66,18 @@ namespace dtn
 				*/
 				static void verify(const dtn::data::Bundle &bundle, const SecurityKey &key);
 
+				/**
+				Checks the signature of sb, while the payload is decrypted by the
+				cipher. The signature is calculated over the encrypted payload as it
+				is read, thus the decryption needs no additional pass. The payload is
+				decrypted even if the signature does not match.
+				@param bundle the bundle to be checked
+				@param sb the PIB containing the signature
+				@param cipher a decrypting cipher
+				@throw ibrcommon::Exception if the signature does not match
+				*/
+				static void verify(const dtn::data::Bundle &bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, PayloadFilter &cipher);
+
 				/**
 				Seeks for a valid PIB in the stack and removes all blocks above and the 
 				PIB block itself.
@@ -99,9 +122,12 @@ namespace dtn
 				Calculates a signature using the PIB-RSA-SHA256 algorithm.
 				@param bundle the bundle to be hashed
 				@param ignore the security block, wichs security result shall be ignored
+				@param cipher if set, the payload is passed through this cipher
 				@return a string with the signature
 				*/
-				static const std::string calcHash(const dtn::data::Bundle &bundle, const SecurityKey &key, PayloadIntegrityBlock& ignore);
+				static void sign(dtn::data::Bundle &bundle, const SecurityKey &key, const dtn::data::EID& destination, PayloadFilter *cipher);
+
+				static const std::string calcHash(const dtn::data::Bundle &bundle, const SecurityKey &key, PayloadIntegrityBlock& ignore, PayloadFilter *cipher = NULL);
 
 				/**
 				Checks if the signature of sb matches to the bundle.
@@ -110,10 +136,11 @@ namespace dtn
 				@param use_eid if set to true, the security source and destination will 
 				be checked before the bundle, to avoid computation on bundles with the 
 				wrong key
+				@param cipher if set, the payload is passed through this cipher
 				@return returns 1 for a correct signature, 0 for failure and -1 if some 
 				other error occurred.
 				*/
-				static void verify(const dtn::data::Bundle& bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, const bool use_eid = true);
+				static void verify(const dtn::data::Bundle& bundle, const SecurityKey &key, const PayloadIntegrityBlock &sb, const bool use_eid = true, PayloadFilter *cipher = NULL);
 
 				/**
 				Set key_size to new_size, when _security_result is empty at the mutable
@@ -190,7 +190,7 @@ namespace dtn
 		void SecurityBlock::store_security_references()
 		{
 			// clear the EID list
-			_eids.clear();
+			clearEIDs();
 
 			// first the security source
 			if (_security_source == dtn::data::EID())
@@ -200,7 +200,7 @@ namespace dtn
 			else
 			{
 				_ciphersuite_flags |= SecurityBlock::CONTAINS_SECURITY_SOURCE;
-				_eids.push_back(_security_source);
+				addEID(_security_source);
 			}
 
 			// then the destination
@@ -211,16 +211,7 @@ namespace dtn
 			else
 			{
 				_ciphersuite_flags |= SecurityBlock::CONTAINS_SECURITY_DESTINATION;
-				_eids.push_back(_security_destination);
-			}
-
-			if (_eids.size() > 0)
-			{
-				set(Block::BLOCK_CONTAINS_EIDS, true);
-			}
-			else
-			{
-				set(Block::BLOCK_CONTAINS_EIDS, false);
+				addEID(_security_destination);
 			}
 		}
 
@@ -393,7 +384,7 @@ namespace dtn
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 			// recheck ciphersuite_id
-			assert(_ciphersuite_id == BAB_HMAC || _ciphersuite_id == PIB_RSA_SHA256 || _ciphersuite_id == PCB_RSA_AES128_PAYLOAD_PIB_PCB || _ciphersuite_id == ESB_RSA_AES128_EXT);
+			assert(_ciphersuite_id == BAB_HMAC || _ciphersuite_id == PIB_RSA_SHA256 || _ciphersuite_id == PCB_RSA_AES128_PAYLOAD_PIB_PCB || _ciphersuite_id == ESB_RSA_AES128_EXT || _ciphersuite_id == PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED);
 			// recheck ciphersuite_flags, could be more exhaustive
 			assert(_ciphersuite_flags < 32);
 #endif
@@ -56,7 +56,9 @@ namespace dtn
 				salt = 7,
 				PCB_integrity_check_value = 8,
 				encapsulated_block = 10,
-				block_type_of_encapsulated_block = 11
+				block_type_of_encapsulated_block = 11,
+				/** private use: size of the chunks of PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED */
+				chunk_size = 192
 			};
 			/** the position of each flag in the ciphersuite flags */
 			enum CIPHERSUITE_FLAGS
@@ -75,7 +77,10 @@ namespace dtn
 				BAB_HMAC = 0x001,
 				PIB_RSA_SHA256 = 0x002,
 				PCB_RSA_AES128_PAYLOAD_PIB_PCB = 0x003,
-				ESB_RSA_AES128_EXT = 0x004
+				ESB_RSA_AES128_EXT = 0x004,
+				/** private use: like PCB_RSA_AES128_PAYLOAD_PIB_PCB, but the payload
+				is encrypted in chunks, each with its own tag */
+				PCB_RSA_AES128_PAYLOAD_PIB_PCB_CHUNKED = 0x0C3
 			};
 
 			class TLV
@@ -20,6 +20,9 @@ namespace dtn
 			// Initialize get pointer.  This should be zero so that underflow is called upon first read.
 			setg(0, 0, 0);
 			setp(out_buf_, out_buf_ + _buffer_size - 1);
+
+			_recv_start.tv_sec = 0;
+			_recv_start.tv_nsec = 0;
 		}
 
 		StreamConnection::StreamBuffer::~StreamBuffer()
@@ -208,6 +211,23 @@ namespace dtn
 			setg(0, 0, 0);
 		}
 
+		void StreamConnection::StreamBuffer::deferFlush(bool enabled)
+		{
+			if (enabled)
+			{
+				set(STREAM_DEFER_FLUSH);
+			}
+			else
+			{
+				unset(STREAM_DEFER_FLUSH);
+			}
+		}
+
+		u_int64_t StreamConnection::StreamBuffer::getReceiveStart() const
+		{
+			return ((u_int64_t)_recv_start.tv_sec * 1000000) + (_recv_start.tv_nsec / 1000);
+		}
+
 		void StreamConnection::StreamBuffer::abort()
 		{
 			_segments.abort();
@@ -275,6 +295,7 @@ namespace dtn
 					// put the segment into the queue
 					if (get(STREAM_ACK_SUPPORT))
 					{
+						::clock_gettime(CLOCK_MONOTONIC, &seg._sent);
 						_segments.push(seg);
 					}
 					else if (seg._flags & StreamDataSegment::MSG_MARK_END)
@@ -326,6 +347,16 @@ namespace dtn
 			int ret = traits_type::eq_int_type(this->overflow(traits_type::eof()),
 											traits_type::eof()) ? -1 : 0;
 
+			// the underlying stream is flushed later
+			if (get(STREAM_DEFER_FLUSH)) return ret;
+
+			flushDeferred();
+
+			return ret;
+		}
+
+		void StreamConnection::StreamBuffer::flushDeferred()
+		{
 			try {
 				ibrcommon::MutexLock l(_sendlock);
 
@@ -337,8 +368,6 @@ namespace dtn
 
 				_conn.shutdown(CONNECTION_SHUTDOWN_ERROR);
 			}
-
-			return ret;
 		}
 
 		void StreamConnection::StreamBuffer::skipData(size_t &size)
@@ -440,6 +469,9 @@ namespace dtn
 
 							if (seg._flags & StreamDataSegment::MSG_MARK_BEGINN)
 							{
+								// the transmission of a new bundle starts now
+								::clock_gettime(CLOCK_MONOTONIC, &_recv_start);
+
 								_recv_size = seg._value;
 								unset(STREAM_REJECT);
 							}
@@ -500,6 +532,11 @@ namespace dtn
 
 									_conn.eventBundleAck(seg._value);
 
+									// measure the round-trip time of the segment
+									struct timespec now;
+									::clock_gettime(CLOCK_MONOTONIC, &now);
+									_conn.eventSegmentAck(((now.tv_sec - qs._sent.tv_sec) * 1000000) + ((now.tv_nsec - qs._sent.tv_nsec) / 1000));
+
 									q.pop();
 								}
 							}
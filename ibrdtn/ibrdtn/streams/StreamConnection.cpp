@@ -56,6 +56,21 @@ namespace dtn
 			_buf.keepalive();
 		}
 
+		void StreamConnection::deferFlush(bool enabled)
+		{
+			_buf.deferFlush(enabled);
+		}
+
+		void StreamConnection::flushDeferred()
+		{
+			_buf.flushDeferred();
+		}
+
+		u_int64_t StreamConnection::getReceiveStart() const
+		{
+			return _buf.getReceiveStart();
+		}
+
 		void StreamConnection::shutdown(ConnectionShutdownCases csc)
 		{
 			if (csc == CONNECTION_SHUTDOWN_SIMPLE_SHUTDOWN)
@@ -120,6 +135,11 @@ namespace dtn
 			_callback.eventBundleAck(ack);
 		}
 
+		void StreamConnection::eventSegmentAck(size_t rtt)
+		{
+			_callback.eventSegmentAck(rtt);
+		}
+
 		void StreamConnection::eventBundleRefused()
 		{
 			IBRCOMMON_LOGGER_DEBUG(20) << "bundle has been refused" << IBRCOMMON_LOGGER_ENDL;
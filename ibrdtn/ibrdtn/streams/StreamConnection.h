@@ -111,6 +111,12 @@ namespace dtn
 				 */
 				virtual void eventBundleAck(size_t ack) = 0;
 
+				/**
+				 * This method is called if a data segment is acknowledged.
+				 * @param rtt The round-trip time of the segment in microseconds.
+				 */
+				virtual void eventSegmentAck(size_t) { };
+
 				/**
 				 * This method is called if a handshake was successful.
 				 * @param header
@@ -182,6 +188,30 @@ namespace dtn
 			 */
 			void enableIdleTimeout(size_t seconds);
 
+			/**
+			 * If enabled, a flush of this stream completes the current bundle but
+			 * leaves the data in the buffer of the underlying stream. Many small
+			 * bundles are then written with a few large writes. A flush after
+			 * disabling this option writes out all buffered data.
+			 * @param enabled
+			 */
+			void deferFlush(bool enabled);
+
+			/**
+			 * Writes out the data left in the buffer of the underlying stream by
+			 * a deferred flush. Other than flush() this does not complete the
+			 * current bundle, thus it may be called by another thread while a
+			 * bundle is written.
+			 */
+			void flushDeferred();
+
+			/**
+			 * Returns the time when the first segment of the bundle, which is
+			 * currently received, has arrived.
+			 * @return The time in microseconds of the monotonic clock.
+			 */
+			u_int64_t getReceiveStart() const;
+
 		private:
 			/**
 			 * stream buffer class
@@ -251,6 +281,22 @@ namespace dtn
 				 */
 				void enableIdleTimeout(size_t seconds);
 
+				/**
+				 * do not flush the underlying stream on sync()
+				 * @param enabled
+				 */
+				void deferFlush(bool enabled);
+
+				/**
+				 * flush the underlying stream
+				 */
+				void flushDeferred();
+
+				/**
+				 * @see StreamConnection::getReceiveStart()
+				 */
+				u_int64_t getReceiveStart() const;
+
 			protected:
 				virtual int sync();
 				virtual int overflow(int = std::char_traits<char>::eof());
@@ -286,7 +332,8 @@ namespace dtn
 					STREAM_ACK_SUPPORT = 1 << 8,
 					STREAM_NACK_SUPPORT = 1 << 9,
 					STREAM_SOB = 1 << 10,			// start of bundle
-					STREAM_TIMER_SUPPORT = 1 << 11
+					STREAM_TIMER_SUPPORT = 1 << 11,
+					STREAM_DEFER_FLUSH = 1 << 12
 				};
 
 				void skipData(size_t &size);
@@ -313,6 +360,9 @@ namespace dtn
 
 				size_t _recv_size;
 
+				// arrival of the first segment of the current bundle
+				struct timespec _recv_start;
+
 				// this queue contains all sent data segments
 				// they are removed if an ack or nack is received
 				ibrcommon::Queue<StreamDataSegment> _segments;
@@ -329,6 +379,7 @@ namespace dtn
 			void eventShutdown(StreamConnection::ConnectionShutdownCases csc);
 
 			void eventBundleAck(size_t ack);
+			void eventSegmentAck(size_t rtt);
 			void eventBundleRefused();
 			void eventBundleForwarded();
 
@@ -15,17 +15,17 @@ namespace dtn
 	namespace streams
 	{
 		StreamDataSegment::StreamDataSegment(SegmentType type, size_t size)
-		 : _value(size), _type(type), _reason(MSG_SHUTDOWN_IDLE_TIMEOUT), _flags(0)
+		 : _value(size), _type(type), _reason(MSG_SHUTDOWN_IDLE_TIMEOUT), _flags(0), _sent()
 		{
 		}
 
 		StreamDataSegment::StreamDataSegment(SegmentType type)
-		: _value(0), _type(type), _reason(MSG_SHUTDOWN_IDLE_TIMEOUT), _flags(0)
+		: _value(0), _type(type), _reason(MSG_SHUTDOWN_IDLE_TIMEOUT), _flags(0), _sent()
 		{
 		}
 
 		StreamDataSegment::StreamDataSegment(ShutdownReason reason, size_t reconnect)
-		: _value(reconnect), _type(MSG_SHUTDOWN), _reason(reason), _flags(3)
+		: _value(reconnect), _type(MSG_SHUTDOWN), _reason(reason), _flags(3), _sent()
 		{
 		}
 
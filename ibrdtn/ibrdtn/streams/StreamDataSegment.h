@@ -10,6 +10,7 @@
 #define STREAMDATASEGMENT_H_
 
 #include <stdlib.h>
+#include <time.h>
 #include <iostream>
 
 namespace dtn
@@ -53,6 +54,9 @@ namespace dtn
 			ShutdownReason _reason;
 			u_int8_t _flags;
 
+			// time the segment has been sent, used to measure the round-trip time
+			struct timespec _sent;
+
 			friend std::ostream &operator<<(std::ostream &stream, const StreamDataSegment &seg);
 			friend std::istream &operator>>(std::istream &stream, StreamDataSegment &seg);
 		};
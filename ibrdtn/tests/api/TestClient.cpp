@@ -0,0 +1,294 @@
+/*
+ * TestClient.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "api/TestClient.h"
+
+#include <ibrdtn/api/Client.h>
+#include <ibrdtn/api/StringBundle.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/streams/StreamConnection.h>
+#include <ibrcommon/net/tcpserver.h>
+#include <ibrcommon/net/tcpclient.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/thread/Thread.h>
+#include <unistd.h>
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestClient);
+
+/**
+ * Accepts one API client and receives its bundles. While the server is
+ * held, no bundle is read and thus no bundle is acknowledged.
+ */
+class apiserver : public ibrcommon::tcpserver, public ibrcommon::JoinableThread, dtn::streams::StreamConnection::Callback
+{
+public:
+	apiserver(const ibrcommon::vinterface &net, int port, bool held)
+	 : ibrcommon::tcpserver(), recv_bundles(0), _held(held), _closed(false)
+	{
+		bind(net, port);
+	};
+
+	virtual ~apiserver() { join(); };
+
+	void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) {};
+	void eventTimeout() {};
+	void eventError() {};
+	void eventBundleRefused() {};
+	void eventBundleForwarded() {};
+	void eventBundleAck(size_t) {};
+	void eventConnectionUp(const dtn::streams::StreamContactHeader&) {};
+	void eventConnectionDown() {};
+
+	void release()
+	{
+		ibrcommon::MutexLock l(_cond);
+		_held = false;
+		_cond.signal(true);
+	}
+
+	void finish()
+	{
+		{
+			ibrcommon::MutexLock l(_cond);
+			_closed = true;
+			_cond.signal(true);
+		}
+
+		close();
+	}
+
+	unsigned int recv_bundles;
+
+protected:
+	void run()
+	{
+		ibrcommon::tcpstream *conn = accept();
+
+		// the banner and the protocol switch of the API
+		std::string buffer;
+		(*conn) << "IBR-DTN test API" << std::endl;
+		std::getline(*conn, buffer);
+
+		{
+			dtn::streams::StreamConnection stream(*this, *conn);
+			stream.handshake(dtn::data::EID("dtn:server"), 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+
+			try {
+				while (conn->good())
+				{
+					{
+						ibrcommon::MutexLock l(_cond);
+						while (_held && !_closed) _cond.wait();
+						if (_closed) break;
+					}
+
+					dtn::data::Bundle b;
+					dtn::data::DefaultDeserializer(stream) >> b;
+					recv_bundles++;
+				}
+			} catch (const std::exception&) {
+				// the client has gone
+			}
+
+			conn->close();
+		}
+
+		delete conn;
+	}
+
+private:
+	ibrcommon::Conditional _cond;
+	bool _held;
+	bool _closed;
+};
+
+/**
+ * Counts the results of the bundles sent with send().
+ */
+class apiclient : public dtn::api::Client
+{
+public:
+	apiclient(ibrcommon::tcpstream &stream)
+	 : dtn::api::Client("test", stream, dtn::api::Client::MODE_SENDONLY), completed(0), aborted(0)
+	{ };
+
+	virtual ~apiclient() { };
+
+	void eventTransferCompleted(const dtn::data::BundleID&)
+	{
+		ibrcommon::MutexLock l(_cond);
+		completed++;
+		_cond.signal(true);
+	}
+
+	void eventTransferAborted(const dtn::data::BundleID&)
+	{
+		ibrcommon::MutexLock l(_cond);
+		aborted++;
+		_cond.signal(true);
+	}
+
+	/**
+	 * Wait until the given number of bundles is completed.
+	 * @return False, if the bundles are not completed within the timeout.
+	 */
+	bool waitFor(unsigned int bundles, size_t timeout)
+	{
+		ibrcommon::MutexLock l(_cond);
+		try {
+			while (completed < bundles) _cond.wait(timeout);
+		} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+			return false;
+		}
+		return true;
+	}
+
+	unsigned int completed;
+	unsigned int aborted;
+
+private:
+	ibrcommon::Conditional _cond;
+};
+
+/**
+ * Sends bundles with send() in a thread of its own.
+ */
+class apisender : public ibrcommon::JoinableThread
+{
+public:
+	apisender(dtn::api::Client &client, unsigned int bundles)
+	 : _client(client), _bundles(bundles), _sent(0)
+	{ };
+
+	virtual ~apisender() { join(); };
+
+	unsigned int sent()
+	{
+		ibrcommon::MutexLock l(_lock);
+		return _sent;
+	}
+
+protected:
+	void run()
+	{
+		try {
+			for (unsigned int i = 0; i < _bundles; i++)
+			{
+				dtn::api::StringBundle b(dtn::data::EID("dtn://node/test"));
+				b.append("Hallo Welt");
+				_client.send(b);
+
+				ibrcommon::MutexLock l(_lock);
+				_sent++;
+			}
+		} catch (const dtn::api::ConnectionException&) { }
+	}
+
+private:
+	dtn::api::Client &_client;
+	unsigned int _bundles;
+	ibrcommon::Mutex _lock;
+	unsigned int _sent;
+};
+
+static void sendBundle(dtn::api::Client &client)
+{
+	dtn::api::StringBundle b(dtn::data::EID("dtn://node/test"));
+	b.append("Hallo Welt");
+	client.send(b);
+}
+
+void TestClient::setUp()
+{
+}
+
+void TestClient::tearDown()
+{
+}
+
+void TestClient::client_window_limit()
+{
+	ibrcommon::vinterface net("lo");
+	apiserver srv(net, 1236, true); srv.start();
+
+	ibrcommon::tcpclient conn("127.0.0.1", 1236);
+	apiclient client(conn);
+	client.connect();
+	client.setWindow(4);
+
+	{
+		apisender sender(client, 6);
+		sender.start();
+
+		// no bundle is acknowledged, thus the sender stops at the window
+		for (int i = 0; (i < 100) && (sender.sent() < 4); i++) ::usleep(10000);
+		::usleep(200000);
+		CPPUNIT_ASSERT_EQUAL(4U, sender.sent());
+		CPPUNIT_ASSERT_EQUAL(0U, client.completed);
+
+		// the acknowledgements open the window again
+		srv.release();
+	}
+
+	client.waitCompleted();
+	CPPUNIT_ASSERT_EQUAL(6U, client.completed);
+	CPPUNIT_ASSERT_EQUAL(0U, client.aborted);
+	CPPUNIT_ASSERT_EQUAL(6U, srv.recv_bundles);
+
+	client.close();
+	conn.close();
+	srv.finish();
+}
+
+void TestClient::client_abort_inflight()
+{
+	ibrcommon::vinterface net("lo");
+	apiserver srv(net, 1237, true); srv.start();
+
+	ibrcommon::tcpclient conn("127.0.0.1", 1237);
+	apiclient client(conn);
+	client.connect();
+	client.setWindow(8);
+
+	for (int i = 0; i < 3; i++) sendBundle(client);
+
+	// all unacknowledged bundles are aborted with the connection
+	client.abort();
+	CPPUNIT_ASSERT_EQUAL(0U, client.completed);
+	CPPUNIT_ASSERT_EQUAL(3U, client.aborted);
+
+	CPPUNIT_ASSERT_THROW(sendBundle(client), dtn::api::ConnectionAbortedException);
+	CPPUNIT_ASSERT_THROW(client.waitCompleted(), dtn::api::ConnectionAbortedException);
+
+	conn.close();
+	srv.finish();
+}
+
+void TestClient::client_partial_batch()
+{
+	ibrcommon::vinterface net("lo");
+	apiserver srv(net, 1238, false); srv.start();
+
+	ibrcommon::tcpclient conn("127.0.0.1", 1238);
+	apiclient client(conn);
+	client.connect();
+	client.setWindow(8, 4);
+
+	// a single bundle is flushed without waiting for the rest of the batch
+	sendBundle(client);
+	CPPUNIT_ASSERT(client.waitFor(1, 5000));
+
+	// the rest of a batch is flushed once the earlier bundles are acknowledged
+	for (int i = 0; i < 5; i++) sendBundle(client);
+	CPPUNIT_ASSERT(client.waitFor(6, 5000));
+	CPPUNIT_ASSERT_EQUAL(0U, client.aborted);
+
+	client.close();
+	conn.close();
+	srv.finish();
+}
@@ -0,0 +1,31 @@
+/*
+ * TestClient.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TESTCLIENT_H_
+#define TESTCLIENT_H_
+
+class TestClient : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestClient);
+	CPPUNIT_TEST (client_window_limit);
+	CPPUNIT_TEST (client_abort_inflight);
+	CPPUNIT_TEST (client_partial_batch);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void client_window_limit(void);
+	void client_abort_inflight(void);
+	void client_partial_batch(void);
+};
+
+#endif /* TESTCLIENT_H_ */
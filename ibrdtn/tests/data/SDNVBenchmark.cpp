@@ -0,0 +1,235 @@
+/*
+ * SDNVBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "data/SDNVBenchmark.h"
+#include <ibrdtn/data/SDNV.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdlib.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SDNVBenchmark);
+
+static const size_t BENCHMARK_VALUES = 1000000;
+static const size_t BENCHMARK_BUNDLES = 100000;
+
+static const u_int64_t values[] = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 1234567890, 0x7fffffffffffffffULL, 0xffffffffffffffffULL };
+static const size_t values_count = sizeof(values) / sizeof(u_int64_t);
+
+/**
+ * The stream operators of SDNV before the buffer codec, kept as reference
+ * for the benchmark. The length is taken from a trial encoding, each value
+ * is encoded into a buffer on the heap and read byte by byte.
+ */
+namespace legacy
+{
+	static int encode(u_int64_t val, u_char *bp, size_t len)
+	{
+		size_t val_len = 0;
+		u_int64_t tmp = val;
+
+		do {
+			tmp = tmp >> 7;
+			val_len++;
+		} while (tmp != 0);
+
+		if (len < val_len) return -1;
+
+		bp += val_len;
+		u_char high_bit = 0;
+		do {
+			--bp;
+			*bp = (u_char)(high_bit | (val & 0x7f));
+			high_bit = (1 << 7);
+			val = val >> 7;
+		} while (val != 0);
+
+		return val_len;
+	}
+
+	static size_t encoding_len(u_int64_t val)
+	{
+		u_char buf[16];
+		return encode(val, buf, sizeof(buf));
+	}
+
+	static int decode(const u_char *bp, size_t len, u_int64_t *val)
+	{
+		size_t val_len = 0;
+		*val = 0;
+
+		do {
+			if (len == 0) return -1;
+
+			*val = (*val << 7) | (*bp & 0x7f);
+			++val_len;
+
+			if ((*bp & (1 << 7)) == 0) break;
+
+			++bp;
+			--len;
+		} while (1);
+
+		return val_len;
+	}
+
+	static void write(std::ostream &stream, u_int64_t value)
+	{
+		size_t len = encoding_len(value);
+		char *data = (char*)calloc(len, sizeof(char));
+		encode(value, (u_char*)data, len);
+		stream.write(data, len);
+		free(data);
+	}
+
+	static u_int64_t read(std::istream &stream)
+	{
+		char sdnv[dtn::data::SDNV::MAX_LENGTH];
+		char *sdnv_buf = sdnv;
+		size_t sdnv_length = 0;
+
+		stream.read(sdnv_buf, sizeof(char));
+		sdnv_length++;
+
+		while (*sdnv_buf & 0x80)
+		{
+			sdnv_buf++;
+			stream.read(sdnv_buf, sizeof(char));
+			sdnv_length++;
+		}
+
+		u_int64_t value = 0;
+		decode((const u_char*)sdnv, sdnv_length, &value);
+		return value;
+	}
+}
+
+void SDNVBenchmark::setUp(void)
+{
+}
+
+void SDNVBenchmark::tearDown(void)
+{
+}
+
+void SDNVBenchmark::benchmark_sdnv(void)
+{
+	ibrcommon::TimeMeasurement tm;
+	u_int64_t sum = 0;
+
+	// encode and decode with the former stream operators
+	tm.start();
+	{
+		std::stringstream ss;
+		for (size_t i = 0; i < BENCHMARK_VALUES; i++)
+		{
+			legacy::write(ss, values[i % values_count]);
+		}
+
+		for (size_t i = 0; i < BENCHMARK_VALUES; i++)
+		{
+			sum += legacy::read(ss);
+		}
+	}
+	tm.stop();
+	const double legacy_ms = tm.getMilliseconds();
+
+	// encode and decode with the stream operators
+	tm.start();
+	{
+		std::stringstream ss;
+		for (size_t i = 0; i < BENCHMARK_VALUES; i++)
+		{
+			ss << dtn::data::SDNV(values[i % values_count]);
+		}
+
+		for (size_t i = 0; i < BENCHMARK_VALUES; i++)
+		{
+			dtn::data::SDNV sdnv;
+			ss >> sdnv;
+			sum -= sdnv.getValue();
+		}
+	}
+	tm.stop();
+	const double stream_ms = tm.getMilliseconds();
+
+	CPPUNIT_ASSERT_EQUAL((u_int64_t)0, sum);
+
+	// encode and decode with the buffer codec
+	tm.start();
+	{
+		std::vector<char> buffer(BENCHMARK_VALUES * dtn::data::SDNV::MAX_LENGTH);
+		char *pos = &buffer[0];
+
+		for (size_t i = 0; i < BENCHMARK_VALUES; i++)
+		{
+			pos = dtn::data::SDNV::write(pos, values[i % values_count]);
+		}
+
+		const char *end = pos;
+		const char *rpos = &buffer[0];
+		while (rpos < end)
+		{
+			u_int64_t value = 0;
+			rpos = dtn::data::SDNV::read(rpos, end, value);
+			sum += value;
+		}
+	}
+	tm.stop();
+	const double buffer_ms = tm.getMilliseconds();
+
+	// all ways have to decode the same values
+	u_int64_t expected = 0;
+	for (size_t i = 0; i < BENCHMARK_VALUES; i++) expected += values[i % values_count];
+	CPPUNIT_ASSERT_EQUAL(expected, sum);
+
+	std::cout << std::endl << BENCHMARK_VALUES << " SDNVs: "
+			<< legacy_ms << " ms with the former stream operators, "
+			<< stream_ms << " ms with stream operators, "
+			<< buffer_ms << " ms with the buffer codec" << std::endl;
+}
+
+void SDNVBenchmark::benchmark_primaryblock(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node1/app1");
+	b._destination = dtn::data::EID("dtn://node2/app2");
+	b._lifetime = 3600;
+	b._timestamp = 12345678;
+	b._sequencenumber = 1234;
+
+	const dtn::data::Dictionary dict(b);
+	ibrcommon::TimeMeasurement tm;
+	std::stringstream ss;
+
+	tm.start();
+	for (size_t i = 0; i < BENCHMARK_BUNDLES; i++)
+	{
+		dtn::data::DefaultSerializer(ss, dict) << (dtn::data::PrimaryBlock&)b;
+	}
+	tm.stop();
+	const double encode_ms = tm.getMilliseconds();
+
+	// each new primary block takes a sequence number, thus reuse one for all bundles
+	dtn::data::PrimaryBlock p;
+
+	tm.start();
+	for (size_t i = 0; i < BENCHMARK_BUNDLES; i++)
+	{
+		dtn::data::DefaultDeserializer(ss) >> p;
+		CPPUNIT_ASSERT_EQUAL(b._sequencenumber, p._sequencenumber);
+	}
+	tm.stop();
+	const double decode_ms = tm.getMilliseconds();
+
+	std::cout << std::endl << BENCHMARK_BUNDLES << " primary blocks: "
+			<< encode_ms << " ms to encode, "
+			<< decode_ms << " ms to decode" << std::endl;
+}
@@ -0,0 +1,37 @@
+/*
+ * SDNVBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef SDNVBENCHMARK_H_
+#define SDNVBENCHMARK_H_
+
+class SDNVBenchmark : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (SDNVBenchmark);
+	CPPUNIT_TEST (benchmark_sdnv);
+	CPPUNIT_TEST (benchmark_primaryblock);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	/**
+	 * Compares the former stream operators, the current stream operators
+	 * and the buffer codec.
+	 */
+	void benchmark_sdnv(void);
+
+	/**
+	 * Measures the serialization and deserialization of bundle headers.
+	 */
+	void benchmark_primaryblock(void);
+};
+
+#endif /* SDNVBENCHMARK_H_ */
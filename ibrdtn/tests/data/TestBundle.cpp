@@ -0,0 +1,215 @@
+/*
+ * TestBundle.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "data/TestBundle.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/data/ScopeControlHopLimitBlock.h>
+#include <ibrdtn/data/StatusReportBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestBundle);
+
+/**
+ * A payload block of its own class.
+ */
+class DerivedPayloadBlock : public dtn::data::PayloadBlock
+{
+public:
+	DerivedPayloadBlock() { };
+	virtual ~DerivedPayloadBlock() { };
+};
+
+void TestBundle::setUp(void)
+{
+}
+
+void TestBundle::tearDown(void)
+{
+}
+
+void TestBundle::copyTest(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://source/app");
+	b._destination = dtn::data::EID("dtn://destination/app");
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	(*ref.iostream()) << "Hallo Welt!" << std::flush;
+	b.push_back(ref);
+
+	dtn::data::Bundle copy = b;
+
+	// the copy refers to the same blocks
+	CPPUNIT_ASSERT_EQUAL(b.blockCount(), copy.blockCount());
+	CPPUNIT_ASSERT(&b.getBlock<dtn::data::PayloadBlock>() == &copy.getBlock<dtn::data::PayloadBlock>());
+
+	// the primary block is not shared
+	copy._custodian = dtn::data::EID("dtn://custodian");
+	CPPUNIT_ASSERT(b._custodian != copy._custodian);
+
+	// both serialize to the same length except for the custodian
+	std::stringstream ss1, ss2;
+	dtn::data::DefaultSerializer(ss1) << b;
+	copy._custodian = b._custodian;
+	dtn::data::DefaultSerializer(ss2) << copy;
+	CPPUNIT_ASSERT_EQUAL(ss1.str(), ss2.str());
+}
+
+void TestBundle::copyPushTest(void)
+{
+	dtn::data::Bundle b;
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	const size_t blocks = b.blockCount();
+
+	dtn::data::Bundle copy = b;
+	copy.push_back(ref);
+	copy.push_front(ref);
+
+	// the blocks added to the copy are not part of the original
+	CPPUNIT_ASSERT_EQUAL(blocks, b.blockCount());
+	CPPUNIT_ASSERT_EQUAL(blocks + 2, copy.blockCount());
+
+	// a copy of the copy keeps the changes
+	dtn::data::Bundle copy2 = copy;
+	CPPUNIT_ASSERT_EQUAL(blocks + 2, copy2.blockCount());
+
+	copy.clearBlocks();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, copy.blockCount());
+	CPPUNIT_ASSERT_EQUAL(blocks + 2, copy2.blockCount());
+	CPPUNIT_ASSERT_EQUAL(blocks, b.blockCount());
+}
+
+void TestBundle::copyRemoveTest(void)
+{
+	dtn::data::Bundle b;
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	const size_t blocks = b.blockCount();
+
+	dtn::data::Bundle copy = b;
+	copy.remove(copy.getBlock<dtn::data::PayloadBlock>());
+
+	// the original still has its payload
+	CPPUNIT_ASSERT_EQUAL(blocks, b.blockCount());
+	CPPUNIT_ASSERT(b.has<dtn::data::PayloadBlock>());
+
+	CPPUNIT_ASSERT_EQUAL(blocks - 1, copy.blockCount());
+	CPPUNIT_ASSERT(!copy.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_THROW(copy.getBlock<dtn::data::PayloadBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+}
+
+void TestBundle::assignTest(void)
+{
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+
+	dtn::data::Bundle b1;
+	b1.push_back(ref);
+
+	dtn::data::Bundle b2;
+	b2.push_back(ref);
+	b2.push_back(ref);
+
+	const size_t blocks = b2.blockCount();
+
+	b1 = b2;
+	CPPUNIT_ASSERT_EQUAL(blocks, b1.blockCount());
+
+	// assigning a bundle to itself keeps its blocks
+	b1 = b1;
+	CPPUNIT_ASSERT_EQUAL(blocks, b1.blockCount());
+
+	b2.remove(b2.getBlock<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_EQUAL(blocks, b1.blockCount());
+	CPPUNIT_ASSERT_EQUAL(blocks - 1, b2.blockCount());
+}
+
+void TestBundle::indexTest(void)
+{
+	dtn::data::Bundle b;
+	b.clearBlocks();
+
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_THROW(b.getBlock<dtn::data::PayloadBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+
+	dtn::data::PayloadBlock &p1 = b.push_back<dtn::data::PayloadBlock>();
+	dtn::data::ScopeControlHopLimitBlock &s1 = b.push_back<dtn::data::ScopeControlHopLimitBlock>();
+	dtn::data::PayloadBlock &p2 = b.push_back<dtn::data::PayloadBlock>();
+
+	CPPUNIT_ASSERT(&p1 == &b.getBlock<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(&s1 == &b.getBlock<dtn::data::ScopeControlHopLimitBlock>());
+	CPPUNIT_ASSERT(!b.has<dtn::data::AgeBlock>());
+
+	// blocks in front of the others move the positions
+	dtn::data::PayloadBlock &p0 = b.push_front<dtn::data::PayloadBlock>();
+	dtn::data::ScopeControlHopLimitBlock &s0 = b.insert<dtn::data::ScopeControlHopLimitBlock>(p1);
+
+	CPPUNIT_ASSERT(&p0 == &b.getBlock<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(&s0 == &b.getBlock<dtn::data::ScopeControlHopLimitBlock>());
+	CPPUNIT_ASSERT_EQUAL((size_t)3, b.getBlockView<dtn::data::PayloadBlock>().size());
+
+	// the next block of the type is found after a removal
+	b.remove(p0);
+	CPPUNIT_ASSERT(&p1 == &b.getBlock<dtn::data::PayloadBlock>());
+
+	b.remove(s0);
+	CPPUNIT_ASSERT(&s1 == &b.getBlock<dtn::data::ScopeControlHopLimitBlock>());
+
+	b.remove(p1);
+	CPPUNIT_ASSERT(&p2 == &b.getBlock<dtn::data::PayloadBlock>());
+
+	b.remove(p2);
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_THROW(b.getBlock<dtn::data::PayloadBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+	CPPUNIT_ASSERT(b.has<dtn::data::ScopeControlHopLimitBlock>());
+}
+
+void TestBundle::indexSubclassTest(void)
+{
+	dtn::data::Bundle b;
+	b.clearBlocks();
+
+	// a status report has the type of a payload block, but is no payload block
+	b.push_back<dtn::data::StatusReportBlock>();
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(b.getBlockView<dtn::data::PayloadBlock>().empty());
+	CPPUNIT_ASSERT_THROW(b.getBlock<dtn::data::PayloadBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+
+	// a subclass is a payload block
+	DerivedPayloadBlock &p = b.push_back<DerivedPayloadBlock>();
+	CPPUNIT_ASSERT(b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(&p == &b.getBlock<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks<dtn::data::PayloadBlock>().size());
+}
+
+void TestBundle::indexLimitTest(void)
+{
+	dtn::data::Bundle b;
+	b.clearBlocks();
+
+	for (int i = 0; i < 300; i++)
+	{
+		b.push_back<dtn::data::ScopeControlHopLimitBlock>();
+	}
+
+	dtn::data::PayloadBlock &p1 = b.push_back<dtn::data::PayloadBlock>();
+	dtn::data::PayloadBlock &p2 = b.push_back<dtn::data::PayloadBlock>();
+	CPPUNIT_ASSERT(&p1 == &b.getBlock<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(!b.has<dtn::data::AgeBlock>());
+
+	b.remove(p1);
+	CPPUNIT_ASSERT(&p2 == &b.getBlock<dtn::data::PayloadBlock>());
+
+	b.remove(p2);
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+}
@@ -0,0 +1,52 @@
+/*
+ * TestBundle.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TESTBUNDLE_H_
+#define TESTBUNDLE_H_
+
+class TestBundle : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestBundle);
+	CPPUNIT_TEST (copyTest);
+	CPPUNIT_TEST (copyPushTest);
+	CPPUNIT_TEST (copyRemoveTest);
+	CPPUNIT_TEST (assignTest);
+	CPPUNIT_TEST (indexTest);
+	CPPUNIT_TEST (indexSubclassTest);
+	CPPUNIT_TEST (indexLimitTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void copyTest(void);
+	void copyPushTest(void);
+	void copyRemoveTest(void);
+	void assignTest(void);
+
+	/**
+	 * The first block of each type is found after blocks have been added and removed.
+	 */
+	void indexTest(void);
+
+	/**
+	 * Blocks of a type are found through their subclasses, other classes with
+	 * the same block type are skipped.
+	 */
+	void indexSubclassTest(void);
+
+	/**
+	 * Blocks behind the positions of the index are found.
+	 */
+	void indexLimitTest(void);
+};
+
+#endif /* TESTBUNDLE_H_ */
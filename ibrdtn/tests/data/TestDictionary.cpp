@@ -8,6 +8,7 @@
 #include "data/TestDictionary.h"
 #include <ibrdtn/data/EID.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION (TestDictionary);
@@ -37,3 +38,29 @@ void TestDictionary::mainTest(void)
 
 	CPPUNIT_ASSERT(ref1.second == 4);
 }
+
+void TestDictionary::loadTest(void)
+{
+	dtn::data::Dictionary dict;
+	dict.add( dtn::data::EID("dtn://node1/app1") );
+	dict.add( dtn::data::EID("dtn://node2/app2") );
+
+	std::stringstream ss;
+	ss << dict;
+
+	dtn::data::Dictionary loaded;
+	ss >> loaded;
+
+	CPPUNIT_ASSERT_EQUAL(dict.getSize(), loaded.getSize());
+
+	// references of the loaded dictionary have to match the origin
+	std::pair<size_t, size_t> ref = dict.getRef( dtn::data::EID("dtn://node2/app2") );
+	CPPUNIT_ASSERT(ref == loaded.getRef( dtn::data::EID("dtn://node2/app2") ));
+	CPPUNIT_ASSERT(loaded.get(ref.first, ref.second) == dtn::data::EID("dtn://node2/app2"));
+
+	// a copy continues with the same offsets
+	dtn::data::Dictionary copy = loaded;
+	copy.add( dtn::data::EID("dtn://node3/app3") );
+	CPPUNIT_ASSERT(ref == copy.getRef( dtn::data::EID("dtn://node2/app2") ));
+	CPPUNIT_ASSERT(copy.getSize() > loaded.getSize());
+}
@@ -17,6 +17,7 @@ class TestDictionary : public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (TestDictionary);
 	CPPUNIT_TEST (mainTest);
+	CPPUNIT_TEST (loadTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -25,6 +26,7 @@ public:
 
 protected:
 	void mainTest(void);
+	void loadTest(void);
 
 };
 
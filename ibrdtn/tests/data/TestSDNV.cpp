@@ -0,0 +1,64 @@
+/*
+ * TestSDNV.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "data/TestSDNV.h"
+#include <ibrdtn/data/SDNV.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestSDNV);
+
+static const u_int64_t values[] = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 1234567890, 0x7fffffffffffffffULL, 0xffffffffffffffffULL };
+static const size_t values_count = sizeof(values) / sizeof(u_int64_t);
+
+void TestSDNV::setUp(void)
+{
+}
+
+void TestSDNV::tearDown(void)
+{
+}
+
+void TestSDNV::buffer_roundtrip(void)
+{
+	for (size_t i = 0; i < values_count; i++)
+	{
+		char data[dtn::data::SDNV::MAX_LENGTH];
+		const char *end = dtn::data::SDNV::write(data, values[i]);
+
+		// the buffer codec has to produce the same data as the stream operators
+		std::stringstream ss;
+		ss << dtn::data::SDNV(values[i]);
+		CPPUNIT_ASSERT_EQUAL(ss.str(), std::string(data, end - data));
+		CPPUNIT_ASSERT_EQUAL(dtn::data::SDNV(values[i]).getLength(), (size_t)(end - data));
+
+		u_int64_t value = 0;
+		CPPUNIT_ASSERT(dtn::data::SDNV::read(data, end, value) == end);
+		CPPUNIT_ASSERT_EQUAL(values[i], value);
+
+		dtn::data::SDNV sdnv;
+		ss >> sdnv;
+		CPPUNIT_ASSERT_EQUAL(values[i], sdnv.getValue());
+	}
+}
+
+void TestSDNV::buffer_invalid(void)
+{
+	char data[dtn::data::SDNV::MAX_LENGTH + 1];
+	const char *end = dtn::data::SDNV::write(data, 16384);
+	u_int64_t value = 0;
+
+	// the buffer ends within the SDNV
+	CPPUNIT_ASSERT_THROW(dtn::data::SDNV::read(data, end - 1, value), dtn::InvalidDataException);
+
+	// the value does not fit into 64 bits
+	for (size_t i = 0; i < dtn::data::SDNV::MAX_LENGTH; i++) data[i] = (char)0xff;
+	data[dtn::data::SDNV::MAX_LENGTH] = 0x01;
+	CPPUNIT_ASSERT_THROW(dtn::data::SDNV::read(data, data + sizeof(data), value), dtn::InvalidDataException);
+}
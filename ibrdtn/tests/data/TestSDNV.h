@@ -0,0 +1,29 @@
+/*
+ * TestSDNV.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TESTSDNV_H_
+#define TESTSDNV_H_
+
+class TestSDNV : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestSDNV);
+	CPPUNIT_TEST (buffer_roundtrip);
+	CPPUNIT_TEST (buffer_invalid);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void buffer_roundtrip(void);
+	void buffer_invalid(void);
+};
+
+#endif /* TESTSDNV_H_ */
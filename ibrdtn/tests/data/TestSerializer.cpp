@@ -13,6 +13,7 @@
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/Serializer.h>
 #include <ibrdtn/data/BundleFragment.h>
+#include <ibrdtn/data/AgeBlock.h>
 #include <iostream>
 #include <sstream>
 
@@ -124,6 +125,138 @@ void TestSerializer::serializer_bundle_length(void)
 	CPPUNIT_ASSERT_EQUAL(ds.getLength(b), ss.str().length());
 }
 
+void TestSerializer::serializer_dictionary_cache(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node1/app1");
+	b._destination = dtn::data::EID("dtn://node2/app2");
+	b._lifetime = 3600;
+	b._timestamp = 12345678;
+	b._sequencenumber = 1234;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	dtn::data::PayloadBlock &p = b.push_back(ref);
+
+	const size_t size = b.getDictionary().getSize();
+
+	// a change of a primary EID has to invalidate the cached dictionary
+	b._reportto = dtn::data::EID("dtn://node3/reports");
+	CPPUNIT_ASSERT(b.getDictionary().getSize() > size);
+
+	// a new EID of a block has to invalidate the cached dictionary
+	const size_t size_reportto = b.getDictionary().getSize();
+	p.addEID(dtn::data::EID("dtn://node4/app4"));
+	CPPUNIT_ASSERT(b.getDictionary().getSize() > size_reportto);
+
+	// the removal of a block has to invalidate the cached dictionary
+	b.remove(p);
+	CPPUNIT_ASSERT_EQUAL(size_reportto, b.getDictionary().getSize());
+
+	// repeated serialization of an unchanged bundle has the same result
+	std::stringstream ss1, ss2;
+	dtn::data::DefaultSerializer(ss1) << b;
+	dtn::data::DefaultSerializer(ss2) << b;
+	CPPUNIT_ASSERT_EQUAL(ss1.str(), ss2.str());
+}
+
+static size_t getSerializedLength(const dtn::data::Bundle &b)
+{
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+	return ss.str().length();
+}
+
+void TestSerializer::serializer_length_cache(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node1/app1");
+	b._destination = dtn::data::EID("dtn://node2/app2");
+	b._lifetime = 3600;
+	b._timestamp = 12345678;
+	b._sequencenumber = 1234;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	std::stringstream ss;
+	dtn::data::DefaultSerializer ds(ss);
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(b), ds.getLength(b));
+
+	// the cached length of the primary block follows a change of its values
+	b._lifetime = 1ULL << 40;
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(b), ds.getLength(b));
+
+	b.set(dtn::data::PrimaryBlock::FRAGMENT, true);
+	b._fragmentoffset = 100000;
+	b._appdatalength = 200000;
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(b), ds.getLength(b));
+
+	// and a change of the dictionary
+	b._custodian = dtn::data::EID("dtn://custodian-with-a-long-name/app");
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(b), ds.getLength(b));
+
+	// a copy starts without a cache and does not change the cache of the original
+	dtn::data::Bundle copy = b;
+	copy._destination = dtn::data::EID("dtn://node-with-a-long-name/app");
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(copy), ds.getLength(copy));
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(b), ds.getLength(b));
+	CPPUNIT_ASSERT(ds.getLength(copy) > ds.getLength(b));
+
+	// an assigned bundle drops its cache
+	copy = b;
+	CPPUNIT_ASSERT_EQUAL(ds.getLength(b), ds.getLength(copy));
+
+	// compressed bundles are measured in compressed form
+	dtn::data::Bundle cbhe;
+	cbhe._source = dtn::data::EID("ipn:1.2");
+	cbhe._destination = dtn::data::EID("ipn:2.3");
+	cbhe.push_back(ref);
+	CPPUNIT_ASSERT_EQUAL(getSerializedLength(cbhe), dtn::data::DefaultSerializer(ss).getLength(cbhe));
+}
+
+void TestSerializer::serializer_block_index(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://node1/app1");
+	b._destination = dtn::data::EID("dtn://node2/app2");
+	b._lifetime = 3600;
+
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(b.getBlockView<dtn::data::AgeBlock>().empty());
+	CPPUNIT_ASSERT_THROW(b.getBlock<dtn::data::PayloadBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	dtn::data::PayloadBlock &p = b.push_back(ref);
+	dtn::data::AgeBlock &a1 = b.push_front<dtn::data::AgeBlock>();
+	b.insert<dtn::data::AgeBlock>(p);
+
+	CPPUNIT_ASSERT(b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(b.has<dtn::data::AgeBlock>());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, b.getBlockView<dtn::data::AgeBlock>().size());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlockView<dtn::data::PayloadBlock>().size());
+	CPPUNIT_ASSERT(&b.getBlock(2) == &p);
+
+	// the view keeps the order of the blocks
+	CPPUNIT_ASSERT(&(*b.getBlockView<dtn::data::AgeBlock>().begin()) == &a1);
+
+	// the index has to survive the serialization
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+
+	dtn::data::Bundle b2;
+	dtn::data::DefaultDeserializer(ss) >> b2;
+	CPPUNIT_ASSERT(b2.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, b2.getBlocks<dtn::data::AgeBlock>().size());
+
+	// removed blocks have to disappear from the index
+	b.remove(p);
+	CPPUNIT_ASSERT(!b.has<dtn::data::PayloadBlock>());
+	CPPUNIT_ASSERT(b.has<dtn::data::AgeBlock>());
+
+	b.clearBlocks();
+	CPPUNIT_ASSERT(!b.has<dtn::data::AgeBlock>());
+}
+
 void TestSerializer::serializer_fragment_one(void)
 {
 	dtn::data::Bundle b;
@@ -167,3 +300,44 @@ void TestSerializer::serializer_fragment_one(void)
 		CPPUNIT_ASSERT_EQUAL(fb.getBlock<dtn::data::PayloadBlock>().getLength(), (size_t)100);
 	}
 }
+
+void TestSerializer::serializer_primary_length(void)
+{
+	// a primary block announcing a huge length is rejected before any allocation
+	{
+		std::stringstream ss;
+		ss.put(dtn::data::BUNDLE_VERSION);
+		ss << dtn::data::SDNV(0);
+		ss << dtn::data::SDNV(1ULL << 40);
+
+		dtn::data::PrimaryBlock pb;
+		CPPUNIT_ASSERT_THROW(dtn::data::DefaultDeserializer(ss) >> pb, dtn::InvalidDataException);
+	}
+
+	// one byte above the limit is rejected, even if the data is complete
+	{
+		std::stringstream ss;
+		ss.put(dtn::data::BUNDLE_VERSION);
+		ss << dtn::data::SDNV(0);
+		ss << dtn::data::SDNV(dtn::data::DefaultDeserializer::MAX_PRIMARY_BLOCK_LENGTH + 1);
+		ss << std::string(dtn::data::DefaultDeserializer::MAX_PRIMARY_BLOCK_LENGTH + 1, '\0');
+
+		dtn::data::PrimaryBlock pb;
+		CPPUNIT_ASSERT_THROW(dtn::data::DefaultDeserializer(ss) >> pb, dtn::InvalidDataException);
+	}
+
+	// a regular bundle still passes
+	{
+		dtn::data::Bundle b;
+		b._source = dtn::data::EID("dtn://node1/app1");
+		b._destination = dtn::data::EID("dtn://node2/app2");
+
+		// the references of the primary block point into the dictionary of the bundle
+		std::stringstream ss;
+		dtn::data::DefaultSerializer(ss, b.getDictionary()) << (const dtn::data::PrimaryBlock&)b;
+
+		dtn::data::PrimaryBlock pb;
+		dtn::data::DefaultDeserializer(ss) >> pb;
+		CPPUNIT_ASSERT_EQUAL(b._source.getString(), pb._source.getString());
+	}
+}
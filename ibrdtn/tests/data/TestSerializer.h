@@ -18,7 +18,11 @@ class TestSerializer : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (serializer_cbhe01);
 	CPPUNIT_TEST (serializer_cbhe02);
 	CPPUNIT_TEST (serializer_bundle_length);
+	CPPUNIT_TEST (serializer_dictionary_cache);
+	CPPUNIT_TEST (serializer_length_cache);
+	CPPUNIT_TEST (serializer_block_index);
 	CPPUNIT_TEST (serializer_fragment_one);
+	CPPUNIT_TEST (serializer_primary_length);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -31,8 +35,12 @@ protected:
 	void serializer_cbhe02(void);
 
 	void serializer_bundle_length(void);
+	void serializer_dictionary_cache(void);
+	void serializer_length_cache(void);
+	void serializer_block_index(void);
 
 	void serializer_fragment_one(void);
+	void serializer_primary_length(void);
 };
 
 #endif /* TESTSERIALIZER_H_ */
@@ -27,12 +27,22 @@ void TestStreamConnection::tearDown()
 }
 
 void TestStreamConnection::connectionUpDown()
+{
+	transfer(1234, 2000, 8192, false);
+}
+
+void TestStreamConnection::deferredFlush()
+{
+	transfer(1235, 2000, 64, true);
+}
+
+void TestStreamConnection::transfer(int port, unsigned int bundles, int size, bool deferred)
 {
 	class testserver : public ibrcommon::tcpserver, public ibrcommon::JoinableThread, dtn::streams::StreamConnection::Callback
 	{
 	public:
-		testserver(ibrcommon::File &file) : ibrcommon::tcpserver(file), recv_bundles(0) {};
-		testserver(const ibrcommon::vinterface &net, int port) : ibrcommon::tcpserver(), recv_bundles(0)
+		testserver(ibrcommon::File &file) : ibrcommon::tcpserver(file), recv_bundles(0), bad_start(0) {};
+		testserver(const ibrcommon::vinterface &net, int port) : ibrcommon::tcpserver(), recv_bundles(0), bad_start(0)
 		{
 			bind(net, port);
 		};
@@ -53,6 +63,9 @@ void TestStreamConnection::connectionUpDown()
 
 		unsigned int recv_bundles;
 
+		// bundles without a plausible start of the reception
+		unsigned int bad_start;
+
 	protected:
 		void run()
 		{
@@ -62,12 +75,23 @@ void TestStreamConnection::connectionUpDown()
 			// do the handshake
 			stream.handshake(dtn::data::EID("dtn:server"), 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
 
+			u_int64_t last = 0;
+
 			while (conn->good())
 			{
 				dtn::data::Bundle b;
 				dtn::data::DefaultDeserializer(stream) >> b;
 //				std::cout << "server: bundle received" << std::endl;
 				recv_bundles++;
+
+				// the reception starts with the first segment of each bundle
+				struct timespec ts;
+				::clock_gettime(CLOCK_MONOTONIC, &ts);
+				const u_int64_t now = ((u_int64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+				const u_int64_t start = stream.getReceiveStart();
+
+				if ((start == 0) || (start < last) || (start > now)) bad_start++;
+				last = start;
 			}
 		}
 	};
@@ -131,6 +155,12 @@ void TestStreamConnection::connectionUpDown()
 			dtn::data::DefaultSerializer(_stream) << b; _stream << std::flush;
 		}
 
+		void defer(bool enabled)
+		{
+			_stream.deferFlush(enabled);
+			if (!enabled) _stream.flush();
+		}
+
 		void close()
 		{
 			_stream.shutdown();
@@ -151,22 +181,29 @@ void TestStreamConnection::connectionUpDown()
 
 	ibrcommon::vinterface net("lo");
 	ibrcommon::File socket("/tmp/testsuite.sock");
-	testserver srv(net, 1234); srv.start();
+	testserver srv(net, port); srv.start();
 
-	ibrcommon::tcpclient conn("127.0.0.1", 1234);
+	ibrcommon::tcpclient conn("127.0.0.1", port);
 	testclient cl(conn);
 	cl.handshake();
 	cl.start();
 
-	for (int i = 0; i < 2000; i++)
+	// write the bundles in large chunks
+	if (deferred) cl.defer(true);
+
+	for (unsigned int i = 0; i < bundles; i++)
 	{
-		cl.send(8192);
+		cl.send(size);
 	}
 
+	// write out the remaining data
+	if (deferred) cl.defer(false);
+
 	cl.close();
 	conn.close();
 	srv.close();
 
-	CPPUNIT_ASSERT_EQUAL((unsigned int) 2000, srv.recv_bundles);
+	CPPUNIT_ASSERT_EQUAL(bundles, srv.recv_bundles);
+	CPPUNIT_ASSERT_EQUAL(0U, srv.bad_start);
 }
 
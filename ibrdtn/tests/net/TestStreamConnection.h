@@ -15,6 +15,7 @@ class TestStreamConnection : public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (TestStreamConnection);
 	CPPUNIT_TEST (connectionUpDown);
+	CPPUNIT_TEST (deferredFlush);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -23,6 +24,10 @@ public:
 
 protected:
 	void connectionUpDown(void);
+	void deferredFlush(void);
+
+private:
+	void transfer(int port, unsigned int bundles, int size, bool deferred);
 };
 
 
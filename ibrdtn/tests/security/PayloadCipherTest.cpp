@@ -0,0 +1,84 @@
+/*
+ * PayloadCipherTest.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "security/PayloadCipherTest.h"
+#include <ibrdtn/security/PayloadCipher.h>
+#include <ibrcommon/ssl/AES128Stream.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PayloadCipherTest);
+
+// the bytes of the salt differ, thus a swapped byte order changes the nonce
+static const u_int32_t test_salt = 0x01020304;
+static const unsigned char test_key[dtn::security::PayloadCipher::key_size_in_bytes] = {
+		0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+
+void PayloadCipherTest::setUp(void)
+{
+	// more than one block of AES and not a multiple of it
+	_testdata.clear();
+	for (int i = 0; i < 100; i++) _testdata += "Hallo Welt!";
+}
+
+void PayloadCipherTest::tearDown(void)
+{
+}
+
+void PayloadCipherTest::roundtripTest(void)
+{
+	std::stringstream ss(_testdata);
+
+	dtn::security::PayloadCipher encrypt(dtn::security::PayloadCipher::CIPHER_ENCRYPT, test_key, test_salt);
+	encrypt.process(ss);
+
+	unsigned char iv[dtn::security::PayloadCipher::iv_len]; encrypt.getIV(iv);
+	unsigned char tag[dtn::security::PayloadCipher::tag_len]; encrypt.getTag(tag);
+	CPPUNIT_ASSERT(ss.str() != _testdata);
+
+	dtn::security::PayloadCipher decrypt(dtn::security::PayloadCipher::CIPHER_DECRYPT, test_key, test_salt, iv);
+	decrypt.process(ss);
+
+	CPPUNIT_ASSERT(decrypt.verify(tag));
+	CPPUNIT_ASSERT(_testdata == ss.str());
+}
+
+void PayloadCipherTest::fromAES128StreamTest(void)
+{
+	// encrypt with the stream, as nodes without the payload cipher do
+	std::stringstream ciphertext;
+	ibrcommon::AES128Stream encrypt(ibrcommon::CipherStream::CIPHER_ENCRYPT, ciphertext, test_key, test_salt);
+	encrypt << _testdata << std::flush;
+
+	unsigned char iv[ibrcommon::AES128Stream::iv_len]; encrypt.getIV(iv);
+	unsigned char tag[ibrcommon::AES128Stream::tag_len]; encrypt.getTag(tag);
+
+	std::stringstream ss(ciphertext.str());
+	dtn::security::PayloadCipher decrypt(dtn::security::PayloadCipher::CIPHER_DECRYPT, test_key, test_salt, iv);
+	decrypt.process(ss);
+
+	CPPUNIT_ASSERT(decrypt.verify(tag));
+	CPPUNIT_ASSERT(_testdata == ss.str());
+}
+
+void PayloadCipherTest::toAES128StreamTest(void)
+{
+	std::stringstream ss(_testdata);
+	dtn::security::PayloadCipher encrypt(dtn::security::PayloadCipher::CIPHER_ENCRYPT, test_key, test_salt);
+	encrypt.process(ss);
+
+	unsigned char iv[dtn::security::PayloadCipher::iv_len]; encrypt.getIV(iv);
+	unsigned char tag[dtn::security::PayloadCipher::tag_len]; encrypt.getTag(tag);
+
+	// decrypt with the stream, as nodes without the payload cipher do
+	std::stringstream plaintext;
+	ibrcommon::AES128Stream decrypt(ibrcommon::CipherStream::CIPHER_DECRYPT, plaintext, test_key, test_salt, iv);
+	decrypt << ss.str() << std::flush;
+
+	CPPUNIT_ASSERT(decrypt.verify(tag));
+	CPPUNIT_ASSERT(_testdata == plaintext.str());
+}
@@ -0,0 +1,35 @@
+/*
+ * PayloadCipherTest.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#ifndef PAYLOADCIPHERTEST_H_
+#define PAYLOADCIPHERTEST_H_
+
+class PayloadCipherTest : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (PayloadCipherTest);
+	CPPUNIT_TEST (roundtripTest);
+	CPPUNIT_TEST (fromAES128StreamTest);
+	CPPUNIT_TEST (toAES128StreamTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void roundtripTest(void);
+	void fromAES128StreamTest(void);
+	void toAES128StreamTest(void);
+
+private:
+	std::string _testdata;
+};
+
+#endif /* PAYLOADCIPHERTEST_H_ */
@@ -7,10 +7,13 @@
 
 #include "security/PayloadConfidentialBlockTest.h"
 #include <ibrdtn/security/PayloadConfidentialBlock.h>
+#include <ibrdtn/security/PayloadIntegrityBlock.h>
+#include <ibrdtn/security/ChunkedPayloadCipher.h>
 #include <ibrdtn/security/SecurityKey.h>
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/Serializer.h>
 #include <ibrcommon/data/File.h>
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -22,10 +25,21 @@ CPPUNIT_TEST_SUITE_REGISTRATION (PayloadConfidentialBlockTest);
 void PayloadConfidentialBlockTest::setUp(void)
 {
 	_testdata = "Hallo Welt!";
+
+	// the node dtn://source owns the test key
+	_pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	_pubkey.file = ibrcommon::File("test-key.pem");
+	_pubkey.reference = dtn::data::EID("dtn://source");
+
+	_pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	_pkey.file = ibrcommon::File("test-key.pem");
+	_pkey.reference = _pubkey.reference;
 }
 
 void PayloadConfidentialBlockTest::tearDown(void)
 {
+	dtn::security::PayloadConfidentialBlock::chunk_size = 0;
+	dtn::security::PayloadConfidentialBlock::chunk_threads = 0;
 }
 
 void PayloadConfidentialBlockTest::encryptTest(void)
@@ -176,3 +190,251 @@ void PayloadConfidentialBlockTest::decryptTest(void)
 	// check the number of block, should be one
 	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks().size());
 }
+
+std::string PayloadConfidentialBlockTest::getChunkedData(const size_t chunks)
+{
+	// the last chunk is not full
+	const size_t length = (chunks * dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE) - 100;
+
+	std::string data;
+	while (data.length() < length) data += _testdata;
+	data.resize(length);
+
+	return data;
+}
+
+dtn::data::PayloadBlock& PayloadConfidentialBlockTest::createBundle(dtn::data::Bundle &b, const std::string &data)
+{
+	b._source = _pubkey.reference + "/test";
+	b._destination = dtn::data::EID("dtn://destination/test");
+
+	dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+	(*p.getBLOB().iostream()) << data << std::flush;
+
+	return p;
+}
+
+std::string PayloadConfidentialBlockTest::getPayload(const dtn::data::Bundle &b)
+{
+	const dtn::data::PayloadBlock &p = b.getBlock<dtn::data::PayloadBlock>();
+	ibrcommon::BLOB::Reference ref = p.getBLOB();
+	ibrcommon::BLOB::iostream stream = ref.iostream();
+	std::stringstream ss; ss << (*stream).rdbuf();
+	return ss.str();
+}
+
+void PayloadConfidentialBlockTest::setPayload(dtn::data::Bundle &b, const std::string &data)
+{
+	dtn::data::PayloadBlock &p = b.getBlock<dtn::data::PayloadBlock>();
+	ibrcommon::BLOB::iostream stream = p.getBLOB().iostream();
+	(*stream).seekp(0);
+	(*stream) << data << std::flush;
+}
+
+void PayloadConfidentialBlockTest::encryptSignTest(void)
+{
+	dtn::data::Bundle b;
+	createBundle(b, _testdata);
+
+	// encrypt and sign within one pass
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source, _pkey);
+
+	// PIB, PCB and payload
+	CPPUNIT_ASSERT_EQUAL((size_t)3, b.getBlocks().size());
+	CPPUNIT_ASSERT(getPayload(b) != _testdata);
+
+	// the signature covers the encrypted payload
+	dtn::security::PayloadIntegrityBlock::strip(b, _pubkey);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, b.getBlocks().size());
+
+	// decrypt as usual
+	dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey);
+	CPPUNIT_ASSERT_EQUAL(_testdata, getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks().size());
+}
+
+void PayloadConfidentialBlockTest::decryptVerifyTest(void)
+{
+	dtn::data::Bundle b;
+	createBundle(b, _testdata);
+
+	// encrypt and sign in separate steps
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source);
+	dtn::security::PayloadIntegrityBlock::sign(b, _pkey, b._destination.getNode());
+
+	// verify the signature while the payload is decrypted
+	const dtn::security::PayloadIntegrityBlock &pib = b.getBlock<dtn::security::PayloadIntegrityBlock>();
+	dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey, pib, _pubkey);
+
+	CPPUNIT_ASSERT_EQUAL(_testdata, getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks().size());
+}
+
+void PayloadConfidentialBlockTest::decryptVerifyTamperTest(void)
+{
+	dtn::data::Bundle b;
+	createBundle(b, _testdata);
+
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source, _pkey);
+
+	// modify one byte of the encrypted payload
+	std::string data = getPayload(b);
+	data[0] = ~data[0];
+	setPayload(b, data);
+
+	const dtn::security::PayloadIntegrityBlock &pib = b.getBlock<dtn::security::PayloadIntegrityBlock>();
+	CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey, pib, _pubkey), ibrcommon::Exception);
+
+	// the bundle is left unchanged
+	CPPUNIT_ASSERT_EQUAL(data, getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, b.getBlocks().size());
+}
+
+void PayloadConfidentialBlockTest::chunkedTest(void)
+{
+	// three chunks processed by two threads
+	dtn::security::PayloadConfidentialBlock::chunk_size = dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE;
+	dtn::security::PayloadConfidentialBlock::chunk_threads = 2;
+	const std::string testdata = getChunkedData(3);
+
+	dtn::data::Bundle b;
+	createBundle(b, testdata);
+
+	// encrypt in chunks and sign within one pass
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source, _pkey);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, b.getBlocks().size());
+	CPPUNIT_ASSERT(getPayload(b) != testdata);
+
+	// the chunk size is taken from the PCB
+	dtn::security::PayloadConfidentialBlock::chunk_size = 0;
+
+	// verify the signature while the chunks are decrypted
+	const dtn::security::PayloadIntegrityBlock &pib = b.getBlock<dtn::security::PayloadIntegrityBlock>();
+	dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey, pib, _pubkey);
+
+	CPPUNIT_ASSERT(testdata == getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks().size());
+}
+
+void PayloadConfidentialBlockTest::chunkedTamperTest(void)
+{
+	dtn::security::PayloadConfidentialBlock::chunk_size = dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE;
+	dtn::security::PayloadConfidentialBlock::chunk_threads = 2;
+
+	dtn::data::Bundle b;
+	createBundle(b, getChunkedData(3));
+
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source);
+
+	// modify one byte of the last chunk
+	std::string data = getPayload(b);
+	data[data.size() - 1] = ~data[data.size() - 1];
+	setPayload(b, data);
+
+	CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey), ibrcommon::Exception);
+
+	// the encrypted payload is restored
+	CPPUNIT_ASSERT_EQUAL(data, getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, b.getBlocks().size());
+}
+
+void PayloadConfidentialBlockTest::chunkedTruncateTest(void)
+{
+	const size_t chunk_size = dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE;
+	const size_t tag_len = dtn::security::ChunkedPayloadCipher::tag_len;
+	dtn::security::PayloadConfidentialBlock::chunk_size = chunk_size;
+	dtn::security::PayloadConfidentialBlock::chunk_threads = 2;
+
+	dtn::data::Bundle b;
+	createBundle(b, getChunkedData(3));
+
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source);
+
+	// cut the encrypted payload after the second chunk
+	const std::string data = getPayload(b).substr(0, 2 * chunk_size);
+	b.remove(b.getBlock<dtn::data::PayloadBlock>());
+	dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+	(*p.getBLOB().iostream()) << data << std::flush;
+
+	CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey), ibrcommon::Exception);
+	CPPUNIT_ASSERT(data == getPayload(b));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, b.getBlocks().size());
+
+	// drop the last chunk together with its tag, thus every remaining chunk has a valid tag
+	const unsigned char key[dtn::security::ChunkedPayloadCipher::key_size_in_bytes] = { 0 };
+	const std::string plain = getChunkedData(3);
+	std::stringstream ss(plain);
+
+	dtn::security::ChunkedPayloadCipher encrypt(dtn::security::PayloadCipher::CIPHER_ENCRYPT, key, 42, chunk_size, 2);
+	encrypt.process(ss);
+	CPPUNIT_ASSERT_EQUAL(3 * tag_len, encrypt.getTags().size());
+
+	unsigned char iv[dtn::security::ChunkedPayloadCipher::iv_len];
+	encrypt.getIV(iv);
+
+	std::stringstream truncated(ss.str().substr(0, 2 * chunk_size));
+	dtn::security::ChunkedPayloadCipher decrypt(dtn::security::PayloadCipher::CIPHER_DECRYPT, key, 42, iv, chunk_size, 2, encrypt.getTags().substr(0, 2 * tag_len));
+	decrypt.process(truncated);
+
+	// the second chunk was not the last one when it was encrypted
+	CPPUNIT_ASSERT(!decrypt.verify());
+
+	// the complete payload still verifies
+	dtn::security::ChunkedPayloadCipher complete(dtn::security::PayloadCipher::CIPHER_DECRYPT, key, 42, iv, chunk_size, 2, encrypt.getTags());
+	complete.process(ss);
+	CPPUNIT_ASSERT(complete.verify());
+	CPPUNIT_ASSERT(plain == ss.str());
+}
+
+void PayloadConfidentialBlockTest::chunkSizeTest(void)
+{
+	const size_t chunk_size = dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE;
+	dtn::security::PayloadConfidentialBlock::chunk_size = chunk_size;
+
+	dtn::data::Bundle b;
+	createBundle(b, getChunkedData(2));
+
+	dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source);
+	const std::string data = getPayload(b);
+
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+	const std::string wire = ss.str();
+
+	// the chunk size parameter: type, length and the size in network byte order
+	std::string param;
+	param.push_back((char)dtn::security::SecurityBlock::chunk_size);
+	param.push_back((char)4);
+	param.push_back((char)((chunk_size >> 24) & 0xff));
+	param.push_back((char)((chunk_size >> 16) & 0xff));
+	param.push_back((char)((chunk_size >> 8) & 0xff));
+	param.push_back((char)(chunk_size & 0xff));
+
+	const size_t pos = wire.find(param);
+	CPPUNIT_ASSERT(pos != std::string::npos);
+
+	const size_t invalid[] = { 16, dtn::security::ChunkedPayloadCipher::MIN_CHUNK_SIZE - 1, dtn::security::ChunkedPayloadCipher::MAX_CHUNK_SIZE + 1 };
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		std::string modified = wire;
+		modified[pos + 2] = (char)((invalid[i] >> 24) & 0xff);
+		modified[pos + 3] = (char)((invalid[i] >> 16) & 0xff);
+		modified[pos + 4] = (char)((invalid[i] >> 8) & 0xff);
+		modified[pos + 5] = (char)(invalid[i] & 0xff);
+
+		dtn::data::Bundle received;
+		std::stringstream rs(modified);
+		dtn::data::DefaultDeserializer(rs) >> received;
+
+		// the chunk size of the sender is rejected before anything is allocated
+		CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::decrypt(received, _pkey), ibrcommon::Exception);
+		CPPUNIT_ASSERT(data == getPayload(received));
+		CPPUNIT_ASSERT_EQUAL((size_t)2, received.getBlocks().size());
+	}
+
+	// a chunk size out of the limits is not used to encrypt
+	dtn::security::ChunkedPayloadCipher cipher(dtn::security::PayloadCipher::CIPHER_ENCRYPT, (const unsigned char*)"0123456789abcdef", 42, 16);
+	std::stringstream plain(data);
+	CPPUNIT_ASSERT_THROW(cipher.process(plain), ibrcommon::Exception);
+}
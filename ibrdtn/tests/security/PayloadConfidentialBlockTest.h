@@ -7,6 +7,9 @@
 
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/security/SecurityKey.h>
 #include <iostream>
 #include <string>
 
@@ -18,6 +21,13 @@ class PayloadConfidentialBlockTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST_SUITE (PayloadConfidentialBlockTest);
 	CPPUNIT_TEST (encryptTest);
 	CPPUNIT_TEST (decryptTest);
+	CPPUNIT_TEST (encryptSignTest);
+	CPPUNIT_TEST (decryptVerifyTest);
+	CPPUNIT_TEST (decryptVerifyTamperTest);
+	CPPUNIT_TEST (chunkedTest);
+	CPPUNIT_TEST (chunkedTamperTest);
+	CPPUNIT_TEST (chunkedTruncateTest);
+	CPPUNIT_TEST (chunkSizeTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -27,10 +37,24 @@ public:
 protected:
 	void encryptTest(void);
 	void decryptTest(void);
+	void encryptSignTest(void);
+	void decryptVerifyTest(void);
+	void decryptVerifyTamperTest(void);
+	void chunkedTest(void);
+	void chunkedTamperTest(void);
+	void chunkedTruncateTest(void);
+	void chunkSizeTest(void);
 
 private:
 	std::string getHex(std::istream &stream);
+	std::string getChunkedData(const size_t chunks);
+	dtn::data::PayloadBlock& createBundle(dtn::data::Bundle &b, const std::string &data);
+	std::string getPayload(const dtn::data::Bundle &b);
+	void setPayload(dtn::data::Bundle &b, const std::string &data);
+
 	std::string _testdata;
+	dtn::security::SecurityKey _pubkey;
+	dtn::security::SecurityKey _pkey;
 };
 
 #endif /* PAYLOADCONFIDENTIALBLOCKTEST_H_ */
@@ -0,0 +1,173 @@
+/*
+ * PayloadSecurityBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "security/PayloadSecurityBenchmark.h"
+#include <ibrdtn/security/PayloadConfidentialBlock.h>
+#include <ibrdtn/security/PayloadIntegrityBlock.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <stdlib.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PayloadSecurityBenchmark);
+
+static std::vector<size_t> getSizes(const char *name, const std::string &def)
+{
+	const char *value = ::getenv(name);
+	std::stringstream ss((value == NULL) ? def : std::string(value));
+
+	std::vector<size_t> ret;
+	std::string item;
+	while (std::getline(ss, item, ','))
+	{
+		const size_t size = ::strtoul(item.c_str(), NULL, 10);
+		if (size > 0) ret.push_back(size);
+	}
+	return ret;
+}
+
+void PayloadSecurityBenchmark::setUp(void)
+{
+	_pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	_pubkey.file = ibrcommon::File("test-key.pem");
+	_pubkey.reference = dtn::data::EID("dtn://source");
+
+	_pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	_pkey.file = ibrcommon::File("test-key.pem");
+	_pkey.reference = _pubkey.reference;
+
+	_output = &std::cout;
+}
+
+void PayloadSecurityBenchmark::tearDown(void)
+{
+}
+
+void PayloadSecurityBenchmark::report(const std::string &pipeline, const std::string &operation, size_t payload, size_t operations, double seconds)
+{
+	const double mbytes = ((double)payload * operations) / (1024 * 1024);
+
+	(*_output) << pipeline << "," << operation << "," << payload << ","
+			<< operations << "," << seconds << "," << ((seconds > 0) ? (mbytes / seconds) : 0) << std::endl;
+}
+
+void PayloadSecurityBenchmark::run(const std::string &pipeline, bool fused, size_t payload, size_t rounds)
+{
+	const std::string data(payload, 'x');
+
+	std::list<dtn::data::Bundle> bundles;
+	for (size_t i = 0; i < rounds; i++)
+	{
+		dtn::data::Bundle b;
+		b._source = _pubkey.reference + "/test";
+		b._destination = dtn::data::EID("dtn://destination/test");
+		b._sequencenumber = i;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << data << std::flush;
+
+		bundles.push_back(b);
+	}
+
+	ibrcommon::TimeMeasurement tm;
+
+	// encrypt and sign
+	tm.start();
+	for (std::list<dtn::data::Bundle>::iterator iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		dtn::data::Bundle &b = (*iter);
+
+		if (fused)
+		{
+			dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source, _pkey);
+		}
+		else
+		{
+			dtn::security::PayloadConfidentialBlock::encrypt(b, _pubkey, b._source);
+			dtn::security::PayloadIntegrityBlock::sign(b, _pkey, b._destination.getNode());
+		}
+	}
+	tm.stop();
+
+	report(pipeline, "encrypt+sign", payload, rounds, tm.getMilliseconds() / 1000.0);
+
+	// verify and decrypt
+	tm.start();
+	for (std::list<dtn::data::Bundle>::iterator iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		dtn::data::Bundle &b = (*iter);
+
+		if (fused)
+		{
+			const dtn::security::PayloadIntegrityBlock &pib = b.getBlock<dtn::security::PayloadIntegrityBlock>();
+			dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey, pib, _pubkey);
+		}
+		else
+		{
+			dtn::security::PayloadIntegrityBlock::strip(b, _pubkey);
+			dtn::security::PayloadConfidentialBlock::decrypt(b, _pkey);
+		}
+	}
+	tm.stop();
+
+	report(pipeline, "verify+decrypt", payload, rounds, tm.getMilliseconds() / 1000.0);
+
+	// all bundles are restored
+	for (std::list<dtn::data::Bundle>::iterator iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		dtn::data::Bundle &b = (*iter);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, b.getBlocks().size());
+
+		dtn::data::PayloadBlock &p = b.getBlock<dtn::data::PayloadBlock>();
+		ibrcommon::BLOB::iostream stream = p.getBLOB().iostream();
+		CPPUNIT_ASSERT_EQUAL(payload, (size_t)stream.size());
+	}
+}
+
+void PayloadSecurityBenchmark::throughputTest(void)
+{
+	if (!_pubkey.file.exists())
+	{
+		throw ibrcommon::Exception("test-key.pem file not exists!");
+	}
+
+	const std::vector<size_t> sizes = getSizes("BENCH_SECURITY_PAYLOAD", "1024,65536,1048576");
+	const std::vector<size_t> rounds = getSizes("BENCH_SECURITY_ROUNDS", "10");
+	const std::vector<size_t> chunk = getSizes("BENCH_SECURITY_CHUNK", "262144");
+
+	std::ofstream file;
+	const char *output = ::getenv("BENCH_SECURITY_OUTPUT");
+	if (output != NULL)
+	{
+		file.open(output);
+		_output = &file;
+	}
+	else
+	{
+		std::cout << std::endl;
+	}
+
+	(*_output) << "pipeline,operation,payload,operations,seconds,mbytes_per_second" << std::endl;
+
+	for (std::vector<size_t>::const_iterator iter = sizes.begin(); iter != sizes.end(); iter++)
+	{
+		run("separate", false, *iter, rounds.empty() ? 10 : rounds.front());
+		run("fused", true, *iter, rounds.empty() ? 10 : rounds.front());
+
+		// payloads up to the chunk size are encrypted as a whole
+		dtn::security::PayloadConfidentialBlock::chunk_size = chunk.empty() ? 262144 : chunk.front();
+		run("chunked", true, *iter, rounds.empty() ? 10 : rounds.front());
+		dtn::security::PayloadConfidentialBlock::chunk_size = 0;
+	}
+
+	_output = &std::cout;
+}
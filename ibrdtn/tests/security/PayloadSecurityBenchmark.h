@@ -0,0 +1,59 @@
+/*
+ * PayloadSecurityBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/security/SecurityKey.h>
+#include <iostream>
+#include <string>
+
+#ifndef PAYLOADSECURITYBENCHMARK_H_
+#define PAYLOADSECURITYBENCHMARK_H_
+
+/**
+ * Measures the throughput of payload encryption and signing for several
+ * payload sizes, once in separate steps, once within a single pass and once
+ * within a single pass with the payload encrypted in parallel chunks.
+ *
+ * The parameters are taken from the environment:
+ *   BENCH_SECURITY_PAYLOAD  payload sizes in bytes, comma separated (default: 1024,65536,1048576)
+ *   BENCH_SECURITY_ROUNDS   number of bundles per payload size (default: 10)
+ *   BENCH_SECURITY_CHUNK    chunk size in bytes of the chunked pipeline (default: 262144)
+ *   BENCH_SECURITY_OUTPUT   file for the results (default: standard output)
+ *
+ * The results are written as CSV with the columns
+ * pipeline,operation,payload,operations,seconds,mbytes_per_second
+ */
+class PayloadSecurityBenchmark : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (PayloadSecurityBenchmark);
+	CPPUNIT_TEST (throughputTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void throughputTest(void);
+
+private:
+	/**
+	 * Encrypt, sign, verify and decrypt bundles of the given payload size.
+	 * @param pipeline The name of the pipeline in the results.
+	 * @param fused Do each direction within one pass over the payload.
+	 */
+	void run(const std::string &pipeline, bool fused, size_t payload, size_t rounds);
+
+	void report(const std::string &pipeline, const std::string &operation, size_t payload, size_t operations, double seconds);
+
+	dtn::security::SecurityKey _pubkey;
+	dtn::security::SecurityKey _pkey;
+	std::ostream *_output;
+};
+
+#endif /* PAYLOADSECURITYBENCHMARK_H_ */
@@ -10,10 +10,12 @@
 
 #include <ibrdtn/data/PayloadBlock.h>
 #include <ibrdtn/security/BundleAuthenticationBlock.h>
+#include <ibrdtn/security/PayloadConfidentialBlock.h>
 #include <ibrdtn/security/SecurityKey.h>
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/Dictionary.h>
 #include <ibrcommon/data/BLOB.h>
 #include <sstream>
 
@@ -118,3 +120,37 @@ void TestSecurityBlock::serializeBABTest(void)
 		dtn::security::BundleAuthenticationBlock::verify(b, key);
 	}
 }
+
+void TestSecurityBlock::dictionaryTest(void)
+{
+	dtn::data::Bundle b;
+	b._source = dtn::data::EID("dtn://source/app");
+	b._destination = dtn::data::EID("dtn://destination/app");
+	b._procflags |= dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON;
+	b._lifetime = 3600;
+
+	b.push_back<dtn::data::PayloadBlock>();
+	dtn::security::PayloadConfidentialBlock &pcb = b.push_front<dtn::security::PayloadConfidentialBlock>();
+	pcb.setSecurityDestination(dtn::data::EID("dtn://node3"));
+
+	// build the cached dictionary
+	b.getDictionary();
+
+	// a new security destination has to invalidate the cached dictionary
+	pcb.setSecurityDestination(dtn::data::EID("dtn://security-gateway"));
+
+	std::stringstream cached, fresh;
+	cached << b.getDictionary();
+	fresh << dtn::data::Dictionary(b);
+	CPPUNIT_ASSERT_EQUAL(fresh.str(), cached.str());
+
+	// the serialized bundle refers to the new security destination
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+
+	dtn::data::Bundle loaded;
+	dtn::data::DefaultDeserializer(ss) >> loaded;
+
+	const dtn::security::PayloadConfidentialBlock &lpcb = loaded.getBlock<dtn::security::PayloadConfidentialBlock>();
+	CPPUNIT_ASSERT(lpcb.isSecurityDestination(loaded, dtn::data::EID("dtn://security-gateway")));
+}
@@ -16,6 +16,7 @@ class TestSecurityBlock : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST_SUITE (TestSecurityBlock);
 	CPPUNIT_TEST (localBABTest);
 	CPPUNIT_TEST (serializeBABTest);
+	CPPUNIT_TEST (dictionaryTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -25,6 +26,7 @@ public:
 protected:
 	void localBABTest(void);
 	void serializeBABTest(void);
+	void dictionaryTest(void);
 };
 
 #endif /* TESTSECURITYBLOCK_H_ */
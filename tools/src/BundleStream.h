@@ -14,6 +14,9 @@
 #include <ibrdtn/data/SDNV.h>
 #include <ibrdtn/data/StreamBlock.h>
 #include <ibrcommon/net/tcpclient.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <queue>
 
 class StreamBundle : public dtn::api::Bundle
 {
@@ -32,6 +35,12 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * Replace the payload of the bundle by the given BLOB and set
+	 * the sequence number of the stream block.
+	 */
+	void setPayload(ibrcommon::BLOB::Reference &ref, size_t seq);
+
 	/**
 	 * returns the size of the current payload
 	 * @return
@@ -51,11 +60,35 @@ public:
 	// The size of the input and output buffers.
 	static const size_t BUFF_SIZE = 5120;
 
-	BundleStreamBuf(dtn::api::Client &client, StreamBundle &chunk, size_t buffer = 4096, bool wait_seq_zero = false);
+	/**
+	 * @param client The client used to send chunks.
+	 * @param chunk Template for all outgoing chunks.
+	 * @param buffer Maximum payload size of a chunk.
+	 * @param wait_seq_zero Wait for the chunk with sequence number zero.
+	 * @param inflight Maximum number of chunks sent but not forwarded by the daemon.
+	 * @param limit Maximum number of payload bytes held in the reorder buffer, zero disables the limit.
+	 */
+	BundleStreamBuf(dtn::api::Client &client, StreamBundle &chunk, size_t buffer = 4096, bool wait_seq_zero = false, size_t inflight = 8, size_t limit = 0);
 	virtual ~BundleStreamBuf();
 
 	virtual void received(const dtn::api::Bundle &b);
 
+	/**
+	 * Is called when the daemon accepted a complete chunk.
+	 */
+	void forwarded();
+
+	/**
+	 * Is called when the daemon refused a chunk. The stream has a gap
+	 * from then on, thus it is aborted.
+	 */
+	void refused();
+
+	/**
+	 * Abort all blocking calls.
+	 */
+	void abort();
+
 protected:
 	virtual int sync();
 	virtual int overflow(int = std::char_traits<char>::eof());
@@ -74,8 +107,48 @@ private:
 
 		dtn::api::Bundle _bundle;
 		size_t _seq;
+		size_t _size;
 	};
 
+	/**
+	 * The sender transmits the filled chunks while the next one is filled.
+	 */
+	class Sender : public ibrcommon::JoinableThread
+	{
+	public:
+		Sender(BundleStreamBuf &buf);
+		virtual ~Sender();
+
+	protected:
+		void run();
+		bool __cancellation();
+
+	private:
+		BundleStreamBuf &_buf;
+	};
+
+	/**
+	 * Queue the current payload for transmission and take
+	 * the next pre-allocated BLOB as payload buffer.
+	 */
+	void flushPayload();
+
+	/**
+	 * Wait until all queued chunks are sent.
+	 */
+	void wait();
+
+	/**
+	 * Returns the next payload to send. Blocks while no chunk is
+	 * queued or the maximum number of chunks is in flight.
+	 */
+	ibrcommon::BLOB::Reference next();
+
+	/**
+	 * Clear a sent payload and put it back into the pool.
+	 */
+	void release(ibrcommon::BLOB::Reference &ref);
+
 	// Input buffer
 	char *_in_buf;
 	// Output buffer
@@ -89,27 +162,52 @@ private:
 	std::set<Chunk> _chunks;
 	size_t _chunk_offset;
 
+	// number of payload bytes held in the reorder buffer
+	size_t _chunks_size;
+	const size_t _chunks_limit;
+
 	size_t _in_seq;
 	bool _streaming;
+
+	Sender _sender;
+
+	// the payload currently filled
+	ibrcommon::BLOB::Reference _payload;
+	size_t _payload_size;
+
+	ibrcommon::Conditional _send_cond;
+	// pre-allocated BLOBs ready to get filled
+	std::queue<ibrcommon::BLOB::Reference> _pool;
+	// filled BLOBs waiting for transmission
+	std::queue<ibrcommon::BLOB::Reference> _outgoing;
+	const size_t _inflight_limit;
+	size_t _inflight;
+	size_t _out_seq;
+	bool _sending;
+	bool _aborted;
 };
 
 class BundleStream : public dtn::api::Client
 {
 public:
-	BundleStream(ibrcommon::tcpstream &stream, size_t chunk_size, const std::string &app = "stream", const dtn::data::EID &group = dtn::data::EID(), bool wait_seq_zero = false);
+	BundleStream(ibrcommon::tcpstream &stream, size_t chunk_size, const std::string &app = "stream", const dtn::data::EID &group = dtn::data::EID(), bool wait_seq_zero = false, size_t inflight = 8, size_t limit = 0);
 	virtual ~BundleStream();
 
 	BundleStreamBuf& rdbuf();
 	dtn::api::Bundle& base();
 
+	virtual void eventBundleForwarded();
+	virtual void eventBundleRefused();
+	virtual void eventConnectionDown();
+
 protected:
 	virtual void received(const dtn::api::Bundle &b);
 
 private:
 	ibrcommon::tcpstream &_stream;
 
-	BundleStreamBuf _buf;
 	StreamBundle _chunk;
+	BundleStreamBuf _buf;
 };
 
 #endif /* BUNDLESTREAM_H_ */
@@ -0,0 +1,517 @@
+/*
+ * TarArchive.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "TarArchive.h"
+#include <sstream>
+#include <vector>
+#include <cstddef>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+static const size_t BLOCK_SIZE = 512;
+
+// the largest size which fits into the octal size field
+static const unsigned long long MAX_OCTAL_SIZE = 077777777777ULL;
+
+// extended headers are read into memory, thus their size per entry is limited
+static const size_t MAX_EXTENDED_HEADER_SIZE = 64 * 1024;
+
+/**
+ * The header of a ustar entry.
+ */
+struct TarHeader
+{
+	char name[100];
+	char mode[8];
+	char uid[8];
+	char gid[8];
+	char size[12];
+	char mtime[12];
+	char chksum[8];
+	char typeflag;
+	char linkname[100];
+	char magic[6];
+	char version[2];
+	char uname[32];
+	char gname[32];
+	char devmajor[8];
+	char devminor[8];
+	char prefix[155];
+	char padding[12];
+};
+
+static void writeOctal(char *field, size_t length, size_t value)
+{
+	// the field is terminated by a null character
+	::snprintf(field, length, "%0*lo", (int)(length - 1), (unsigned long)value);
+}
+
+static size_t readOctal(const char *field, size_t length)
+{
+	size_t ret = 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		if ((field[i] < '0') || (field[i] > '7')) continue;
+		ret = (ret << 3) + (field[i] - '0');
+	}
+	return ret;
+}
+
+static unsigned int checksum(const TarHeader &header)
+{
+	const unsigned char *data = (const unsigned char*)&header;
+	unsigned int sum = 0;
+
+	for (size_t i = 0; i < sizeof(TarHeader); i++)
+	{
+		// the checksum field counts as spaces
+		if ((i >= offsetof(TarHeader, chksum)) && (i < offsetof(TarHeader, chksum) + sizeof(header.chksum)))
+		{
+			sum += ' ';
+		}
+		else
+		{
+			sum += data[i];
+		}
+	}
+
+	return sum;
+}
+
+static std::string toString(size_t value)
+{
+	std::stringstream ss; ss << value;
+	return ss.str();
+}
+
+static void createDirectories(const std::string &path)
+{
+	for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+	{
+		const std::string dir = path.substr(0, pos);
+		if ((::mkdir(dir.c_str(), 0755) != 0) && (errno != EEXIST))
+		{
+			throw ibrcommon::IOException("can not create directory " + dir);
+		}
+		if (pos == std::string::npos) break;
+	}
+}
+
+TarWriter::TarWriter(std::ostream &stream)
+ : _stream(stream), _closed(false)
+{
+}
+
+TarWriter::~TarWriter()
+{
+	close();
+}
+
+void TarWriter::writeHeader(const std::string &name, char type, size_t size, mode_t mode, time_t mtime)
+{
+	TarHeader header;
+	::memset(&header, 0, sizeof(header));
+
+	::strncpy(header.name, name.c_str(), sizeof(header.name));
+	writeOctal(header.mode, sizeof(header.mode), mode & 07777);
+	writeOctal(header.uid, sizeof(header.uid), 0);
+	writeOctal(header.gid, sizeof(header.gid), 0);
+	writeOctal(header.size, sizeof(header.size), size);
+	writeOctal(header.mtime, sizeof(header.mtime), mtime);
+	header.typeflag = type;
+	::memcpy(header.magic, "ustar", 6);
+	::memcpy(header.version, "00", 2);
+
+	::snprintf(header.chksum, sizeof(header.chksum), "%06o", checksum(header));
+	header.chksum[7] = ' ';
+
+	_stream.write((const char*)&header, sizeof(header));
+}
+
+void TarWriter::writePax(const std::map<std::string, std::string> &records)
+{
+	std::string data;
+
+	for (std::map<std::string, std::string>::const_iterator iter = records.begin(); iter != records.end(); iter++)
+	{
+		// each record is "<length> <key>=<value>\n" and the length counts itself
+		const std::string record = " " + iter->first + "=" + iter->second + "\n";
+		size_t length = record.length() + 1;
+		while (toString(length).length() + record.length() > length) length++;
+
+		data += toString(length) + record;
+	}
+
+	writeHeader("PaxHeader", 'x', data.length(), 0644, 0);
+	_stream.write(data.c_str(), data.length());
+	pad(data.length());
+}
+
+void TarWriter::pad(size_t size)
+{
+	const size_t remain = size % BLOCK_SIZE;
+	if (remain == 0) return;
+
+	static const char zeros[BLOCK_SIZE] = { 0 };
+	_stream.write(zeros, BLOCK_SIZE - remain);
+}
+
+void TarWriter::addDirectory(const std::string &name, mode_t mode, time_t mtime)
+{
+	const std::string dirname = name + "/";
+
+	if (dirname.length() > 100)
+	{
+		std::map<std::string, std::string> records;
+		records["path"] = dirname;
+		writePax(records);
+	}
+
+	writeHeader(dirname, '5', 0, mode, mtime);
+}
+
+void TarWriter::addFile(const std::string &name, std::istream &data, size_t length, mode_t mode, time_t mtime, size_t offset, size_t filesize)
+{
+	std::map<std::string, std::string> records;
+
+	if (name.length() > 100) records["path"] = name;
+	if ((unsigned long long)length > MAX_OCTAL_SIZE) records["size"] = toString(length);
+
+	if ((offset > 0) || ((filesize > 0) && (filesize != length)))
+	{
+		records["IBRDTN.offset"] = toString(offset);
+		records["IBRDTN.filesize"] = toString(filesize);
+	}
+
+	if (!records.empty()) writePax(records);
+
+	writeHeader(name, '0', ((unsigned long long)length > MAX_OCTAL_SIZE) ? 0 : length, mode, mtime);
+
+	// copy the data in blocks
+	char buf[16 * BLOCK_SIZE];
+	size_t remain = length;
+
+	while (remain > 0)
+	{
+		const size_t chunk = (remain > sizeof(buf)) ? sizeof(buf) : remain;
+		data.read(buf, chunk);
+
+		if ((size_t)data.gcount() != chunk)
+		{
+			throw FileException("file " + name + " is shorter than expected");
+		}
+
+		_stream.write(buf, chunk);
+		remain -= chunk;
+	}
+
+	pad(length);
+}
+
+void TarWriter::close()
+{
+	if (_closed) return;
+	_closed = true;
+
+	// two empty blocks mark the end of the archive
+	static const char zeros[2 * BLOCK_SIZE] = { 0 };
+	_stream.write(zeros, sizeof(zeros));
+	_stream.flush();
+}
+
+TarReader::Entry::Entry()
+ : type(ENTRY_OTHER), size(0), mode(0), mtime(0), offset(0), filesize(0)
+{
+}
+
+TarReader::Entry::~Entry()
+{
+}
+
+TarReader::TarReader(std::istream &stream)
+ : _stream(stream), _remain(0), _padding(0)
+{
+}
+
+TarReader::~TarReader()
+{
+}
+
+void TarReader::skip(size_t size)
+{
+	char buf[16 * BLOCK_SIZE];
+
+	while (size > 0)
+	{
+		const size_t chunk = (size > sizeof(buf)) ? sizeof(buf) : size;
+		_stream.read(buf, chunk);
+		if ((size_t)_stream.gcount() != chunk) throw FormatException("unexpected end of the archive");
+		size -= chunk;
+	}
+}
+
+bool TarReader::next(Entry &entry)
+{
+	// skip the rest of the previous entry
+	skip(_remain + _padding);
+	_remain = 0;
+	_padding = 0;
+
+	std::map<std::string, std::string> records;
+	std::string longname;
+	size_t extended = 0;
+
+	while (true)
+	{
+		TarHeader header;
+		_stream.read((char*)&header, sizeof(header));
+
+		// a missing end marker is accepted
+		if (_stream.gcount() == 0) return false;
+		if ((size_t)_stream.gcount() != sizeof(header)) throw FormatException("unexpected end of the archive");
+
+		// an empty block marks the end
+		if (header.name[0] == '\0') return false;
+
+		if (readOctal(header.chksum, sizeof(header.chksum)) != checksum(header))
+		{
+			throw FormatException("checksum mismatch");
+		}
+
+		size_t size = readOctal(header.size, sizeof(header.size));
+		const size_t padding = (BLOCK_SIZE - (size % BLOCK_SIZE)) % BLOCK_SIZE;
+
+		if ((header.typeflag == 'x') || (header.typeflag == 'L'))
+		{
+			// the limit applies to all extended headers of one entry
+			extended += size;
+			if (extended > MAX_EXTENDED_HEADER_SIZE) throw FormatException("extended header is too large");
+
+			std::vector<char> data(size + 1, 0);
+			_stream.read(&data[0], size);
+			if ((size_t)_stream.gcount() != size) throw FormatException("unexpected end of the archive");
+			skip(padding);
+
+			if (header.typeflag == 'L')
+			{
+				// GNU long name
+				longname = std::string(&data[0]);
+				continue;
+			}
+
+			// parse the pax records
+			size_t pos = 0;
+			while (pos < size)
+			{
+				const size_t length = ::strtoul(&data[pos], NULL, 10);
+				if ((length == 0) || (pos + length > size)) throw FormatException("invalid pax header");
+
+				const std::string record(&data[pos], length);
+				const size_t space = record.find(' ');
+				const size_t equal = record.find('=');
+
+				if ((space != std::string::npos) && (equal != std::string::npos) && (space < equal))
+				{
+					records[record.substr(space + 1, equal - space - 1)] = record.substr(equal + 1, length - equal - 2);
+				}
+
+				pos += length;
+			}
+			continue;
+		}
+
+		if ((header.typeflag == 'g') || (header.typeflag == 'K'))
+		{
+			// global headers and long link names are ignored
+			skip(size + padding);
+			continue;
+		}
+
+		// name with prefix of the ustar format
+		std::string name(header.name, ::strnlen(header.name, sizeof(header.name)));
+		if ((::memcmp(header.magic, "ustar", 5) == 0) && (header.prefix[0] != '\0'))
+		{
+			name = std::string(header.prefix, ::strnlen(header.prefix, sizeof(header.prefix))) + "/" + name;
+		}
+
+		if (longname.length() > 0) name = longname;
+		if (records.find("path") != records.end()) name = records["path"];
+		if (records.find("size") != records.end()) size = ::strtoul(records["size"].c_str(), NULL, 10);
+
+		entry = Entry();
+		entry.name = name;
+		entry.size = size;
+		entry.mode = readOctal(header.mode, sizeof(header.mode));
+		entry.mtime = readOctal(header.mtime, sizeof(header.mtime));
+
+		switch (header.typeflag)
+		{
+		case '0':
+		case '\0':
+			entry.type = ENTRY_FILE;
+			break;
+		case '5':
+			entry.type = ENTRY_DIRECTORY;
+			break;
+		default:
+			entry.type = ENTRY_OTHER;
+			break;
+		}
+
+		if (records.find("IBRDTN.offset") != records.end())
+		{
+			entry.offset = ::strtoul(records["IBRDTN.offset"].c_str(), NULL, 10);
+			entry.filesize = ::strtoul(records["IBRDTN.filesize"].c_str(), NULL, 10);
+		}
+		else
+		{
+			entry.filesize = size;
+		}
+
+		// remove trailing slashes of directories
+		while ((entry.name.length() > 1) && (entry.name[entry.name.length() - 1] == '/'))
+		{
+			entry.name.erase(entry.name.length() - 1);
+		}
+
+		_remain = size;
+		_padding = (BLOCK_SIZE - (size % BLOCK_SIZE)) % BLOCK_SIZE;
+		return true;
+	}
+}
+
+void TarReader::read(std::ostream &stream)
+{
+	char buf[16 * BLOCK_SIZE];
+
+	while (_remain > 0)
+	{
+		const size_t chunk = (_remain > sizeof(buf)) ? sizeof(buf) : _remain;
+		_stream.read(buf, chunk);
+		if ((size_t)_stream.gcount() != chunk) throw FormatException("unexpected end of the archive");
+
+		stream.write(buf, chunk);
+		_remain -= chunk;
+	}
+}
+
+bool TarReader::isSafePath(const std::string &name)
+{
+	if (name.length() == 0) return false;
+	if (name[0] == '/') return false;
+
+	std::stringstream ss(name);
+	std::string component;
+	while (std::getline(ss, component, '/'))
+	{
+		if (component == "..") return false;
+	}
+
+	return true;
+}
+
+size_t TarReader::extract(const std::string &directory, PartMap &parts)
+{
+	size_t ret = 0;
+	Entry entry;
+
+	while (next(entry))
+	{
+		if (!isSafePath(entry.name))
+		{
+			std::cerr << "skip unsafe path " << entry.name << std::endl;
+			continue;
+		}
+
+		const std::string path = directory + "/" + entry.name;
+
+		if (entry.type == ENTRY_DIRECTORY)
+		{
+			createDirectories(path);
+			ret++;
+			continue;
+		}
+
+		if (entry.type != ENTRY_FILE) continue;
+
+		// create the parent directories
+		const size_t slash = path.rfind('/');
+		if (slash != std::string::npos) createDirectories(path.substr(0, slash));
+
+		// write into a temporary file first, renamed when the file is complete
+		const std::string tmp = path + ".part";
+		const int flags = (entry.offset == 0 && entry.size == entry.filesize) ? (O_WRONLY | O_CREAT | O_TRUNC) : (O_WRONLY | O_CREAT);
+
+		int fd = ::open(tmp.c_str(), flags, (entry.mode & 0777) ? (entry.mode & 0777) : 0644);
+		if (fd < 0) throw ibrcommon::IOException("can not open " + tmp);
+
+		char buf[16 * BLOCK_SIZE];
+		size_t pos = entry.offset;
+
+		while (_remain > 0)
+		{
+			const size_t chunk = (_remain > sizeof(buf)) ? sizeof(buf) : _remain;
+			_stream.read(buf, chunk);
+
+			if ((size_t)_stream.gcount() != chunk)
+			{
+				::close(fd);
+				throw FormatException("unexpected end of the archive");
+			}
+
+			for (size_t done = 0; done < chunk; )
+			{
+				const ssize_t w = ::pwrite(fd, buf + done, chunk - done, pos + done);
+				if (w < 0)
+				{
+					::close(fd);
+					throw ibrcommon::IOException("can not write " + tmp);
+				}
+				done += w;
+			}
+
+			pos += chunk;
+			_remain -= chunk;
+		}
+
+		::close(fd);
+
+		// count the received bytes of the file
+		std::map<size_t, size_t> &received = parts[entry.name];
+		received[entry.offset] = entry.size;
+
+		size_t complete = 0;
+		for (std::map<size_t, size_t>::const_iterator iter = received.begin(); iter != received.end(); iter++)
+		{
+			complete += iter->second;
+		}
+
+		if (complete >= entry.filesize)
+		{
+			if (::rename(tmp.c_str(), path.c_str()) != 0)
+			{
+				throw ibrcommon::IOException("can not rename " + tmp);
+			}
+
+			// restore the modification time
+			struct timeval times[2];
+			times[0].tv_sec = entry.mtime; times[0].tv_usec = 0;
+			times[1].tv_sec = entry.mtime; times[1].tv_usec = 0;
+			::utimes(path.c_str(), times);
+
+			parts.erase(entry.name);
+			ret++;
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,156 @@
+/*
+ * TarArchive.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#ifndef TARARCHIVE_H_
+#define TARARCHIVE_H_
+
+#include <ibrcommon/Exceptions.h>
+#include <sys/types.h>
+#include <iostream>
+#include <string>
+#include <map>
+
+/**
+ * Writes a tar archive (POSIX ustar with pax headers) to a stream.
+ *
+ * A file may be split into several parts. Each part is a regular entry
+ * with the pax records "IBRDTN.offset" and "IBRDTN.filesize", which is
+ * the position of the part and the size of the complete file. Other tar
+ * implementations extract such a part as a file of its own.
+ */
+class TarWriter
+{
+public:
+	/**
+	 * The input of a file ended before the announced length. The
+	 * archive is broken after this exception.
+	 */
+	class FileException : public ibrcommon::IOException
+	{
+	public:
+		FileException(std::string what = "file is shorter than expected") throw() : ibrcommon::IOException(what)
+		{
+		};
+	};
+
+	TarWriter(std::ostream &stream);
+	virtual ~TarWriter();
+
+	/**
+	 * Add a directory entry.
+	 */
+	void addDirectory(const std::string &name, mode_t mode, time_t mtime);
+
+	/**
+	 * Add a file or a part of a file. The data is copied from the
+	 * current position of the input stream.
+	 * @param name Path of the file in the archive.
+	 * @param data Stream with the content of the file.
+	 * @param length Number of bytes to copy.
+	 * @param offset Position of this part in the file.
+	 * @param filesize Size of the complete file.
+	 * @throw FileException if the stream ends before length bytes are copied.
+	 */
+	void addFile(const std::string &name, std::istream &data, size_t length, mode_t mode, time_t mtime, size_t offset = 0, size_t filesize = 0);
+
+	/**
+	 * Write the end-of-archive marker.
+	 */
+	void close();
+
+private:
+	void writeHeader(const std::string &name, char type, size_t size, mode_t mode, time_t mtime);
+	void writePax(const std::map<std::string, std::string> &records);
+	void pad(size_t size);
+
+	std::ostream &_stream;
+	bool _closed;
+};
+
+/**
+ * Reads a tar archive from a stream. Entries written by GNU tar
+ * with long names are supported as well.
+ */
+class TarReader
+{
+public:
+	class FormatException : public ibrcommon::Exception
+	{
+	public:
+		FormatException(std::string what = "invalid tar archive") throw() : ibrcommon::Exception(what)
+		{
+		};
+	};
+
+	enum EntryType
+	{
+		ENTRY_FILE = 0,
+		ENTRY_DIRECTORY = 1,
+		ENTRY_OTHER = 2
+	};
+
+	class Entry
+	{
+	public:
+		Entry();
+		~Entry();
+
+		std::string name;
+		EntryType type;
+		size_t size;
+		mode_t mode;
+		time_t mtime;
+
+		// position and complete size if this entry is a part of a file
+		size_t offset;
+		size_t filesize;
+	};
+
+	TarReader(std::istream &stream);
+	virtual ~TarReader();
+
+	/**
+	 * Read the header of the next entry. The data of the previous entry
+	 * is skipped if it has not been read.
+	 * @return False, if the end of the archive is reached.
+	 */
+	bool next(Entry &entry);
+
+	/**
+	 * Copy the data of the current entry to a stream.
+	 */
+	void read(std::ostream &stream);
+
+	/**
+	 * Received parts of incomplete files: path -> (offset -> length)
+	 */
+	typedef std::map<std::string, std::map<size_t, size_t> > PartMap;
+
+	/**
+	 * Extract all entries into a directory. Parts of a file are written
+	 * into "<name>.part" and renamed once the file is complete. Entries
+	 * with absolute paths or ".." components are skipped.
+	 * @param parts Parts received so far, kept by the caller across archives.
+	 * @return The number of extracted entries.
+	 */
+	size_t extract(const std::string &directory, PartMap &parts);
+
+	/**
+	 * Returns true if the path stays inside of the target directory.
+	 */
+	static bool isSafePath(const std::string &name);
+
+private:
+	void skip(size_t size);
+
+	std::istream &_stream;
+
+	// remaining data and padding of the current entry
+	size_t _remain;
+	size_t _padding;
+};
+
+#endif /* TARARCHIVE_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "config.h"
+#include "TarArchive.h"
 #include "ibrdtn/api/Client.h"
 #include "ibrdtn/api/FileBundle.h"
 #include "ibrcommon/net/tcpclient.h"
@@ -15,12 +16,12 @@
 #include "ibrdtn/data/Bundle.h"
 #include "ibrcommon/data/BLOB.h"
 #include "ibrcommon/data/File.h"
-#include "ibrcommon/appstreambuf.h"
 
 #include <stdlib.h>
 #include <iostream>
 #include <map>
 #include <vector>
+#include <new>
 #include <csignal>
 #include <sys/types.h>
 
@@ -108,8 +109,8 @@ int main(int argc, char** argv)
     // backoff for reconnect
     size_t backoff = 2;
 
-    // check outbox for files
-	File outbox(conf["outbox"]);
+    // parts of files which are split into several bundles
+    TarReader::PartMap parts;
 
     // loop, if no stop if requested
     while (_running)
@@ -143,18 +144,19 @@ int main(int argc, char** argv)
             	// get the reference to the blob
             	ibrcommon::BLOB::Reference ref = b.getData();
 
-                // create the extract command
-                stringstream cmdstream; cmdstream << "tar -x -C " << conf["inbox"];
-
-                // create a tar handler
-                appstreambuf extractor(cmdstream.str(), appstreambuf::MODE_WRITE);
-                ostream stream(&extractor);
-
-                // write the payload to the extractor
-               	stream << ref.iostream()->rdbuf();
-
-                // flush the stream
-                stream.flush();
+                // extract the archive directly out of the payload
+                try {
+                	ibrcommon::BLOB::iostream io = ref.iostream();
+                	TarReader reader(*io);
+                	reader.extract(conf["inbox"], parts);
+                } catch (const TarReader::FormatException &ex) {
+                	cout << "Invalid archive received: " << ex.what() << endl;
+                } catch (const ibrcommon::IOException &ex) {
+                	// the inbox is not writable, skip this archive but keep the connection
+                	cout << "Failed to extract archive: " << ex.what() << endl;
+                } catch (const std::bad_alloc&) {
+                	cout << "Failed to extract archive: out of memory" << endl;
+                }
             }
 
             // close the client connection
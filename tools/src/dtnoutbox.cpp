@@ -6,6 +6,7 @@
  */
 
 #include "config.h"
+#include "TarArchive.h"
 #include "ibrdtn/api/Client.h"
 #include "ibrdtn/api/FileBundle.h"
 #include "ibrcommon/net/tcpclient.h"
@@ -15,14 +16,26 @@
 #include "ibrdtn/api/BLOBBundle.h"
 #include "ibrcommon/data/BLOB.h"
 #include "ibrcommon/data/File.h"
-#include "ibrcommon/appstreambuf.h"
 
 #include <stdlib.h>
 #include <iostream>
+#include <fstream>
 #include <map>
+#include <list>
 #include <vector>
+#include <memory>
 #include <csignal>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
 
 using namespace ibrcommon;
 
@@ -36,6 +49,13 @@ void print_help()
         cout << "* optional parameters *" << endl;
         cout << " -h|--help        display this text" << endl;
         cout << " -w|--workdir     temporary work directory" << endl;
+        cout << " -k|--keep        keep the files and send only new or changed files" << endl;
+        cout << " -d|--delay <ms>  wait until no file changed for this time (default: 1000)" << endl;
+        cout << " -i|--interval <seconds>" << endl;
+        cout << "                  interval to scan the outbox (default: 10)" << endl;
+        cout << " -c|--chunk <bytes>" << endl;
+        cout << "                  maximum payload of one bundle, larger files are" << endl;
+        cout << "                  split into several bundles (default: 4194304)" << endl;
 }
 
 map<string,string> readconfiguration(int argc, char** argv)
@@ -64,6 +84,26 @@ map<string,string> readconfiguration(int argc, char** argv)
         {
             ret["workdir"] = argv[i + 1];
         }
+
+        if (arg == "-k" || arg == "--keep")
+        {
+            ret["keep"] = "1";
+        }
+
+        if ((arg == "-d" || arg == "--delay") && (argc > i))
+        {
+            ret["delay"] = argv[i + 1];
+        }
+
+        if ((arg == "-i" || arg == "--interval") && (argc > i))
+        {
+            ret["interval"] = argv[i + 1];
+        }
+
+        if ((arg == "-c" || arg == "--chunk") && (argc > i))
+        {
+            ret["chunk"] = argv[i + 1];
+        }
     }
 
     return ret;
@@ -84,6 +124,315 @@ void term(int signal)
     }
 }
 
+/**
+ * A regular file of the outbox.
+ */
+class OutboxFile
+{
+public:
+	OutboxFile() : size(0), mtime(0), mode(0), hash(0) {};
+
+	// path relative to the outbox
+	std::string path;
+	size_t size;
+	time_t mtime;
+	mode_t mode;
+	u_int64_t hash;
+};
+
+/**
+ * Calculate the FNV-1a hash of the content of a file.
+ */
+u_int64_t hashFile(const std::string &path)
+{
+	u_int64_t hash = 14695981039346656037ULL;
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return 0;
+
+	char buf[65536];
+	ssize_t len = 0;
+	while ((len = ::read(fd, buf, sizeof(buf))) > 0)
+	{
+		for (ssize_t i = 0; i < len; i++)
+		{
+			hash ^= (unsigned char)buf[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	::close(fd);
+	return hash;
+}
+
+/**
+ * Collect all regular files below a directory.
+ */
+void scan(const std::string &outbox, const std::string &rpath, std::list<OutboxFile> &files)
+{
+	const std::string path = rpath.empty() ? outbox : (outbox + "/" + rpath);
+
+	DIR *dir = ::opendir(path.c_str());
+	if (dir == NULL) return;
+
+	struct dirent *entry = NULL;
+	while ((entry = ::readdir(dir)) != NULL)
+	{
+		const std::string name = entry->d_name;
+
+		// skip system files ("." and "..") and incomplete files
+		if ((name == ".") || (name == "..")) continue;
+
+		const std::string file_rpath = rpath.empty() ? name : (rpath + "/" + name);
+
+		struct stat st;
+		if (::lstat((outbox + "/" + file_rpath).c_str(), &st) != 0) continue;
+
+		if (S_ISDIR(st.st_mode))
+		{
+			scan(outbox, file_rpath, files);
+		}
+		else if (S_ISREG(st.st_mode))
+		{
+			OutboxFile f;
+			f.path = file_rpath;
+			f.size = st.st_size;
+			f.mtime = st.st_mtime;
+			f.mode = st.st_mode;
+			files.push_back(f);
+		}
+	}
+
+	::closedir(dir);
+}
+
+/**
+ * Waits for changes in the outbox. With inotify, it returns once no
+ * further change happened for the debounce delay. Without, it returns
+ * after each scan interval.
+ */
+class OutboxWatcher
+{
+public:
+	OutboxWatcher(const std::string &outbox)
+	 : _outbox(outbox), _fd(-1)
+	{
+#ifdef HAVE_SYS_INOTIFY_H
+		_fd = ::inotify_init();
+
+		if (_fd < 0)
+		{
+			cout << "inotify is not available, scan the outbox periodically" << endl;
+		}
+		else
+		{
+			::fcntl(_fd, F_SETFL, O_NONBLOCK);
+			watch(_outbox);
+		}
+#endif
+	};
+
+	~OutboxWatcher()
+	{
+		if (_fd >= 0) ::close(_fd);
+	};
+
+	/**
+	 * Wait for changes.
+	 * @param interval Maximum time to wait in milliseconds.
+	 * @param delay Time without any change before returning in milliseconds.
+	 */
+	void wait(size_t interval, size_t delay)
+	{
+		if (_fd < 0)
+		{
+			::usleep(interval * 1000);
+			return;
+		}
+
+		// wait for the first change
+		if (!poll(interval)) return;
+
+		// collect all changes until the outbox is quiet, but at most
+		// for ten times the delay to bound the latency
+		for (size_t i = 0; (i < 10) && _running; i++)
+		{
+			if (!poll(delay)) break;
+		}
+	};
+
+private:
+	bool poll(size_t timeout)
+	{
+		struct pollfd pfd;
+		pfd.fd = _fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+
+		int ret = ::poll(&pfd, 1, timeout);
+		if (ret <= 0) return false;
+
+		read();
+		return true;
+	};
+
+	void watch(const std::string &path)
+	{
+#ifdef HAVE_SYS_INOTIFY_H
+		int wd = ::inotify_add_watch(_fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (wd < 0) return;
+		_watches[wd] = path;
+
+		// watch all sub-directories
+		DIR *dir = ::opendir(path.c_str());
+		if (dir == NULL) return;
+
+		struct dirent *entry = NULL;
+		while ((entry = ::readdir(dir)) != NULL)
+		{
+			const std::string name = entry->d_name;
+			if ((name == ".") || (name == "..")) continue;
+
+			struct stat st;
+			const std::string sub = path + "/" + name;
+			if ((::lstat(sub.c_str(), &st) == 0) && S_ISDIR(st.st_mode)) watch(sub);
+		}
+
+		::closedir(dir);
+#endif
+	};
+
+	void read()
+	{
+#ifdef HAVE_SYS_INOTIFY_H
+		char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+		ssize_t len = 0;
+
+		while ((len = ::read(_fd, buf, sizeof(buf))) > 0)
+		{
+			for (char *ptr = buf; ptr < buf + len; )
+			{
+				const struct inotify_event *event = (const struct inotify_event*)ptr;
+
+				// watch new directories
+				if ((event->mask & IN_ISDIR) && (event->len > 0))
+				{
+					std::map<int, std::string>::const_iterator iter = _watches.find(event->wd);
+					if (iter != _watches.end()) watch(iter->second + "/" + event->name);
+				}
+
+				ptr += sizeof(struct inotify_event) + event->len;
+			}
+		}
+#endif
+	};
+
+	const std::string _outbox;
+	int _fd;
+	std::map<int, std::string> _watches;
+};
+
+/**
+ * A bundle with a tar archive as payload. The archive
+ * is written directly into the BLOB of the bundle.
+ */
+class OutboxBundle
+{
+public:
+	OutboxBundle()
+	 : _ref(ibrcommon::BLOB::create()), _io(new ibrcommon::BLOB::iostream(_ref.iostream())), _tar(new TarWriter(**_io)), _entries(0), _length(0)
+	{
+	};
+
+	~OutboxBundle()
+	{
+		delete _tar;
+		delete _io;
+	};
+
+	void add(const OutboxFile &f, std::istream &data, size_t offset, size_t length)
+	{
+		_tar->addFile(f.path, data, length, f.mode, f.mtime, offset, f.size);
+		_entries++;
+		_length += length;
+	};
+
+	/**
+	 * Mark a file as complete once its last part is added. The file
+	 * is done, when this bundle has been sent.
+	 */
+	void complete(const OutboxFile &f)
+	{
+		_files.push_back(f);
+	};
+
+	const std::list<OutboxFile>& getFiles() const
+	{
+		return _files;
+	};
+
+	/**
+	 * Finish the archive and send the bundle.
+	 */
+	void send(dtn::api::Client &client, const dtn::data::EID &destination)
+	{
+		_tar->close();
+		delete _tar; _tar = NULL;
+		delete _io; _io = NULL;
+
+		dtn::api::BLOBBundle b(destination, _ref);
+		client << b; client.flush();
+	};
+
+	bool empty() const
+	{
+		return (_entries == 0);
+	};
+
+	size_t length() const
+	{
+		return _length;
+	};
+
+private:
+	ibrcommon::BLOB::Reference _ref;
+	ibrcommon::BLOB::iostream *_io;
+	TarWriter *_tar;
+	size_t _entries;
+	size_t _length;
+	std::list<OutboxFile> _files;
+};
+
+/**
+ * Remove a sent file and its directories if they are empty.
+ */
+void remove(const std::string &outbox, const std::string &rpath)
+{
+	::unlink((outbox + "/" + rpath).c_str());
+
+	for (size_t pos = rpath.rfind('/'); pos != std::string::npos; pos = rpath.rfind('/', pos - 1))
+	{
+		if (::rmdir((outbox + "/" + rpath.substr(0, pos)).c_str()) != 0) break;
+		if (pos == 0) break;
+	}
+}
+
+/**
+ * Send a bundle and remove or remember all files completed by it.
+ */
+void send(OutboxBundle &bundle, dtn::api::Client &client, const dtn::data::EID &destination,
+		const std::string &outbox, bool keep, std::map<std::string, OutboxFile> &sent)
+{
+	bundle.send(client, destination);
+
+	const std::list<OutboxFile> &files = bundle.getFiles();
+	for (std::list<OutboxFile>::const_iterator iter = files.begin(); iter != files.end(); iter++)
+	{
+		if (keep) sent[(*iter).path] = (*iter);
+		else remove(outbox, (*iter).path);
+	}
+}
+
 /*
  * main application method
  */
@@ -107,11 +456,24 @@ int main(int argc, char** argv)
     	}
     }
 
+    const bool keep = (conf.find("keep") != conf.end());
+    const size_t delay = (conf.find("delay") != conf.end()) ? atoi(conf["delay"].c_str()) : 1000;
+    const size_t interval = (conf.find("interval") != conf.end()) ? atoi(conf["interval"].c_str()) : 10;
+    size_t chunk = (conf.find("chunk") != conf.end()) ? atoi(conf["chunk"].c_str()) : 4194304;
+    if (chunk == 0) chunk = 4194304;
+
     // backoff for reconnect
     size_t backoff = 2;
 
     // check outbox for files
 	File outbox(conf["outbox"]);
+	const std::string outbox_path = outbox.getPath();
+
+	// wait for changes in the outbox
+	OutboxWatcher watcher(outbox_path);
+
+	// state of the sent files, if they are kept
+	std::map<std::string, OutboxFile> sent;
 
     // loop, if no stop if requested
     while (_running)
@@ -136,66 +498,96 @@ int main(int argc, char** argv)
             // reset backoff if connected
             backoff = 2;
 
+            const dtn::data::EID destination = EID(conf["destination"]);
+
             // check the connection
             while (_running)
             {
-            	list<File> files;
-            	outbox.getFiles(files);
+            	std::list<OutboxFile> files;
+            	scan(outbox_path, "", files);
 
-            	// <= 2 because of "." and ".."
-            	if (files.size() <= 2)
+            	// select new and changed files
+            	std::list<OutboxFile> changed;
+            	for (std::list<OutboxFile>::iterator iter = files.begin(); iter != files.end(); iter++)
             	{
-                    // wait some seconds
-                    sleep(10);
-
-                    continue;
-            	}
+            		OutboxFile &f = (*iter);
 
-            	stringstream file_list;
+            		if (keep)
+            		{
+            			std::map<std::string, OutboxFile>::iterator s = sent.find(f.path);
 
-            	int prefix_length = outbox.getPath().length() + 1;
+            			// unchanged size and modification time, skip without reading
+            			if ((s != sent.end()) && (s->second.size == f.size) && (s->second.mtime == f.mtime)) continue;
 
-            	for (list<File>::iterator iter = files.begin(); iter != files.end(); iter++)
-            	{
-            		File &f = (*iter);
+            			// same content as sent before
+            			f.hash = hashFile(outbox_path + "/" + f.path);
+            			if ((s != sent.end()) && (s->second.hash == f.hash))
+            			{
+            				s->second = f;
+            				continue;
+            			}
+            		}
 
-            		// skip system files ("." and "..")
-            		if (f.isSystem()) continue;
-
-					// remove the prefix of the outbox path
-            		string rpath = f.getPath();
-            		rpath = rpath.substr(prefix_length, rpath.length() - prefix_length);
-
-            		file_list << rpath << " ";
+            		changed.push_back(f);
             	}
 
-            	// output of all files to send
-            	cout << "files: " << file_list.str() << endl;
-
-            	// "--remove-files" deletes files after adding
-            	stringstream cmd; cmd << "tar --remove-files -cO -C " << outbox.getPath() << " " << file_list.str();
-
-            	// make a tar archive
-            	appstreambuf app(cmd.str(), appstreambuf::MODE_READ);
-            	istream stream(&app);
-
-    			// create a blob
-            	ibrcommon::BLOB::Reference blob = ibrcommon::BLOB::create();
-
-    			// stream the content of "tar" to the payload block
-    			(*blob.iostream()) << stream.rdbuf();
-
-            	// create a new bundle
-    			dtn::data::EID destination = EID(conf["destination"]);
-    			dtn::api::BLOBBundle b(destination, blob);
-
-                // send the bundle
-    			client << b; client.flush();
+            	if (!changed.empty())
+            	{
+            		cout << "files: " << changed.size() << endl;
+
+            		std::auto_ptr<OutboxBundle> bundle(new OutboxBundle());
+
+            		for (std::list<OutboxFile>::const_iterator iter = changed.begin(); iter != changed.end(); iter++)
+            		{
+            			const OutboxFile &f = (*iter);
+
+            			// skipped files stay in the outbox and are tried again in the next round
+            			std::ifstream data((outbox_path + "/" + f.path).c_str(), ios::in | ios::binary);
+            			if (!data.good()) continue;
+
+            			try {
+            				size_t offset = 0;
+            				do {
+            					// start a new bundle if a small file does not fit into the current one
+            					size_t space = chunk - bundle->length();
+            					if (!bundle->empty() && ((space == 0) || ((f.size <= chunk) && (f.size > space))))
+            					{
+            						send(*bundle, client, destination, outbox_path, keep, sent);
+            						bundle.reset(new OutboxBundle());
+            						space = chunk;
+            					}
+
+            					const size_t length = ((f.size - offset) > space) ? space : (f.size - offset);
+            					bundle->add(f, data, offset, length);
+            					offset += length;
+
+            					// large files are continued in the next bundle
+            					if ((offset < f.size) && (bundle->length() >= chunk))
+            					{
+            						send(*bundle, client, destination, outbox_path, keep, sent);
+            						bundle.reset(new OutboxBundle());
+            					}
+            				} while (offset < f.size);
+
+            				bundle->complete(f);
+            			} catch (const TarWriter::FileException &ex) {
+            				// the file has changed while it was read, the archive of the current
+            				// bundle is broken, thus its files are sent again in the next round
+            				cout << "Failed to read " << f.path << ": " << ex.what() << endl;
+            				bundle.reset(new OutboxBundle());
+            			}
+            		}
+
+            		if (!bundle->empty())
+            		{
+            			send(*bundle, client, destination, outbox_path, keep, sent);
+            		}
+            	}
 
             	if (_running)
             	{
-					// wait some seconds
-					sleep(10);
+            		// wait for changes
+            		watcher.wait(interval * 1000, delay);
             	}
             }
 
@@ -0,0 +1,713 @@
+/*
+ * dtnperf.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "config.h"
+#include <ibrdtn/api/Client.h>
+#include <ibrdtn/api/BLOBBundle.h>
+#include <ibrcommon/net/tcpclient.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <csignal>
+#include <cmath>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Each payload starts with this header. All fields are in network byte order.
+ *
+ *  0  magic "PERF"
+ *  4  flags
+ *  8  sequence number, or the number of sent bundles in the end marker
+ * 12  seconds of the send time
+ * 20  microseconds of the send time
+ * 24  identifier of the run, chosen by the client
+ */
+#define PERF_HEADER_SIZE 28
+#define PERF_FLAG_END 0x01
+
+#define CREATE_CHUNK_SIZE 2048
+
+// set this variable to false to stop the app
+bool _running = true;
+
+// global client to abort blocking calls
+dtn::api::Client *_client = NULL;
+
+void term(int signal)
+{
+	if (signal >= 1)
+	{
+		_running = false;
+		if (_client != NULL) _client->abort();
+	}
+}
+
+void print_help()
+{
+	cout << "-- dtnperf (IBR-DTN) --" << endl;
+	cout << "Syntax: dtnperf [options] <dst>"  << endl;
+	cout << "        dtnperf --server [options] <name>"  << endl;
+	cout << " <dst>         send bundles to this destination (e.g. dtn://node/perf)" << endl;
+	cout << " <name>        receive bundles as this application name (e.g. perf)" << endl;
+	cout << "* optional parameters *" << endl;
+	cout << " -h|--help     display this text" << endl;
+	cout << " --server      run as server, receive bundles and report the latency" << endl;
+	cout << " --src <name>  set the source application name of the client" << endl;
+	cout << " -n <count>    send <count> bundles; default: until the duration is over" << endl;
+	cout << " -t <seconds>  send bundles for this duration; default: 10" << endl;
+	cout << " -s <size>     size of the payload in bytes; default: 1024" << endl;
+	cout << "               <min>:<max> for uniformly distributed sizes" << endl;
+	cout << "               exp:<mean> for exponentially distributed sizes" << endl;
+	cout << " -w <bundles>  number of unacknowledged bundles; default: 32" << endl;
+	cout << " -b <bundles>  number of bundles per write to the daemon; default: 1" << endl;
+	cout << " -p <0..2>     set the bundle priority (0 = low, 1 = normal, 2 = high)" << endl;
+	cout << " --drain <seconds>" << endl;
+	cout << "               time the server waits for missing bundles after the" << endl;
+	cout << "               end of a run; default: 10" << endl;
+	cout << " --lifetime <seconds>" << endl;
+	cout << "               set the lifetime of outgoing bundles; default: 3600" << endl;
+	cout << " --format <text|csv|json>" << endl;
+	cout << "               format of the report; default: text" << endl;
+	cout << " --output <file>" << endl;
+	cout << "               append the report to a file instead of stdout" << endl;
+	cout << " -U <socket>   use UNIX domain sockets" << endl;
+}
+
+static void put32(char *data, uint32_t value)
+{
+	data[0] = (char)(value >> 24);
+	data[1] = (char)(value >> 16);
+	data[2] = (char)(value >> 8);
+	data[3] = (char)(value);
+}
+
+static uint32_t get32(const char *data)
+{
+	const unsigned char *d = (const unsigned char*)data;
+	return ((uint32_t)d[0] << 24) | ((uint32_t)d[1] << 16) | ((uint32_t)d[2] << 8) | (uint32_t)d[3];
+}
+
+static double now()
+{
+	struct timeval tv;
+	::gettimeofday(&tv, NULL);
+	return (double)tv.tv_sec + ((double)tv.tv_usec / 1000000.0);
+}
+
+/**
+ * Generates payload sizes of a configured distribution.
+ */
+class SizeDistribution
+{
+public:
+	enum Type
+	{
+		SIZE_FIXED = 0,
+		SIZE_UNIFORM = 1,
+		SIZE_EXPONENTIAL = 2
+	};
+
+	SizeDistribution() : _type(SIZE_FIXED), _a(1024), _b(1024) {};
+
+	/**
+	 * Parse a specification like "1024", "64:4096" or "exp:1024".
+	 * @return False, if the specification is invalid.
+	 */
+	bool parse(const std::string &spec)
+	{
+		std::string value = spec;
+		_type = SIZE_FIXED;
+
+		if (value.substr(0, 4) == "exp:")
+		{
+			_type = SIZE_EXPONENTIAL;
+			value = value.substr(4);
+		}
+
+		const size_t pos = value.find(':');
+		if ((_type == SIZE_FIXED) && (pos != std::string::npos))
+		{
+			_type = SIZE_UNIFORM;
+			std::stringstream(value.substr(pos + 1)) >> _b;
+			value = value.substr(0, pos);
+		}
+
+		std::stringstream(value) >> _a;
+		if (_type != SIZE_UNIFORM) _b = _a;
+
+		return (_a > 0) && (_b >= _a);
+	};
+
+	size_t next()
+	{
+		size_t size = _a;
+
+		switch (_type)
+		{
+		case SIZE_UNIFORM:
+			size = _a + (size_t)(::random() % (_b - _a + 1));
+			break;
+
+		case SIZE_EXPONENTIAL:
+			size = (size_t)(-std::log(1.0 - ((double)::random() / ((double)RAND_MAX + 1.0))) * (double)_a);
+			break;
+
+		default:
+			break;
+		}
+
+		return (size < PERF_HEADER_SIZE) ? PERF_HEADER_SIZE : size;
+	};
+
+private:
+	Type _type;
+	size_t _a;
+	size_t _b;
+};
+
+/**
+ * A list of named values which is written as text, CSV or JSON.
+ */
+class Report
+{
+public:
+	Report(const std::string &format, const std::string &output)
+	 : _format(format), _output(output) {};
+
+	template<class T>
+	void add(const std::string &name, const T &value)
+	{
+		std::stringstream ss; ss << value;
+		_values.push_back(std::make_pair(name, ss.str()));
+	};
+
+	void write()
+	{
+		if (_output.length() == 0)
+		{
+			write(std::cout, true);
+			return;
+		}
+
+		// the CSV header is only written into new files
+		struct stat st;
+		const bool header = (::stat(_output.c_str(), &st) != 0) || (st.st_size == 0);
+
+		std::ofstream stream(_output.c_str(), std::ios::out | std::ios::app);
+		write(stream, header);
+	};
+
+private:
+	void write(std::ostream &stream, bool header)
+	{
+		if (_format == "csv")
+		{
+			if (header)
+			{
+				for (std::vector<std::pair<std::string, std::string> >::const_iterator iter = _values.begin(); iter != _values.end(); iter++)
+				{
+					if (iter != _values.begin()) stream << ",";
+					stream << (*iter).first;
+				}
+				stream << std::endl;
+			}
+
+			for (std::vector<std::pair<std::string, std::string> >::const_iterator iter = _values.begin(); iter != _values.end(); iter++)
+			{
+				if (iter != _values.begin()) stream << ",";
+				stream << (*iter).second;
+			}
+			stream << std::endl;
+		}
+		else if (_format == "json")
+		{
+			stream << "{";
+			for (std::vector<std::pair<std::string, std::string> >::const_iterator iter = _values.begin(); iter != _values.end(); iter++)
+			{
+				if (iter != _values.begin()) stream << ", ";
+				stream << "\"" << (*iter).first << "\": ";
+
+				// the mode is the only value which is not a number
+				if ((*iter).first == "mode")
+					stream << "\"" << (*iter).second << "\"";
+				else
+					stream << (*iter).second;
+			}
+			stream << "}" << std::endl;
+		}
+		else
+		{
+			for (std::vector<std::pair<std::string, std::string> >::const_iterator iter = _values.begin(); iter != _values.end(); iter++)
+			{
+				stream << (*iter).first << ": " << (*iter).second << std::endl;
+			}
+		}
+	};
+
+	const std::string _format;
+	const std::string _output;
+	std::vector<std::pair<std::string, std::string> > _values;
+};
+
+/**
+ * Client which counts the bundles accepted by the daemon.
+ */
+class PerfClient : public dtn::api::Client
+{
+public:
+	PerfClient(const std::string &app, ibrcommon::tcpstream &stream, dtn::api::Client::COMMUNICATION_MODE mode)
+	 : dtn::api::Client(app, stream, mode), completed(0), aborted(0)
+	{ };
+
+	virtual ~PerfClient() { };
+
+	virtual void eventTransferCompleted(const dtn::data::BundleID&)
+	{
+		completed++;
+	};
+
+	virtual void eventTransferAborted(const dtn::data::BundleID&)
+	{
+		aborted++;
+	};
+
+	size_t completed;
+	size_t aborted;
+};
+
+/**
+ * Create a bundle with a header and a testing pattern of the given size.
+ */
+dtn::api::BLOBBundle createBundle(const dtn::data::EID &destination, uint32_t run, uint32_t seq, uint32_t flags, size_t size)
+{
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+
+	{
+		ibrcommon::BLOB::iostream io = ref.iostream();
+
+		struct timeval tv;
+		::gettimeofday(&tv, NULL);
+
+		char header[PERF_HEADER_SIZE];
+		header[0] = 'P'; header[1] = 'E'; header[2] = 'R'; header[3] = 'F';
+		put32(header + 4, flags);
+		put32(header + 8, seq);
+		put32(header + 12, (uint32_t)((uint64_t)tv.tv_sec >> 32));
+		put32(header + 16, (uint32_t)tv.tv_sec);
+		put32(header + 20, (uint32_t)tv.tv_usec);
+		put32(header + 24, run);
+		(*io).write(header, PERF_HEADER_SIZE);
+
+		// create testing pattern, chunkwise to conserve memory
+		char pattern[CREATE_CHUNK_SIZE];
+		for (size_t i = 0; i < sizeof(pattern); i++)
+		{
+			pattern[i] = '0';
+			pattern[i] += i % 10;
+		}
+
+		for (size_t remain = size - PERF_HEADER_SIZE; remain > 0; )
+		{
+			const size_t len = (remain > CREATE_CHUNK_SIZE) ? CREATE_CHUNK_SIZE : remain;
+			(*io).write(pattern, len);
+			remain -= len;
+		}
+	}
+
+	return dtn::api::BLOBBundle(destination, ref);
+}
+
+/**
+ * Statistics of the received bundles of one run.
+ */
+class Statistics
+{
+public:
+	Statistics() : run(0), received(0), bytes(0), expected(0), finished(false), ended(0), _first(0), _last(0) {};
+
+	void add(size_t size, double latency)
+	{
+		const double t = now();
+		if (received == 0) _first = t;
+		_last = t;
+
+		received++;
+		bytes += size;
+		_latencies.push_back(latency);
+	};
+
+	void report(Report &r)
+	{
+		std::sort(_latencies.begin(), _latencies.end());
+
+		double avg = 0;
+		for (std::vector<double>::const_iterator iter = _latencies.begin(); iter != _latencies.end(); iter++) avg += (*iter);
+		if (!_latencies.empty()) avg /= (double)_latencies.size();
+
+		const double duration = _last - _first;
+
+		r.add("mode", "server");
+		r.add("bundles", received);
+		r.add("bytes", bytes);
+		r.add("lost", (expected > received) ? (expected - received) : 0);
+		r.add("seconds", duration);
+		r.add("bundles_per_second", (duration > 0) ? ((double)received / duration) : 0);
+		r.add("goodput_mbit", (duration > 0) ? ((double)bytes * 8.0 / duration / 1000000.0) : 0);
+		r.add("latency_min_ms", _latencies.empty() ? 0 : _latencies.front());
+		r.add("latency_avg_ms", avg);
+		r.add("latency_p50_ms", percentile(0.5));
+		r.add("latency_p99_ms", percentile(0.99));
+		r.add("latency_p999_ms", percentile(0.999));
+		r.add("latency_max_ms", _latencies.empty() ? 0 : _latencies.back());
+	};
+
+	uint32_t run;
+	size_t received;
+	size_t bytes;
+	size_t expected;
+	bool finished;
+
+	// time of the reception of the end marker
+	double ended;
+
+private:
+	double percentile(double p) const
+	{
+		if (_latencies.empty()) return 0;
+
+		size_t index = (size_t)std::ceil(p * (double)_latencies.size());
+		if (index > 0) index--;
+		if (index >= _latencies.size()) index = _latencies.size() - 1;
+
+		return _latencies[index];
+	};
+
+	double _first;
+	double _last;
+
+	// end-to-end latency of each bundle in milliseconds
+	std::vector<double> _latencies;
+};
+
+int run_server(PerfClient &client, size_t drain, const std::string &format, const std::string &output)
+{
+	Statistics stats;
+
+	// runs already reported, late bundles of them are ignored
+	std::set<uint32_t> finished;
+
+	while (_running)
+	{
+		try {
+			dtn::api::Bundle b = client.getBundle(1);
+			const double received = now();
+
+			ibrcommon::BLOB::Reference ref = b.getData();
+			ibrcommon::BLOB::iostream io = ref.iostream();
+
+			char header[PERF_HEADER_SIZE];
+			(*io).read(header, PERF_HEADER_SIZE);
+
+			// ignore other bundles
+			if (((*io).gcount() != PERF_HEADER_SIZE) || (std::string(header, 4) != "PERF")) continue;
+
+			const uint32_t flags = get32(header + 4);
+			const uint32_t seq = get32(header + 8);
+			const double sent = (double)(((uint64_t)get32(header + 12) << 32) | get32(header + 16)) + ((double)get32(header + 20) / 1000000.0);
+			const uint32_t run = get32(header + 24);
+
+			if (finished.find(run) != finished.end()) continue;
+
+			// a new run starts, report the incomplete one
+			if ((run != stats.run) && ((stats.received > 0) || stats.finished))
+			{
+				Report r(format, output);
+				stats.report(r);
+				r.write();
+
+				finished.insert(stats.run);
+				stats = Statistics();
+			}
+
+			stats.run = run;
+
+			if (flags & PERF_FLAG_END)
+			{
+				stats.expected = seq;
+				stats.finished = true;
+				stats.ended = received;
+			}
+			else
+			{
+				stats.add(io.size(), (received - sent) * 1000.0);
+			}
+		} catch (const dtn::MissingObjectException&) {
+			// bundle without payload
+			continue;
+		} catch (const dtn::api::ConnectionTimeoutException&) {
+			// check the drain time of a finished run
+		} catch (const dtn::api::ConnectionAbortedException&) {
+			break;
+		}
+
+		// bundles may arrive after the end marker, wait for them until the drain time is over
+		if (stats.finished && ((stats.received >= stats.expected) || ((now() - stats.ended) >= (double)drain) || !_running))
+		{
+			Report r(format, output);
+			stats.report(r);
+			r.write();
+
+			finished.insert(stats.run);
+			stats = Statistics();
+		}
+	}
+
+	// report the incomplete run
+	if (stats.received > 0)
+	{
+		Report r(format, output);
+		stats.report(r);
+		r.write();
+	}
+
+	return 0;
+}
+
+int run_client(PerfClient &client, const dtn::data::EID &destination, SizeDistribution &sizes, size_t count, size_t duration,
+		size_t window, size_t batch, unsigned int lifetime, int priority, const std::string &format, const std::string &output)
+{
+	client.setWindow(window, batch);
+
+	// identifies the bundles of this run at the server
+	const uint32_t run = (uint32_t)::time(NULL) ^ ((uint32_t)::getpid() << 16);
+
+	size_t sent = 0;
+	size_t bytes = 0;
+
+	const double start = now();
+
+	while (_running)
+	{
+		if ((count > 0) && (sent >= count)) break;
+		if ((count == 0) && ((now() - start) >= (double)duration)) break;
+
+		const size_t size = sizes.next();
+		dtn::api::BLOBBundle b = createBundle(destination, run, (uint32_t)sent, 0, size);
+		b.setLifetime(lifetime);
+		b.setPriority(dtn::api::Bundle::BUNDLE_PRIORITY(priority));
+
+		client.send(b);
+
+		sent++;
+		bytes += size;
+	}
+
+	// tell the server the number of sent bundles
+	dtn::api::BLOBBundle end = createBundle(destination, run, (uint32_t)sent, PERF_FLAG_END, PERF_HEADER_SIZE);
+	end.setLifetime(lifetime);
+	end.setPriority(dtn::api::Bundle::BUNDLE_PRIORITY(priority));
+	client.send(end);
+
+	// wait until the daemon accepted all bundles
+	client.waitCompleted();
+
+	const double seconds = now() - start;
+
+	Report r(format, output);
+	r.add("mode", "client");
+	r.add("bundles", sent);
+	r.add("bytes", bytes);
+	r.add("refused", client.aborted);
+	r.add("seconds", seconds);
+	r.add("bundles_per_second", (seconds > 0) ? ((double)sent / seconds) : 0);
+	r.add("goodput_mbit", (seconds > 0) ? ((double)bytes * 8.0 / seconds / 1000000.0) : 0);
+	r.write();
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	// catch process signals
+	signal(SIGINT, term);
+	signal(SIGTERM, term);
+
+	bool server = false;
+	std::string source = "";
+	size_t count = 0;
+	size_t duration = 10;
+	SizeDistribution sizes;
+	size_t window = 32;
+	size_t batch = 1;
+	size_t drain = 10;
+	unsigned int lifetime = 3600;
+	int priority = 1;
+	std::string format = "text";
+	std::string output = "";
+	ibrcommon::File unixdomain;
+
+	if (argc == 1)
+	{
+		print_help();
+		return 0;
+	}
+
+	for (int i = 1; i < (argc - 1); i++)
+	{
+		std::string arg = argv[i];
+
+		// print help if requested
+		if ((arg == "-h") || (arg == "--help"))
+		{
+			print_help();
+			return 0;
+		}
+		else if (arg == "--server")
+		{
+			server = true;
+		}
+		else if (arg == "--src")
+		{
+			source = argv[++i];
+		}
+		else if (arg == "-n")
+		{
+			stringstream data; data << argv[++i];
+			data >> count;
+		}
+		else if (arg == "-t")
+		{
+			stringstream data; data << argv[++i];
+			data >> duration;
+		}
+		else if (arg == "-s")
+		{
+			if (!sizes.parse(argv[++i]))
+			{
+				std::cout << "invalid payload size!" << std::endl;
+				return -1;
+			}
+		}
+		else if (arg == "-w")
+		{
+			stringstream data; data << argv[++i];
+			data >> window;
+		}
+		else if (arg == "-b")
+		{
+			stringstream data; data << argv[++i];
+			data >> batch;
+		}
+		else if (arg == "-p")
+		{
+			stringstream data; data << argv[++i];
+			data >> priority;
+		}
+		else if (arg == "--drain")
+		{
+			stringstream data; data << argv[++i];
+			data >> drain;
+		}
+		else if (arg == "--lifetime")
+		{
+			stringstream data; data << argv[++i];
+			data >> lifetime;
+		}
+		else if (arg == "--format")
+		{
+			format = argv[++i];
+		}
+		else if (arg == "--output")
+		{
+			output = argv[++i];
+		}
+		else if (arg == "-U")
+		{
+			unixdomain = ibrcommon::File(argv[++i]);
+		}
+		else
+		{
+			std::cout << "invalid argument " << arg << std::endl;
+			return -1;
+		}
+	}
+
+	// the last parameter is the destination or the application name
+	const std::string target = argv[argc - 1];
+
+	int ret = 0;
+
+	try {
+		// Create a stream to the server using TCP.
+		ibrcommon::tcpclient conn;
+
+		// check if the unixdomain socket exists
+		if (unixdomain.exists())
+		{
+			// connect to the unix domain socket
+			conn.open(unixdomain);
+		}
+		else
+		{
+			// connect to the standard local api port
+			conn.open("127.0.0.1", 4550);
+
+			// enable nodelay option
+			conn.enableNoDelay();
+		}
+
+		PerfClient client(server ? target : source, conn, server ? dtn::api::Client::MODE_BIDIRECTIONAL : dtn::api::Client::MODE_SENDONLY);
+		_client = &client;
+
+		// Connect to the server. Actually, this function initiate the
+		// stream protocol by starting the thread and sending the contact header.
+		client.connect();
+
+		try {
+			if (server)
+			{
+				ret = run_server(client, drain, format, output);
+			}
+			else
+			{
+				ret = run_client(client, dtn::data::EID(target), sizes, count, duration, window, batch, lifetime, priority, format, output);
+			}
+
+			// Shutdown the client connection.
+			client.close();
+		} catch (const dtn::api::ConnectionException &ex) {
+			if (_running)
+			{
+				std::cerr << "Error: " << ex.what() << std::endl;
+				ret = -1;
+			}
+		}
+
+		_client = NULL;
+
+		// close the tcpstream
+		conn.close();
+	} catch (const std::exception &ex) {
+		std::cerr << "Error: " << ex.what() << std::endl;
+		ret = -1;
+	}
+
+	return ret;
+}
@@ -14,8 +14,10 @@
 #include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/data/BLOB.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/TimeMeasurement.h>
 
 #include <iostream>
+#include <unistd.h>
 
 void print_help()
 {
@@ -36,9 +38,51 @@ void print_help()
 	cout << " --sign        request signature on the bundle layer" << endl;
 	cout << " --custody     request custody transfer of the bundle" << endl;
 	cout << " --compression request compression of the payload" << endl;
+	cout << " --count <n>   send <n> bundles without waiting for each acknowledgement" << endl;
+	cout << "               and report the sustained rate" << endl;
+	cout << " --rate <n>    limit the rate of --count to <n> bundles per second" << endl;
 
 }
 
+/**
+ * Client which counts the results of asynchronously sent bundles.
+ */
+class AsyncClient : public dtn::api::Client
+{
+public:
+	AsyncClient(const std::string &app, ibrcommon::tcpstream &stream)
+	 : dtn::api::Client(app, stream, dtn::api::Client::MODE_SENDONLY), completed(0), aborted(0)
+	{ };
+
+	virtual ~AsyncClient() { };
+
+	virtual void eventTransferCompleted(const dtn::data::BundleID&)
+	{
+		completed++;
+	};
+
+	virtual void eventTransferAborted(const dtn::data::BundleID&)
+	{
+		aborted++;
+	};
+
+	size_t completed;
+	size_t aborted;
+};
+
+/**
+ * Wait until the next bundle is due to keep the given rate.
+ */
+void pace(ibrcommon::TimeMeasurement &tm, size_t sent, size_t rate)
+{
+	tm.stop();
+
+	const double due = (double)sent * 1000.0 / (double)rate;
+	const double now = tm.getMilliseconds();
+
+	if (due > now) ::usleep((useconds_t)((due - now) * 1000.0));
+}
+
 int main(int argc, char *argv[])
 {
 	bool error = false;
@@ -55,6 +99,8 @@ int main(int argc, char *argv[])
 	bool bundle_custody = false;
 	bool bundle_compression = false;
 	bool bundle_group = false;
+	size_t count = 0;
+	size_t rate = 0;
 
 //	ibrcommon::Logger::setVerbosity(99);
 //	ibrcommon::Logger::addStream(std::cout, ibrcommon::Logger::LOGGER_ALL, ibrcommon::Logger::LOG_DATETIME | ibrcommon::Logger::LOG_LEVEL);
@@ -146,6 +192,33 @@ int main(int argc, char *argv[])
 					return -1;
 				}
 			}
+			else if (arg == "--count" && argc > i)
+			{
+				if (++i > argc)
+				{
+					std::cout << "argument missing!" << std::endl;
+					return -1;
+				}
+
+				stringstream data; data << argv[i];
+				data >> count;
+
+				if (count < 1) {
+					std::cout << "invalid number of bundles!" << std::endl;
+					return -1;
+				}
+			}
+			else if (arg == "--rate" && argc > i)
+			{
+				if (++i > argc)
+				{
+					std::cout << "argument missing!" << std::endl;
+					return -1;
+				}
+
+				stringstream data; data << argv[i];
+				data >> rate;
+			}
 			else if (arg == "-g")
 			{
 				bundle_group = true;
@@ -207,7 +280,7 @@ int main(int argc, char *argv[])
 
 		try {
 			// Initiate a client for synchronous receiving
-			dtn::api::Client client(file_source, conn, dtn::api::Client::MODE_SENDONLY);
+			AsyncClient client(file_source, conn);
 
 			// Connect to the server. Actually, this function initiate the
 			// stream protocol by starting the thread and sending the contact header.
@@ -216,6 +289,19 @@ int main(int argc, char *argv[])
 			// target address
 			EID addr = EID(file_destination);
 
+			// send the bundles asynchronously if a count is given
+			const bool async = (count > 0);
+			if (async)
+			{
+				copies = count;
+
+				// without a rate limit the bundles are written in batches
+				client.setWindow(64, (rate > 0) ? 1 : 16);
+			}
+
+			ibrcommon::TimeMeasurement tm;
+			tm.start();
+
 			try {
 				if (use_stdin)
 				{
@@ -251,10 +337,20 @@ int main(int argc, char *argv[])
 						// set the bundles priority
 						b.setPriority(dtn::api::Bundle::BUNDLE_PRIORITY(priority));
 
+						// keep the requested rate
+						if (rate > 0) pace(tm, u, rate);
+
 						// send the bundle
-						client << b;
+						if (async)
+						{
+							client.send(b);
+						}
+						else
+						{
+							client << b;
+						}
 
-						if (copies > 1)
+						if ((copies > 1) && !async)
 						{
 							std::cout << "sent copy #" << (u+1) << std::endl;
 						}
@@ -289,10 +385,20 @@ int main(int argc, char *argv[])
 						// set the bundles priority
 						b.setPriority(dtn::api::Bundle::BUNDLE_PRIORITY(priority));
 
+						// keep the requested rate
+						if (rate > 0) pace(tm, u, rate);
+
 						// send the bundle
-						client << b;
+						if (async)
+						{
+							client.send(b);
+						}
+						else
+						{
+							client << b;
+						}
 
-						if (copies > 1)
+						if ((copies > 1) && !async)
 						{
 							std::cout << "sent copy #" << (u+1) << std::endl;
 						}
@@ -301,10 +407,26 @@ int main(int argc, char *argv[])
 
 				// flush the buffers
 				client.flush();
+
+				if (async)
+				{
+					// wait until the daemon accepted all bundles
+					client.waitCompleted();
+					tm.stop();
+
+					std::cout << client.completed << " bundles sent in " << tm << ", "
+							<< ((double)client.completed / (tm.getMilliseconds() / 1000.0)) << " bundles/s";
+					if (client.aborted > 0) std::cout << ", " << client.aborted << " refused";
+					std::cout << std::endl;
+				}
 			} catch (const ibrcommon::IOException &ex) {
 				std::cerr << "Error while sending bundle." << std::endl;
 				std::cerr << "\t" << ex.what() << std::endl;
 				error = true;
+			} catch (const dtn::api::ConnectionException &ex) {
+				std::cerr << "Error while sending bundle." << std::endl;
+				std::cerr << "\t" << ex.what() << std::endl;
+				error = true;
 			}
 
 			// Shutdown the client connection.
@@ -57,6 +57,22 @@ void StreamBundle::clear()
 	} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { };
 }
 
+void StreamBundle::setPayload(ibrcommon::BLOB::Reference &ref, size_t seq)
+{
+	// replace the payload block
+	try {
+		_b.remove(_b.getBlock<dtn::data::PayloadBlock>());
+	} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { };
+
+	_b.push_back(ref);
+	_ref = ref;
+
+	try {
+		StreamBlock &block = _b.getBlock<StreamBlock>();
+		block.setSequenceNumber(seq);
+	} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { };
+}
+
 size_t StreamBundle::size()
 {
 	ibrcommon::BLOB::iostream stream = _ref.iostream();
@@ -73,9 +89,11 @@ size_t StreamBundle::getSequenceNumber(const StreamBundle &b)
 	return 0;
 }
 
-BundleStreamBuf::BundleStreamBuf(dtn::api::Client &client, StreamBundle &chunk, size_t buffer, bool wait_seq_zero)
+BundleStreamBuf::BundleStreamBuf(dtn::api::Client &client, StreamBundle &chunk, size_t buffer, bool wait_seq_zero, size_t inflight, size_t limit)
  : _in_buf(new char[BUFF_SIZE]), _out_buf(new char[BUFF_SIZE]), _client(client), _chunk(chunk),
-   _buffer(buffer), _chunk_offset(0), _in_seq(0), _streaming(wait_seq_zero)
+   _buffer(buffer), _chunk_offset(0), _chunks_size(0), _chunks_limit(limit), _in_seq(0), _streaming(wait_seq_zero),
+   _sender(*this), _payload_size(0), _inflight_limit((inflight > 0) ? inflight : 1), _inflight(0), _out_seq(0),
+   _sending(false), _aborted(false)
 {
 	// Initialize get pointer.  This should be zero so that underflow is called upon first read.
 	setg(0, 0, 0);
@@ -84,6 +102,12 @@ BundleStreamBuf::BundleStreamBuf(dtn::api::Client &client, StreamBundle &chunk,
 
 BundleStreamBuf::~BundleStreamBuf()
 {
+	if (_sending)
+	{
+		abort();
+		_sender.join();
+	}
+
 	delete[] _in_buf;
 	delete[] _out_buf;
 };
@@ -94,9 +118,9 @@ int BundleStreamBuf::sync()
 			std::char_traits<char>::eof()), std::char_traits<char>::eof()) ? -1
 			: 0;
 
-	// send the current chunk and clear it
-	_client << _chunk; _client.flush();
-	_chunk.clear();
+	// send the current chunk and wait until all chunks are sent
+	flushPayload();
+	wait();
 
 	return ret;
 }
@@ -120,26 +144,203 @@ int BundleStreamBuf::overflow(int c)
 		return std::char_traits<char>::not_eof(c);
 	}
 
+	// start the sender and allocate the payload buffers on first use
+	if (!_sending)
+	{
+		ibrcommon::MutexLock l(_send_cond);
+
+		// one buffer for each chunk in flight plus one to fill
+		for (size_t i = 0; i <= _inflight_limit; i++)
+		{
+			_pool.push(ibrcommon::BLOB::create());
+		}
+
+		_payload = _pool.front();
+		_pool.pop();
+
+		_sending = true;
+		_sender.start();
+	}
+
 	// copy data into the bundles payload
-	_chunk.append(_in_buf, iend - ibegin);
+	{
+		ibrcommon::BLOB::iostream stream = _payload.iostream();
+		(*stream).write(_in_buf, iend - ibegin);
+	}
+	_payload_size += (iend - ibegin);
 
 	// if size exceeds chunk limit, send it
-	if (_chunk.size() > _buffer)
+	if (_payload_size > _buffer)
 	{
-		_client << _chunk; _client.flush();
-		_chunk.clear();
+		flushPayload();
 	}
 
 	return std::char_traits<char>::not_eof(c);
 }
 
+void BundleStreamBuf::flushPayload()
+{
+	// nothing to send
+	if (_payload_size == 0) return;
+
+	ibrcommon::MutexLock l(_send_cond);
+
+	// hand over the filled payload to the sender
+	_outgoing.push(_payload);
+	_send_cond.signal(true);
+
+	// wait for a free buffer
+	while (_pool.empty())
+	{
+		if (_aborted) throw ibrcommon::Exception("stream aborted");
+		_send_cond.wait();
+	}
+
+	_payload = _pool.front();
+	_pool.pop();
+	_payload_size = 0;
+}
+
+void BundleStreamBuf::wait()
+{
+	ibrcommon::MutexLock l(_send_cond);
+
+	// all buffers are back in the pool when the sender is idle
+	while (_sending && !_aborted && ((_pool.size() + 1) <= _inflight_limit))
+	{
+		_send_cond.wait();
+	}
+}
+
+ibrcommon::BLOB::Reference BundleStreamBuf::next()
+{
+	ibrcommon::MutexLock l(_send_cond);
+
+	while (_outgoing.empty() || (_inflight >= _inflight_limit))
+	{
+		if (_aborted) throw ibrcommon::Exception("stream aborted");
+		_send_cond.wait();
+	}
+
+	if (_aborted) throw ibrcommon::Exception("stream aborted");
+
+	ibrcommon::BLOB::Reference ref = _outgoing.front();
+	_outgoing.pop();
+
+	// count the chunk before the daemon is able to confirm it
+	_inflight++;
+
+	return ref;
+}
+
+void BundleStreamBuf::release(ibrcommon::BLOB::Reference &ref)
+{
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		stream.clear();
+	}
+
+	ibrcommon::MutexLock l(_send_cond);
+	_pool.push(ref);
+	_send_cond.signal(true);
+}
+
+void BundleStreamBuf::forwarded()
+{
+	ibrcommon::MutexLock l(_send_cond);
+	if (_inflight > 0) _inflight--;
+	_send_cond.signal(true);
+}
+
+void BundleStreamBuf::refused()
+{
+	std::cerr << "A chunk has been refused by the daemon, the stream is aborted." << std::endl;
+
+	// release the slot of the chunk
+	forwarded();
+	abort();
+}
+
+void BundleStreamBuf::abort()
+{
+	{
+		ibrcommon::MutexLock l(_send_cond);
+		_aborted = true;
+		_send_cond.signal(true);
+	}
+
+	{
+		ibrcommon::MutexLock l(_chunks_cond);
+		_chunks_cond.abort();
+	}
+}
+
+BundleStreamBuf::Sender::Sender(BundleStreamBuf &buf)
+ : _buf(buf)
+{
+}
+
+BundleStreamBuf::Sender::~Sender()
+{
+	join();
+}
+
+bool BundleStreamBuf::Sender::__cancellation()
+{
+	_buf.abort();
+	return true;
+}
+
+void BundleStreamBuf::Sender::run()
+{
+	try {
+		while (true)
+		{
+			// wait for the next chunk and a free slot in the window
+			ibrcommon::BLOB::Reference ref = _buf.next();
+
+			// the template is only used by this thread
+			_buf._chunk.setPayload(ref, _buf._out_seq++);
+			_buf._client << _buf._chunk; _buf._client.flush();
+
+			// the payload has been serialized, thus the BLOB is free for the next chunk
+			_buf.release(ref);
+		}
+	} catch (const std::exception&) {
+		_buf.abort();
+	}
+}
+
 void BundleStreamBuf::received(const dtn::api::Bundle &b)
 {
 	ibrcommon::MutexLock l(_chunks_cond);
 
-	if (StreamBundle::getSequenceNumber(b) < _in_seq) return;
+	Chunk c(b);
 
-	_chunks.insert(Chunk(b));
+	if (c._seq < _in_seq) return;
+
+	// the reorder buffer is full, the chunk the reader is waiting for is always accepted
+	while ((_chunks_limit > 0) && (c._seq != _in_seq) && !_chunks.empty() && ((_chunks_size + c._size) > _chunks_limit))
+	{
+		if ((*_chunks.begin())._seq == _in_seq)
+		{
+			// the reader is able to proceed, wait until it consumed a chunk
+			_chunks_cond.wait();
+			if (c._seq < _in_seq) return;
+		}
+		else
+		{
+			// a missing chunk blocks the buffer, skip it
+			_in_seq = (*_chunks.begin())._seq;
+			_streaming = true;
+			_chunks_cond.signal(true);
+		}
+	}
+
+	if (_chunks.insert(c).second)
+	{
+		_chunks_size += c._size;
+	}
 	_chunks_cond.signal(true);
 
 	// bundle received
@@ -208,8 +409,12 @@ int BundleStreamBuf::__underflow()
 //		std::cerr << std::endl << "# " << c._seq << std::endl << std::flush;
 
 		// delete the last chunk
+		_chunks_size -= c._size;
 		_chunks.erase(c);
 
+		// wake-up the receiver if it waits for space in the buffer
+		_chunks_cond.signal(true);
+
 		// reset the chunk offset
 		_chunk_offset = 0;
 
@@ -236,8 +441,12 @@ int BundleStreamBuf::__underflow()
 }
 
 BundleStreamBuf::Chunk::Chunk(const dtn::api::Bundle &b)
- : _bundle(b), _seq(StreamBundle::getSequenceNumber(b))
+ : _bundle(b), _seq(StreamBundle::getSequenceNumber(b)), _size(0)
 {
+	try {
+		ibrcommon::BLOB::Reference ref = _bundle.getData();
+		_size = ref.iostream().size();
+	} catch (const dtn::MissingObjectException&) { };
 }
 
 BundleStreamBuf::Chunk::~Chunk()
@@ -254,8 +463,8 @@ bool BundleStreamBuf::Chunk::operator<(const Chunk& other) const
 	return (_seq < other._seq);
 }
 
-BundleStream::BundleStream(ibrcommon::tcpstream &stream, size_t chunk_size, const std::string &app, const dtn::data::EID &group, bool wait_seq_zero)
- : dtn::api::Client(app, group, stream), _stream(stream), _buf(*this, _chunk, chunk_size, wait_seq_zero)
+BundleStream::BundleStream(ibrcommon::tcpstream &stream, size_t chunk_size, const std::string &app, const dtn::data::EID &group, bool wait_seq_zero, size_t inflight, size_t limit)
+ : dtn::api::Client(app, group, stream), _stream(stream), _buf(*this, _chunk, chunk_size, wait_seq_zero, inflight, limit)
 {};
 
 BundleStream::~BundleStream() {};
@@ -270,6 +479,24 @@ dtn::api::Bundle& BundleStream::base()
 	return _chunk;
 }
 
+void BundleStream::eventBundleForwarded()
+{
+	_buf.forwarded();
+	dtn::api::Client::eventBundleForwarded();
+}
+
+void BundleStream::eventBundleRefused()
+{
+	_buf.refused();
+	dtn::api::Client::eventBundleRefused();
+}
+
+void BundleStream::eventConnectionDown()
+{
+	_buf.abort();
+	dtn::api::Client::eventConnectionDown();
+}
+
 void BundleStream::received(const dtn::api::Bundle &b)
 {
 	_buf.received(b);
@@ -290,6 +517,7 @@ void print_help()
 	std::cout << " -G               destination is a group" << std::endl;
 	std::cout << " -c <bytes>       set the chunk size (max. size of each bundle)" << std::endl;
 	std::cout << " -l <seconds>     set the lifetime of stream chunks default: 30" << std::endl;
+	std::cout << " -p <chunks>      set the number of chunks in flight default: 8" << std::endl;
 	std::cout << " -E               request encryption on the bundle layer" << std::endl;
 	std::cout << " -S               request signature on the bundle layer" << std::endl;
 	std::cout << "" << std::endl;
@@ -297,6 +525,7 @@ void print_help()
 	std::cout << " -g <group>       join a destination group" << std::endl;
 	std::cout << " -t <seconds>     set the timeout of the buffer" << std::endl;
 	std::cout << " -w               wait for the bundle with seq zero" << std::endl;
+	std::cout << " -b <bytes>       set the size of the reorder buffer default: 1048576" << std::endl;
 	std::cout << "" << std::endl;
 }
 
@@ -312,9 +541,11 @@ int main(int argc, char *argv[])
 	bool _bundle_signed = false;
 	bool _bundle_group = false;
 	bool _wait_seq_zero = false;
+	size_t _inflight = 8;
+	size_t _buffer_limit = 1048576;
 	ibrcommon::File _unixdomain;
 
-	while((opt = getopt(argc, argv, "hg:Gd:t:s:c:l:ESU:w")) != -1)
+	while((opt = getopt(argc, argv, "hg:Gd:t:s:c:l:ESU:wp:b:")) != -1)
 	{
 		switch (opt)
 		{
@@ -366,6 +597,14 @@ int main(int argc, char *argv[])
 			_wait_seq_zero = true;
 			break;
 
+		case 'p':
+			_inflight = atoi(optarg);
+			break;
+
+		case 'b':
+			_buffer_limit = atoi(optarg);
+			break;
+
 		default:
 			std::cout << "unknown command" << std::endl;
 			return -1;
@@ -392,7 +631,7 @@ int main(int argc, char *argv[])
 		}
 
 		// Initiate a derivated client
-		BundleStream bs(conn, _chunk_size, _source, _group, _wait_seq_zero);
+		BundleStream bs(conn, _chunk_size, _source, _group, _wait_seq_zero, _inflight, _buffer_limit);
 
 		// Connect to the server. Actually, this function initiate the
 		// stream protocol by starting the thread and sending the contact header.
@@ -45,10 +45,22 @@
 
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include <poll.h>
 #include <linux/if.h>
 
+#include <vector>
+
 using namespace std;
 
+/*
+ * Marker for bundles carrying several IP packets. Each packet is prefixed
+ * with its length as 16-bit unsigned integer in network byte order.
+ * A plain IP packet never starts with a zero byte, because the first
+ * nibble contains the IP version.
+ */
+static const char AGGREGATE_MARKER = 0x00;
+
 /*
  * Allocate TUN device, returns opened fd.
  * Stores dev name in the first arg(must be large enough).
@@ -166,11 +178,43 @@ class TUN2BundleGateway : public dtn::api::Client
 			ibrcommon::BLOB::Reference ref = b.getData();
 			ibrcommon::BLOB::iostream stream = ref.iostream();
 			char data[65536];
-			stream->read(data, sizeof(data));
-			size_t ret = stream->gcount();
-			if (::write(_fd, data, ret) < 0)
+
+			char marker = 0;
+			if (!stream->get(marker)) return;
+
+			if (marker != AGGREGATE_MARKER)
 			{
-				std::cerr << "error while writing" << std::endl;
+				// the bundle contains a single IP packet
+				data[0] = marker;
+				stream->read(data + 1, sizeof(data) - 1);
+				size_t ret = stream->gcount() + 1;
+				if (::write(_fd, data, ret) < 0)
+				{
+					std::cerr << "error while writing" << std::endl;
+				}
+				return;
+			}
+
+			// unpack all IP packets of an aggregate
+			while (stream->good())
+			{
+				unsigned char header[2];
+				stream->read((char*)header, sizeof(header));
+				if (stream->gcount() != sizeof(header)) break;
+
+				size_t len = (header[0] << 8) | header[1];
+				stream->read(data, len);
+
+				if ((size_t)stream->gcount() != len)
+				{
+					std::cerr << "truncated packet in aggregate" << std::endl;
+					break;
+				}
+
+				if (::write(_fd, data, len) < 0)
+				{
+					std::cerr << "error while writing" << std::endl;
+				}
 			}
 		}
 
@@ -180,6 +224,112 @@ class TUN2BundleGateway : public dtn::api::Client
 bool m_running = true;
 int tunnel_fd = -1;
 
+/**
+ * Collects several IP packets and sends them as one bundle as soon as
+ * the size limit is reached or the oldest packet waits longer than
+ * the latency limit.
+ */
+class PacketAggregator
+{
+	public:
+		PacketAggregator(dtn::api::Client &client, const dtn::data::EID &destination, size_t limit, size_t latency, bool compression)
+		: _client(client), _destination(destination), _limit(limit), _latency(latency), _compression(compression), _packets(0)
+		{
+			_buffer.reserve(limit + 2);
+		};
+
+		virtual ~PacketAggregator() {};
+
+		/**
+		 * Add an IP packet to the current aggregate.
+		 */
+		void add(const char *data, size_t len)
+		{
+			// send the current aggregate if the packet does not fit into it
+			if ((_packets > 0) && ((_buffer.size() + len + 2) > _limit)) flush();
+
+			if (_packets == 0)
+			{
+				_buffer.push_back(AGGREGATE_MARKER);
+				::gettimeofday(&_first, NULL);
+			}
+
+			_buffer.push_back((char)((len >> 8) & 0xff));
+			_buffer.push_back((char)(len & 0xff));
+			_buffer.insert(_buffer.end(), data, data + len);
+			_packets++;
+
+			if (_buffer.size() >= _limit) flush();
+		}
+
+		/**
+		 * Returns the time in milliseconds until the current aggregate
+		 * has to be sent or -1 if no packet is waiting.
+		 */
+		int timeout() const
+		{
+			if (_packets == 0) return -1;
+
+			struct timeval now;
+			::gettimeofday(&now, NULL);
+
+			long waiting = ((now.tv_sec - _first.tv_sec) * 1000) + ((now.tv_usec - _first.tv_usec) / 1000);
+			if (waiting >= (long)_latency) return 0;
+			return _latency - waiting;
+		}
+
+		/**
+		 * Send all collected packets as one bundle.
+		 */
+		void flush()
+		{
+			if (_packets == 0) return;
+
+			// create a blob
+			ibrcommon::BLOB::Reference blob = ibrcommon::BLOB::create();
+
+			// add the data
+			blob.iostream()->write(&_buffer[0], _buffer.size());
+
+			// create a new bundle
+			dtn::api::BLOBBundle b(_destination, blob);
+
+			// let the daemon compress the aggregate
+			if (_compression) b.requestCompression();
+
+			// transmit the packets
+			_client << b;
+			_client.flush();
+
+			_buffer.clear();
+			_packets = 0;
+		}
+
+	private:
+		dtn::api::Client &_client;
+		const dtn::data::EID _destination;
+		const size_t _limit;
+		const size_t _latency;
+		const bool _compression;
+
+		std::vector<char> _buffer;
+		size_t _packets;
+		struct timeval _first;
+};
+
+void print_help(const char *name)
+{
+	cout << "Syntax: " << name << " [options] <dev> <ip> <ptp> <dst>" << endl;
+	cout << "  <dev>   Virtual network device to create" << endl;
+	cout << "  <ip>    Own IP address to set" << endl;
+	cout << "  <ptp>   IP address of the Point-To-Point partner" << endl;
+	cout << "  <dst>   EID of the destination" << endl;
+	cout << "* optional parameters *" << endl;
+	cout << "  -a <bytes>    aggregate IP packets into bundles up to this size" << endl;
+	cout << "  -l <ms>       max. delay of a packet in the aggregation; default: 10" << endl;
+	cout << "  --compression request compression of aggregated bundles" << endl;
+}
+
 void term(int signal)
 {
 	if (signal >= 1)
@@ -198,17 +348,47 @@ int main(int argc, char *argv[])
 
 	cout << "IBR-DTN IP <-> Bundle Tunnel" << endl;
 
-	if (argc < 5)
+	size_t aggregate_limit = 0;
+	size_t aggregate_latency = 10;
+	bool compression = false;
+	std::vector<char*> args;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if ((arg == "-a") && (i + 1 < argc))
+		{
+			stringstream data; data << argv[++i];
+			data >> aggregate_limit;
+		}
+		else if ((arg == "-l") && (i + 1 < argc))
+		{
+			stringstream data; data << argv[++i];
+			data >> aggregate_latency;
+		}
+		else if (arg == "--compression")
+		{
+			compression = true;
+		}
+		else if ((arg == "-h") || (arg == "--help"))
+		{
+			print_help(argv[0]);
+			return 0;
+		}
+		else
+		{
+			args.push_back(argv[i]);
+		}
+	}
+
+	if (args.size() < 4)
 	{
-		cout << "Syntax: " << argv[0] << " <dev> <ip> <ptp> <dst>" << endl;
-		cout << "  <dev>   Virtual network device to create" << endl;
-		cout << "  <ip>    Own IP address to set" << endl;
-		cout << "  <ptp>   IP address of the Point-To-Point partner" << endl;
-		cout << "  <dst>   EID of the destination" << endl;
+		print_help(argv[0]);
 		return -1;
 	}
 
-	int tunnel_fd = tun_open(argv[1]);
+	int tunnel_fd = tun_open(args[0]);
 
 	if (tunnel_fd == -1)
 	{
@@ -221,7 +401,7 @@ int main(int argc, char *argv[])
 
 	// set the interface addresses
 	stringstream ifconfig;
-	ifconfig << "ifconfig " << argv[1] << " -pointopoint " << argv[2] << " dstaddr " << argv[3];
+	ifconfig << "ifconfig " << args[0] << " -pointopoint " << args[1] << " dstaddr " << args[2];
 	if ( system(ifconfig.str().c_str()) > 0 )
 	{
 		std::cerr << "can not the interface address" << std::endl;
@@ -231,9 +411,42 @@ int main(int argc, char *argv[])
 
 	cout << "ready" << endl;
 
+	const dtn::data::EID destination(args[3]);
+	PacketAggregator aggregator(gateway, destination, aggregate_limit, aggregate_latency, compression);
+
 	while (m_running)
 	{
 		char data[65536];
+
+		if (aggregate_limit > 0)
+		{
+			// wait for the next packet until the aggregate has to be sent
+			struct pollfd pfd;
+			pfd.fd = tunnel_fd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+
+			int ready = ::poll(&pfd, 1, aggregator.timeout());
+
+			if (ready < 0)
+			{
+				if (errno == EINTR) continue;
+				break;
+			}
+
+			if (ready == 0)
+			{
+				aggregator.flush();
+				continue;
+			}
+
+			int ret = ::read(tunnel_fd, data, sizeof(data));
+			if (ret <= 0) continue;
+
+			aggregator.add(data, ret);
+			continue;
+		}
+
 		int ret = ::read(tunnel_fd, data, sizeof(data));
 
 		cout << "received " << ret << " bytes" << endl;
@@ -245,13 +458,16 @@ int main(int argc, char *argv[])
 		blob.iostream()->write(data, ret);
 
 		// create a new bundle
-		dtn::api::BLOBBundle b(dtn::data::EID(argv[4]), blob);
+		dtn::api::BLOBBundle b(destination, blob);
 
 		// transmit the packet
 		gateway << b;
 		gateway.flush();
 	}
 
+	// send remaining packets
+	aggregator.flush();
+
 	gateway.close();
 
 	::close(tunnel_fd);
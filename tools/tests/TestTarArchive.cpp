@@ -0,0 +1,299 @@
+/*
+ * TestTarArchive.cpp
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include "TestTarArchive.h"
+#include "TarArchive.h"
+#include <sstream>
+#include <fstream>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ftw.h>
+#include <sys/stat.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestTarArchive);
+
+static int removeEntry(const char *path, const struct stat*, int, struct FTW*)
+{
+	return ::remove(path);
+}
+
+static std::string readFile(const std::string &path)
+{
+	std::ifstream fs(path.c_str(), std::ios::binary);
+	std::stringstream ss;
+	ss << fs.rdbuf();
+	return ss.str();
+}
+
+static bool exists(const std::string &path)
+{
+	struct stat s;
+	return (::stat(path.c_str(), &s) == 0);
+}
+
+/**
+ * Create a header block with a valid checksum.
+ */
+static std::string createHeader(const std::string &name, char type, size_t size)
+{
+	char header[512];
+	::memset(header, 0, sizeof(header));
+
+	::strncpy(header, name.c_str(), 100);
+	::snprintf(header + 100, 8, "%07o", 0644);
+	::snprintf(header + 124, 12, "%011lo", (unsigned long)size);
+	::snprintf(header + 136, 12, "%011o", 0);
+	header[156] = type;
+	::memcpy(header + 257, "ustar", 6);
+	::memcpy(header + 263, "00", 2);
+
+	// the checksum field counts as spaces
+	::memset(header + 148, ' ', 8);
+	unsigned int sum = 0;
+	for (size_t i = 0; i < sizeof(header); i++) sum += (unsigned char)header[i];
+	::snprintf(header + 148, 8, "%06o", sum);
+	header[155] = ' ';
+
+	return std::string(header, sizeof(header));
+}
+
+void TestTarArchive::setUp(void)
+{
+	char tmpl[] = "/tmp/tartest-XXXXXX";
+	_directory = ::mkdtemp(tmpl);
+}
+
+void TestTarArchive::tearDown(void)
+{
+	::nftw(_directory.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+void TestTarArchive::tar_roundtrip(void)
+{
+	std::stringstream archive;
+
+	{
+		TarWriter writer(archive);
+		writer.addDirectory("dir", 0755, 1000);
+
+		std::stringstream data("hello world");
+		writer.addFile("dir/file.txt", data, 11, 0644, 2000);
+
+		std::stringstream empty;
+		writer.addFile("empty", empty, 0, 0600, 3000);
+
+		writer.close();
+	}
+
+	// the archive consists of whole blocks only
+	CPPUNIT_ASSERT_EQUAL((size_t)0, archive.str().length() % 512);
+
+	TarReader reader(archive);
+	TarReader::Entry entry;
+
+	CPPUNIT_ASSERT(reader.next(entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("dir"), entry.name);
+	CPPUNIT_ASSERT_EQUAL(TarReader::ENTRY_DIRECTORY, entry.type);
+	CPPUNIT_ASSERT_EQUAL((mode_t)0755, entry.mode);
+
+	CPPUNIT_ASSERT(reader.next(entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("dir/file.txt"), entry.name);
+	CPPUNIT_ASSERT_EQUAL(TarReader::ENTRY_FILE, entry.type);
+	CPPUNIT_ASSERT_EQUAL((size_t)11, entry.size);
+	CPPUNIT_ASSERT_EQUAL((time_t)2000, entry.mtime);
+
+	std::stringstream content;
+	reader.read(content);
+	CPPUNIT_ASSERT_EQUAL(std::string("hello world"), content.str());
+
+	// the data of this entry is skipped by the next call
+	CPPUNIT_ASSERT(reader.next(entry));
+	CPPUNIT_ASSERT_EQUAL(std::string("empty"), entry.name);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, entry.size);
+
+	CPPUNIT_ASSERT(!reader.next(entry));
+}
+
+void TestTarArchive::tar_longname(void)
+{
+	const std::string name = std::string(150, 'a') + "/" + std::string(80, 'b');
+	std::stringstream archive;
+
+	{
+		TarWriter writer(archive);
+		std::stringstream data("0123456789");
+		writer.addFile(name, data, 10, 0644, 0);
+	}
+
+	TarReader reader(archive);
+	TarReader::Entry entry;
+
+	// the path is taken out of the pax header
+	CPPUNIT_ASSERT(reader.next(entry));
+	CPPUNIT_ASSERT_EQUAL(name, entry.name);
+	CPPUNIT_ASSERT_EQUAL((size_t)10, entry.size);
+	CPPUNIT_ASSERT(!reader.next(entry));
+}
+
+void TestTarArchive::tar_parts(void)
+{
+	const std::string content = "first part|second part";
+	TarReader::PartMap parts;
+
+	// the second part arrives first
+	for (int i = 1; i >= 0; i--)
+	{
+		const size_t offset = (i == 0) ? 0 : 11;
+		const size_t length = (i == 0) ? 11 : content.length() - 11;
+
+		std::stringstream archive;
+		{
+			TarWriter writer(archive);
+			std::stringstream data(content.substr(offset, length));
+			writer.addFile("split.txt", data, length, 0644, 0, offset, content.length());
+		}
+
+		TarReader reader(archive);
+		const size_t extracted = reader.extract(_directory, parts);
+
+		if (i == 1)
+		{
+			// the file is incomplete
+			CPPUNIT_ASSERT_EQUAL((size_t)0, extracted);
+			CPPUNIT_ASSERT(!exists(_directory + "/split.txt"));
+			CPPUNIT_ASSERT_EQUAL((size_t)1, parts.size());
+		}
+		else
+		{
+			CPPUNIT_ASSERT_EQUAL((size_t)1, extracted);
+			CPPUNIT_ASSERT(parts.empty());
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL(content, readFile(_directory + "/split.txt"));
+	CPPUNIT_ASSERT(!exists(_directory + "/split.txt.part"));
+}
+
+void TestTarArchive::tar_checksum(void)
+{
+	std::stringstream archive;
+
+	{
+		TarWriter writer(archive);
+		std::stringstream data("hello world");
+		writer.addFile("file.txt", data, 11, 0644, 0);
+	}
+
+	// modify the name of the first entry
+	std::string raw = archive.str();
+	raw[0] = 'F';
+
+	std::stringstream broken(raw);
+	TarReader reader(broken);
+	TarReader::Entry entry;
+	CPPUNIT_ASSERT_THROW(reader.next(entry), TarReader::FormatException);
+}
+
+void TestTarArchive::tar_truncated(void)
+{
+	std::stringstream archive;
+
+	{
+		TarWriter writer(archive);
+		const std::string content(4096, 'x');
+		std::stringstream data(content);
+		writer.addFile("file.txt", data, content.length(), 0644, 0);
+	}
+
+	// cut the archive in the middle of the data
+	std::stringstream broken(archive.str().substr(0, 2048));
+	TarReader reader(broken);
+	TarReader::Entry entry;
+
+	CPPUNIT_ASSERT(reader.next(entry));
+
+	std::stringstream content;
+	CPPUNIT_ASSERT_THROW(reader.read(content), TarReader::FormatException);
+
+	// a header cut in the middle is rejected as well
+	std::stringstream header(archive.str().substr(0, 100));
+	TarReader hreader(header);
+	CPPUNIT_ASSERT_THROW(hreader.next(entry), TarReader::FormatException);
+}
+
+void TestTarArchive::tar_short_input(void)
+{
+	std::stringstream archive;
+	TarWriter writer(archive);
+
+	// the file has been truncated after its size was read
+	std::stringstream data("short");
+	CPPUNIT_ASSERT_THROW(writer.addFile("file.txt", data, 100, 0644, 0), TarWriter::FileException);
+}
+
+void TestTarArchive::tar_extended_size(void)
+{
+	// a pax header announcing a huge size is rejected before it is read
+	{
+		std::stringstream archive(createHeader("PaxHeader", 'x', 1024 * 1024 * 1024));
+		TarReader reader(archive);
+		TarReader::Entry entry;
+		CPPUNIT_ASSERT_THROW(reader.next(entry), TarReader::FormatException);
+	}
+
+	// the same applies to GNU long names
+	{
+		std::stringstream archive(createHeader("././@LongLink", 'L', 1024 * 1024));
+		TarReader reader(archive);
+		TarReader::Entry entry;
+		CPPUNIT_ASSERT_THROW(reader.next(entry), TarReader::FormatException);
+	}
+
+	// many small extended headers do not add up beyond the limit
+	{
+		std::string raw;
+		const std::string record = "22 comment=0123456789\n";
+		const std::string data = record + std::string(512 - record.length(), '\0');
+
+		for (int i = 0; i < 256; i++)
+		{
+			raw += createHeader("PaxHeader", 'x', 512) + data;
+		}
+
+		std::stringstream archive(raw);
+		TarReader reader(archive);
+		TarReader::Entry entry;
+		CPPUNIT_ASSERT_THROW(reader.next(entry), TarReader::FormatException);
+	}
+}
+
+void TestTarArchive::tar_safepath(void)
+{
+	CPPUNIT_ASSERT(TarReader::isSafePath("file.txt"));
+	CPPUNIT_ASSERT(TarReader::isSafePath("dir/file.txt"));
+	CPPUNIT_ASSERT(TarReader::isSafePath("dir/..file"));
+
+	CPPUNIT_ASSERT(!TarReader::isSafePath(""));
+	CPPUNIT_ASSERT(!TarReader::isSafePath("/etc/passwd"));
+	CPPUNIT_ASSERT(!TarReader::isSafePath("../file.txt"));
+	CPPUNIT_ASSERT(!TarReader::isSafePath("dir/../../file.txt"));
+
+	// unsafe entries are skipped on extraction
+	std::stringstream archive;
+	{
+		TarWriter writer(archive);
+		std::stringstream evil("evil");
+		writer.addFile("../evil.txt", evil, 4, 0644, 0);
+		std::stringstream good("good");
+		writer.addFile("good.txt", good, 4, 0644, 0);
+	}
+
+	TarReader::PartMap parts;
+	TarReader reader(archive);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, reader.extract(_directory, parts));
+	CPPUNIT_ASSERT_EQUAL(std::string("good"), readFile(_directory + "/good.txt"));
+}
@@ -0,0 +1,46 @@
+/*
+ * TestTarArchive.h
+ *
+ *  Created on: 19.10.2026
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#ifndef TESTTARARCHIVE_H_
+#define TESTTARARCHIVE_H_
+
+class TestTarArchive : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestTarArchive);
+	CPPUNIT_TEST (tar_roundtrip);
+	CPPUNIT_TEST (tar_longname);
+	CPPUNIT_TEST (tar_parts);
+	CPPUNIT_TEST (tar_checksum);
+	CPPUNIT_TEST (tar_truncated);
+	CPPUNIT_TEST (tar_short_input);
+	CPPUNIT_TEST (tar_extended_size);
+	CPPUNIT_TEST (tar_safepath);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void tar_roundtrip(void);
+	void tar_longname(void);
+	void tar_parts(void);
+
+	void tar_checksum(void);
+	void tar_truncated(void);
+	void tar_short_input(void);
+	void tar_extended_size(void);
+	void tar_safepath(void);
+
+private:
+	std::string _directory;
+};
+
+#endif /* TESTTARARCHIVE_H_ */